@@ -0,0 +1,318 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/ghoul.h>
+#include <ghoul/cmdparser/commandlineparser.h>
+#include <ghoul/cmdparser/singlecommand.h>
+#include <ghoul/fmt.h>
+#include <ghoul/io/socket/tcpsocket.h>
+#include <ghoul/logging/consolelog.h>
+#include <ghoul/logging/logmanager.h>
+#include <openspace/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// This application measures how many subscription updates the server module can deliver
+// per second. It opens a number of connections to a running OpenSpace instance that all
+// subscribe to the same property, while one additional connection keeps changing the
+// value of that property at a fixed frequency.
+
+namespace {
+    constexpr const char* _loggerCat = "ServerLoad";
+
+    struct Client {
+        std::unique_ptr<ghoul::io::TcpSocket> socket;
+        std::thread thread;
+    };
+
+    // Reads a MessagePack message, which is preceded by its size
+    bool getFrame(ghoul::io::TcpSocket& socket, std::string& message) {
+        uint32_t size = 0;
+        if (!socket.get(reinterpret_cast<char*>(&size), sizeof(uint32_t))) {
+            return false;
+        }
+        message.resize(size);
+        return socket.get(message.data(), size);
+    }
+
+    bool putFrame(ghoul::io::TcpSocket& socket, const std::vector<uint8_t>& message) {
+        const uint32_t size = static_cast<uint32_t>(message.size());
+        return socket.put(reinterpret_cast<const char*>(&size), sizeof(uint32_t)) &&
+               socket.put(reinterpret_cast<const char*>(message.data()), message.size());
+    }
+
+    nlohmann::json subscriptionMessage(const std::string& uri, double rate) {
+        nlohmann::json payload = {
+            { "event", "start_subscription" },
+            { "property", uri }
+        };
+        if (rate > 0.0) {
+            payload["rate"] = rate;
+        }
+        const nlohmann::json message = {
+            { "topic", 1 },
+            { "type", "subscribe" },
+            { "payload", payload }
+        };
+        return message;
+    }
+
+    std::string setPropertyMessage(int topic, const std::string& uri, double value) {
+        const nlohmann::json message = {
+            { "topic", topic },
+            { "type", "set" },
+            { "payload", { { "property", uri }, { "value", value } } }
+        };
+        return message.dump();
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace ghoul::cmdparser;
+    using namespace ghoul::logging;
+
+    ghoul::initialize();
+    LogManager::initialize(LogLevel::Info, LogManager::ImmediateFlush::Yes);
+    LogMgr.addLog(std::make_unique<ConsoleLog>());
+
+    CommandlineParser commandlineParser(
+        "ServerLoad",
+        CommandlineParser::AllowUnknownCommands::Yes
+    );
+
+    std::string address = "localhost";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        address,
+        "--address",
+        "-a",
+        "Sets the address of the OpenSpace instance. Default: localhost"
+    ));
+
+    std::string portString = "4681";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        portString,
+        "--port",
+        "-p",
+        "Sets the port of the TcpSocket server interface. Default: 4681"
+    ));
+
+    std::string connectionsString = "32";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        connectionsString,
+        "--connections",
+        "-c",
+        "Sets the number of subscribing connections. Default: 32"
+    ));
+
+    std::string uri = "RenderEngine.Gamma";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        uri,
+        "--uri",
+        "-u",
+        "Sets the URI of the numerical property that is subscribed to and changed. "
+        "Default: RenderEngine.Gamma"
+    ));
+
+    std::string valueString = "2.2";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        valueString,
+        "--value",
+        "-v",
+        "Sets the value around which the property is changed. Default: 2.2"
+    ));
+
+    std::string frequencyString = "120";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        frequencyString,
+        "--frequency",
+        "-f",
+        "Sets how many times per second the property is changed. Default: 120"
+    ));
+
+    std::string rateString = "0";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        rateString,
+        "--rate",
+        "-r",
+        "Sets the maximum number of updates per second that each subscription requests. "
+        "0 requests at most one update per frame. Default: 0"
+    ));
+
+    std::string encoding = "json";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        encoding,
+        "--encoding",
+        "-e",
+        "Sets the encoding that the subscribing connections request, either 'json' or "
+        "'msgpack'. Default: json"
+    ));
+
+    std::string durationString = "10";
+    commandlineParser.addCommand(std::make_unique<SingleCommand<std::string>>(
+        durationString,
+        "--duration",
+        "-d",
+        "Sets the number of seconds that the measurement runs. Default: 10"
+    ));
+
+    commandlineParser.setCommandLine({ argv, argv + argc });
+    commandlineParser.execute();
+
+    int port = 0;
+    int nConnections = 0;
+    int duration = 0;
+    double value = 0.0;
+    double frequency = 0.0;
+    double rate = 0.0;
+    try {
+        port = std::stoi(portString);
+        nConnections = std::stoi(connectionsString);
+        duration = std::stoi(durationString);
+        value = std::stod(valueString);
+        frequency = std::stod(frequencyString);
+        rate = std::stod(rateString);
+    }
+    catch (const std::logic_error& e) {
+        LFATAL(fmt::format("Invalid argument: {}", e.what()));
+        return EXIT_FAILURE;
+    }
+    if (nConnections <= 0 || duration <= 0 || frequency <= 0.0) {
+        LFATAL("Connections, duration, and frequency have to be positive");
+        return EXIT_FAILURE;
+    }
+    const bool useMessagePack = (encoding == "msgpack");
+    if (!useMessagePack && encoding != "json") {
+        LFATAL(fmt::format("Unknown encoding '{}'", encoding));
+        return EXIT_FAILURE;
+    }
+
+    std::atomic<uint64_t> nMessages = 0;
+    std::atomic<uint64_t> nBytes = 0;
+    std::vector<Client> clients(nConnections);
+    try {
+        for (Client& client : clients) {
+            client.socket = std::make_unique<ghoul::io::TcpSocket>(address, port);
+            client.socket->connect();
+        }
+    }
+    catch (const std::exception& e) {
+        LFATAL(fmt::format("Could not connect to {}:{}: {}", address, port, e.what()));
+        return EXIT_FAILURE;
+    }
+
+    const nlohmann::json subscription = subscriptionMessage(uri, rate);
+    for (Client& client : clients) {
+        ghoul::io::TcpSocket& socket = *client.socket;
+        if (useMessagePack) {
+            std::string answer;
+            socket.putMessage(R"({ "encoding": "msgpack" })");
+            if (!socket.getMessage(answer) ||
+                nlohmann::json::parse(answer).value("encoding", "") != "msgpack")
+            {
+                LFATAL("Server did not accept the MessagePack encoding");
+                return EXIT_FAILURE;
+            }
+            putFrame(socket, nlohmann::json::to_msgpack(subscription));
+        }
+        else {
+            socket.putMessage(subscription.dump());
+        }
+    }
+
+    for (Client& client : clients) {
+        ghoul::io::TcpSocket& socket = *client.socket;
+        client.thread = std::thread([&nMessages, &nBytes, &socket, useMessagePack]() {
+            std::string message;
+            while (useMessagePack ? getFrame(socket, message) :
+                                    socket.getMessage(message))
+            {
+                ++nMessages;
+                nBytes += message.size();
+            }
+        });
+    }
+    LINFO(fmt::format(
+        "{} connections subscribed to '{}' using {}", nConnections, uri, encoding
+    ));
+
+    std::atomic_bool isRunning = true;
+    ghoul::io::TcpSocket driver(address, port);
+    driver.connect();
+    std::thread driverThread([&]() {
+        const std::chrono::duration<double> interval(1.0 / frequency);
+        int topic = 2;
+        bool isOffset = false;
+        while (isRunning) {
+            const double v = isOffset ? value * 1.0001 : value;
+            driver.putMessage(setPropertyMessage(topic++, uri, v));
+            isOffset = !isOffset;
+            std::this_thread::sleep_for(interval);
+        }
+        // Restore the original value
+        driver.putMessage(setPropertyMessage(topic, uri, value));
+    });
+
+    uint64_t previous = nMessages;
+    const uint64_t start = previous;
+    const uint64_t startBytes = nBytes;
+    for (int i = 0; i < duration; ++i) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        const uint64_t current = nMessages;
+        LINFO(fmt::format(
+            "{:>4} s: {:>8} updates/s ({:.1f} per connection)",
+            i + 1, current - previous,
+            static_cast<double>(current - previous) / nConnections
+        ));
+        previous = current;
+    }
+    const uint64_t bytes = nBytes - startBytes;
+
+    isRunning = false;
+    driverThread.join();
+    driver.disconnect();
+
+    const double average = static_cast<double>(previous - start) / duration;
+    LINFO(fmt::format(
+        "Sustained {:.1f} updates/s over {} s ({:.1f} per connection)",
+        average, duration, average / nConnections
+    ));
+    if (previous > start) {
+        LINFO(fmt::format(
+            "Average message size: {:.1f} bytes",
+            static_cast<double>(bytes) / (previous - start)
+        ));
+    }
+
+    for (Client& client : clients) {
+        client.socket->disconnect();
+        client.thread.join();
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -135,7 +135,10 @@ int main(int argc, char** argv) {
     while (std::cin.get() != 'q') {}
 
     server.stop();
-    LINFO("Server stopped");
+    LINFO(fmt::format(
+        "Server stopped. {} stale camera keyframes were dropped",
+        server.nDroppedKeyframes()
+    ));
 
     return 0;
 };
@@ -87,6 +87,7 @@ struct Configuration {
     bool isRenderingOnMasterDisabled = false;
     bool isSceneTranslationOnMasterDisabled = false;
     bool isConsoleDisabled = false;
+    bool isSyncCompressionEnabled = false;
 
     std::map<std::string, ghoul::Dictionary> moduleConfigurations;
 
@@ -46,6 +46,7 @@ class RaycasterManager;
 class RenderEngine;
 class ScreenSpaceRenderable;
 class SyncEngine;
+class TaskScheduler;
 class TimeManager;
 class VirtualPropertyManager;
 struct WindowDelegate;
@@ -58,7 +59,10 @@ namespace interaction {
     class ShortcutManager;
 } // namespace interaction
 namespace performance { class PerformanceManager; }
-namespace properties { class PropertyOwner; }
+namespace properties {
+    class PropertyIndex;
+    class PropertyOwner;
+} // namespace properties
 namespace scripting {
     class ScriptEngine;
     class ScriptScheduler;
@@ -82,6 +86,7 @@ RaycasterManager& gRaycasterManager();
 RenderEngine& gRenderEngine();
 std::vector<std::unique_ptr<ScreenSpaceRenderable>>& gScreenspaceRenderables();
 SyncEngine& gSyncEngine();
+TaskScheduler& gTaskScheduler();
 TimeManager& gTimeManager();
 VirtualPropertyManager& gVirtualPropertyManager();
 WindowDelegate& gWindowDelegate();
@@ -92,6 +97,7 @@ interaction::NavigationHandler& gNavigationHandler();
 interaction::SessionRecording& gSessionRecording();
 interaction::ShortcutManager& gShortcutManager();
 performance::PerformanceManager& gPerformanceManager();
+properties::PropertyIndex& gPropertyIndex();
 properties::PropertyOwner& gRootPropertyOwner();
 properties::PropertyOwner& gScreenSpaceRootPropertyOwner();
 scripting::ScriptEngine& gScriptEngine();
@@ -114,6 +120,7 @@ static RenderEngine& renderEngine = detail::gRenderEngine();
 static std::vector<std::unique_ptr<ScreenSpaceRenderable>>& screenSpaceRenderables =
     detail::gScreenspaceRenderables();
 static SyncEngine& syncEngine = detail::gSyncEngine();
+static TaskScheduler& taskScheduler = detail::gTaskScheduler();
 static TimeManager& timeManager = detail::gTimeManager();
 static VirtualPropertyManager& virtualPropertyManager = detail::gVirtualPropertyManager();
 static WindowDelegate& windowDelegate = detail::gWindowDelegate();
@@ -126,6 +133,7 @@ static interaction::SessionRecording& sessionRecording = detail::gSessionRecordi
 static interaction::ShortcutManager& shortcutManager = detail::gShortcutManager();
 static performance::PerformanceManager& performanceManager =
     detail::gPerformanceManager();
+static properties::PropertyIndex& propertyIndex = detail::gPropertyIndex();
 static properties::PropertyOwner& rootPropertyOwner = detail::gRootPropertyOwner();
 static properties::PropertyOwner& screenSpaceRootPropertyOwner =
     detail::gScreenSpaceRootPropertyOwner();
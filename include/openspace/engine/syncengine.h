@@ -38,6 +38,14 @@ class Syncable;
 /**
  * Manages a collection of <code>Syncable</code>s and ensures they are synchronized
  * over SGCT nodes. Encoding/Decoding order is handles internally.
+ *
+ * Each frame only contains the Syncables whose encoded state differs from the previous
+ * frame. SGCT delivers every frame to all nodes before the next one is encoded, so the
+ * previous frame is always the last one acknowledged by the slaves. The slaves keep the
+ * last received state of every Syncable and decode all Syncables each frame, so that
+ * Syncables observe the same data as if the full state had been sent. Keyframes that
+ * contain the full state are sent first, after the set of Syncables changed, and
+ * periodically in between. Optionally, the frames are compressed with LZ4.
  */
 class SyncEngine {
 public:
@@ -71,6 +79,15 @@ public:
      */
     void postSynchronization(IsMaster isMaster);
 
+    /**
+     * Enables or disables the LZ4 compression of the encoded frames. This only has to be
+     * set on the master, as every frame signals whether it is compressed
+     */
+    void setCompressionEnabled(bool enabled);
+
+    /// Returns whether the encoded frames are compressed
+    bool isCompressionEnabled() const;
+
     /**
      * Add a Syncable to be synchronized over the SGCT cluster.
      * \pre syncable must not be nullptr
@@ -103,6 +120,23 @@ private:
      * Databuffer used in encoding/decoding
      */
     SyncBuffer _syncBuffer;
+
+    /**
+     * The encoded state of every Syncable in the last frame that was encoded or decoded
+     */
+    std::vector<std::vector<char>> _records;
+
+    /**
+     * The changed records of the current frame before compression on the master, or
+     * after decompression on the slaves
+     */
+    std::vector<char> _payload;
+
+    /// Whether the next encoded frame has to be or next decoded frame must be a keyframe
+    bool _needsKeyframe = true;
+    unsigned int _nFramesSinceKeyframe = 0;
+
+    bool _isCompressionEnabled = false;
 };
 
 } // namespace openspace
@@ -0,0 +1,144 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___RECORDINGBLOCKS___H__
+#define __OPENSPACE_CORE___RECORDINGBLOCKS___H__
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace openspace::interaction {
+
+/**
+ * Binary session recordings store their entries in blocks that are a multiple of
+ * RecordingBlockWriter::BlockSize bytes large. Each block starts with this header, which
+ * is followed by the \c dataSize bytes of the entries and padding up to \c blockSize.
+ * Every entry starts with its type (<code>c</code>, <code>t</code>, or <code>s</code>)
+ * followed by the application, recording-relative, and simulation timestamps of the
+ * entry. The headers of all blocks form the index of a recording that is used to seek
+ * to a specific time and to only load the parts of the recording that are needed.
+ */
+struct RecordingBlockHeader {
+    uint32_t nCameraEntries = 0;
+    uint32_t nTimeEntries = 0;
+    uint32_t nScriptEntries = 0;
+    /// The number of bytes of entry data following the header
+    uint32_t dataSize = 0;
+    /// The total size of the block, including the header and the padding
+    uint32_t blockSize = 0;
+    uint32_t reserved = 0;
+    /// The timestamps of the first entry of the block
+    double firstTimestampApplication = 0.0;
+    double firstTimestampRecorded = 0.0;
+    double firstTimestampSimulation = 0.0;
+
+    /// Returns the number of entries of all types in the block
+    uint32_t nEntries() const;
+};
+
+/**
+ * Collects the entries of a recording into blocks and writes each block to the stream
+ * once it is full. The current, partial block can be written with #checkpoint so that
+ * the entries are not lost if the recording is interrupted before the block is full.
+ */
+class RecordingBlockWriter {
+public:
+    static constexpr const uint32_t BlockSize = 64 * 1024;
+
+    /**
+     * Adds the entry of \p size bytes in \p data to the current block. If the entry does
+     * not fit into the current block, the current block is written to \p out first. An
+     * entry that is larger than a block gets a block of its own.
+     *
+     * \pre \p data must start with the entry type and the three timestamps
+     */
+    void addEntry(std::ostream& out, const char* data, size_t size);
+
+    /**
+     * Writes the entries of the current block that have not been written yet, together
+     * with the block's updated header, to \p out and flushes the stream. The block stays
+     * open and is completed by later calls to #addEntry or #flush, which requires \p out
+     * to be seekable. A recording that ends after a checkpoint is a valid recording whose
+     * last block is missing its padding.
+     */
+    void checkpoint(std::ostream& out);
+
+    /// Writes the current block to \p out if it contains any entries
+    void flush(std::ostream& out);
+
+private:
+    /// Writes the entry data that has not been written by a previous #checkpoint and
+    /// then updates the header at the beginning of the current block. The header is only
+    /// written after the entry data, so it never counts entries that are not in the
+    /// stream yet
+    void writePending(std::ostream& out);
+
+    RecordingBlockHeader _header;
+    std::vector<char> _data;
+
+    /// The position of the current block's header in the stream
+    uint64_t _blockOffset = 0;
+    /// The number of bytes of \c _data that have already been written by #checkpoint
+    size_t _nCheckpointedBytes = 0;
+};
+
+/**
+ * Builds the index of the blocks of a recording and reads the data of individual blocks.
+ */
+class RecordingBlockReader {
+public:
+    struct Block {
+        /// The position of the block's header in the file
+        uint64_t offset = 0;
+        RecordingBlockHeader header;
+    };
+
+    /**
+     * Reads the headers of all blocks starting at the current position of \p in until
+     * the end of the stream. A trailing block that has not been written completely, for
+     * example because the recording was interrupted, is ignored.
+     *
+     * \return \c false if a block header is invalid, \c true otherwise
+     */
+    bool readIndex(std::istream& in);
+
+    /// Returns the blocks of the recording in the order in which they are stored
+    const std::vector<Block>& blocks() const;
+
+    /**
+     * Reads the entry data of the block with the index \p block from \p in into
+     * \p data, replacing its previous contents.
+     *
+     * \return \c true if the entire entry data of the block could be read
+     */
+    bool readBlockData(std::istream& in, size_t block, std::vector<char>& data) const;
+
+private:
+    std::vector<Block> _blocks;
+};
+
+} // namespace openspace::interaction
+
+#endif // __OPENSPACE_CORE___RECORDINGBLOCKS___H__
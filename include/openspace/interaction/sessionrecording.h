@@ -27,10 +27,12 @@
 
 #include <openspace/interaction/externinteraction.h>
 #include <openspace/interaction/keyframenavigator.h>
+#include <openspace/interaction/recordingblocks.h>
 #include <openspace/network/messagestructures.h>
 #include <openspace/scripting/lualibrary.h>
 #include <ghoul/io/socket/tcpsocket.h>
 
+#include <deque>
 #include <vector>
 #include <fstream>
 #include <iomanip>
@@ -115,6 +117,26 @@ public:
     */
     bool isPlayingBack() const;
 
+    /**
+    * Moves a playback in progress to the provided time. Only the blocks of the
+    * recording that are needed around the new time are loaded. Scripts that were
+    * recorded between the previous and the new time are not executed. Seeking is only
+    * possible for a playback that is relative to the time the recording was started.
+    * \param recordedTime seconds since the start of the recording
+    * \returns true if the playback was moved to the provided time
+    */
+    bool seekPlayback(double recordedTime);
+
+    /**
+    * Converts an ASCII recording, or a binary recording that was written before
+    * recordings were stored in blocks, into the block-based binary format, which can be
+    * streamed and seeked during playback.
+    * \param inFilename recording file that is converted
+    * \param outFilename file to which the converted recording is written
+    * \returns true if the conversion finished without errors
+    */
+    bool convertToBinary(const std::string& inFilename, const std::string& outFilename);
+
     /**
     * Used to trigger a save of the camera states (position, rotation, focus node,
     * whether it is following the rotation of a node, and timestamp). The data will
@@ -179,16 +201,22 @@ private:
     void writeToFileBuffer(std::vector<char>& cvec);
     void writeToFileBuffer(const unsigned char c);
     void writeToFileBuffer(bool b);
-    void saveStringToFile(const std::string& s);
     void saveKeyframeToFileBinary(unsigned char* bufferSource, size_t size);
     void findFirstCameraKeyframeInTimeline();
     std::string readHeaderElement(size_t readLen_chars);
+    bool parseBinaryEntries();
+    bool loadNextPlaybackBlock();
+    bool hasMorePlaybackBlocks() const;
+    void streamPlaybackBlocks();
+    void clearPlaybackTimeline();
+    void readFromPlayback(void* result, size_t size);
     void readFromPlayback(unsigned char& result);
     void readFromPlayback(double& result);
     void readFromPlayback(float& result);
     void readFromPlayback(size_t& result);
     void readFromPlayback(bool& result);
     void readFromPlayback(std::string& result);
+    void readFromPlayback(datamessagestructures::CameraKeyframe& result);
     void saveKeyframeToFile(std::string entry);
 
     void addKeyframe(double timestamp,
@@ -217,6 +245,9 @@ private:
     const std::string _fileHeaderTitle = "OpenSpace_record/playback";
     static const size_t _fileHeaderVersionLength = 5;
     const char _fileHeaderVersion[_fileHeaderVersionLength] = { '0', '0', '.', '8', '5' };
+    const char _fileHeaderVersionBlocks[_fileHeaderVersionLength] = {
+        '0', '1', '.', '0', '0'
+    };
     const char dataFormatAsciiTag = 'A';
     const char dataFormatBinaryTag = 'B';
 
@@ -226,6 +257,7 @@ private:
     std::ifstream _playbackFile;
     std::string _playbackLineParsing;
     std::ofstream _recordFile;
+    RecordingBlockWriter _recordBlocks;
     int _playbackLineNum = 1;
     KeyframeTimeRef _playbackTimeReferenceMode;
     datamessagestructures::CameraKeyframe _prevRecordedCameraKeyframe;
@@ -234,6 +266,26 @@ private:
     bool _playbackActive_script = false;
     bool _hasHitEndOfCameraKeyframes = false;
     bool _setSimulationTimeWithNextCameraKeyframe = false;
+    bool _forceSimTimeAtStart = false;
+
+    // The binary entries that are currently parsed, either of a single block or of an
+    // entire recording that does not use blocks
+    std::vector<char> _playbackBuffer;
+    size_t _playbackBufferPosition = 0;
+    bool _playbackBufferFailed = false;
+
+    struct LoadedBlock {
+        unsigned int nTimelineEntries;
+        unsigned int nCameraKeyframes;
+        unsigned int nTimeKeyframes;
+        unsigned int nScriptKeyframes;
+    };
+    // The number of blocks that are kept in memory around the playback position
+    static const size_t _playbackBlocksInMemory = 4;
+    bool _playbackUsesBlocks = false;
+    RecordingBlockReader _playbackBlocks;
+    size_t _nextPlaybackBlock = 0;
+    std::deque<LoadedBlock> _loadedPlaybackBlocks;
 
     static const size_t keyframeHeaderSize_bytes = 33;
     static const size_t saveBufferCameraSize_min = 82;
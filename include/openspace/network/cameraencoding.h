@@ -0,0 +1,111 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___CAMERAENCODING___H__
+#define __OPENSPACE_CORE___CAMERAENCODING___H__
+
+#include <openspace/network/messagestructures.h>
+#include <ghoul/glm.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace::datamessagestructures {
+
+/**
+ * Packs the normalized rotation \p q into 64 bits using the smallest-three encoding: the
+ * component with the largest magnitude is dropped and reconstructed from the other three,
+ * which are stored with 20 bits each, together with the 2 bit index of the dropped one.
+ * The angular error is on the order of 1e-6 radians.
+ */
+uint64_t quantizeRotation(const glm::dquat& q);
+
+/// Unpacks a rotation that was packed with quantizeRotation
+glm::dquat dequantizeRotation(uint64_t packed);
+
+/**
+ * Encodes CameraKeyframes for the Type::CompactCameraData messages of a parallel
+ * session. Instead of the focus node name and the full double precision position, a
+ * compact keyframe only contains the position as a single precision offset from a
+ * reference position, and the rotation in the packed form of quantizeRotation. The
+ * reference position and the focus node are sent in a separate Type::CameraReference
+ * message whenever the focus node changes or the camera moved too far away from the
+ * reference for the offset to be precise. Each focus node name is only sent once; after
+ * that, it is referred to by an integer identifier.
+ *
+ * Camera references must be delivered to all peers, whereas compact keyframes may be
+ * dropped, as each of them only depends on the latest reference.
+ */
+class CameraKeyframeEncoder {
+public:
+    /**
+     * Encodes the \p keyframe into the \p keyframeBuffer. If a new reference is needed,
+     * it is written into the \p referenceBuffer and this function returns \c true; the
+     * reference then has to be sent before the keyframe. Both buffers are cleared first,
+     * so they can be reused between calls without allocating.
+     */
+    bool encode(const CameraKeyframe& keyframe, std::vector<char>& referenceBuffer,
+        std::vector<char>& keyframeBuffer);
+
+    /**
+     * Forgets all focus node identifiers and the reference position, which causes them
+     * to be sent again. This has to be called whenever new peers might have joined.
+     */
+    void reset();
+
+private:
+    std::unordered_map<std::string, uint16_t> _focusNodeIds;
+    std::string _focusNode;
+    glm::dvec3 _referencePosition = glm::dvec3(0.0);
+    bool _hasReference = false;
+};
+
+/// Decodes the messages that were created by a CameraKeyframeEncoder
+class CameraKeyframeDecoder {
+public:
+    /**
+     * Reads a Type::CameraReference message. Returns \c false if it is malformed, in
+     * which case all keyframes are rejected until the next valid reference is read.
+     */
+    bool decodeReference(const std::vector<char>& buffer);
+
+    /**
+     * Reads a Type::CompactCameraData message into the \p keyframe. Returns \c false if
+     * the message is malformed or if no camera reference has been received yet.
+     */
+    bool decode(const std::vector<char>& buffer, CameraKeyframe& keyframe) const;
+
+    /// Forgets all focus node identifiers and the reference position
+    void reset();
+
+private:
+    std::vector<std::string> _focusNodes;
+    uint16_t _focusNodeId = 0;
+    glm::dvec3 _referencePosition = glm::dvec3(0.0);
+    bool _hasReference = false;
+};
+
+} // namespace openspace::datamessagestructures
+
+#endif // __OPENSPACE_CORE___CAMERAENCODING___H__
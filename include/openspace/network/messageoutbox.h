@@ -0,0 +1,105 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MESSAGEOUTBOX___H__
+#define __OPENSPACE_CORE___MESSAGEOUTBOX___H__
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The messages that are waiting to be sent to one peer of a parallel session. Messages
+ * are sent in the order in which they were pushed. The socket does not tell how much of
+ * its output is still pending, so the number of camera keyframes that were sent but not
+ * acknowledged by the peer is used to detect a slow peer instead. As long as that number
+ * is at the limit, the next keyframe waits in the outbox, and a waiting keyframe that has
+ * not been sent yet is replaced by a newer one. A slow peer thereby skips stale keyframes
+ * instead of falling further behind.
+ */
+class MessageOutbox {
+public:
+    using EncodedMessage = std::shared_ptr<const std::vector<char>>;
+    using SendFunction = std::function<void(const std::vector<char>&)>;
+
+    /// The number of unacknowledged camera keyframes that are sent to a peer by default
+    static constexpr const int DefaultMaxKeyframesInFlight = 2;
+
+    /**
+     * Creates an outbox that passes the messages to \p send. Every camera keyframe that
+     * is replaced before it was sent increments \p droppedKeyframes.
+     */
+    MessageOutbox(SendFunction send, std::atomic_size_t& droppedKeyframes,
+        int maxKeyframesInFlight = DefaultMaxKeyframesInFlight);
+
+    /**
+     * Adds the \p message to the end of the outbox. The same encoded message can be
+     * pushed into the outboxes of many peers. Returns \c true if the caller has to
+     * schedule a call to #flush, which is only the case if no flush is pending already.
+     */
+    bool push(EncodedMessage message, bool isCameraKeyframe);
+
+    /**
+     * Records that the peer received one of the camera keyframes that were sent to it.
+     * Returns \c true if the caller has to schedule a call to #flush.
+     */
+    bool acknowledgeKeyframe();
+
+    /**
+     * Sends the waiting messages until the outbox is empty or until the next message is
+     * a camera keyframe that has to wait for an acknowledgement. At most one flush may
+     * run at any time, which is ensured by only calling it when #push or
+     * #acknowledgeKeyframe returned \c true.
+     */
+    void flush();
+
+    /// Returns the number of messages that are waiting to be sent
+    size_t nWaitingMessages() const;
+
+private:
+    struct Entry {
+        EncodedMessage message;
+        bool isCameraKeyframe = false;
+    };
+
+    bool canSendNext() const;
+
+    SendFunction _send;
+    std::atomic_size_t& _droppedKeyframes;
+    const int _maxKeyframesInFlight;
+
+    mutable std::mutex _mutex;
+    std::deque<Entry> _messages;
+    int _nKeyframesInFlight = 0;
+    bool _isFlushScheduled = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___MESSAGEOUTBOX___H__
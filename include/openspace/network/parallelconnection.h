@@ -49,7 +49,8 @@ public:
         HostshipRequest,
         HostshipResignation,
         NConnections,
-        Disconnection
+        Disconnection,
+        KeyframeAcknowledgement
     };
 
     struct Message {
@@ -78,15 +79,42 @@ public:
 
     bool isConnectedOrConnecting() const;
     void sendDataMessage(const ParallelConnection::DataMessage& dataMessage);
+
+    /**
+     * Sends a data message with the provided \p content. The message is assembled in a
+     * buffer that is reused between calls, so this function must not be called
+     * concurrently on the same connection.
+     */
+    void sendDataMessage(datamessagestructures::Type type, double timestamp,
+        const std::vector<char>& content);
     bool sendMessage(const ParallelConnection::Message& message);
+
+    /**
+     * Sends a message that was previously encoded with #encodeMessage. This makes it
+     * possible to encode a message once and send it to many connections.
+     */
+    bool sendEncodedMessage(const std::vector<char>& encodedMessage);
     void disconnect();
     ghoul::io::TcpSocket* socket();
 
     ParallelConnection::Message receiveMessage();
 
+    /// Returns the \p message, including its header, as it is sent over the socket
+    static std::vector<char> encodeMessage(const ParallelConnection::Message& message);
+
     static const unsigned int ProtocolVersion;
+
+    /// The size of the header that precedes every message
+    static constexpr const size_t HeaderSize =
+        2 * sizeof(char) + // OS
+        3 * sizeof(uint32_t); // Protocol version, message type and message size
+
 private:
+    static void appendHeader(std::vector<char>& buffer, MessageType type,
+        uint32_t messageSize);
+
     std::unique_ptr<ghoul::io::TcpSocket> _socket;
+    std::vector<char> _sendBuffer;
 };
 
 } // namespace openspace
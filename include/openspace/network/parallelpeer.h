@@ -27,6 +27,7 @@
 
 #include <openspace/network/parallelconnection.h>
 #include <openspace/interaction/externinteraction.h>
+#include <openspace/network/cameraencoding.h>
 #include <openspace/network/messagestructures.h>
 #include <openspace/util/timemanager.h>
 
@@ -85,6 +86,8 @@ private:
 
     void handleMessage(const ParallelConnection::Message&);
     void dataMessageReceived(const std::vector<char>& message);
+    void cameraKeyframeReceived(const datamessagestructures::CameraKeyframe& kf);
+    void acknowledgeKeyframe();
     void connectionStatusMessageReceived(const std::vector<char>& message);
     void nConnectionsMessageReceived(const std::vector<char>& message);
 
@@ -137,6 +140,11 @@ private:
 
     ParallelConnection _connection;
 
+    datamessagestructures::CameraKeyframeEncoder _cameraEncoder;
+    datamessagestructures::CameraKeyframeDecoder _cameraDecoder;
+    std::vector<char> _cameraReferenceBuffer;
+    std::vector<char> _cameraKeyframeBuffer;
+
     TimeManager::CallbackHandle _timeJumpCallback = -1;
     TimeManager::CallbackHandle _timeTimelineChangeCallback = -1;
 };
@@ -25,11 +25,14 @@
 #ifndef __OPENSPACE_CORE___PARALLELSERVER___H__
 #define __OPENSPACE_CORE___PARALLELSERVER___H__
 
+#include <openspace/network/messageoutbox.h>
 #include <openspace/network/parallelconnection.h>
 
 #include <openspace/util/concurrentqueue.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/io/socket/tcpsocketserver.h>
 #include <atomic>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -48,16 +51,19 @@ public:
 
     size_t nConnections() const;
 
+    /// Returns the number of camera keyframes that were replaced before they were sent
+    size_t nDroppedKeyframes() const;
+
 private:
-    struct Peer {
-        //Peer(size_t id_, std::string name_, ParallelConnection parallelConnection_,
-            //ParallelConnection::Status status_, std::thread )
+    using EncodedMessage = MessageOutbox::EncodedMessage;
 
+    struct Peer {
         size_t id;
         std::string name;
-        ParallelConnection parallelConnection;
+        std::shared_ptr<ParallelConnection> parallelConnection;
         ParallelConnection::Status status;
         std::thread thread;
+        std::shared_ptr<MessageOutbox> outbox;
     };
 
     struct PeerMessage {
@@ -70,10 +76,10 @@ private:
     void sendMessage(Peer& peer, ParallelConnection::MessageType messageType,
         const std::vector<char>& message);
 
-    void sendMessageToAll(ParallelConnection::MessageType messageType,
-        const std::vector<char>& message);
+    void queueMessage(Peer& peer, EncodedMessage message, bool isCameraKeyframe);
+    void scheduleFlush(std::shared_ptr<MessageOutbox> outbox);
 
-    void sendMessageToClients(ParallelConnection::MessageType messageType,
+    void sendMessageToAll(ParallelConnection::MessageType messageType,
         const std::vector<char>& message);
 
     void disconnect(Peer& peer);
@@ -87,6 +93,7 @@ private:
     void handleData(const Peer& peer, std::vector<char> data);
     void handleHostshipRequest(std::shared_ptr<Peer> peer, std::vector<char> message);
     void handleHostshipResignation(Peer& peer);
+    void handleKeyframeAcknowledgement(Peer& peer);
     void handleDisconnection(std::shared_ptr<Peer> peer);
 
     void handleNewPeers();
@@ -114,6 +121,12 @@ private:
     std::string _defaultHostAddress;
 
     ConcurrentQueue<PeerMessage> _incomingMessages;
+
+    // Declared before the send workers, as the outboxes of the peers refer to it
+    std::atomic_size_t _nDroppedKeyframes = 0;
+
+    // Writes the outgoing messages of all peers
+    TaskScheduler _sendScheduler = TaskScheduler(2);
 };
 
 } // namespace openspace
@@ -0,0 +1,105 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___PROPERTYINDEX___H__
+#define __OPENSPACE_CORE___PROPERTYINDEX___H__
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace::properties {
+
+class Property;
+class PropertyOwner;
+
+/**
+ * The PropertyIndex maps the fully qualified URIs of all Propertys in a tree of
+ * PropertyOwners to the Propertys themselves. It is attached to the root of the tree
+ * using PropertyOwner::setPropertyIndex and is kept up-to-date by the PropertyOwners of
+ * the tree whenever a Property or sub-owner is added or removed, or a sub-owner is
+ * renamed.
+ *
+ * Besides exact lookups of URIs, the index answers wildcard queries (see #matches) in
+ * which a <code>*</code> matches any, possibly empty, sequence of characters. To avoid
+ * testing every Property against the pattern, the URIs are additionally kept sorted both
+ * forwards and backwards. The literal prefix before the first wildcard and the literal
+ * suffix after the last wildcard each select a contiguous range of candidates, of which
+ * only the smaller one is tested against the full pattern.
+ */
+class PropertyIndex {
+public:
+    /**
+     * Adds the Property \p prop with its current fully qualified identifier to the
+     * index. If another Property with the same URI is already indexed, the \p prop is
+     * ignored.
+     */
+    void addProperty(Property* prop);
+
+    /// Removes the Property \p prop using its current fully qualified identifier
+    void removeProperty(Property* prop);
+
+    /// Adds all Propertys of the \p owner and all of its sub-owners to the index
+    void addPropertyOwner(const PropertyOwner& owner);
+
+    /// Removes all Propertys of the \p owner and all of its sub-owners from the index
+    void removePropertyOwner(const PropertyOwner& owner);
+
+    /**
+     * Returns the Property with the fully qualified \p uri or \c nullptr if no such
+     * Property has been indexed.
+     */
+    Property* property(const std::string& uri) const;
+
+    /**
+     * Returns all indexed Propertys whose fully qualified URI matches the \p pattern, in
+     * which each <code>*</code> matches any, possibly empty, sequence of characters. The
+     * Propertys are returned in a deterministic order that only depends on the indexed
+     * URIs.
+     */
+    std::vector<Property*> matches(const std::string& pattern) const;
+
+    /// Returns the number of indexed Propertys
+    size_t size() const;
+
+    /**
+     * Returns whether the \p uri matches the \p pattern, in which each <code>*</code>
+     * matches any, possibly empty, sequence of characters.
+     */
+    static bool matchesPattern(std::string_view uri, std::string_view pattern);
+
+private:
+    /// Maps the fully qualified URIs to their Propertys
+    std::unordered_map<std::string, Property*> _properties;
+    /// The same mapping sorted by URI for queries with a literal prefix
+    std::map<std::string, Property*> _sortedUris;
+    /// The same mapping sorted by reversed URI for queries with a literal suffix
+    std::map<std::string, Property*> _sortedReversedUris;
+};
+
+} // namespace openspace::properties
+
+#endif // __OPENSPACE_CORE___PROPERTYINDEX___H__
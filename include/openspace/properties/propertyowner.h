@@ -34,6 +34,7 @@
 namespace openspace::properties {
 
 class Property;
+class PropertyIndex;
 
 /**
  * A PropertyOwner can own Propertys or other PropertyOwner and provide access to both in
@@ -169,6 +170,25 @@ public:
     void setPropertyOwner(PropertyOwner* owner) { _owner = owner; }
     PropertyOwner* owner() const { return _owner; }
 
+    /**
+     * Makes this PropertyOwner the root of the tree of PropertyOwners that is indexed by
+     * the \p index and adds all Propertys of this tree to it. From then on, adding or
+     * removing Propertys or sub-owners anywhere in the tree keeps the \p index
+     * up-to-date. Passing \c nullptr detaches the current index after removing all
+     * Propertys of the tree from it.
+     *
+     * \param index The PropertyIndex that should index this tree, or \c nullptr
+     *
+     * \pre This PropertyOwner must not have an owner
+     */
+    void setPropertyIndex(PropertyIndex* index);
+
+    /**
+     * Returns the PropertyIndex of the tree that this PropertyOwner is part of, or
+     * \c nullptr if the tree is not indexed.
+     */
+    PropertyIndex* propertyIndex() const;
+
     /**
      * Returns a list of all sub-owners this PropertyOwner has. Each name of a sub-owner
      * has to be unique with respect to other sub-owners as well as Property's owned by
@@ -257,7 +277,9 @@ public:
     void removeProperty(Property& prop);
 
     /**
-     * Removes the sub-owner from this PropertyOwner.
+     * Removes the sub-owner from this PropertyOwner. Notifies the sub-owner about this
+     * change by calling the PropertyOwner::setPropertyOwner method with a \c nullptr as
+     * parameter.
      *
      * \param owner The PropertyOwner that should be removed
      */
@@ -305,6 +327,8 @@ private:
 
     /// The owner of this PropertyOwner
     PropertyOwner* _owner = nullptr;
+    /// The index of the tree if this PropertyOwner is its root, \c nullptr otherwise
+    PropertyIndex* _propertyIndex = nullptr;
     /// A list of all registered Property's
     std::vector<Property*> _properties;
     /// A list of all sub-owners
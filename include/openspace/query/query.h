@@ -44,6 +44,15 @@ const Renderable* renderable(const std::string& name);
 properties::Property* property(const std::string& uri);
 std::vector<properties::Property*> allProperties();
 
+/**
+ * Returns all Propertys whose fully qualified URI matches the \p uriPattern, in which
+ * each <code>*</code> matches any, possibly empty, sequence of characters. In contrast to
+ * filtering #allProperties, the cost of this function scales with the number of
+ * candidates sharing the literal prefix or suffix of the pattern rather than with the
+ * total number of Propertys.
+ */
+std::vector<properties::Property*> matchingProperties(const std::string& uriPattern);
+
 } // namespace openspace
 
 #endif // __OPENSPACE_CORE___QUERY___H__
@@ -50,7 +50,25 @@ public:
 
     const glm::dmat3& matrix() const;
     virtual glm::dmat3 matrix(const UpdateData& time) const = 0;
-    void update(const UpdateData& data);
+
+    /**
+     * Recomputes the cached matrix if the time has changed or an update has been
+     * required. Returns whether the cached matrix has changed
+     */
+    bool update(const UpdateData& data);
+
+    /**
+     * Returns whether the matrix depends on the simulation time. If it does not, the
+     * matrix is only recomputed after #requireUpdate has been called
+     */
+    virtual bool isTimeDependent() const;
+
+    /**
+     * Returns whether this rotation reads the world transform of scene graph nodes other
+     * than the parent and the dependencies of the node it belongs to. A node with such a
+     * rotation is not updated concurrently with other nodes of the scene.
+     */
+    virtual bool readsOtherNodes() const;
 
     static documentation::Documentation Documentation();
 
@@ -61,7 +79,7 @@ protected:
 private:
     bool _needsUpdate = true;
     double _cachedTime = -std::numeric_limits<double>::max();
-    glm::dmat3 _cachedMatrix;
+    glm::dmat3 _cachedMatrix = glm::dmat3(1.0);
 };
 
 }  // namespace openspace
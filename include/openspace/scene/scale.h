@@ -50,7 +50,25 @@ public:
 
     double scaleValue() const;
     virtual double scaleValue(const UpdateData& data) const = 0;
-    virtual void update(const UpdateData& data);
+
+    /**
+     * Recomputes the cached scale if the time has changed or an update has been
+     * required. Returns whether the cached scale has changed
+     */
+    virtual bool update(const UpdateData& data);
+
+    /**
+     * Returns whether the scale depends on the simulation time. If it does not, the
+     * scale is only recomputed after #requireUpdate has been called
+     */
+    virtual bool isTimeDependent() const;
+
+    /**
+     * Returns whether this scale reads the world transform or other state of scene graph
+     * nodes other than the parent and the dependencies of the node it belongs to. A node
+     * with such a scale is not updated concurrently with other nodes.
+     */
+    virtual bool readsOtherNodes() const;
 
     static documentation::Documentation Documentation();
 
@@ -29,6 +29,7 @@
 
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scene/scenelicense.h>
+#include <openspace/scene/transformstore.h>
 #include <ghoul/misc/easing.h>
 #include <ghoul/misc/exception.h>
 #include <mutex>
@@ -159,6 +160,14 @@ public:
      */
     const std::unordered_map<std::string, SceneGraphNode*>& nodesByIdentifier() const;
 
+    /**
+     * Returns the store that contains the local and world transforms of all nodes of
+     * this scene. The slots are laid out in order of the dependency levels of the nodes,
+     * so the world transforms of all nodes can be read without touching the nodes.
+     */
+    TransformStore& transformStore();
+    const TransformStore& transformStore() const;
+
     /**
      * Load a scene graph node from a dictionary and return it.
      */
@@ -251,11 +260,29 @@ private:
 
     void sortTopologically();
 
+    /**
+     * Groups the topologically sorted nodes into levels such that every node only
+     * depends on nodes of previous levels and lays out the TransformStore in the order
+     * of these levels.
+     */
+    void computeDependencyLevels();
+
+    /**
+     * Updates the transforms of the \p nodes of a single dependency level, distributing
+     * them over the workers of the global TaskScheduler if it is worthwhile.
+     */
+    void updateTransforms(const std::vector<SceneGraphNode*>& nodes,
+        size_t firstSlot, const UpdateData& data);
+
     std::unique_ptr<Camera> _camera;
     std::vector<SceneGraphNode*> _topologicallySortedNodes;
+    /// The nodes of a level can be updated concurrently, see #computeDependencyLevels
+    std::vector<std::vector<SceneGraphNode*>> _dependencyLevels;
     std::vector<SceneGraphNode*> _circularNodes;
     std::unordered_map<std::string, SceneGraphNode*> _nodesByIdentifier;
     bool _dirtyNodeRegistry = false;
+    // Has to outlive the _rootDummy, which releases its transform on destruction
+    TransformStore _transformStore;
     SceneGraphNode _rootDummy;
     std::unique_ptr<SceneInitializer> _initializer;
 
@@ -29,6 +29,7 @@
 
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/scene/transformstore.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/boolean.h>
 #include <atomic>
@@ -95,6 +96,27 @@ public:
     void traversePreOrder(const std::function<void(SceneGraphNode*)>& fn);
     void traversePostOrder(const std::function<void(SceneGraphNode*)>& fn);
     void update(const UpdateData& data);
+
+    /**
+     * Updates the translation, rotation, and scale of this node and stores them as the
+     * local transform in the TransformStore of the scene. The world transform is then
+     * composed by the Scene, see TransformStore::composeWorldTransforms. Requires the
+     * world transforms of the parent and the dependencies of this node to be up to date.
+     * Nodes that do not depend on each other can be updated concurrently, unless
+     * #canUpdateConcurrently returns <code>false</code>.
+     */
+    void updateTransform(const UpdateData& data);
+
+    /**
+     * Updates the Renderable of this node with its current world transform. As
+     * Renderables might use OpenGL, this function must only be called from the main
+     * thread.
+     */
+    void updateRenderable(const UpdateData& data);
+
+    /// Returns whether #updateTransform is safe to call concurrently with other nodes
+    bool canUpdateConcurrently() const;
+
     void render(const RenderData& data, RendererTasks& tasks);
     void updateCamera(Camera* camera) const;
 
@@ -126,6 +148,12 @@ public:
     glm::dmat4 modelTransform() const;
     glm::dmat4 inverseModelTransform() const;
     double worldScale() const;
+
+    /**
+     * Returns the handle of the transform of this node in the TransformStore of its
+     * scene, or TransformStore::InvalidHandle if the node is not part of a scene.
+     */
+    TransformStore::Handle transformHandle() const;
     bool isTimeFrameActive(const Time& time) const;
 
     SceneGraphNode* parent() const;
@@ -147,10 +175,6 @@ public:
     static documentation::Documentation Documentation();
 
 private:
-    glm::dvec3 calculateWorldPosition() const;
-    glm::dmat3 calculateWorldRotation() const;
-    double calculateWorldScale() const;
-
     std::atomic<State> _state = State::Loaded;
     std::vector<std::unique_ptr<SceneGraphNode>> _children;
     SceneGraphNode* _parent = nullptr;
@@ -178,13 +202,8 @@ private:
 
     std::unique_ptr<TimeFrame> _timeFrame;
 
-    // Cached transform data
-    glm::dvec3 _worldPositionCached;
-    glm::dmat3 _worldRotationCached;
-    double _worldScaleCached = 1.0;
-
-    glm::dmat4 _modelTransformCached;
-    glm::dmat4 _inverseModelTransformCached;
+    // The world transform is stored in the TransformStore of the scene
+    TransformStore::Handle _transformHandle = TransformStore::InvalidHandle;
 
 #ifdef Debugging_Core_SceneGraphNode_Indices
     int index = 0;
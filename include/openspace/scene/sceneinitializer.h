@@ -25,7 +25,8 @@
 #ifndef __OPENSPACE_CORE___SCENEINITIALIZER___H__
 #define __OPENSPACE_CORE___SCENEINITIALIZER___H__
 
-#include <openspace/util/threadpool.h>
+#include <openspace/util/taskscheduler.h>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -53,7 +54,7 @@ private:
 
 class MultiThreadedSceneInitializer : public SceneInitializer {
 public:
-    MultiThreadedSceneInitializer(unsigned int nThreads);
+    MultiThreadedSceneInitializer(TaskScheduler& scheduler);
 
     void initializeNode(SceneGraphNode* node) override;
     std::vector<SceneGraphNode*> takeInitializedNodes() override;
@@ -62,8 +63,8 @@ public:
 private:
     std::vector<SceneGraphNode*> _initializedNodes;
     std::unordered_set<SceneGraphNode*> _initializingNodes;
-    ThreadPool _threadPool;
     mutable std::mutex _mutex;
+    TaskGroup _tasks;
 };
 
 } // namespace openspace
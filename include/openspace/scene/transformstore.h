@@ -0,0 +1,151 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TRANSFORMSTORE___H__
+#define __OPENSPACE_CORE___TRANSFORMSTORE___H__
+
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The TransformStore holds the local and world transforms of all scene graph nodes of a
+ * Scene in a structure-of-arrays layout. Each node is identified by a Handle that stays
+ * valid for as long as the node is part of the scene, while the position of its
+ * transform in the arrays (its slot) is determined by the order passed to #setLayout.
+ * If the slots are laid out such that every parent precedes its children, the world
+ * transforms of all nodes can be composed with a single linear sweep over the arrays,
+ * see #composeWorldTransforms. Only slots whose local transform or whose parent's world
+ * transform has changed since the last composition are recomputed, so static subtrees
+ * are skipped.
+ *
+ * Concurrent calls to #setLocalTransform for different handles and concurrent reads are
+ * safe. Changing the handles or the layout requires exclusive access.
+ */
+class TransformStore {
+public:
+    using Handle = uint32_t;
+    static constexpr const Handle InvalidHandle = std::numeric_limits<Handle>::max();
+
+    /**
+     * Allocates a new transform with an identity local and world transform that has no
+     * parent. Its slot is placed after all existing slots until the next #setLayout.
+     */
+    Handle allocate();
+
+    /**
+     * Releases the \p handle, which can be reused by a later call to #allocate. The slot
+     * of the handle is only reclaimed by the next call to #setLayout.
+     *
+     * \pre \p handle must have been returned by #allocate and not been released
+     */
+    void release(Handle handle);
+
+    /**
+     * Reorders the slots such that the transform of <code>order[i]</code> is stored in
+     * slot \c i, with <code>parents[i]</code> as its parent, which can be the
+     * #InvalidHandle. All current values are retained, but every slot is marked dirty
+     * as its parent might have changed. Handles that are not part of the \p order are
+     * placed after the ordered slots without a parent.
+     *
+     * \pre \p order and \p parents must have the same size
+     * \pre Every parent must be part of \p order and precede its child
+     */
+    void setLayout(const std::vector<Handle>& order, const std::vector<Handle>& parents);
+
+    /// Stores the local transform of \p handle relative to its parent and marks it dirty
+    void setLocalTransform(Handle handle, const glm::dvec3& position,
+        const glm::dmat3& rotation, double scale);
+
+    /**
+     * Computes the world transforms, model transforms, and inverse model transforms of
+     * the slots in [\p begin, \p end) from their local transforms and the world
+     * transforms of their parents. Slots are skipped if neither their local transform
+     * nor the world transform of their parent has changed.
+     *
+     * \pre The world transforms of all parents must already have been composed
+     */
+    void composeWorldTransforms(size_t begin, size_t end);
+
+    /// Composes the world transform of the single \p handle
+    void composeWorldTransform(Handle handle);
+
+    /**
+     * Returns whether the world transform of \p handle has changed in the last
+     * composition that included it
+     */
+    bool hasWorldTransformChanged(Handle handle) const;
+
+    /// Returns the slot in which the transform of the \p handle is stored
+    size_t slot(Handle handle) const;
+
+    /// Returns the number of slots, which includes released but unreclaimed slots
+    size_t size() const;
+
+    glm::dvec3 worldPosition(Handle handle) const;
+    const glm::dmat3& worldRotation(Handle handle) const;
+    double worldScale(Handle handle) const;
+    const glm::dmat4& modelTransform(Handle handle) const;
+    const glm::dmat4& inverseModelTransform(Handle handle) const;
+
+    /// The world positions of all slots, indexed by slot
+    const std::vector<glm::dvec3>& worldPositions() const;
+    /// The world rotations of all slots, indexed by slot
+    const std::vector<glm::dmat3>& worldRotations() const;
+    /// The world scales of all slots, indexed by slot
+    const std::vector<double>& worldScales() const;
+
+private:
+    static constexpr const uint32_t NoParent = std::numeric_limits<uint32_t>::max();
+
+    /// Appends a slot with identity transforms for \p handle
+    void appendSlot(Handle handle);
+
+    /// Maps each handle to its slot
+    std::vector<uint32_t> _slots;
+    /// Released handles that can be reused by #allocate
+    std::vector<Handle> _freeHandles;
+
+    // Indexed by slot
+    std::vector<Handle> _handles;
+    std::vector<uint32_t> _parentSlots;
+    std::vector<glm::dvec3> _localPositions;
+    std::vector<glm::dmat3> _localRotations;
+    std::vector<double> _localScales;
+    std::vector<glm::dvec3> _worldPositions;
+    std::vector<glm::dmat3> _worldRotations;
+    std::vector<double> _worldScales;
+    std::vector<glm::dmat4> _modelTransforms;
+    std::vector<glm::dmat4> _inverseModelTransforms;
+    // Bytes instead of bools so that different slots can be written concurrently
+    std::vector<uint8_t> _isLocalDirty;
+    std::vector<uint8_t> _hasWorldChanged;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___TRANSFORMSTORE___H__
@@ -50,7 +50,25 @@ public:
     virtual bool initialize();
 
     glm::dvec3 position() const;
-    void update(const UpdateData& data);
+
+    /**
+     * Recomputes the cached position if the time has changed or an update has been
+     * required. Returns whether the cached position has changed
+     */
+    virtual bool update(const UpdateData& data);
+
+    /**
+     * Returns whether the position depends on the simulation time. If it does not, the
+     * position is only recomputed after #requireUpdate has been called
+     */
+    virtual bool isTimeDependent() const;
+
+    /**
+     * Returns whether this translation reads the world transform or other state of scene
+     * graph nodes other than the parent and the dependencies of the node it belongs to.
+     * A node with such a translation is not updated concurrently with other nodes.
+     */
+    virtual bool readsOtherNodes() const;
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
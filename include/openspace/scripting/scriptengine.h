@@ -32,6 +32,7 @@
 #include <ghoul/lua/luastate.h>
 #include <ghoul/misc/boolean.h>
 #include <mutex>
+#include <unordered_map>
 
 namespace openspace { class SyncBuffer; }
 
@@ -71,6 +72,10 @@ public:
     void addLibrary(LuaLibrary library);
     bool hasLibrary(const std::string& name);
 
+    /**
+     * Runs the \p script in the internal Lua state. The compiled chunk of the script is
+     * cached, so repeatedly running the same script only compiles it once.
+     */
     bool runScript(const std::string& script);
     bool runScriptFile(const std::string& filename);
 
@@ -81,6 +86,11 @@ public:
     virtual void decode(SyncBuffer* syncBuffer) override;
     virtual void postSync(bool isMaster) override;
 
+    /**
+     * Queues the \p script to be synchronized and run in the next frame. All scripts
+     * that are queued during a frame are run in the next frame in the order in which
+     * they were queued.
+     */
     void queueScript(const std::string &script, RemoteScripting remoteScripting);
 
     void setLogFile(const std::string& filename, const std::string& type);
@@ -102,6 +112,16 @@ private:
 
     std::string generateJson() const override;
 
+    /**
+     * Returns the registry reference of the compiled chunk of \p script, compiling it if
+     * it has not been cached. Returns <code>LUA_NOREF</code> if the script could not be
+     * compiled.
+     */
+    int compiledScript(const std::string& script);
+
+    /// Releases all cached compiled scripts
+    void clearCompiledScripts();
+
     ghoul::lua::LuaState _state;
     std::vector<LuaLibrary> _registeredLibraries;
 
@@ -110,7 +130,10 @@ private:
     std::mutex _mutex;
     std::vector<std::pair<std::string, bool>> _queuedScripts;
     std::vector<std::string> _receivedScripts;
-    std::string _currentSyncedScript;
+    std::vector<std::string> _currentSyncedScripts;
+
+    /// Maps script texts to registry references of their compiled chunks
+    std::unordered_map<std::string, int> _compiledScripts;
 
     //parallel variables
     //std::map<std::string, std::map<std::string, std::string>> _cachedScripts;
@@ -26,8 +26,9 @@
 #define __OPENSPACE_CORE___CONCURRENT_JOB_MANAGER___H__
 
 #include <openspace/util/concurrentqueue.h>
-#include <openspace/util/threadpool.h>
+#include <openspace/util/taskscheduler.h>
 
+#include <atomic>
 #include <mutex>
 
 namespace openspace {
@@ -36,12 +37,14 @@ template <typename T> struct Job;
 
 /*
  * Templated Concurrent Job Manager
- * This class is used execute specific jobs on one (1) parallell thread
+ * This class is used execute specific jobs on the worker threads of a TaskScheduler. The
+ * scheduler is not owned by the job manager and has to outlive it
  */
 template<typename P>
 class ConcurrentJobManager {
 public:
-    ConcurrentJobManager(ThreadPool pool);
+    ConcurrentJobManager(TaskScheduler& scheduler);
+    ~ConcurrentJobManager();
 
     void enqueueJob(std::shared_ptr<Job<P>> job);
 
@@ -54,7 +57,10 @@ public:
 private:
     ConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
     std::mutex _finishedJobsMutex;
-    ThreadPool threadPool;
+
+    // Jobs that were enqueued before the last call to clearEnqueuedJobs are skipped
+    std::atomic<unsigned int> _generation = 0;
+    TaskGroup _tasks;
 };
 
 } // namespace openspace
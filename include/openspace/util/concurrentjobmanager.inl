@@ -28,13 +28,25 @@
 namespace openspace {
 
 template<typename P>
-ConcurrentJobManager<P>::ConcurrentJobManager(ThreadPool pool)
-    : threadPool(pool)
+ConcurrentJobManager<P>::ConcurrentJobManager(TaskScheduler& scheduler)
+    : _tasks(scheduler)
 {}
 
+template<typename P>
+ConcurrentJobManager<P>::~ConcurrentJobManager() {
+    // The scheduler is shared, so we have to wait for our jobs to leave it before the
+    // queue they report to is destroyed. Jobs that have not started yet are skipped
+    clearEnqueuedJobs();
+    _tasks.wait();
+}
+
 template<typename P>
 void ConcurrentJobManager<P>::enqueueJob(std::shared_ptr<Job<P>> job) {
-    threadPool.enqueue([this, job]() {
+    const unsigned int generation = _generation;
+    _tasks.run([this, job, generation]() {
+        if (generation != _generation) {
+            return;
+        }
         job->execute();
         std::lock_guard<std::mutex> lock(_finishedJobsMutex);
         _finishedJobs.push(job);
@@ -43,7 +55,7 @@ void ConcurrentJobManager<P>::enqueueJob(std::shared_ptr<Job<P>> job) {
 
 template<typename P>
 void ConcurrentJobManager<P>::clearEnqueuedJobs() {
-    threadPool.clearTasks();
+    ++_generation;
 }
 
 template<typename P>
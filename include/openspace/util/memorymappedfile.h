@@ -0,0 +1,93 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+#define __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+
+#include <cstddef>
+#include <string>
+
+namespace openspace {
+
+/**
+ * A read-only memory mapping of an entire file. The mapping is created in the
+ * constructor and released in the destructor. Pages of the file are only read from disk
+ * when they are accessed for the first time, which can be triggered ahead of time with
+ * <code>prefetch</code>.
+ */
+class MemoryMappedFile {
+public:
+    /// The expected order in which the pages of the file are accessed
+    enum class AccessPattern {
+        /// The file is read from front to back, so neighboring pages are read ahead
+        Sequential,
+        /// The file is accessed in an unpredictable order, so nothing is read ahead
+        Random
+    };
+
+    /**
+     * Maps the file at \p filePath into memory. The \p accessPattern is passed on to the
+     * operating system as a hint for how the pages should be read.
+     * \throws ghoul::RuntimeError If the file could not be opened or mapped
+     */
+    MemoryMappedFile(const std::string& filePath, AccessPattern accessPattern);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /// Returns the first byte of the mapped file
+    const char* data() const;
+
+    /// Returns the size of the mapped file in bytes
+    size_t size() const;
+
+    /**
+     * Pages in the byte range [\p offset, \p offset + \p size) of the file so that
+     * subsequent accesses to it do not block on disk reads.
+     */
+    void prefetch(size_t offset, size_t size) const;
+
+    /**
+     * Tells the operating system that the byte range [\p offset, \p offset + \p size)
+     * will not be accessed in the near future and that its pages can be dropped. The
+     * data remains accessible, but will be read from disk again on the next access.
+     */
+    void release(size_t offset, size_t size) const;
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+
+#ifdef WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#else // WIN32
+    int _fileDescriptor = -1;
+#endif // WIN32
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
@@ -0,0 +1,161 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SPECKFILE___H__
+#define __OPENSPACE_CORE___SPECKFILE___H__
+
+#include <ghoul/glm.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace { class TaskScheduler; }
+
+/**
+ * Readers for the text formats of the Digital Universe catalogs: speck files, which
+ * contain a header describing the data variables followed by one line of values per
+ * object, label files, and color map files. The files are memory mapped and tokenized in
+ * place, so apart from the output no memory is allocated while parsing.
+ */
+namespace openspace::speck {
+
+/**
+ * Splits a range of characters into lines and the lines into whitespace-separated
+ * tokens. Empty lines and lines starting with a <code>#</code> are skipped, and a
+ * trailing <code>\r</code> is removed from all lines. The scanner does not own the
+ * characters, which do not have to be null-terminated.
+ */
+class Scanner {
+public:
+    Scanner(const char* begin, const char* end);
+
+    /**
+     * Advances to the next line that is neither empty nor a comment. Returns \c false if
+     * the end of the range has been reached.
+     */
+    bool nextLine();
+
+    /// Moves back to the first token of the current line
+    void rewindLine();
+
+    /// Returns \c true if there are more tokens on the current line
+    bool hasToken();
+
+    /// Returns the next token of the current line, or an empty token at the end of it
+    std::string_view token();
+
+    /**
+     * Parses the next token of the current line as a number and stores it in \p value.
+     * If the token is not a number, \c false is returned and the token is not consumed.
+     */
+    bool number(float& value);
+
+    /// Returns the first character of the current line
+    const char* lineBegin() const;
+
+private:
+    void skipWhitespace();
+
+    const char* _end;
+    const char* _next;
+    const char* _lineBegin;
+    const char* _lineEnd;
+    const char* _cursor;
+};
+
+/// A data variable from a <code>datavar</code> line of a speck file's header
+struct Variable {
+    /// The index of the variable's first value, not counting X, Y, and Z
+    int index;
+    std::string name;
+};
+
+/// A texture from a <code>texture</code> line of a speck file's header
+struct Texture {
+    int index;
+    std::string file;
+};
+
+struct Dataset {
+    /// Returns the number of objects in the #values
+    size_t numberOfEntries() const;
+
+    std::vector<Variable> variables;
+    std::vector<Texture> textures;
+
+    /// The index of the <code>texturevar</code> variable, or -1 if there is none
+    int textureVariable = -1;
+    /// The index of the <code>polyorivar</code> variable, or -1 if there is none
+    int orientationVariable = -1;
+
+    /**
+     * The number of values of each object, which are X, Y, Z and the values of all
+     * variables. An <code>orientation</code> or <code>ori</code> variable consists of six
+     * values; all other variables consist of a single value.
+     */
+    int valuesPerEntry = 3;
+
+    /// The values of all objects, one after another, with #valuesPerEntry values each
+    std::vector<float> values;
+};
+
+struct Label {
+    glm::vec3 position;
+    std::string text;
+};
+
+/**
+ * Reads the speck file at \p path into the \p dataset. Values that are missing from a
+ * line are set to 0 and additional values are ignored. If a \p scheduler is provided,
+ * large files are split into chunks of lines that are parsed concurrently.
+ *
+ * \return \c true if the file could be read, \c false otherwise, in which case an error
+ *         has been logged
+ */
+bool loadSpeckFile(const std::string& path, Dataset& dataset,
+    TaskScheduler* scheduler = nullptr);
+
+/**
+ * Reads the label file at \p path and appends its labels to \p labels. Each line of the
+ * file consists of the position followed by the <code>text</code> keyword and the label,
+ * which ends at the end of the line or at a <code>#</code> that starts a comment.
+ *
+ * \return \c true if the file could be read, \c false otherwise, in which case an error
+ *         has been logged
+ */
+bool loadLabelFile(const std::string& path, std::vector<Label>& labels);
+
+/**
+ * Reads the color map file at \p path and appends its colors to \p colors. The first line
+ * of the file is the number of colors, which is followed by one line with the RGBA
+ * components of each color.
+ *
+ * \return \c true if the file could be read, \c false otherwise, in which case an error
+ *         has been logged
+ */
+bool loadColorMapFile(const std::string& path, std::vector<glm::vec4>& colors);
+
+} // namespace openspace::speck
+
+#endif // __OPENSPACE_CORE___SPECKFILE___H__
@@ -25,11 +25,16 @@
 #ifndef __OPENSPACE_CORE___SPICEMANAGER___H__
 #define __OPENSPACE_CORE___SPICEMANAGER___H__
 
+#include <openspace/util/timeformat.h>
+
 #include <ghoul/glm.h>
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/exception.h>
 #include <array>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <set>
@@ -38,6 +43,13 @@ namespace openspace {
 
 namespace scripting { struct LuaLibrary; }
 
+/**
+ * The SpiceManager is the interface to the CSPICE library. All methods can be called
+ * from multiple threads. As CSPICE is not reentrant, all calls into the library are
+ * serialized, but NAIF and frame ids that have been resolved before and the coverage of
+ * the loaded kernels are answered from an immutable snapshot without any locking. Many
+ * queries are best issued as a batch, for example with #targetPositions.
+ */
 class SpiceManager {
 public:
     BooleanType(UseException);
@@ -479,6 +491,19 @@ public:
     std::string dateFromEphemerisTime(double ephemerisTime,
         const std::string& formatString = "YYYY MON DDTHR:MN:SC.### ::RND") const;
 
+    /**
+     * Returns the leap seconds and the TDB parameters of the currently loaded leap
+     * seconds kernel, which are used to convert dates without calling into CSPICE. The
+     * table is empty if no leap seconds kernel is loaded. This method does not lock
+     * CSPICE.
+     *
+     * \return The leap second table of the current kernel pool
+     *
+     * \sa formatDate
+     * \sa parseDate
+     */
+    std::shared_ptr<const LeapSecondTable> leapSecondTable() const;
+
     /**
      * Returns the \p position of a \p target body relative to an \p observer in a
      * specific \p referenceFrame, optionally corrected for \p lightTime (planetary
@@ -542,6 +567,28 @@ public:
         const std::string& observer, const std::string& referenceFrame,
         AberrationCorrection aberrationCorrection, double ephemerisTime) const;
 
+    /**
+     * Returns the positions of the \p target relative to the \p observer at all
+     * \p ephemerisTimes, see #targetPosition. CSPICE is only locked once for the whole
+     * batch, which makes this cheaper than individual queries when SPICE is used from
+     * multiple threads at the same time.
+     *
+     * \param target The target body name or the target body's NAIF ID
+     * \param observer The observing body name or the observing body's NAIF ID
+     * \param referenceFrame The reference frame of the output position vectors
+     * \param aberrationCorrection The aberration correction used for the position
+     *        calculation
+     * \param ephemerisTimes The times at which the positions are retrieved
+     * \return The positions of the \p target in the same order as the
+     *         \p ephemerisTimes
+     *
+     * \throw SpiceException If any of the positions could not be retrieved
+     */
+    std::vector<glm::dvec3> targetPositions(const std::string& target,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection,
+        const std::vector<double>& ephemerisTimes) const;
+
     /**
      * This method returns the transformation matrix that defines the transformation from
      * the reference frame \p from to the reference frame \p to. As both reference frames
@@ -771,6 +818,22 @@ public:
     glm::dmat3 positionTransformMatrix(const std::string& sourceFrame,
         const std::string& destinationFrame, double ephemerisTime) const;
 
+    /**
+     * Returns the matrices that transform position vectors from the \p sourceFrame to
+     * the \p destinationFrame at all \p ephemerisTimes, see #positionTransformMatrix.
+     * CSPICE is only locked once for the whole batch.
+     *
+     * \param sourceFrame The name of the source reference frame
+     * \param destinationFrame The name of the destination reference frame
+     * \param ephemerisTimes The times at which the matrices are retrieved
+     * \return The transformation matrices in the same order as the \p ephemerisTimes
+     *
+     * \throw SpiceException If any of the matrices could not be retrieved
+     */
+    std::vector<glm::dmat3> positionTransformMatrices(const std::string& sourceFrame,
+        const std::string& destinationFrame,
+        const std::vector<double>& ephemerisTimes) const;
+
     /**
      * Returns the transformation matrix that transforms position vectors from the
      * \p sourceFrame at the time \p ephemerisTimeFrom to the \p destinationFrame at the
@@ -939,6 +1002,15 @@ public:
      */
     UseException exceptionHandling() const;
 
+    /**
+     * Returns a number that changes every time a kernel is loaded into or unloaded from
+     * the kernel pool. Values that were computed from the kernel pool remain valid for as
+     * long as the returned number does not change.
+     *
+     * \return The current generation of the kernel pool
+     */
+    unsigned int kernelGeneration() const;
+
     static scripting::LuaLibrary luaLibrary();
 
 private:
@@ -1057,6 +1129,36 @@ private:
     /// The last assigned kernel-id, used to determine the next free kernel id
     KernelHandle _lastAssignedKernel = KernelHandle(0);
 
+    /// Incremented every time the kernel pool changes, see #kernelGeneration
+    std::atomic<unsigned int> _kernelGeneration = 0;
+
+    /// Tables that are derived from the kernel pool and can be read without locking
+    /// CSPICE. A snapshot is never modified after it has been published; instead a
+    /// modified copy replaces it with <code>std::atomic_store</code>
+    struct Snapshot {
+        std::map<std::string, int> naifIds;
+        std::map<std::string, int> frameIds;
+        std::map<int, std::vector<std::pair<double, double>>> ckIntervals;
+        std::map<int, std::vector<std::pair<double, double>>> spkIntervals;
+        std::shared_ptr<const LeapSecondTable> leapSeconds =
+            std::make_shared<const LeapSecondTable>();
+    };
+
+    /// Publishes a snapshot without any resolved names and with the current coverage
+    /// intervals and leap seconds. Has to be called with the _mutex locked
+    void resetSnapshot();
+
+    /// Publishes a snapshot with the \p id of the \p name added to the \p table. Has
+    /// to be called with the _mutex locked
+    void publishId(std::map<std::string, int> Snapshot::* table, const std::string& name,
+        int id) const;
+
+    mutable std::shared_ptr<const Snapshot> _snapshot;
+
+    /// CSPICE is not reentrant and keeps its error state globally, so all calls into the
+    /// library are serialized. Recursive as the public methods call each other
+    mutable std::recursive_mutex _mutex;
+
     static SpiceManager* _instance;
 };
 
@@ -26,10 +26,17 @@
 #define __OPENSPACE_CORE___SYNCBUFFER___H__
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace openspace {
 
+/**
+ * A buffer into which Syncable%s encode their state and from which they decode it. The
+ * buffer grows as needed while encoding, the size passed to the constructor is only the
+ * initially reserved size. Decoding either reads from data owned by the buffer (see
+ * #setData) or from externally owned memory without copying it (see #setDataView).
+ */
 class SyncBuffer {
 public:
     SyncBuffer(size_t n);
@@ -57,13 +64,37 @@ public:
     //void read();
 
     void setData(std::vector<char> data);
+
+    /**
+     * Decodes directly from the \p size bytes starting at \p data, which have to stay
+     * valid until the next call to #reset, #setData, or #setDataView
+     */
+    void setDataView(const char* data, size_t size);
+
+    /// Returns a copy of the encoded data
     std::vector<char> data();
 
+    /// Returns the beginning of the encoded data, which is valid until the next encode
+    const char* encodedData() const;
+
+    /// Returns the number of bytes that have been encoded since the last #reset
+    size_t encodedSize() const;
+
+    /// Returns the number of bytes that have been decoded since the last #reset
+    size_t decodedSize() const;
+
 private:
+    /// Grows the data stream such that \p size more bytes can be encoded
+    void reserveForEncode(size_t size);
+
     size_t _n;
     size_t _encodeOffset = 0;
     size_t _decodeOffset = 0;
     std::vector<char> _dataStream;
+
+    /// The data that is decoded, which either points into _dataStream or into a view
+    const char* _decodeData = nullptr;
+    size_t _decodeSize = 0;
 };
 
 } // namespace openspace
@@ -30,7 +30,7 @@ namespace openspace {
 template <typename T>
 void SyncBuffer::encode(const T& v) {
     const size_t size = sizeof(T);
-    ghoul_assert(_encodeOffset + size < _n, "");
+    reserveForEncode(size);
 
     memcpy(_dataStream.data() + _encodeOffset, &v, size);
     _encodeOffset += size;
@@ -39,9 +39,9 @@ void SyncBuffer::encode(const T& v) {
 template <typename T>
 T SyncBuffer::decode() {
     const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
+    ghoul_assert(_decodeOffset + size <= _decodeSize, "Decoding past the end of data");
     T value;
-    memcpy(&value, _dataStream.data() + _decodeOffset, size);
+    memcpy(&value, _decodeData + _decodeOffset, size);
     _decodeOffset += size;
     return value;
 }
@@ -49,8 +49,8 @@ T SyncBuffer::decode() {
 template <typename T>
 void SyncBuffer::decode(T& value) {
     const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
-    memcpy(&value, _dataStream.data() + _decodeOffset, size);
+    ghoul_assert(_decodeOffset + size <= _decodeSize, "Decoding past the end of data");
+    memcpy(&value, _decodeData + _decodeOffset, size);
     _decodeOffset += size;
 }
 
@@ -0,0 +1,171 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TASK_SCHEDULER___H__
+#define __OPENSPACE_CORE___TASK_SCHEDULER___H__
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+class TaskGroup;
+
+/**
+ * A work-stealing task scheduler. Every worker thread owns a set of double-ended queues,
+ * one per Priority. A worker pushes and pops tasks at the back of its own queues and, if
+ * these are empty, steals tasks from the front of the other workers' queues. Tasks
+ * submitted from a thread that is not a worker of this scheduler are distributed to the
+ * workers in a round-robin fashion. This avoids the single lock that all workers would
+ * have to contend on with a shared queue.
+ *
+ * The worker threads are started lazily the first time a task is enqueued, which makes
+ * it safe to create a TaskScheduler during static initialization. Tasks that are still
+ * queued when the scheduler is destroyed are discarded, tasks that are currently running
+ * are allowed to finish.
+ */
+class TaskScheduler {
+public:
+    enum class Priority {
+        High = 0,
+        Normal,
+        Low
+    };
+
+    /**
+     * Creates a scheduler that will use \p nThreads worker threads. If \p nThreads is 0,
+     * one less than the number of hardware threads is used, but at least one.
+     */
+    explicit TaskScheduler(unsigned int nThreads = 0);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /// Enqueues the \p task to be executed by one of the worker threads
+    void enqueue(std::function<void()> task, Priority priority = Priority::Normal);
+
+    /**
+     * Executes a single pending task on the calling thread, if there is any. Returns
+     * \c true if a task was executed and \c false if no task could be found.
+     */
+    bool runPendingTask();
+
+    /// Returns the number of worker threads that this scheduler will use
+    unsigned int numberOfThreads() const;
+
+    /// Returns the number of tasks that have been enqueued but not yet started
+    size_t numberOfPendingTasks() const;
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> function;
+        /// The group that has to be notified when this task finished, if any
+        TaskGroup* group = nullptr;
+    };
+    static constexpr const int NumberOfPriorities = 3;
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::array<std::deque<Task>, NumberOfPriorities> tasks;
+    };
+
+    void enqueue(Task task, Priority priority);
+
+    /**
+     * Executes a single pending task that belongs to the \p group on the calling thread,
+     * if there is any. Returns \c true if a task was executed.
+     */
+    bool runPendingTask(const TaskGroup& group);
+
+    void startWorkers();
+    void workerLoop(unsigned int index);
+    bool popOwnTask(unsigned int index, Task& task);
+    bool stealTask(unsigned int thief, Task& task);
+    bool takeGroupTask(unsigned int start, const TaskGroup& group, Task& task);
+    void execute(Task& task);
+
+    const unsigned int _nThreads;
+    std::once_flag _startFlag;
+    std::vector<std::thread> _workers;
+    std::unique_ptr<WorkerQueue[]> _queues;
+
+    std::atomic<size_t> _nPendingTasks = 0;
+    std::atomic<unsigned int> _nextQueue = 0;
+    std::atomic_bool _shouldStop = false;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeCondition;
+    std::atomic<unsigned int> _nSleepingWorkers = 0;
+};
+
+/**
+ * A TaskGroup collects a number of tasks that are executed by a TaskScheduler and makes
+ * it possible to wait for all of them to finish. While waiting, the waiting thread helps
+ * with executing the pending tasks of this group, so waiting on a TaskGroup from inside a
+ * task is safe and does not deadlock. Tasks of other groups are never run by a waiting
+ * thread, so a wait only takes as long as the group's own work. The destructor waits for
+ * all remaining tasks.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Enqueues the \p task as part of this group
+    void run(std::function<void()> task,
+        TaskScheduler::Priority priority = TaskScheduler::Priority::Normal);
+
+    /// Blocks until all tasks that were added to this group have finished
+    void wait();
+
+    /// Returns \c true if there are no unfinished tasks in this group
+    bool isDone() const;
+
+private:
+    friend class TaskScheduler;
+
+    void taskFinished();
+
+    TaskScheduler& _scheduler;
+    std::atomic<int> _nPendingTasks = 0;
+    std::mutex _mutex;
+    std::condition_variable _finishedCondition;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___TASK_SCHEDULER___H__
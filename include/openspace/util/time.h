@@ -25,7 +25,10 @@
 #ifndef __OPENSPACE_CORE___TIME___H__
 #define __OPENSPACE_CORE___TIME___H__
 
+#include <openspace/util/timeformat.h>
+
 #include <string>
+#include <string_view>
 
 namespace openspace {
 
@@ -57,7 +60,9 @@ public:
     /**
      * Converts the \p timeString representing a date to a double precision
      * value representing the ephemeris time; that is the number of TDB
-     * seconds past the J2000 epoch.
+     * seconds past the J2000 epoch. The common date formats are converted without
+     * calling SPICE, with a result that is within MaxParseErrorUlps units in the last
+     * place of the one SPICE would return (see parseDate).
      * \param timeString A string representing the time to be converted
      * \return The converted time; the number of TDB seconds past the J2000 epoch,
      * representing the passed \p timeString
@@ -114,12 +119,28 @@ public:
      */
     std::string UTC() const;
 
+    /**
+     * Writes the current time in the same format as UTC() into the \p buffer without
+     * allocating memory.
+     * \param buffer The destination of the null-terminated date string
+     * \return A view of the date string in the \p buffer
+     */
+    std::string_view UTC(char (&buffer)[DateBufferSize]) const;
+
     /**
     * Returns the current time as a ISO 8601 formatted, i.e YYYY-MM-DDThh:mm:ssZ
     * \return The current time as a ISO 8601 formatted string
     */
     std::string ISO8601() const;
 
+    /**
+     * Writes the current time in the same format as ISO8601() into the \p buffer without
+     * allocating memory.
+     * \param buffer The destination of the null-terminated date string
+     * \return A view of the date string in the \p buffer
+     */
+    std::string_view ISO8601(char (&buffer)[DateBufferSize]) const;
+
     /**
      * Advances the simulation time using the deltaTime() and the <code>tickTime</code>.
      * The deltaTime() is the number of simulation seconds that pass for each real-time
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TIMEFORMAT___H__
+#define __OPENSPACE_CORE___TIMEFORMAT___H__
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The parameters of a SPICE leap seconds kernel that are needed to convert between UTC
+ * and ephemeris time (TDB seconds past the J2000 epoch). The names follow the
+ * <code>DELTET</code> variables of the kernel pool.
+ */
+struct LeapSecondTable {
+    /// The difference TDT - TAI
+    double deltaTA = 0.0;
+    /// The amplitude of the periodic TDB - TDT term
+    double k = 0.0;
+    /// The eccentricity of the Earth-Moon barycenter orbit
+    double eb = 0.0;
+    /// The mean anomaly at J2000 and its rate of change
+    double m0 = 0.0;
+    double m1 = 0.0;
+    /// Pairs of TAI - UTC and the UTC date, as seconds past J2000 without leap seconds,
+    /// from which on that difference applies. Sorted by date
+    std::vector<std::pair<double, double>> deltaAT;
+};
+
+/// The date formats that can be written without calling SPICE
+enum class DateFormat {
+    /// <code>YYYY MON DDTHR:MN:SC.###</code>, the default format of
+    /// SpiceManager::dateFromEphemerisTime
+    Spice,
+    /// <code>YYYY-MM-DDTHR:MN:SC.###</code>
+    ISO8601
+};
+
+/// The buffer size that is sufficient for all DateFormat%s including the terminator
+constexpr const size_t DateBufferSize = 32;
+
+/// The largest difference, in units in the last place, between the ephemeris times that
+/// are returned by parseDate and by SPICE's <code>str2et_c</code> for the same date
+constexpr const int MaxParseErrorUlps = 8;
+
+/**
+ * Writes the \p ephemerisTime as a null-terminated UTC date string in the \p format into
+ * the \p buffer, rounded to milliseconds like SPICE's <code>::RND</code> modifier. Like
+ * SPICE's default calendar, the Gregorian calendar is used for all dates.
+ *
+ * \return \c false if the date lies outside of the years 1 to 9999 or the \p table is
+ *         empty; the \p buffer is unchanged in that case
+ */
+bool formatDate(double ephemerisTime, const LeapSecondTable& table, DateFormat format,
+    char (&buffer)[DateBufferSize]);
+
+/**
+ * Converts the UTC \p date into ephemeris time. The supported formats are
+ * <code>YYYY-MM-DD[THR:MN[:SC[.###]]]</code> and
+ * <code>YYYY MON DD[( |T)HR:MN[:SC[.###]]]</code>, which are interpreted the same way as
+ * by SPICE's <code>str2et_c</code>. The result is not always bit-identical to the one of
+ * <code>str2et_c</code>: the seconds field is converted with a correctly rounding
+ * parser and the time scale offsets are added in a different order, each of which rounds
+ * on its own. The results differ by at most MaxParseErrorUlps units in the last place,
+ * which is below 2.5e-4 seconds for all dates in the years 1 to 9999.
+ *
+ * \return \c false if the \p date is not in a supported format, is invalid, or the
+ *         \p table is empty. The caller should fall back to SPICE in that case
+ */
+bool parseDate(std::string_view date, const LeapSecondTable& table,
+    double& ephemerisTime);
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___TIMEFORMAT___H__
@@ -112,18 +112,20 @@ DashboardItemDate::DashboardItemDate(const ghoul::Dictionary& dictionary)
 }
 
 void DashboardItemDate::render(glm::vec2& penPosition) {
+    char buffer[DateBufferSize];
     penPosition.y -= _font->height();
     RenderFont(
         *_font,
         penPosition,
-        fmt::format("Date: {} UTC", global::timeManager.time().UTC())
+        fmt::format("Date: {} UTC", global::timeManager.time().UTC(buffer).data())
     );
 }
 
 glm::vec2 DashboardItemDate::size() const {
+    char buffer[DateBufferSize];
     return ghoul::fontrendering::FontRenderer::defaultRenderer().boundingBox(
         *_font,
-        fmt::format("Date: {} UTC", global::timeManager.time().UTC())
+        fmt::format("Date: {} UTC", global::timeManager.time().UTC(buffer).data())
     ).boundingBox;
 }
 
@@ -549,6 +549,11 @@ bool FixedRotation::initialize() {
     return res;
 }
 
+bool FixedRotation::readsOtherNodes() const {
+    // The axes can point towards arbitrary scene graph nodes
+    return true;
+}
+
 glm::dmat3 FixedRotation::matrix(const UpdateData&) const {
     if (!_enabled) {
         return glm::dmat3();
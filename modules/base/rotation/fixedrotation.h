@@ -49,6 +49,7 @@ public:
     static documentation::Documentation Documentation();
 
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool readsOtherNodes() const override;
 
 private:
     glm::vec3 xAxis() const;
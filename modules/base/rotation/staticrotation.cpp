@@ -89,6 +89,10 @@ StaticRotation::StaticRotation(const ghoul::Dictionary& dictionary) : StaticRota
     }
 }
 
+bool StaticRotation::isTimeDependent() const {
+    return false;
+}
+
 glm::dmat3 StaticRotation::matrix(const UpdateData&) const {
     return _rotationMatrix;
 }
@@ -39,6 +39,7 @@ public:
     StaticRotation(const ghoul::Dictionary& dictionary);
 
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool isTimeDependent() const override;
 
     static documentation::Documentation Documentation();
 
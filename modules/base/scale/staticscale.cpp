@@ -54,6 +54,10 @@ documentation::Documentation StaticScale::Documentation() {
     };
 }
 
+bool StaticScale::isTimeDependent() const {
+    return false;
+}
+
 double StaticScale::scaleValue(const UpdateData&) const {
     return _scaleValue;
 }
@@ -88,6 +88,10 @@ StaticTranslation::StaticTranslation(const ghoul::Dictionary& dictionary)
     _position = dictionary.value<glm::dvec3>(PositionInfo.identifier);
 }
 
+bool StaticTranslation::isTimeDependent() const {
+    return false;
+}
+
 glm::dvec3 StaticTranslation::position(const UpdateData&) const {
     return _position;
 }
@@ -27,6 +27,8 @@
 #include <modules/digitaluniverse/digitaluniversemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/memorymappedfile.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
@@ -38,12 +40,14 @@
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 #include <array>
 #include <fstream>
 #include <cstdint>
+#include <memory>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableDUMeshes";
@@ -694,213 +698,113 @@ bool RenderableDUMeshes::loadData() {
 }
 
 bool RenderableDUMeshes::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
+    std::unique_ptr<MemoryMappedFile> file;
+    try {
+        file = std::make_unique<MemoryMappedFile>(
+            _speckFile,
+            MemoryMappedFile::AccessPattern::Sequential
+        );
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Speck file '{}': {}", _speckFile, e.message));
         return false;
     }
 
     int meshIndex = 0;
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (file.eof()) {
+    // The speck file consists of a list of meshes; anything after them is ignored
+    speck::Scanner scanner(file->data(), file->data() + file->size());
+    while (scanner.nextLine()) {
+        if (scanner.token() != "mesh") {
             break;
         }
 
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 4) != "mesh") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
+        // mesh lines are structured as follows:
+        // mesh -t texnum -c colorindex -s style {
+        // where textnum is the index of the texture;
+        // colorindex is the index of the color for the mesh
+        // and style is solid, wire or point (for now we support only wire)
+        RenderingMesh mesh;
+        mesh.meshIndex = meshIndex;
+
+        for (std::string_view t = scanner.token(); !t.empty(); t = scanner.token()) {
+            if (t == "{") {
+                break;
+            }
 
-        if (line.substr(0, 4) == "mesh") {
-            // mesh lines are structured as follows:
-            // mesh -t texnum -c colorindex -s style {
-            // where textnum is the index of the texture;
-            // colorindex is the index of the color for the mesh
-            // and style is solid, wire or point (for now we support only wire)
-            std::stringstream str(line);
-
-            RenderingMesh mesh;
-            mesh.meshIndex = meshIndex;
-
-            std::string dummy;
-            str >> dummy; // mesh command
-            dummy.clear();
-            str >> dummy; // texture index command?
-            do {
-                if (dummy == "-t") {
-                    dummy.clear();
-                    str >> mesh.textureIndex; // texture index
+            float value = 0.f;
+            if (t == "-t") {
+                scanner.number(value);
+                mesh.textureIndex = static_cast<int>(value);
+            }
+            else if (t == "-c") {
+                scanner.number(value);
+                mesh.colorIndex = static_cast<int>(value);
+            }
+            else if (t == "-s") {
+                const std::string_view style = scanner.token();
+                if (style == "solid") {
+                    mesh.style = Solid;
                 }
-                else if (dummy == "-c") {
-                    dummy.clear();
-                    str >> mesh.colorIndex; // color index command
+                else if (style == "wire") {
+                    mesh.style = Wire;
                 }
-                else if (dummy == "-s") {
-                    dummy.clear();
-                    str >> dummy; // style value command
-                    if (dummy == "solid") {
-                        mesh.style = Solid;
-                    }
-                    else if (dummy == "wire") {
-                        mesh.style = Wire;
-                    }
-                    else if (dummy == "point") {
-                        mesh.style = Point;
-                    }
-                    else {
-                        mesh.style = INVALID;
-                        break;
-                    }
-                }
-                dummy.clear();
-                str >> dummy;
-            } while (dummy != "{");
-
-            std::getline(file, line);
-            std::stringstream dim(line);
-            dim >> mesh.numU; // numU
-            dim >> mesh.numV; // numV
-
-            // We can now read the vertices data:
-            for (int l = 0; l < mesh.numU * mesh.numV; ++l) {
-                std::getline(file, line);
-                if (line.substr(0, 1) != "}") {
-                    std::stringstream lineData(line);
-                    for (int i = 0; i < 7; ++i) {
-                        GLfloat value;
-                        lineData >> value;
-                        bool errorReading = lineData.rdstate() & std::ifstream::failbit;
-                        if (!errorReading) {
-                            mesh.vertices.push_back(value);
-                        }
-                        else {
-                            break;
-                        }
-                    }
+                else if (style == "point") {
+                    mesh.style = Point;
                 }
                 else {
+                    mesh.style = INVALID;
                     break;
                 }
             }
+        }
 
-            std::getline(file, line);
-            if (line.substr(0, 1) == "}") {
-                _renderingMeshesMap.insert({ meshIndex++, mesh });
+        // The line after the mesh command contains numU and numV
+        float numU = 0.f;
+        float numV = 0.f;
+        if (!scanner.nextLine() || !scanner.number(numU) || !scanner.number(numV)) {
+            return false;
+        }
+        mesh.numU = static_cast<int>(numU);
+        mesh.numV = static_cast<int>(numV);
+
+        // We can now read the vertices data, which is followed by the closing brace
+        int nVertices = 0;
+        while (scanner.nextLine()) {
+            float value;
+            if (nVertices == mesh.numU * mesh.numV || !scanner.number(value)) {
+                break;
             }
-            else {
-                return false;
+            mesh.vertices.push_back(value);
+            for (int i = 1; i < 7 && scanner.number(value); ++i) {
+                mesh.vertices.push_back(value);
             }
+            ++nVertices;
+        }
+
+        scanner.rewindLine();
+        if (scanner.token() != "}") {
+            return false;
         }
+        _renderingMeshesMap.insert({ meshIndex++, std::move(mesh) });
     }
 
     return true;
 }
 
 bool RenderableDUMeshes::readLabelFile() {
-    std::ifstream file(_labelFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _labelFile));
+    std::vector<speck::Label> labels;
+    if (!speck::loadLabelFile(_labelFile, labels)) {
         return false;
     }
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
-
-            // TODO: handle cases of labels with different colors
-            break;
-        }
-    }
-
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (int j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            label += " " + dummy;
-            dummy.clear();
-        }
-
+    _labelData.reserve(_labelData.size() + labels.size());
+    for (speck::Label& label : labels) {
         glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
+            _transformationMatrix * glm::dvec4(label.position, 1.0)
         );
-        _labelData.emplace_back(std::make_pair(transformedPos, label));
-
-    } while (!file.eof());
+        _labelData.emplace_back(transformedPos, std::move(label.text));
+    }
 
     return true;
 }
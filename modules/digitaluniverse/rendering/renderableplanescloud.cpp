@@ -29,6 +29,7 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
@@ -862,272 +863,58 @@ bool RenderablePlanesCloud::loadTextures() {
 }
 
 bool RenderablePlanesCloud::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
+    speck::Dataset dataset;
+    if (!speck::loadSpeckFile(_speckFile, dataset, &global::taskScheduler)) {
         return false;
     }
 
-    _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture" &&
-            line.substr(0, 10) != "polyorivar" &&
-            line.substr(0, 10) != "maxcomment")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _nValuesPerAstronomicalObject; // variable index
-            dummy.clear();
-            str >> dummy; // variable name
-
-            // +3 because of the x, y and z at the begining of each line.
-            _variableDataPositionMap.insert({ dummy, _nValuesPerAstronomicalObject + 3});
-
-            if ((dummy == "orientation") || (dummy == "ori")) { // 3d vectors u and v
-                // We want the number, but the index is 0 based
-                _nValuesPerAstronomicalObject += 6;
-            }
-            else {
-                // We want the number, but the index is 0 based
-                _nValuesPerAstronomicalObject += 1;
-            }
-        }
+    // +3 because of the x, y and z at the begining of each line.
+    for (const speck::Variable& variable : dataset.variables) {
+        _variableDataPositionMap.insert({ variable.name, variable.index + 3 });
+    }
+    if (dataset.orientationVariable != -1) {
+        _planeStartingIndexPos = dataset.orientationVariable + 3;
+    }
+    if (dataset.textureVariable != -1) {
+        _textureVariableIndex = dataset.textureVariable + 3;
+    }
 
-        if (line.substr(0, 10) == "polyorivar") {
-            _planeStartingIndexPos = 0;
-            std::stringstream str(line);
+    for (const speck::Texture& texture : dataset.textures) {
+        std::string fullPath = absPath(_texturesPath + '/' + texture.file);
+        std::string pngPath =
+            ghoul::filesystem::File(fullPath).fullBaseName() + ".png";
 
-            std::string dummy;
-            str >> dummy; // command
-            str >> _planeStartingIndexPos;
-            _planeStartingIndexPos += 3; // 3 for xyz
+        if (FileSys.fileExists(fullPath)) {
+            _textureFileMap.insert({ texture.index, fullPath });
         }
-
-        if (line.substr(0, 10) == "texturevar") {
-            _textureVariableIndex = 0;
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _textureVariableIndex;
-            _textureVariableIndex += 3; // 3 for xyz
+        else if (FileSys.fileExists(pngPath)) {
+            _textureFileMap.insert({ texture.index, pngPath });
         }
-
-        if (line.substr(0, 8) == "texture ") {
-            std::stringstream str(line);
-
-            std::size_t found = line.find('-');
-
-            int textureIndex = 0;
-
-            std::string dummy;
-            str >> dummy; // command
-
-            if (found != std::string::npos) {
-                std::string option; // Not being used right now.
-                str >> option;
-            }
-
-            str >> textureIndex;
-            std::string fileName;
-            str >> fileName; // texture file name
-
-            std::string fullPath = absPath(_texturesPath + '/' + fileName);
-            std::string pngPath =
-                ghoul::filesystem::File(fullPath).fullBaseName() + ".png";
-
-            if (FileSys.fileExists(fullPath)) {
-                _textureFileMap.insert({ textureIndex, fullPath });
-
-            }
-            else if (FileSys.fileExists(pngPath)) {
-                _textureFileMap.insert({ textureIndex, pngPath });
-            }
-            else {
-                LWARNING(fmt::format("Could not find image file {}", fileName));
-                _textureFileMap.insert({ textureIndex, "" });
-            }
+        else {
+            LWARNING(fmt::format("Could not find image file {}", texture.file));
+            _textureFileMap.insert({ texture.index, "" });
         }
     }
 
-    _nValuesPerAstronomicalObject += 3; // X Y Z are not counted in the Speck file indices
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 u(0.f);
-        glm::vec3 v(0.f);
-        int textureIndex = 0;
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-            if ((i >= _planeStartingIndexPos) &&
-                (i <= _planeStartingIndexPos + 6)) { // vectors u and v
-                int index = i - _planeStartingIndexPos;
-                switch (index) {
-                    case 0:
-                        u.x = values[i];
-                        break;
-                    case 1:
-                        u.y = values[i];
-                        break;
-                    case 2:
-                        u.z = values[i];
-                        break;
-                    case 3:
-                        v.x = values[i];
-                        break;
-                    case 4:
-                        v.y = values[i];
-                        break;
-                    case 5:
-                        v.z = values[i];
-                        break;
-                }
-            }
-
-            // JCC: This should be moved to the RenderablePlanesCloud:
-            if (i == _textureVariableIndex) {
-                textureIndex = static_cast<int>(values[i]);
-            }
-        }
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
+    _nValuesPerAstronomicalObject = dataset.valuesPerEntry;
+    _fullData = std::move(dataset.values);
 
     return true;
 }
 
 bool RenderablePlanesCloud::readLabelFile() {
-    std::ifstream file(_labelFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _labelFile));
+    std::vector<speck::Label> labels;
+    if (!speck::loadLabelFile(_labelFile, labels)) {
         return false;
     }
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
-
-            // TODO: handle cases of labels with different colors
-            break;
-        }
-    }
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (int j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            label += " " + dummy;
-            dummy.clear();
-        }
-
+    _labelData.reserve(_labelData.size() + labels.size());
+    for (speck::Label& label : labels) {
         glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
+            _transformationMatrix * glm::dvec4(label.position, 1.0)
         );
-        _labelData.emplace_back(std::make_pair(transformedPos, label));
-
-    } while (!file.eof());
+        _labelData.emplace_back(transformedPos, std::move(label.text));
+    }
 
     return true;
 }
@@ -29,6 +29,7 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -40,7 +41,6 @@
 #include <ghoul/opengl/textureunit.h>
 #include <array>
 #include <fstream>
-#include <locale>
 #include <cstdint>
 #include <string>
 
@@ -478,118 +478,19 @@ bool RenderablePoints::loadData() {
 }
 
 bool RenderablePoints::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
+    speck::Dataset dataset;
+    if (!speck::loadSpeckFile(_speckFile, dataset, &global::taskScheduler)) {
         return false;
     }
 
-    _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty()) {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump
-            // back before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly
-            // overwrite the 'nValues' variable with the latest index, we will end up
-            // with the total number of values (+3 since X Y Z are not counted in the
-            // Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> _nValuesPerAstronomicalObject;
-            // We want the number, but the index is 0 based
-            _nValuesPerAstronomicalObject += 1;
-        }
-    }
-
-    // X Y Z are not counted in the Speck file indices
-    _nValuesPerAstronomicalObject += 3;
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-        }
-
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
+    _nValuesPerAstronomicalObject = dataset.valuesPerEntry;
+    _fullData = std::move(dataset.values);
 
     return true;
 }
 
 bool RenderablePoints::readColorMapFile() {
-    std::ifstream file(_colorMapFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Color Map file '{}'", _colorMapFile));
-        return false;
-    }
-
-    std::size_t numberOfColors = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        // std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty()) {
-            continue;
-        }
-
-        // Initial number of colors
-        std::locale loc;
-        if (std::isdigit(line[0], loc)) {
-            std::string::size_type sz;
-            numberOfColors = std::stoi(line, &sz);
-            break;
-        }
-        else if (file.eof()) {
-            return false;
-        }
-    }
-
-    for (size_t i = 0; i < numberOfColors; ++i) {
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        glm::vec4 color;
-        for (int j = 0; j < 4; ++j) {
-            str >> color[j];
-        }
-
-        _colorMapData.push_back(color);
-    }
-
-    return true;
+    return speck::loadColorMapFile(_colorMapFile, _colorMapData);
 }
 
 bool RenderablePoints::loadCachedFile(const std::string& file) {
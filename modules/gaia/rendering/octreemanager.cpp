@@ -29,15 +29,78 @@
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "OctreeManager";
+
+    // Layout of the flat Octree file. The header is followed by the node table, which
+    // is followed by the data blocks of all nodes that contain any stars. The header,
+    // the table, and every data block start at a multiple of FlatFileAlignment bytes
+    constexpr const char FlatFileMagic[8] = { 'O', 'S', 'G', 'A', 'I', 'A', 'O', 'T' };
+    constexpr const int32_t FlatFileVersion = 1;
+    constexpr const size_t FlatFileAlignment = 64;
+
+    struct FlatFileHeader {
+        char magic[8];
+        int32_t version;
+        int32_t valuesPerStar;
+        int32_t maxStarsPerNode;
+        int32_t maxDist;
+        uint64_t nNodes;
+    };
+
+    // The nodes are stored in breadth-first order, with the 8 top level nodes first,
+    // which means that the 8 children of every inner node are stored next to each other
+    struct FlatFileNode {
+        // Offset of the node data from the start of the file, 0 if there are no stars
+        uint64_t dataOffset;
+        uint32_t numStars;
+        // Table index of the first child of an inner node, 0 for leaves
+        uint32_t firstChild;
+    };
+    static_assert(sizeof(FlatFileHeader) <= FlatFileAlignment);
+    static_assert(sizeof(FlatFileNode) == 16);
+
+    size_t alignToFlatFile(size_t offset) {
+        return (offset + FlatFileAlignment - 1) / FlatFileAlignment * FlatFileAlignment;
+    }
 } // namespace
 
 namespace openspace {
 
+OctreeManager::StarBatch::StarBatch(const float* data, size_t nStars,
+                                    size_t valuesPerStar)
+{
+    for (size_t v = 0; v < values.size(); ++v) {
+        values[v].resize(nStars);
+        for (size_t i = 0; i < nStars; ++i) {
+            values[v][i] = data[i * valuesPerStar + v];
+        }
+    }
+}
+
+void OctreeManager::StarBatch::append(const float* starValues) {
+    for (size_t v = 0; v < values.size(); ++v) {
+        values[v].push_back(starValues[v]);
+    }
+}
+
+void OctreeManager::StarBatch::reserve(size_t nStars) {
+    for (std::vector<float>& v : values) {
+        v.reserve(nStars);
+    }
+}
+
+size_t OctreeManager::StarBatch::size() const {
+    return values[0].size();
+}
+
 void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStarsPerNode) {
     if (_root) {
         LDEBUG("Clear existing Octree");
@@ -47,6 +110,7 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
     LDEBUG("Initializing new Octree");
     _root = std::make_shared<OctreeNode>();
     _root->octreePositionIndex = 8;
+    _mappedFile = nullptr;
 
     // Initialize the culler. The NDC.z of the comparing corners are always -1 or 1.
     globebrowsing::AABB3 box;
@@ -122,6 +186,37 @@ void OctreeManager::insert(const std::vector<float>& starValues) {
     insertInNode(*_root->Children[index], starValues);
 }
 
+void OctreeManager::insertBatch(StarBatch batch) {
+    const size_t nStars = batch.size();
+    StarBatch scratch;
+    for (std::vector<float>& v : scratch.values) {
+        v.resize(nStars);
+    }
+    std::vector<uint8_t> octants(nStars);
+
+    const std::array<size_t, 9> branches = partitionBatch(
+        batch,
+        scratch,
+        octants,
+        0,
+        nStars,
+        0.f,
+        0.f,
+        0.f
+    );
+    for (size_t i = 0; i < 8; ++i) {
+        insertBatchInNode(
+            *_root->Children[i],
+            batch,
+            scratch,
+            octants,
+            branches[i],
+            branches[i + 1],
+            1
+        );
+    }
+}
+
 void OctreeManager::sliceLodData(size_t branchIndex) {
     if (branchIndex != 8) {
         sliceNodeLodCache(*_root->Children[branchIndex]);
@@ -612,18 +707,7 @@ int OctreeManager::readFromFile(std::ifstream& inFileStream, bool readData,
 
     // Octree Manager root halfDistance must be updated before any nodes are created!
     if (MAX_DIST != oldMaxdist) {
-        for (size_t i = 0; i < 8; ++i) {
-            _root->Children[i]->halfDimension = MAX_DIST / 2.f;
-            _root->Children[i]->originX = (i % 2 == 0) ?
-                _root->Children[i]->halfDimension :
-                -_root->Children[i]->halfDimension;
-            _root->Children[i]->originY = (i % 4 < 2) ?
-                _root->Children[i]->halfDimension :
-                -_root->Children[i]->halfDimension;
-            _root->Children[i]->originZ = (i < 4) ?
-                _root->Children[i]->halfDimension :
-                -_root->Children[i]->halfDimension;
-        }
+        updateRootChildrenDimensions();
     }
 
     if (_valuesPerStar != (POS_SIZE + COL_SIZE + VEL_SIZE)) {
@@ -704,28 +788,9 @@ void OctreeManager::writeNodeToMultipleFiles(const std::string& outFilePrefix,
     std::vector<float> nodeData = node.posData;
     nodeData.insert(nodeData.end(), node.colData.begin(), node.colData.end());
     nodeData.insert(nodeData.end(), node.velData.begin(), node.velData.end());
-    int32_t nDataSize = static_cast<int32_t>(nodeData.size());
-    size_t nBytes = nDataSize * sizeof(nodeData[0]);
-
-    // Only open output stream if we have any values to write.
-    if (nDataSize > 0) {
-        // Use Morton code to name file (placement in Octree).
-        std::string outPath = outFilePrefix + BINARY_SUFFIX;
-        std::ofstream outFileStream(outPath, std::ofstream::binary);
-        if (outFileStream.good()) {
-            // LINFO("Write " + std::to_string(nDataSize) + " values to " + outPath);
-            outFileStream.write(
-                reinterpret_cast<const char*>(&nDataSize),
-                sizeof(int32_t)
-            );
-            outFileStream.write(reinterpret_cast<const char*>(nodeData.data()), nBytes);
 
-            outFileStream.close();
-        }
-        else {
-            LERROR(fmt::format("Error opening file: {} as output data file.", outPath));
-        }
-    }
+    // Use Morton code to name file (placement in Octree).
+    writeNodeDataToFile(outFilePrefix + BINARY_SUFFIX, nodeData);
 
     // Recursively write children to file (in Morton order) if we're in an inner node.
     if (!node.isLeaf) {
@@ -754,6 +819,411 @@ void OctreeManager::writeNodeToMultipleFiles(const std::string& outFilePrefix,
     }
 }
 
+bool OctreeManager::writeToFlatFile(const std::string& outFilePath,
+                                    const std::string& nodeFolderPath)
+{
+    // Order all nodes breadth-first and store where the children of every node end up.
+    std::vector<const OctreeNode*> nodes;
+    std::vector<FlatFileNode> table;
+    for (size_t i = 0; i < 8; ++i) {
+        nodes.push_back(_root->Children[i].get());
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        FlatFileNode entry = { 0, static_cast<uint32_t>(nodes[i]->numStars), 0 };
+        if (!nodes[i]->isLeaf) {
+            entry.firstChild = static_cast<uint32_t>(nodes.size());
+            for (size_t j = 0; j < 8; ++j) {
+                nodes.push_back(nodes[i]->Children[j].get());
+            }
+        }
+        table.push_back(entry);
+    }
+
+    // Assign an aligned data block to every node with stars.
+    const size_t tableOffset = alignToFlatFile(sizeof(FlatFileHeader));
+    const size_t tableSize = table.size() * sizeof(FlatFileNode);
+    size_t dataOffset = alignToFlatFile(tableOffset + tableSize);
+    for (FlatFileNode& entry : table) {
+        if (entry.numStars > 0) {
+            entry.dataOffset = dataOffset;
+            dataOffset = alignToFlatFile(
+                dataOffset + entry.numStars * _valuesPerStar * sizeof(float)
+            );
+        }
+    }
+
+    std::ofstream outFileStream(outFilePath, std::ofstream::binary);
+    if (!outFileStream.good()) {
+        LERROR(fmt::format("Error opening file: {} as flat Octree file.", outFilePath));
+        return false;
+    }
+
+    FlatFileHeader header;
+    std::memcpy(header.magic, FlatFileMagic, sizeof(FlatFileMagic));
+    header.version = FlatFileVersion;
+    header.valuesPerStar = static_cast<int32_t>(_valuesPerStar);
+    header.maxStarsPerNode = static_cast<int32_t>(MAX_STARS_PER_NODE);
+    header.maxDist = static_cast<int32_t>(MAX_DIST);
+    header.nNodes = table.size();
+
+    // Pads the file with zeros up to the offset of the next section.
+    auto padTo = [&outFileStream](size_t offset) {
+        const size_t position = static_cast<size_t>(outFileStream.tellp());
+        const std::vector<char> padding(offset - position, 0);
+        outFileStream.write(padding.data(), padding.size());
+    };
+
+    outFileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    padTo(tableOffset);
+    outFileStream.write(reinterpret_cast<const char*>(table.data()), tableSize);
+
+    std::vector<float> nodeData;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (table[i].numStars == 0) {
+            continue;
+        }
+        const OctreeNode& node = *nodes[i];
+        const size_t nValues = table[i].numStars * _valuesPerStar;
+
+        if (nodeFolderPath.empty()) {
+            nodeData = node.posData;
+            nodeData.insert(nodeData.end(), node.colData.begin(), node.colData.end());
+            nodeData.insert(nodeData.end(), node.velData.begin(), node.velData.end());
+        }
+        else {
+            // Remove root ID ("8") from index to get the name of the node file.
+            std::string posId = std::to_string(node.octreePositionIndex);
+            posId.erase(posId.begin());
+
+            const std::string inFilePath = nodeFolderPath + posId + BINARY_SUFFIX;
+            std::ifstream inFileStream(inFilePath, std::ifstream::binary);
+            int32_t nDataSize = 0;
+            inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
+            nodeData.resize(nDataSize);
+            inFileStream.read(
+                reinterpret_cast<char*>(nodeData.data()),
+                nDataSize * sizeof(nodeData[0])
+            );
+            if (!inFileStream.good()) {
+                LERROR("Error reading node data file: " + inFilePath);
+                return false;
+            }
+        }
+
+        if (nodeData.size() != nValues) {
+            LERROR(fmt::format(
+                "Node {} has {} values but should have {}",
+                node.octreePositionIndex, nodeData.size(), nValues
+            ));
+            return false;
+        }
+
+        padTo(table[i].dataOffset);
+        outFileStream.write(
+            reinterpret_cast<const char*>(nodeData.data()),
+            nValues * sizeof(nodeData[0])
+        );
+    }
+    padTo(dataOffset);
+
+    return outFileStream.good();
+}
+
+int OctreeManager::readFromFlatFile(const std::string& filePath) {
+    try {
+        // Nodes are streamed in an order that depends on the camera, so read-ahead of
+        // neighboring pages would mostly be wasted
+        _mappedFile = std::make_unique<MemoryMappedFile>(
+            filePath,
+            MemoryMappedFile::AccessPattern::Random
+        );
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        return 0;
+    }
+
+    const char* fileData = _mappedFile->data();
+    const size_t fileSize = _mappedFile->size();
+
+    FlatFileHeader header;
+    if (fileSize < sizeof(header)) {
+        LERROR(fmt::format("File '{}' is not a flat Octree file", filePath));
+        _mappedFile = nullptr;
+        return 0;
+    }
+    std::memcpy(&header, fileData, sizeof(header));
+
+    const size_t tableOffset = alignToFlatFile(sizeof(FlatFileHeader));
+    if (std::memcmp(header.magic, FlatFileMagic, sizeof(FlatFileMagic)) != 0 ||
+        header.version != FlatFileVersion || header.nNodes < 8 ||
+        tableOffset + header.nNodes * sizeof(FlatFileNode) > fileSize)
+    {
+        LERROR(fmt::format("File '{}' is not a valid flat Octree file", filePath));
+        _mappedFile = nullptr;
+        return 0;
+    }
+
+    // Nodes are only paged in when they are fetched.
+    _streamOctree = true;
+    _streamFolderPath.clear();
+
+    _valuesPerStar = header.valuesPerStar;
+    MAX_STARS_PER_NODE = header.maxStarsPerNode;
+    MAX_DIST = header.maxDist;
+
+    LDEBUG(fmt::format(
+        "Max stars per node in mapped Octree: {} - Radius of root layer: {}",
+        MAX_STARS_PER_NODE, MAX_DIST
+    ));
+
+    if (_valuesPerStar != (POS_SIZE + COL_SIZE + VEL_SIZE)) {
+        LERROR("Read file doesn't have the same structure of render parameters!");
+    }
+
+    // Octree Manager root halfDistance must be updated before any nodes are created!
+    updateRootChildrenDimensions();
+
+    // The table is in breadth-first order, so every node has been created by its parent
+    // by the time we get to it.
+    const FlatFileNode* table = reinterpret_cast<const FlatFileNode*>(
+        fileData + tableOffset
+    );
+    std::vector<OctreeNode*> nodes(header.nNodes, nullptr);
+    for (size_t i = 0; i < 8; ++i) {
+        nodes[i] = _root->Children[i].get();
+    }
+
+    int nStarsRead = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!nodes[i]) {
+            LERROR(fmt::format("Corrupt node table in flat Octree file '{}'", filePath));
+            initOctree(_maxCpuRamBudget);
+            return 0;
+        }
+        const FlatFileNode& entry = table[i];
+        OctreeNode& node = *nodes[i];
+        node.numStars = entry.numStars;
+
+        const size_t nBytes = entry.numStars * _valuesPerStar * sizeof(float);
+        if (entry.numStars > 0) {
+            if (entry.dataOffset % FlatFileAlignment != 0 ||
+                entry.dataOffset + nBytes > fileSize)
+            {
+                LERROR(fmt::format(
+                    "Corrupt data block in flat Octree file '{}'", filePath
+                ));
+                initOctree(_maxCpuRamBudget);
+                return 0;
+            }
+            node.mappedData = reinterpret_cast<const float*>(fileData + entry.dataOffset);
+        }
+
+        if (entry.firstChild == 0) {
+            // Only count stars in leaves, inner nodes hold copies of their LOD stars.
+            nStarsRead += static_cast<int>(entry.numStars);
+            continue;
+        }
+
+        if (entry.firstChild <= i || entry.firstChild + 8 > nodes.size()) {
+            LERROR(fmt::format("Corrupt node table in flat Octree file '{}'", filePath));
+            initOctree(_maxCpuRamBudget);
+            return 0;
+        }
+        createNodeChildren(node);
+        for (size_t j = 0; j < 8; ++j) {
+            nodes[entry.firstChild + j] = node.Children[j].get();
+        }
+    }
+    return nStarsRead;
+}
+
+void OctreeManager::writeNodeDataToFile(const std::string& outFilePath,
+                                        const std::vector<float>& nodeData)
+{
+    int32_t nDataSize = static_cast<int32_t>(nodeData.size());
+    size_t nBytes = nDataSize * sizeof(nodeData[0]);
+
+    // Only open output stream if we have any values to write.
+    if (nDataSize == 0) {
+        return;
+    }
+
+    std::ofstream outFileStream(outFilePath, std::ofstream::binary);
+    if (outFileStream.good()) {
+        outFileStream.write(reinterpret_cast<const char*>(&nDataSize), sizeof(int32_t));
+        outFileStream.write(reinterpret_cast<const char*>(nodeData.data()), nBytes);
+
+        outFileStream.close();
+    }
+    else {
+        LERROR(fmt::format("Error opening file: {} as output data file.", outFilePath));
+    }
+}
+
+unsigned long long OctreeManager::mortonCode(float posX, float posY, float posZ) const {
+    // Find the cell on the deepest level on every axis. The axes are flipped as the
+    // child index is increased for positions below the origin. Cells are closed towards
+    // the origin of their parents, as positions at the origin count as being above it.
+    const double nCells = static_cast<double>(1ULL << MAX_MORTON_DEPTH);
+    const double maxDist = static_cast<double>(MAX_DIST);
+    auto cell = [nCells, maxDist](float pos) {
+        const double flipped = (maxDist - pos) / (2.0 * maxDist);
+        const double c = std::ceil(flipped * nCells) - 1.0;
+        return static_cast<unsigned long long>(std::clamp(c, 0.0, nCells - 1.0));
+    };
+    const unsigned long long cellX = cell(posX);
+    const unsigned long long cellY = cell(posY);
+    const unsigned long long cellZ = cell(posZ);
+
+    // Interleave the cells into one child index per level, starting with the top level.
+    unsigned long long code = 0;
+    for (size_t level = 0; level < MAX_MORTON_DEPTH; ++level) {
+        const size_t bit = MAX_MORTON_DEPTH - 1 - level;
+        const unsigned long long childIndex = ((cellX >> bit) & 1) +
+                                              (((cellY >> bit) & 1) << 1) +
+                                              (((cellZ >> bit) & 1) << 2);
+        code = (code << 3) + childIndex;
+    }
+    return code;
+}
+
+size_t OctreeManager::branchIndex(unsigned long long mortonCode) const {
+    return static_cast<size_t>(mortonCode >> (3 * (MAX_MORTON_DEPTH - 1)));
+}
+
+size_t OctreeManager::buildBranchFromSortedStars(size_t branchIndex,
+                                      const std::function<bool(SortableStar&)>& nextStar,
+                                                 const std::string& outFolderPath)
+{
+    std::deque<SortableStar> pendingStars;
+    size_t nStars = 0;
+    buildNodeFromSortedStars(
+        *_root->Children[branchIndex],
+        1,
+        branchIndex,
+        pendingStars,
+        nextStar,
+        outFolderPath,
+        nStars
+    );
+
+    SortableStar star;
+    if (!pendingStars.empty() || nextStar(star)) {
+        LERROR(fmt::format(
+            "Stars for branch {} weren't sorted or belong to another branch", branchIndex
+        ));
+    }
+    return nStars;
+}
+
+std::vector<OctreeManager::SortableStar> OctreeManager::buildNodeFromSortedStars(
+                                                                   OctreeNode& node,
+                                                                       size_t depth,
+                                                           unsigned long long prefix,
+                                             std::deque<SortableStar>& pendingStars,
+                                 const std::function<bool(SortableStar&)>& nextStar,
+                                                    const std::string& outFolderPath,
+                                                                      size_t& nStars)
+{
+    const size_t shift = 3 * (MAX_MORTON_DEPTH - depth);
+
+    // Checks if the i:th pending star belongs to this node. Stars are only pulled from
+    // the sorted stream when they are needed, so at most one node worth of stars (plus
+    // one) is pending at any time.
+    auto isInNode = [&](size_t i) {
+        while (pendingStars.size() <= i) {
+            SortableStar star;
+            if (!nextStar(star)) {
+                return false;
+            }
+            pendingStars.push_back(star);
+        }
+        return (pendingStars[i].mortonCode >> shift) == prefix;
+    };
+
+    auto keepBrightestStars = [this](std::vector<SortableStar>& stars) {
+        // A lower magnitude means a brighter star.
+        if (stars.size() > MAX_STARS_PER_NODE) {
+            std::nth_element(
+                stars.begin(),
+                stars.begin() + MAX_STARS_PER_NODE,
+                stars.end(),
+                [this](const SortableStar& lhs, const SortableStar& rhs) {
+                    return lhs.values[POS_SIZE] < rhs.values[POS_SIZE];
+                }
+            );
+            stars.resize(MAX_STARS_PER_NODE);
+        }
+    };
+
+    size_t nNodeStars = 0;
+    while (nNodeStars <= MAX_STARS_PER_NODE && isInNode(nNodeStars)) {
+        nNodeStars++;
+    }
+
+    std::vector<SortableStar> stars;
+    if (nNodeStars <= MAX_STARS_PER_NODE || depth == MAX_MORTON_DEPTH) {
+        // All stars fit in a leaf.
+        while (isInNode(0)) {
+            stars.push_back(pendingStars.front());
+            pendingStars.pop_front();
+        }
+
+        // Only happens if a lot of stars are on top of each other or outside MAX_DIST.
+        if (stars.size() > MAX_STARS_PER_NODE) {
+            LWARNING(fmt::format(
+                "Discarding {} of the faintest stars in node {} at maximum depth",
+                stars.size() - MAX_STARS_PER_NODE, node.octreePositionIndex
+            ));
+            keepBrightestStars(stars);
+        }
+        nStars += stars.size();
+
+        size_t totalDepth = _totalDepth;
+        while (depth > totalDepth &&
+               !_totalDepth.compare_exchange_weak(totalDepth, depth)) {}
+    }
+    else {
+        // Build children in Morton order and keep the brightest of their stars as LOD.
+        createNodeChildren(node);
+        for (size_t i = 0; i < 8; ++i) {
+            std::vector<SortableStar> childStars = buildNodeFromSortedStars(
+                *node.Children[i],
+                depth + 1,
+                (prefix << 3) + i,
+                pendingStars,
+                nextStar,
+                outFolderPath,
+                nStars
+            );
+            stars.insert(stars.end(), childStars.begin(), childStars.end());
+            keepBrightestStars(stars);
+        }
+    }
+    node.numStars = stars.size();
+
+    // Write node data straight away, only the structure is kept in memory.
+    std::vector<float> nodeData(stars.size() * _valuesPerStar);
+    auto posIt = nodeData.begin();
+    auto colIt = posIt + stars.size() * POS_SIZE;
+    auto velIt = colIt + stars.size() * COL_SIZE;
+    for (const SortableStar& star : stars) {
+        auto posEnd = star.values.begin() + POS_SIZE;
+        auto colEnd = posEnd + COL_SIZE;
+        posIt = std::copy(star.values.begin(), posEnd, posIt);
+        colIt = std::copy(posEnd, colEnd, colIt);
+        velIt = std::copy(colEnd, star.values.end(), velIt);
+    }
+
+    // Remove root ID ("8") from index to get the name of the node file.
+    std::string posId = std::to_string(node.octreePositionIndex);
+    posId.erase(posId.begin());
+    writeNodeDataToFile(outFolderPath + posId + BINARY_SUFFIX, nodeData);
+
+    return stars;
+}
+
 void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
                                        int additionalLevelsToFetch)
 {
@@ -779,6 +1249,24 @@ void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
 }
 
 void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
+    if (_mappedFile) {
+        // The data is already addressable through the mapping, it only has to be paged
+        // in so that the render thread won't stall on it when it is uploaded.
+        const size_t nBytes = node.numStars * _valuesPerStar * sizeof(float);
+        const size_t offset = static_cast<size_t>(
+            reinterpret_cast<const char*>(node.mappedData) - _mappedFile->data()
+        );
+        _mappedFile->prefetch(offset, nBytes);
+
+        node.isLoaded = true;
+        if (!_datasetFitInMemory) {
+            std::lock_guard g(_leastRecentlyFetchedNodesMutex);
+            _leastRecentlyFetchedNodes.push(node.octreePositionIndex);
+        }
+        _cpuRamBudget -= nBytes;
+        return;
+    }
+
     // Remove root ID ("8") from index before loading file.
     std::string posId = std::to_string(node.octreePositionIndex);
     posId.erase(posId.begin());
@@ -867,6 +1355,14 @@ void OctreeManager::removeNode(OctreeNode& node) {
     node.colData.shrink_to_fit();
     node.velData.clear();
     node.velData.shrink_to_fit();
+
+    // Mapped data stays addressable, but its pages don't have to be kept resident.
+    if (_mappedFile && node.mappedData) {
+        const size_t offset = static_cast<size_t>(
+            reinterpret_cast<const char*>(node.mappedData) - _mappedFile->data()
+        );
+        _mappedFile->release(offset, static_cast<size_t>(nBytes));
+    }
 }
 
 void OctreeManager::propagateUnloadedNodes(
@@ -1078,6 +1574,182 @@ void OctreeManager::storeStarData(OctreeNode& node, const std::vector<float>& st
     node.velData.insert(node.velData.end(), colEnd, starValues.end());
 }
 
+void OctreeManager::insertBatchInNode(OctreeNode& node, StarBatch& batch,
+                                      StarBatch& scratch, std::vector<uint8_t>& octants,
+                                      size_t begin, size_t end, size_t depth)
+{
+    if (begin == end) {
+        return;
+    }
+
+    if (node.isLeaf) {
+        // Fill up the leaf first. A leaf never holds more than MAX_STARS_PER_NODE stars.
+        const size_t nFitting = std::min(end - begin, MAX_STARS_PER_NODE - node.numStars);
+        node.posData.reserve(MAX_STARS_PER_NODE * POS_SIZE);
+        node.colData.reserve(MAX_STARS_PER_NODE * COL_SIZE);
+        node.velData.reserve(MAX_STARS_PER_NODE * VEL_SIZE);
+        node.magOrder.reserve(MAX_STARS_PER_NODE);
+        for (size_t i = begin; i < begin + nFitting; ++i) {
+            storeBatchStar(node, batch, i);
+        }
+        begin += nFitting;
+
+        if (depth > _totalDepth) {
+            _totalDepth = depth;
+        }
+        if (begin == end) {
+            return;
+        }
+
+        // Too many stars in leaf node, subdivide into 8 new nodes.
+        // Create children and clean up parent.
+        createNodeChildren(node);
+
+        // Distribute stars from parent node into children.
+        StarBatch nodeBatch;
+        nodeBatch.reserve(node.numStars);
+        for (size_t n = 0; n < node.numStars; ++n) {
+            std::array<float, 8> starValues;
+            auto it = std::copy_n(node.posData.begin() + n * POS_SIZE, POS_SIZE,
+                starValues.begin());
+            it = std::copy_n(node.colData.begin() + n * COL_SIZE, COL_SIZE, it);
+            std::copy_n(node.velData.begin() + n * VEL_SIZE, VEL_SIZE, it);
+            nodeBatch.append(starValues.data());
+        }
+        StarBatch nodeScratch = nodeBatch;
+        std::vector<uint8_t> nodeOctants(nodeBatch.size());
+        const std::array<size_t, 9> nodeChildren = partitionBatch(
+            nodeBatch,
+            nodeScratch,
+            nodeOctants,
+            0,
+            nodeBatch.size(),
+            node.originX,
+            node.originY,
+            node.originZ
+        );
+        for (size_t i = 0; i < 8; ++i) {
+            insertBatchInNode(
+                *node.Children[i],
+                nodeBatch,
+                nodeScratch,
+                nodeOctants,
+                nodeChildren[i],
+                nodeChildren[i + 1],
+                depth
+            );
+        }
+
+        // Sort magnitudes in inner node.
+        // (The last value will be used as comparison for what to store in LOD cache.)
+        std::sort(node.magOrder.begin(), node.magOrder.end());
+    }
+
+    // Node is an inner node. Keep the stars that are brighter than the current LOD
+    // threshold in our LOD cache. The stars are compared in slices of at most
+    // MAX_STARS_PER_NODE stars, after which the LOD cache is trimmed and the threshold is
+    // raised, so that the cache grows as slowly as when inserting stars one by one.
+    const float* magnitudes = batch.values[POS_SIZE].data();
+    for (size_t sliceBegin = begin; sliceBegin < end; sliceBegin += MAX_STARS_PER_NODE) {
+        const size_t sliceEnd = std::min(end, sliceBegin + MAX_STARS_PER_NODE);
+        const float lodThreshold = node.magOrder[MAX_STARS_PER_NODE - 1].first;
+        const size_t nLodStars = node.magOrder.size();
+        for (size_t i = sliceBegin; i < sliceEnd; ++i) {
+            if (magnitudes[i] < lodThreshold) {
+                storeBatchStar(node, batch, i);
+            }
+        }
+
+        if (node.magOrder.size() > nLodStars) {
+            std::sort(node.magOrder.begin(), node.magOrder.end());
+            node.magOrder.resize(MAX_STARS_PER_NODE);
+        }
+    }
+
+    // Keep recursion going with the stars of every child.
+    const std::array<size_t, 9> children = partitionBatch(
+        batch,
+        scratch,
+        octants,
+        begin,
+        end,
+        node.originX,
+        node.originY,
+        node.originZ
+    );
+    for (size_t i = 0; i < 8; ++i) {
+        insertBatchInNode(
+            *node.Children[i],
+            batch,
+            scratch,
+            octants,
+            children[i],
+            children[i + 1],
+            depth + 1
+        );
+    }
+}
+
+std::array<size_t, 9> OctreeManager::partitionBatch(StarBatch& batch,
+                                                    StarBatch& scratch,
+                                                    std::vector<uint8_t>& octants,
+                                                    size_t begin, size_t end,
+                                                    float origX, float origY,
+                                                    float origZ)
+{
+    // Same as getChildIndex, but without branches so that the loop is vectorized.
+    const float* posX = batch.values[0].data();
+    const float* posY = batch.values[1].data();
+    const float* posZ = batch.values[2].data();
+    uint8_t* octant = octants.data();
+    for (size_t i = begin; i < end; ++i) {
+        octant[i] = static_cast<uint8_t>(
+            (posX[i] < origX) | ((posY[i] < origY) << 1) | ((posZ[i] < origZ) << 2)
+        );
+    }
+
+    std::array<size_t, 9> firstStars = {};
+    for (size_t i = begin; i < end; ++i) {
+        firstStars[octant[i] + 1]++;
+    }
+    firstStars[0] = begin;
+    for (size_t i = 1; i < firstStars.size(); ++i) {
+        firstStars[i] += firstStars[i - 1];
+    }
+
+    // Counting sort of one value array at a time, which keeps the order of the stars.
+    for (size_t v = 0; v < batch.values.size(); ++v) {
+        std::array<size_t, 8> next;
+        std::copy_n(firstStars.begin(), next.size(), next.begin());
+
+        const float* source = batch.values[v].data();
+        float* target = scratch.values[v].data();
+        for (size_t i = begin; i < end; ++i) {
+            target[next[octant[i]]++] = source[i];
+        }
+        std::copy(target + begin, target + end, batch.values[v].data() + begin);
+    }
+    return firstStars;
+}
+
+void OctreeManager::storeBatchStar(OctreeNode& node, const StarBatch& batch,
+                                   size_t index)
+{
+    node.magOrder.emplace_back(batch.values[POS_SIZE][index], node.numStars);
+    node.numStars++;
+
+    size_t v = 0;
+    for (; v < POS_SIZE; ++v) {
+        node.posData.push_back(batch.values[v][index]);
+    }
+    for (; v < POS_SIZE + COL_SIZE; ++v) {
+        node.colData.push_back(batch.values[v][index]);
+    }
+    for (; v < POS_SIZE + COL_SIZE + VEL_SIZE; ++v) {
+        node.velData.push_back(batch.values[v][index]);
+    }
+}
+
 std::string OctreeManager::printStarsPerNode(const OctreeNode& node,
                                              const std::string& prefix) const
 {
@@ -1293,6 +1965,21 @@ void OctreeManager::clearNodeData(OctreeNode& node) {
     }
 }
 
+void OctreeManager::updateRootChildrenDimensions() {
+    for (size_t i = 0; i < 8; ++i) {
+        _root->Children[i]->halfDimension = MAX_DIST / 2.f;
+        _root->Children[i]->originX = (i % 2 == 0) ?
+            _root->Children[i]->halfDimension :
+            -_root->Children[i]->halfDimension;
+        _root->Children[i]->originY = (i % 4 < 2) ?
+            _root->Children[i]->halfDimension :
+            -_root->Children[i]->halfDimension;
+        _root->Children[i]->originZ = (i < 4) ?
+            _root->Children[i]->halfDimension :
+            -_root->Children[i]->halfDimension;
+    }
+}
+
 void OctreeManager::createNodeChildren(OctreeNode& node) {
     for (size_t i = 0; i < 8; ++i) {
         _numLeafNodes++;
@@ -1370,19 +2057,35 @@ std::vector<float> OctreeManager::constructInsertData(const OctreeNode& node,
         return std::vector<float>();
     }
 
+    // Data of mapped nodes is read directly from the mapped file.
+    const float* posBegin = node.posData.data();
+    const float* posEnd = posBegin + node.posData.size();
+    const float* colBegin = node.colData.data();
+    const float* colEnd = colBegin + node.colData.size();
+    const float* velBegin = node.velData.data();
+    const float* velEnd = velBegin + node.velData.size();
+    if (node.mappedData) {
+        posBegin = node.mappedData;
+        posEnd = posBegin + node.numStars * POS_SIZE;
+        colBegin = posEnd;
+        colEnd = colBegin + node.numStars * COL_SIZE;
+        velBegin = colEnd;
+        velEnd = velBegin + node.numStars * VEL_SIZE;
+    }
+
     // Fill chunk by appending zeroes to data so we overwrite possible earlier values.
     // And more importantly so our attribute pointers knows where to read!
-    auto insertData = std::vector<float>(node.posData.begin(), node.posData.end());
+    auto insertData = std::vector<float>(posBegin, posEnd);
     if (_useVBO) {
         insertData.resize(POS_SIZE * MAX_STARS_PER_NODE, 0.f);
     }
     if (option != gaia::RenderOption::Static) {
-        insertData.insert(insertData.end(), node.colData.begin(), node.colData.end());
+        insertData.insert(insertData.end(), colBegin, colEnd);
         if (_useVBO) {
             insertData.resize((POS_SIZE + COL_SIZE) * MAX_STARS_PER_NODE, 0.f);
         }
         if (option == gaia::RenderOption::Motion) {
-            insertData.insert(insertData.end(), node.velData.begin(), node.velData.end());
+            insertData.insert(insertData.end(), velBegin, velEnd);
             if (_useVBO) {
                 insertData.resize(
                     (POS_SIZE + COL_SIZE + VEL_SIZE) * MAX_STARS_PER_NODE, 0.f
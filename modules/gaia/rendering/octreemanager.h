@@ -26,9 +26,16 @@
 #define __OPENSPACE_MODULE_GAIA___OCTREEMANAGER___H__
 
 #include <modules/gaia/rendering/gaiaoptions.h>
+#include <openspace/util/memorymappedfile.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <stack>
@@ -57,6 +64,44 @@ public:
         std::mutex loadingLock;
         int bufferIndex;
         unsigned long long octreePositionIndex;
+        // Star data of the node in a memory-mapped flat Octree file, in which case the
+        // data vectors above are left empty. Positions, colors and velocities follow
+        // each other in the same way as in the node files
+        const float* mappedData = nullptr;
+    };
+
+    /**
+     * A star with its render values together with the Morton code of its position.
+     */
+    struct SortableStar {
+        unsigned long long mortonCode;
+        std::array<float, 8> values;
+    };
+
+    /**
+     * A batch of stars in columnar form. Every render value of a star (position x, y, z,
+     * absolute magnitude, color, velocity x, y, z) is stored in its own array, which
+     * lets <code>insertBatch()</code> process many stars at once with vectorized loops.
+     */
+    struct StarBatch {
+        StarBatch() = default;
+
+        /**
+         * Creates a batch from \param nStars stars in \param data, in which all values
+         * of a star are stored after each other. Only the first 8 of the
+         * \param valuesPerStar values of every star are used.
+         */
+        StarBatch(const float* data, size_t nStars, size_t valuesPerStar);
+
+        /**
+         * Appends a star with the 8 render values starting at \param starValues.
+         */
+        void append(const float* starValues);
+
+        void reserve(size_t nStars);
+        size_t size() const;
+
+        std::array<std::vector<float>, 8> values;
     };
 
     OctreeManager() = default;
@@ -85,6 +130,14 @@ public:
      */
     void insert(const std::vector<float>& starValues);
 
+    /**
+     * Inserts all stars in \param batch into the Octree. This gives the same Octree as
+     * inserting the stars one by one with <code>insert()</code>, but every node is only
+     * visited once per batch, stars are partitioned into the children of a node all at
+     * once, and the buffers of a leaf are only allocated once.
+     */
+    void insertBatch(StarBatch batch);
+
     /**
      * Slices LOD data so only the MAX_STARS_PER_NODE brightest stars are stored in inner
      * nodes. If \p branchIndex is defined then only that branch will be sliced.
@@ -158,6 +211,54 @@ public:
      */
     void writeToMultipleFiles(const std::string& outFolderPath, size_t branchIndex);
 
+    /**
+     * Writes the Octree to a single flat file at \param outFilePath. All nodes are stored
+     * in breadth-first order in a table, followed by the data of every node in a block
+     * that is aligned to 64 bytes. If \param nodeFolderPath is set, the node data is read
+     * from the node files that <code>writeToMultipleFiles</code> wrote into that folder,
+     * otherwise the data that is held in memory is written.
+     * \returns false if the file couldn't be written.
+     */
+    bool writeToFlatFile(const std::string& outFilePath,
+        const std::string& nodeFolderPath = std::string());
+
+    /**
+     * Memory-maps a flat Octree file written by <code>writeToFlatFile</code> and
+     * constructs the Octree structure from its node table. No data is copied, instead
+     * the nodes are streamed by paging in their blocks of the mapped file.
+     * \returns the total number of stars in the Octree.
+     */
+    int readFromFlatFile(const std::string& filePath);
+
+    /**
+     * \returns the Morton code of the deepest possible node that contains the position
+     * (\param posX, \param posY, \param posZ). Sorting stars by their Morton codes
+     * orders them in the same way as a pre-order traversal of the Octree visits them,
+     * i.e. the stars of every node are contiguous. Positions outside of MAX_DIST are
+     * clamped to the border nodes.
+     */
+    unsigned long long mortonCode(float posX, float posY, float posZ) const;
+
+    /**
+     * \returns the index of the branch that contains the node with \param mortonCode.
+     */
+    size_t branchIndex(unsigned long long mortonCode) const;
+
+    /**
+     * Builds branch \param branchIndex bottom-up from stars that are sorted by their
+     * Morton code. The stars are pulled from \param nextStar until it returns false. A
+     * node becomes a leaf if it contains at most MAX_STARS_PER_NODE stars, and every
+     * inner node stores the MAX_STARS_PER_NODE brightest stars of all its descendants
+     * as LOD cache. The data of every node is written to \param outFolderPath in the
+     * same way as <code>writeToMultipleFiles</code> does, as soon as the node is done,
+     * so only the structure of the branch is kept in memory. Different branches may be
+     * built concurrently.
+     * \returns the number of stars that were stored in the branch.
+     */
+    size_t buildBranchFromSortedStars(size_t branchIndex,
+        const std::function<bool(SortableStar&)>& nextStar,
+        const std::string& outFolderPath);
+
     /**
      * Getters.
      */
@@ -196,6 +297,10 @@ private:
     size_t MAX_DIST = 2; // [kPc]
     size_t MAX_STARS_PER_NODE = 2000;
 
+    // The number of levels (including the top level) that Morton codes can address.
+    // Deeper nodes would overflow their octreePositionIndex.
+    const size_t MAX_MORTON_DEPTH = 18;
+
     const int DEFAULT_INDEX = -1;
     const std::string BINARY_SUFFIX = ".bin";
 
@@ -215,6 +320,32 @@ private:
     bool insertInNode(OctreeNode& node, const std::vector<float>& starValues,
         int depth = 1);
 
+    /**
+     * Private help function for <code>insertBatch()</code>. Inserts the stars in range
+     * [\param begin, \param end) of \param batch into \param node in the same way as
+     * <code>insertInNode()</code> does, and the rest of the stars into the children of
+     * an inner node. \param scratch and \param octants are used to partition stars.
+     */
+    void insertBatchInNode(OctreeNode& node, StarBatch& batch, StarBatch& scratch,
+        std::vector<uint8_t>& octants, size_t begin, size_t end, size_t depth);
+
+    /**
+     * Sorts the stars in range [\param begin, \param end) of \param batch by the index
+     * of the child node that they belong to, relative to the origin (\param origX,
+     * \param origY, \param origZ). The order of stars in the same child is kept.
+     * \returns the first star of every child, and \param end.
+     */
+    std::array<size_t, 9> partitionBatch(StarBatch& batch, StarBatch& scratch,
+        std::vector<uint8_t>& octants, size_t begin, size_t end, float origX,
+        float origY, float origZ);
+
+    /**
+     * Private help function for <code>insertBatchInNode()</code>. Appends star
+     * \param index of \param batch to the node data in the same way as
+     * <code>storeStarData()</code> does, except for trimming the LOD order.
+     */
+    void storeBatchStar(OctreeNode& node, const StarBatch& batch, size_t index);
+
     /**
      * Slices LOD cache data in node to the MAX_STARS_PER_NODE brightest stars. This needs
      * to be called after the last star has been inserted into Octree but before it is
@@ -309,6 +440,25 @@ private:
     void writeNodeToMultipleFiles(const std::string& outFilePrefix, OctreeNode& node,
         bool threadWrites);
 
+    /**
+     * Write \param nodeData (positions, followed by colors and velocities) of one node
+     * to a file at \param outFilePath. Nothing is written if there is no data.
+     */
+    void writeNodeDataToFile(const std::string& outFilePath,
+        const std::vector<float>& nodeData);
+
+    /**
+     * Builds \param node at level \param depth from all stars whose Morton code starts
+     * with \param prefix. The stars are taken from \param pendingStars, which is
+     * refilled from \param nextStar, see <code>buildBranchFromSortedStars</code>.
+     * \param nStars is increased by the number of stars stored in leaves.
+     * \returns the MAX_STARS_PER_NODE brightest stars of the node and its descendants.
+     */
+    std::vector<SortableStar> buildNodeFromSortedStars(OctreeNode& node, size_t depth,
+        unsigned long long prefix, std::deque<SortableStar>& pendingStars,
+        const std::function<bool(SortableStar&)>& nextStar,
+        const std::string& outFolderPath, size_t& nStars);
+
     /**
      * Finds the neighboring node on the same level (or a higher level if there is no
      * corresponding level) in the specified direction. Also fetches data from found node
@@ -355,6 +505,11 @@ private:
      */
     void propagateUnloadedNodes(std::vector<std::shared_ptr<OctreeNode>> ancestorNodes);
 
+    /**
+     * Updates the dimensions of the top level nodes after MAX_DIST has changed.
+     */
+    void updateRootChildrenDimensions();
+
     std::shared_ptr<OctreeNode> _root;
     std::unique_ptr<OctreeCuller> _culler;
     std::stack<int> _freeSpotsInBuffer;
@@ -362,9 +517,10 @@ private:
     std::queue<unsigned long long> _leastRecentlyFetchedNodes;
     std::mutex _leastRecentlyFetchedNodesMutex;
 
-    size_t _totalDepth = 0;
-    size_t _numLeafNodes = 0;
-    size_t _numInnerNodes = 0;
+    // Atomic, as branches can be built concurrently
+    std::atomic<size_t> _totalDepth = 0;
+    std::atomic<size_t> _numLeafNodes = 0;
+    std::atomic<size_t> _numInnerNodes = 0;
     size_t _biggestChunkIndexInUse = 0;
     size_t _valuesPerStar = 0;
     float _minTotalPixelsLod = 0.f;
@@ -378,6 +534,7 @@ private:
     long long _maxCpuRamBudget = 0;
     unsigned long long _parentNodeOfCamera = 8;
     std::string _streamFolderPath;
+    std::unique_ptr<MemoryMappedFile> _mappedFile;
     size_t _traversedBranchesInRenderCall = 0;
 
 }; // class OctreeManager
@@ -70,7 +70,8 @@ namespace {
         "data, construct an Octree and render it. 'BinaryOctree' will read a constructed "
         "Octree from binary file and render full data. 'StreamOctree' will read an index "
         "file with full Octree structure and then stream nodes during runtime. (This "
-        "option is suited for bigger datasets.)"
+        "option is suited for bigger datasets.) 'MappedOctree' will memory-map a flat "
+        "Octree file and stream nodes directly from the mapping during runtime."
     };
 
     constexpr openspace::properties::Property::PropertyInfo RenderOptionInfo = {
@@ -324,7 +325,8 @@ documentation::Documentation RenderableGaiaStars::Documentation() {
             {
                 FileReaderOptionInfo.identifier,
                 new StringInListVerifier({
-                    "Fits", "Speck", "BinaryRaw", "BinaryOctree", "StreamOctree"
+                    "Fits", "Speck", "BinaryRaw", "BinaryOctree", "StreamOctree",
+                    "MappedOctree"
                 }),
                 Optional::No,
                 FileReaderOptionInfo.description
@@ -559,7 +561,8 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
         { gaia::FileReaderOption::Speck, "Speck" },
         { gaia::FileReaderOption::BinaryRaw, "BinaryRaw" },
         { gaia::FileReaderOption::BinaryOctree, "BinaryOctree" },
-        { gaia::FileReaderOption::StreamOctree, "StreamOctree" }
+        { gaia::FileReaderOption::StreamOctree, "StreamOctree" },
+        { gaia::FileReaderOption::MappedOctree, "MappedOctree" }
     });
     if (dictionary.hasKey(FileReaderOptionInfo.identifier)) {
         const std::string fileReaderOption = dictionary.value<std::string>(
@@ -577,6 +580,9 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
         else if (fileReaderOption == "BinaryOctree") {
             _fileReaderOption = gaia::FileReaderOption::BinaryOctree;
         }
+        else if (fileReaderOption == "MappedOctree") {
+            _fileReaderOption = gaia::FileReaderOption::MappedOctree;
+        }
         else {
             _fileReaderOption = gaia::FileReaderOption::StreamOctree;
         }
@@ -1164,7 +1170,9 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
 
     // Update which nodes that are stored in memory as the camera moves around
     // (if streaming)
-    if (_fileReaderOption == gaia::FileReaderOption::StreamOctree) {
+    if (_fileReaderOption == gaia::FileReaderOption::StreamOctree ||
+        _fileReaderOption == gaia::FileReaderOption::MappedOctree)
+    {
         glm::dvec3 cameraPos = data.camera.positionVec3();
         size_t chunkSizeBytes = _chunkSize * sizeof(GLfloat);
         _octreeManager.fetchSurroundingNodes(cameraPos, chunkSizeBytes, _additionalNodes);
@@ -2387,6 +2395,10 @@ bool RenderableGaiaStars::readDataFile() {
             // Read Octree structure from file, without data.
             nReadStars = readBinaryOctreeStructureFile(_filePath);
             break;
+        case gaia::FileReaderOption::MappedOctree:
+            // Map flat Octree file, data is paged in when nodes are streamed.
+            nReadStars = _octreeManager.readFromFlatFile(_filePath);
+            break;
         default:
             LERROR("Wrong FileReaderOption - no data file loaded!");
             break;
@@ -2413,13 +2425,10 @@ int RenderableGaiaStars::readFitsFile(const std::string& filePath) {
     );
 
     // Insert stars into octree.
-    for (size_t i = 0; i < fullData.size(); i += nReadValuesPerStar) {
-        auto first = fullData.begin() + i;
-        auto last = fullData.begin() + i + nReadValuesPerStar;
-        std::vector<float> starValues(first, last);
-
-        _octreeManager.insert(starValues);
-    }
+    const size_t nStars = fullData.size() / nReadValuesPerStar;
+    _octreeManager.insertBatch(
+        OctreeManager::StarBatch(fullData.data(), nStars, nReadValuesPerStar)
+    );
     _octreeManager.sliceLodData();
     return static_cast<int>(fullData.size() / nReadValuesPerStar);
 }
@@ -2431,13 +2440,10 @@ int RenderableGaiaStars::readSpeckFile(const std::string& filePath) {
     std::vector<float> fullData = fileReader.readSpeckFile(filePath, nReadValuesPerStar);
 
     // Insert stars into octree.
-    for (size_t i = 0; i < fullData.size(); i += nReadValuesPerStar) {
-        auto first = fullData.begin() + i;
-        auto last = fullData.begin() + i + nReadValuesPerStar;
-        std::vector<float> starValues(first, last);
-
-        _octreeManager.insert(starValues);
-    }
+    const size_t nStars = fullData.size() / nReadValuesPerStar;
+    _octreeManager.insertBatch(
+        OctreeManager::StarBatch(fullData.data(), nStars, nReadValuesPerStar)
+    );
     _octreeManager.sliceLodData();
     return static_cast<int>(fullData.size() / nReadValuesPerStar);
 }
@@ -2450,7 +2456,6 @@ int RenderableGaiaStars::readBinaryRawFile(const std::string& filePath) {
     if (fileStream.good()) {
         int32_t nValues = 0;
         int32_t nReadValuesPerStar = 0;
-        int renderValues = 8;
         fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
         fileStream.read(reinterpret_cast<char*>(&nReadValuesPerStar), sizeof(int32_t));
 
@@ -2461,13 +2466,10 @@ int RenderableGaiaStars::readBinaryRawFile(const std::string& filePath) {
         );
 
         // Insert stars into octree.
-        for (size_t i = 0; i < fullData.size(); i += nReadValuesPerStar) {
-            auto first = fullData.begin() + i;
-            auto last = fullData.begin() + i + renderValues;
-            std::vector<float> starValues(first, last);
-
-            _octreeManager.insert(starValues);
-        }
+        const size_t nStars = fullData.size() / nReadValuesPerStar;
+        _octreeManager.insertBatch(
+            OctreeManager::StarBatch(fullData.data(), nStars, nReadValuesPerStar)
+        );
         _octreeManager.sliceLodData();
 
         nReadStars = nValues / nReadValuesPerStar;
@@ -26,13 +26,18 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/directory.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <fstream>
-#include <thread>
+#include <queue>
 
 namespace {
     constexpr const char* KeyInFileOrFolderPath = "InFileOrFolderPath";
@@ -40,6 +45,10 @@ namespace {
     constexpr const char* KeyMaxDist = "MaxDist";
     constexpr const char* KeyMaxStarsPerNode = "MaxStarsPerNode";
     constexpr const char* KeySingleFileInput = "SingleFileInput";
+    constexpr const char* KeyFlatOutput = "FlatOutput";
+    constexpr const char* KeyScratchFolderPath = "ScratchFolderPath";
+    constexpr const char* KeyStarsPerRun = "StarsPerRun";
+    constexpr const char* FlatFileName = "octree.flat";
 
     constexpr const char* KeyFilterPosX = "FilterPosX";
     constexpr const char* KeyFilterPosY = "FilterPosY";
@@ -67,6 +76,109 @@ namespace {
     constexpr const char* KeyFilterRvError = "FilterRvError";
 
     constexpr const char* _loggerCat = "ConstructOctreeTask";
+
+    using SortableStar = openspace::OctreeManager::SortableStar;
+
+    // Sorts the stars by their Morton code and writes them to a run file.
+    bool writeRun(std::vector<SortableStar>& stars, const std::string& runFilePath) {
+        std::sort(
+            stars.begin(),
+            stars.end(),
+            [](const SortableStar& lhs, const SortableStar& rhs) {
+                return lhs.mortonCode < rhs.mortonCode;
+            }
+        );
+
+        std::ofstream runFileStream(runFilePath, std::ofstream::binary);
+        runFileStream.write(
+            reinterpret_cast<const char*>(stars.data()),
+            stars.size() * sizeof(SortableStar)
+        );
+        if (!runFileStream.good()) {
+            LERROR(fmt::format("Error writing run file: {}", runFilePath));
+            return false;
+        }
+        return true;
+    }
+
+    // Merges sorted run files into a single stream of sorted stars. If a run file can't
+    // be opened or read, no more stars are returned and the merger becomes invalid.
+    class RunMerger {
+    public:
+        explicit RunMerger(const std::vector<std::string>& runFilePaths)
+            : _runs(runFilePaths.size())
+        {
+            for (size_t i = 0; i < runFilePaths.size(); ++i) {
+                _runs[i].path = runFilePaths[i];
+                _runs[i].stream.open(runFilePaths[i], std::ifstream::binary);
+                if (!_runs[i].stream.is_open()) {
+                    LERROR(fmt::format("Error opening run file: {}", runFilePaths[i]));
+                    _isValid = false;
+                    return;
+                }
+                if (refill(_runs[i])) {
+                    _heap.emplace(_runs[i].stars.front().mortonCode, i);
+                }
+                else if (!_isValid) {
+                    return;
+                }
+            }
+        }
+
+        bool isValid() const {
+            return _isValid;
+        }
+
+        bool next(SortableStar& star) {
+            if (_heap.empty() || !_isValid) {
+                return false;
+            }
+            Run& run = _runs[_heap.top().second];
+            _heap.pop();
+
+            star = run.stars[run.position++];
+            if (run.position < run.stars.size() || refill(run)) {
+                _heap.emplace(run.stars[run.position].mortonCode, &run - _runs.data());
+            }
+            return true;
+        }
+
+    private:
+        struct Run {
+            std::string path;
+            std::ifstream stream;
+            std::vector<SortableStar> stars;
+            size_t position = 0;
+        };
+
+        bool refill(Run& run) {
+            constexpr const size_t StarsPerRead = 1 << 14;
+            run.stars.resize(StarsPerRead);
+            run.stream.read(
+                reinterpret_cast<char*>(run.stars.data()),
+                StarsPerRead * sizeof(SortableStar)
+            );
+            if (run.stream.bad()) {
+                LERROR(fmt::format("Error reading run file: {}", run.path));
+                _isValid = false;
+                return false;
+            }
+            run.stars.resize(
+                static_cast<size_t>(run.stream.gcount()) / sizeof(SortableStar)
+            );
+            run.position = 0;
+            return !run.stars.empty();
+        }
+
+        std::vector<Run> _runs;
+        bool _isValid = true;
+        // Morton code of the next star of every run that has any stars left.
+        std::priority_queue<
+            std::pair<unsigned long long, size_t>,
+            std::vector<std::pair<unsigned long long, size_t>>,
+            std::greater<>
+        > _heap;
+    };
 } // namespace
 
 namespace openspace {
@@ -93,6 +205,21 @@ ConstructOctreeTask::ConstructOctreeTask(const ghoul::Dictionary& dictionary) {
         _singleFileInput = dictionary.value<bool>(KeySingleFileInput);
     }
 
+    if (dictionary.hasKey(KeyFlatOutput)) {
+        _flatOutput = dictionary.value<bool>(KeyFlatOutput);
+    }
+
+    if (dictionary.hasKey(KeyScratchFolderPath)) {
+        _scratchFolderPath = absPath(dictionary.value<std::string>(KeyScratchFolderPath));
+    }
+    else {
+        _scratchFolderPath = _outFileOrFolderPath + "scratch/";
+    }
+
+    if (dictionary.hasKey(KeyStarsPerRun)) {
+        _starsPerRun = static_cast<int>(dictionary.value<double>(KeyStarsPerRun));
+    }
+
     _octreeManager = std::make_shared<OctreeManager>();
     _indexOctreeManager = std::make_shared<OctreeManager>();
 
@@ -286,11 +413,12 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
         LINFO("Constructing Octree.");
 
         // Insert star into octree. We assume the data already is in correct order.
+        OctreeManager::StarBatch batch;
+        batch.reserve(nTotalStars);
+        std::vector<float> filterValues(nValuesPerStar);
         for (size_t i = 0; i < fullData.size(); i += nValuesPerStar) {
             auto first = fullData.begin() + i;
-            auto last = fullData.begin() + i + nValuesPerStar;
-            std::vector<float> filterValues(first, last);
-            std::vector<float> renderValues(first, first + RENDER_VALUES);
+            std::copy(first, first + nValuesPerStar, filterValues.begin());
 
             // Filter data by parameters.
             if (checkAllFilters(filterValues)) {
@@ -298,9 +426,10 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
                 continue;
             }
 
-            // If all filters passed then insert render values into Octree.
-            _octreeManager->insert(renderValues);
+            // If all filters passed then add render values to the batch.
+            batch.append(&fullData[i]);
         }
+        _octreeManager->insertBatch(std::move(batch));
         inFileStream.close();
     }
     else {
@@ -315,6 +444,14 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
     _octreeManager->sliceLodData();
 
     LINFO("Writing octree to: " + _outFileOrFolderPath);
+    if (_flatOutput) {
+        if (nValues == 0) {
+            LERROR("Error writing file - No values were read from file.");
+        }
+        _octreeManager->writeToFlatFile(_outFileOrFolderPath);
+        return;
+    }
+
     std::ofstream outFileStream(_outFileOrFolderPath, std::ofstream::binary);
     if (outFileStream.good()) {
         if (nValues == 0) {
@@ -334,129 +471,125 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
 void ConstructOctreeTask::constructOctreeFromFolder(
                                            const Task::ProgressCallback& progressCallback)
 {
-    int32_t nStars = 0;
-    int32_t nValuesPerStar = 0;
-    size_t nFilteredStars = 0;
-    //float maxRadius = 0.0;
-    //int starsOutside10 = 0;
-    //int starsOutside25 = 0;
-    //int starsOutside50 = 0;
-    //int starsOutside75 = 0;
-    //int starsOutside100 = 0;
-    //int starsOutside200 = 0;
-    //int starsOutside300 = 0;
-    //int starsOutside400 = 0;
-    //int starsOutside500 = 0;
-    //int starsOutside750 = 0;
-    //int starsOutside1000 = 0;
-    //int starsOutside1500 = 0;
-    //int starsOutside2000 = 0;
-    //int starsOutside5000 = 0;
-
     ghoul::filesystem::Directory currentDir(_inFileOrFolderPath);
     std::vector<std::string> allInputFiles = currentDir.readFiles();
-    std::vector<float> filterValues;
-    auto writeThreads = std::vector<std::thread>(8);
 
     _indexOctreeManager->initOctree(0, _maxDist, _maxStarsPerNode);
 
-    float processOneFile = 1.f / allInputFiles.size();
-
     LINFO(fmt::format(
         "MAX DIST: {} - MAX STARS PER NODE: {}",
         _indexOctreeManager->maxDist(), _indexOctreeManager->maxStarsPerNode()
     ));
 
-    for (size_t idx = 0; idx < allInputFiles.size(); ++idx) {
-        std::string inFilePath = allInputFiles[idx];
-        int nStarsInfile = 0;
-
-        LINFO("Reading data file: " + inFilePath);
+    const bool createScratchFolder = !FileSys.directoryExists(_scratchFolderPath);
+    if (createScratchFolder) {
+        FileSys.createDirectory(
+            _scratchFolderPath,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
 
-        std::ifstream inFileStream(inFilePath, std::ifstream::binary);
-        if (inFileStream.good()) {
-            inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
-            filterValues.resize(nValuesPerStar, 0.f);
+    // Read, filter and sort all files in parallel. Each file is split into sorted runs
+    // that are spilled to the scratch folder.
+    LINFO(fmt::format("Sorting {} files into runs", allInputFiles.size()));
+    std::vector<SortedRuns> sortedRuns(allInputFiles.size());
+    {
+        TaskGroup readTasks(global::taskScheduler);
+        for (size_t idx = 0; idx < allInputFiles.size(); ++idx) {
+            readTasks.run([this, &allInputFiles, &sortedRuns, idx]() {
+                sortedRuns[idx] = sortFileIntoRuns(allInputFiles[idx], idx);
+            });
+        }
+        readTasks.wait();
+    }
+    progressCallback(0.5f);
 
-            while (inFileStream.read(
-                reinterpret_cast<char*>(filterValues.data()),
-                nValuesPerStar * sizeof(filterValues[0])
-            ))
-            {
-                // Filter data by parameters.
-                if (checkAllFilters(filterValues)) {
-                    nFilteredStars++;
-                    continue;
-                }
-                // Generate a 50/12,5 dataset (gMag <=13/>13).
-                //if ((filterStar(glm::vec2(20.0), filterValues[3], 20.f)) ||
-                //    (filterStar(glm::vec2(0.0), filterValues[16])) ||
-                //    (filterValues[3] > 13.0 && filterValues[17] > 0.125) ||
-                //    (filterValues[3] <= 13.0 && filterValues[17] > 0.5)) {
-                //    nFilteredStars++;
-                //    continue;
-                //}
-
-                // If all filters passed then insert render values into Octree.
-                std::vector<float> renderValues(
-                    filterValues.begin(),
-                    filterValues.begin() + RENDER_VALUES
-                );
+    size_t nStars = 0;
+    size_t nFilteredStars = 0;
+    std::string failedRunFile;
+    std::array<std::vector<std::string>, 8> branchRunFiles;
+    for (const SortedRuns& runs : sortedRuns) {
+        nStars += runs.nStars;
+        nFilteredStars += runs.nFilteredStars;
+        if (failedRunFile.empty()) {
+            failedRunFile = runs.failedRunFile;
+        }
+        for (size_t branch = 0; branch < 8; ++branch) {
+            branchRunFiles[branch].insert(
+                branchRunFiles[branch].end(),
+                runs.runFiles[branch].begin(),
+                runs.runFiles[branch].end()
+            );
+        }
+    }
 
-                _indexOctreeManager->insert(renderValues);
-                nStarsInfile++;
-
-                //float maxVal = fmax(fmax(fabs(renderValues[0]), fabs(renderValues[1])),
-                //    fabs(renderValues[2]));
-                //if (maxVal > maxRadius) maxRadius = maxVal;
-                //// Calculate how many stars are outside of different thresholds.
-                //if (maxVal > 10) starsOutside10++;
-                //if (maxVal > 25) starsOutside25++;
-                //if (maxVal > 50) starsOutside50++;
-                //if (maxVal > 75) starsOutside75++;
-                //if (maxVal > 100) starsOutside100++;
-                //if (maxVal > 200) starsOutside200++;
-                //if (maxVal > 300) starsOutside300++;
-                //if (maxVal > 400) starsOutside400++;
-                //if (maxVal > 500) starsOutside500++;
-                //if (maxVal > 750) starsOutside750++;
-                //if (maxVal > 1000) starsOutside1000++;
-                //if (maxVal > 1500) starsOutside1500++;
-                //if (maxVal > 2000) starsOutside2000++;
-                //if (maxVal > 5000) starsOutside5000++;
+    // The run files are only needed until the branches are built
+    auto removeScratchFiles = [this, &branchRunFiles, createScratchFolder]() {
+        for (const std::vector<std::string>& runFiles : branchRunFiles) {
+            for (const std::string& runFile : runFiles) {
+                std::remove(runFile.c_str());
             }
-            inFileStream.close();
         }
-        else {
-            LERROR(fmt::format(
-                "Error opening file '{}' for loading preprocessed file!", inFilePath
-            ));
+        if (createScratchFolder) {
+            FileSys.deleteDirectory(_scratchFolderPath);
         }
+    };
+
+    if (!failedRunFile.empty()) {
+        LERROR(fmt::format(
+            "Failed to construct Octree in {} since run file {} could not be written",
+            _outFileOrFolderPath, failedRunFile
+        ));
+        removeScratchFiles();
+        return;
+    }
 
-        // Slice LOD data.
-        LINFO("Slicing LOD data!");
-        _indexOctreeManager->sliceLodData(idx);
+    // Merge the runs of every branch and build the branches in parallel. The node files
+    // are written while the branches are built.
+    LINFO("Building Octree from sorted runs");
+    std::array<size_t, 8> nBranchStars = {};
+    std::atomic_bool hasMissingRuns = false;
+    {
+        TaskGroup buildTasks(global::taskScheduler);
+        for (size_t branch = 0; branch < 8; ++branch) {
+            buildTasks.run([this, &branchRunFiles, &nBranchStars, &hasMissingRuns,
+                            branch]()
+            {
+                RunMerger merger(branchRunFiles[branch]);
+                if (!merger.isValid()) {
+                    hasMissingRuns = true;
+                    return;
+                }
+                nBranchStars[branch] = _indexOctreeManager->buildBranchFromSortedStars(
+                    branch,
+                    [&merger](OctreeManager::SortableStar& star) {
+                        return merger.next(star);
+                    },
+                    _outFileOrFolderPath
+                );
+                if (!merger.isValid()) {
+                    hasMissingRuns = true;
+                }
+            });
+        }
+        buildTasks.wait();
+    }
+    progressCallback(0.9f);
 
-        progressCallback((idx + 1) * processOneFile);
-        nStars += nStarsInfile;
+    removeScratchFiles();
 
-        LINFO(fmt::format("Writing {} stars to octree files!", nStarsInfile));
-        LINFO(fmt::format(
-            "Number leaf nodes: {}\n Number inner nodes: {}\n Total depth of tree: {}",
-            _indexOctreeManager->numLeafNodes(),
-            _indexOctreeManager->numInnerNodes(),
-            _indexOctreeManager->totalDepth()
+    if (hasMissingRuns) {
+        // Without all runs the Octree would silently lack stars, so no index is written
+        LERROR(fmt::format(
+            "Failed to construct Octree in {} since sorted runs could not be read",
+            _outFileOrFolderPath
         ));
+        return;
+    }
 
-        // Write to 8 separate files in a separate thread. Data will be cleared after it
-        // has been written. Store joinable thread for later sync.
-        std::thread t(
-            &OctreeManager::writeToMultipleFiles,
-            _indexOctreeManager,
-            _outFileOrFolderPath,
-            idx
-        );
-        writeThreads[idx] = std::move(t);
+    size_t nStoredStars = 0;
+    for (size_t n : nBranchStars) {
+        nStoredStars += n;
     }
 
     LINFO(fmt::format(
@@ -464,23 +597,17 @@ void ConstructOctreeTask::constructOctreeFromFolder(
         nStars, _indexOctreeManager->totalNodes()
     ));
     LINFO(std::to_string(nFilteredStars) + " stars were filtered");
-
-    //LINFO("Max radius of dataset is: " + std::to_string(maxRadius) +
-    //    "\n Number of stars outside of:" +
-    //    " - 10kPc is " + std::to_string(starsOutside10) + "\n" +
-    //    " - 25kPc is " + std::to_string(starsOutside25) + "\n" +
-    //    " - 50kPc is " + std::to_string(starsOutside50) + "\n" +
-    //    " - 75kPc is " + std::to_string(starsOutside75) + "\n" +
-    //    " - 100kPc is " + std::to_string(starsOutside100) + "\n" +
-    //    " - 200kPc is " + std::to_string(starsOutside200) + "\n" +
-    //    " - 300kPc is " + std::to_string(starsOutside300) + "\n" +
-    //    " - 400kPc is " + std::to_string(starsOutside400) + "\n" +
-    //    " - 500kPc is " + std::to_string(starsOutside500) + "\n" +
-    //    " - 750kPc is " + std::to_string(starsOutside750) + "\n" +
-    //    " - 1000kPc is " + std::to_string(starsOutside1000) + "\n" +
-    //    " - 1500kPc is " + std::to_string(starsOutside1500) + "\n" +
-    //    " - 2000kPc is " + std::to_string(starsOutside2000) + "\n" +
-    //    " - 5000kPc is " + std::to_string(starsOutside5000));
+    if (nStoredStars != nStars) {
+        LWARNING(fmt::format(
+            "{} stars didn't fit in the deepest nodes", nStars - nStoredStars
+        ));
+    }
+    LINFO(fmt::format(
+        "Number leaf nodes: {}\n Number inner nodes: {}\n Total depth of tree: {}",
+        _indexOctreeManager->numLeafNodes(),
+        _indexOctreeManager->numInnerNodes(),
+        _indexOctreeManager->totalDepth()
+    ));
 
     // Write index file of Octree structure.
     std::string indexFileOutPath = _outFileOrFolderPath + "index.bin";
@@ -497,10 +624,111 @@ void ConstructOctreeTask::constructOctreeFromFolder(
         ));
     }
 
-    // Make sure all threads are done.
-    for (int i = 0; i < 8; ++i) {
-        writeThreads[i].join();
+    if (_flatOutput) {
+        // Pack all node files into one file that can be memory-mapped when rendering.
+        const std::string flatFileOutPath = _outFileOrFolderPath + FlatFileName;
+        LINFO("Writing flat Octree file: " + flatFileOutPath);
+        _indexOctreeManager->writeToFlatFile(flatFileOutPath, _outFileOrFolderPath);
+    }
+}
+
+ConstructOctreeTask::SortedRuns ConstructOctreeTask::sortFileIntoRuns(
+                                                          const std::string& inFilePath,
+                                                                        size_t fileIndex)
+{
+    SortedRuns result;
+
+    std::ifstream inFileStream(inFilePath, std::ifstream::binary);
+    if (!inFileStream.good()) {
+        LERROR(fmt::format(
+            "Error opening file '{}' for loading preprocessed file!", inFilePath
+        ));
+        return result;
+    }
+    LINFO("Reading data file: " + inFilePath);
+
+    int32_t nValuesPerStar = 0;
+    inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
+    if (nValuesPerStar < RENDER_VALUES) {
+        LERROR(fmt::format("File '{}' has too few values per star", inFilePath));
+        return result;
+    }
+
+    // Stars are buffered per branch until the buffers hold a full run.
+    std::array<std::vector<OctreeManager::SortableStar>, 8> buffers;
+    size_t nBufferedStars = 0;
+    size_t nRuns = 0;
+    auto writeRuns = [&]() {
+        for (size_t branch = 0; branch < 8; ++branch) {
+            if (buffers[branch].empty()) {
+                continue;
+            }
+            const std::string runFilePath = fmt::format(
+                "{}{}_{}_{}.run", _scratchFolderPath, branch, fileIndex, nRuns++
+            );
+            if (!writeRun(buffers[branch], runFilePath)) {
+                // The stars of the run are lost, so the file can't be used at all
+                std::remove(runFilePath.c_str());
+                result.failedRunFile = runFilePath;
+                return false;
+            }
+            result.runFiles[branch].push_back(runFilePath);
+            buffers[branch].clear();
+        }
+        nBufferedStars = 0;
+        return true;
+    };
+
+    // Read many stars at once, one star at a time is bound by the stream overhead.
+    constexpr const size_t StarsPerRead = 1 << 16;
+    std::vector<float> readValues(StarsPerRead * nValuesPerStar);
+    std::vector<float> filterValues(nValuesPerStar);
+    while (inFileStream) {
+        inFileStream.read(
+            reinterpret_cast<char*>(readValues.data()),
+            readValues.size() * sizeof(readValues[0])
+        );
+        const size_t nReadStars = static_cast<size_t>(inFileStream.gcount()) /
+                                  (nValuesPerStar * sizeof(readValues[0]));
+
+        for (size_t i = 0; i < nReadStars; ++i) {
+            auto first = readValues.begin() + i * nValuesPerStar;
+            std::copy(first, first + nValuesPerStar, filterValues.begin());
+
+            // Filter data by parameters.
+            if (checkAllFilters(filterValues)) {
+                result.nFilteredStars++;
+                continue;
+            }
+            // Generate a 50/12,5 dataset (gMag <=13/>13).
+            //if ((filterStar(glm::vec2(20.0), filterValues[3], 20.f)) ||
+            //    (filterStar(glm::vec2(0.0), filterValues[16])) ||
+            //    (filterValues[3] > 13.0 && filterValues[17] > 0.125) ||
+            //    (filterValues[3] <= 13.0 && filterValues[17] > 0.5)) {
+            //    nFilteredStars++;
+            //    continue;
+            //}
+
+            // If all filters passed then keep the render values of the star.
+            OctreeManager::SortableStar star;
+            std::copy(first, first + RENDER_VALUES, star.values.begin());
+            star.mortonCode = _indexOctreeManager->mortonCode(
+                star.values[0],
+                star.values[1],
+                star.values[2]
+            );
+            buffers[_indexOctreeManager->branchIndex(star.mortonCode)].push_back(star);
+            result.nStars++;
+
+            nBufferedStars++;
+            if (nBufferedStars >= static_cast<size_t>(_starsPerRun) && !writeRuns()) {
+                return result;
+            }
+        }
     }
+    writeRuns();
+
+    return result;
 }
 
 bool ConstructOctreeTask::checkAllFilters(const std::vector<float>& filterValues) {
@@ -590,6 +818,32 @@ documentation::Documentation ConstructOctreeTask::Documentation() {
                 "binary file with the full Octree. If false then task will read all "
                 "files in specified folder and output multiple files for the Octree."
             },
+            {
+                KeyFlatOutput,
+                new BoolVerifier,
+                Optional::Yes,
+                "If true then the Octree is (also) written as a flat file that can be "
+                "memory-mapped with the 'MappedOctree' FileReaderOption. With a single "
+                "input file it replaces the binary Octree file, otherwise an additional "
+                "'octree.flat' file is written into the output folder next to the node "
+                "files."
+            },
+            {
+                KeyScratchFolderPath,
+                new StringVerifier,
+                Optional::Yes,
+                "If SingleFileInput is false then stars are sorted in runs that are "
+                "stored in this folder while the Octree is constructed. Defaults to a "
+                "'scratch' folder in the output folder."
+            },
+            {
+                KeyStarsPerRun,
+                new IntVerifier,
+                Optional::Yes,
+                "If SingleFileInput is false then this determines how many stars are "
+                "sorted in memory at once per input file. Files are read in parallel, so "
+                "a smaller value is needed if there are many cores but little RAM."
+            },
             {
                 KeyFilterPosX,
                 new Vector2Verifier<double>,
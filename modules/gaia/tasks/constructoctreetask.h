@@ -29,6 +29,7 @@
 
 #include <modules/gaia/rendering/octreeculler.h>
 #include <modules/gaia/rendering/octreemanager.h>
+#include <array>
 
 namespace openspace {
 
@@ -54,14 +55,36 @@ private:
     void constructOctreeFromSingleFile(const Task::ProgressCallback& progressCallback);
 
     /**
-     *  Reads binary star data from 8 preprocessed files (one per branch) in specified
-     * folder, prepared by ReadFitsTask, and inserts star render data into an octree
-     * (if star data passed all defined filters).
+     * Stars of one input file that passed all filters, sorted by their Morton code into
+     * runs that are stored in the scratch folder. There is one list of runs per branch.
+     */
+    struct SortedRuns {
+        std::array<std::vector<std::string>, 8> runFiles;
+        size_t nStars = 0;
+        size_t nFilteredStars = 0;
+        /// The run file that could not be written, empty if all runs were written
+        std::string failedRunFile;
+    };
+
+    /**
+     * Reads binary star data from all preprocessed files in specified folder, prepared
+     * by ReadFitsTask, and builds an octree from the render data of all stars that
+     * passed all defined filters. The files are read in parallel and the stars are
+     * sorted by their position in the octree with an external merge sort, which means
+     * that the dataset doesn't have to fit in RAM. The branches are then built
+     * bottom-up in parallel from the sorted stars.
      * Stores octree structure in a binary index file and stores all render data
      * separate files, one file per node in the octree.
      */
     void constructOctreeFromFolder(const Task::ProgressCallback& progressCallback);
 
+    /**
+     * Reads all stars in \param inFilePath that pass all filters and writes them as
+     * sorted runs of at most _starsPerRun stars to the scratch folder.
+     * \param fileIndex is used to give the runs of different files unique names.
+     */
+    SortedRuns sortFileIntoRuns(const std::string& inFilePath, size_t fileIndex);
+
     /**
      * Checks all defined filter ranges and \returns true if any of the corresponding
      * <code>filterValues</code> are outside of the defined range.
@@ -83,6 +106,9 @@ private:
     int _maxDist = 0;
     int _maxStarsPerNode = 0;
     bool _singleFileInput = false;
+    bool _flatOutput = false;
+    std::string _scratchFolderPath;
+    int _starsPerRun = 4000000;
 
     std::shared_ptr<OctreeManager> _octreeManager;
     std::shared_ptr<OctreeManager> _indexOctreeManager;
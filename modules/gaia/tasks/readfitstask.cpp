@@ -27,6 +27,8 @@
 #include <modules/gaia/tasks/readfilejob.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/util/taskscheduler.h>
 
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -173,10 +175,11 @@ void ReadFitsTask::readAllFitsFilesFromFolder(const Task::ProgressCallback&) {
 
     _firstRow = std::max(_firstRow, 1);
 
-    // Create Threadpool and JobManager.
-    LINFO("Threads in pool: " + std::to_string(_threadsToUse));
-    ThreadPool threadPool(_threadsToUse);
-    ConcurrentJobManager<std::vector<std::vector<float>>> jobManager(threadPool);
+    // Create JobManager that submits to the shared task scheduler.
+    LINFO("Files to read concurrently: " + std::to_string(_threadsToUse));
+    ConcurrentJobManager<std::vector<std::vector<float>>> jobManager(
+        global::taskScheduler
+    );
 
     // Get all files in specified folder.
     ghoul::filesystem::Directory currentDir(_inFileOrFolderPath);
@@ -231,11 +234,11 @@ void ReadFitsTask::readAllFitsFilesFromFolder(const Task::ProgressCallback&) {
     auto fitsFileReader = std::make_shared<FitsFileReader>(false);
 
     // Divide all files into ReadFilejobs and then delegate them onto several threads!
-    while (!allInputFiles.empty()) {
+    auto enqueueNextFile = [&]() {
         std::string fileToRead = allInputFiles.back();
         allInputFiles.erase(allInputFiles.end() - 1);
 
-        // Add reading of file to jobmanager, which will distribute it to our threadpool.
+        // Add reading of file to jobmanager, which will distribute it to the scheduler.
         auto readFileJob = std::make_shared<gaia::ReadFileJob>(
             fileToRead,
             _allColumnNames,
@@ -246,9 +249,14 @@ void ReadFitsTask::readAllFitsFilesFromFolder(const Task::ProgressCallback&) {
             fitsFileReader
         );
         jobManager.enqueueJob(readFileJob);
-    }
+    };
 
-    LINFO("All files added to queue!");
+    // Every job keeps the content of a whole file in memory, so only ThreadsToUse files
+    // are read at the same time. A new file is enqueued whenever a job has finished.
+    while (!allInputFiles.empty() && (nInputFiles - allInputFiles.size() < _threadsToUse))
+    {
+        enqueueNextFile();
+    }
 
     // Check for finished jobs.
     while (finishedJobs < nInputFiles) {
@@ -257,6 +265,9 @@ void ReadFitsTask::readAllFitsFilesFromFolder(const Task::ProgressCallback&) {
                 jobManager.popFinishedJob()->product();
 
             finishedJobs++;
+            if (!allInputFiles.empty()) {
+                enqueueNextFile();
+            }
 
             for (int i = 0; i < 8; ++i) {
                 // Add read values to global octant and check if it's time to write!
@@ -360,7 +371,8 @@ documentation::Documentation ReadFitsTask::Documentation() {
                 KeyThreadsToUse,
                 new IntVerifier,
                 Optional::Yes,
-                "Defines how many threads to use when reading from multiple files."
+                "Defines how many files are read concurrently when reading from multiple "
+                "files."
             },
             {
                 KeyFirstRow,
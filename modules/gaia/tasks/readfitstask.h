@@ -26,7 +26,6 @@
 #define __OPENSPACE_MODULE_GAIA___READFITSTASK___H__
 
 #include <openspace/util/task.h>
-#include <openspace/util/threadpool.h>
 #include <openspace/util/concurrentjobmanager.h>
 #include <modules/fitsfilereader/include/fitsfilereader.h>
 
@@ -26,10 +26,12 @@
 
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/dashboarditemglobelocation.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/gdalwrapper.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/globetranslation.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
+#include <modules/globebrowsing/src/tileioscheduler.h>
 #include <modules/globebrowsing/src/tileprovider.h>
 #include <openspace/engine/globalscallbacks.h>
 #include <openspace/scripting/lualibrary.h>
@@ -91,6 +93,39 @@ namespace {
         "property will not affect already created WMS datasets."
     };
 
+    constexpr const openspace::properties::Property::PropertyInfo
+    DiskTileCacheEnabledInfo = {
+        "DiskTileCacheEnabled",
+        "Disk Tile Cache Enabled",
+        "Determines whether preprocessed tiles of all datasets are stored on disk so "
+        "that they do not have to be read and processed again in later sessions. "
+        "Changing the value of this property only has an effect after a restart."
+    };
+
+    constexpr const openspace::properties::Property::PropertyInfo
+    DiskTileCacheLocationInfo = {
+        "DiskTileCacheLocation",
+        "Disk Tile Cache Location",
+        "The folder in which the preprocessed tiles are stored. Changing the value of "
+        "this property only has an effect after a restart."
+    };
+
+    constexpr const openspace::properties::Property::PropertyInfo
+    DiskTileCacheSizeInfo = {
+        "DiskTileCacheSize",
+        "Disk Tile Cache Size",
+        "The maximum size of the disk tile cache in megabytes. If the cache grows "
+        "larger, the least recently used tiles are removed."
+    };
+
+    constexpr const openspace::properties::Property::PropertyInfo
+    TileLoadingThreadsInfo = {
+        "TileLoadingThreads",
+        "Tile Loading Threads",
+        "The number of threads that are shared between all globes and layers to load "
+        "tiles. Changing the value of this property only has an effect after a restart."
+    };
+
 
     openspace::GlobeBrowsingModule::Capabilities
     parseSubDatasets(char** subDatasets, int nSubdatasets)
@@ -152,11 +187,27 @@ GlobeBrowsingModule::GlobeBrowsingModule()
     , _offlineMode(OfflineModeInfo, false)
     , _cacheLocation(CacheLocationInfo, "${BASE}/cache_gdal")
     , _cacheSizeMB(CacheSizeInfo, 1024)
+    , _diskTileCacheEnabled(DiskTileCacheEnabledInfo, true)
+    , _diskTileCacheLocation(DiskTileCacheLocationInfo, "${CACHE}/globebrowsing_tiles")
+    , _diskTileCacheSizeMB(DiskTileCacheSizeInfo, 2048)
+    , _nTileLoadingThreads(TileLoadingThreadsInfo, 4, 1, 64)
 {
     addProperty(_cacheEnabled);
     addProperty(_offlineMode);
     addProperty(_cacheLocation);
     addProperty(_cacheSizeMB);
+
+    _diskTileCacheSizeMB.onChange([this]() {
+        if (_diskTileCache) {
+            _diskTileCache->setMaximumSize(
+                static_cast<uint64_t>(_diskTileCacheSizeMB) * 1024 * 1024
+            );
+        }
+    });
+    addProperty(_diskTileCacheEnabled);
+    addProperty(_diskTileCacheLocation);
+    addProperty(_diskTileCacheSizeMB);
+    addProperty(_nTileLoadingThreads);
 }
 
 void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
@@ -174,6 +225,24 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     if (dict.hasKeyAndValue<double>(CacheSizeInfo.identifier)) {
         _cacheSizeMB = static_cast<int>(dict.value<double>(CacheSizeInfo.identifier));
     }
+    if (dict.hasKeyAndValue<bool>(DiskTileCacheEnabledInfo.identifier)) {
+        _diskTileCacheEnabled = dict.value<bool>(DiskTileCacheEnabledInfo.identifier);
+    }
+    if (dict.hasKeyAndValue<std::string>(DiskTileCacheLocationInfo.identifier)) {
+        _diskTileCacheLocation = dict.value<std::string>(
+            DiskTileCacheLocationInfo.identifier
+        );
+    }
+    if (dict.hasKeyAndValue<double>(DiskTileCacheSizeInfo.identifier)) {
+        _diskTileCacheSizeMB = static_cast<unsigned int>(
+            dict.value<double>(DiskTileCacheSizeInfo.identifier)
+        );
+    }
+    if (dict.hasKeyAndValue<double>(TileLoadingThreadsInfo.identifier)) {
+        _nTileLoadingThreads = static_cast<unsigned int>(
+            dict.value<double>(TileLoadingThreadsInfo.identifier)
+        );
+    }
 
     // Sanity check
     const bool noWarning = dict.hasKeyAndValue<bool>("NoWarning") ?
@@ -196,6 +265,17 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
         _tileCache = std::make_unique<globebrowsing::cache::MemoryAwareTileCache>();
         addPropertySubOwner(*_tileCache);
 
+        _tileIOScheduler = std::make_unique<globebrowsing::TileIOScheduler>(
+            _nTileLoadingThreads
+        );
+
+        if (_diskTileCacheEnabled) {
+            _diskTileCache = std::make_unique<globebrowsing::cache::DiskTileCache>(
+                absPath(_diskTileCacheLocation),
+                static_cast<uint64_t>(_diskTileCacheSizeMB) * 1024 * 1024
+            );
+        }
+
         tileprovider::initializeDefaultTile();
 
         // Convert from MB to Bytes
@@ -214,8 +294,16 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     // Render
     global::callback::render.emplace_back([&]() { _tileCache->update(); });
 
+    // Requests that were not repeated in this frame have left the view
+    global::callback::postDraw.emplace_back([&]() { _tileIOScheduler->update(); });
+
     // Deinitialize
-    global::callback::deinitialize.emplace_back([&]() { GdalWrapper::destroy(); });
+    global::callback::deinitialize.emplace_back([&]() {
+        _tileIOScheduler = nullptr;
+        // Writes the index of the disk tile cache for the next session
+        _diskTileCache = nullptr;
+        GdalWrapper::destroy();
+    });
 
     auto fRenderable = FactoryManager::ref().factory<Renderable>();
     ghoul_assert(fRenderable, "Renderable factory was not created");
@@ -277,6 +365,14 @@ globebrowsing::cache::MemoryAwareTileCache* GlobeBrowsingModule::tileCache() {
     return _tileCache.get();
 }
 
+globebrowsing::cache::DiskTileCache* GlobeBrowsingModule::diskTileCache() {
+    return _diskTileCache.get();
+}
+
+globebrowsing::TileIOScheduler* GlobeBrowsingModule::tileIOScheduler() {
+    return _tileIOScheduler.get();
+}
+
 scripting::LuaLibrary GlobeBrowsingModule::luaLibrary() const {
     std::string listLayerGroups = layerGroupNamesList();
 
@@ -39,8 +39,12 @@ namespace openspace::globebrowsing {
     struct TileIndex;
     struct Geodetic2;
     struct Geodetic3;
+    class TileIOScheduler;
 
-    namespace cache { class MemoryAwareTileCache; }
+    namespace cache {
+        class DiskTileCache;
+        class MemoryAwareTileCache;
+    } // namespace cache
 } // namespace openspace::globebrowsing
 
 namespace openspace {
@@ -61,6 +65,13 @@ public:
         double latitude, double longitude, double altitude);
 
     globebrowsing::cache::MemoryAwareTileCache* tileCache();
+
+    /// Returns the persistent tile cache, or nullptr if it is disabled
+    globebrowsing::cache::DiskTileCache* diskTileCache();
+
+    /// Returns the scheduler that loads the tiles of all globes
+    globebrowsing::TileIOScheduler* tileIOScheduler();
+
     scripting::LuaLibrary luaLibrary() const override;
     const globebrowsing::RenderableGlobe* castFocusNodeRenderableToGlobe();
 
@@ -118,7 +129,14 @@ private:
     properties::StringProperty _cacheLocation;
     properties::UIntProperty _cacheSizeMB;
 
+    properties::BoolProperty _diskTileCacheEnabled;
+    properties::StringProperty _diskTileCacheLocation;
+    properties::UIntProperty _diskTileCacheSizeMB;
+    properties::UIntProperty _nTileLoadingThreads;
+
     std::unique_ptr<globebrowsing::cache::MemoryAwareTileCache> _tileCache;
+    std::unique_ptr<globebrowsing::cache::DiskTileCache> _diskTileCache;
+    std::unique_ptr<globebrowsing::TileIOScheduler> _tileIOScheduler;
 
     // name -> capabilities
     std::map<std::string, std::future<Capabilities>> _inFlightCapabilitiesMap;
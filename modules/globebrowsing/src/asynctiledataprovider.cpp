@@ -27,6 +27,7 @@
 #include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
 #include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tileioscheduler.h>
 #include <modules/globebrowsing/src/tileloadjob.h>
 #include <openspace/engine/moduleengine.h>
 #include <openspace/engine/globals.h>
@@ -40,16 +41,29 @@ namespace {
 } // namespace
 
 AsyncTileDataProvider::AsyncTileDataProvider(std::string name,
-                                    std::unique_ptr<RawTileDataReader> rawTileDataReader)
+                                    std::unique_ptr<RawTileDataReader> rawTileDataReader,
+                                                        layergroupid::GroupID layerGroup)
     : _name(std::move(name))
+    , _layerGroup(layerGroup)
+    , _globeBrowsingModule(global::moduleEngine.module<GlobeBrowsingModule>())
+    , _scheduler(*_globeBrowsingModule->tileIOScheduler())
     , _rawTileDataReader(std::move(rawTileDataReader))
-    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(1, 10))
 {
-    _globeBrowsingModule = global::moduleEngine.module<GlobeBrowsingModule>();
+    _diskTileCache = _globeBrowsingModule->diskTileCache();
+    if (_diskTileCache) {
+        _datasetIdentifier = cache::DiskTileCache::datasetIdentifier(
+            _rawTileDataReader->datasetFilePath(),
+            _rawTileDataReader->tileTextureInitData(),
+            _rawTileDataReader->performsPreprocessing()
+        );
+    }
     performReset(ResetRawTileDataReader::No);
 }
 
-AsyncTileDataProvider::~AsyncTileDataProvider() {} // NOLINT
+AsyncTileDataProvider::~AsyncTileDataProvider() {
+    // Jobs that are currently running reference our RawTileDataReader
+    _scheduler.removeClient(*this);
+}
 
 const RawTileDataReader& AsyncTileDataProvider::rawTileDataReader() const {
     return *_rawTileDataReader;
@@ -57,8 +71,13 @@ const RawTileDataReader& AsyncTileDataProvider::rawTileDataReader() const {
 
 bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
     if (_resetMode == ResetMode::ShouldNotReset && satisfiesEnqueueCriteria(tileIndex)) {
-        auto job = std::make_unique<TileLoadJob>(*_rawTileDataReader, tileIndex);
-        _concurrentJobManager.enqueueJob(std::move(job), tileIndex.hashKey());
+        auto job = std::make_shared<TileLoadJob>(
+            *_rawTileDataReader,
+            tileIndex,
+            _diskTileCache,
+            _datasetIdentifier
+        );
+        _scheduler.enqueue(*this, tileIndex, _layerGroup, std::move(job));
         _enqueuedTileRequests.insert(tileIndex.hashKey());
         return true;
     }
@@ -76,9 +95,10 @@ std::vector<RawTile> AsyncTileDataProvider::rawTiles() {
 }
 
 std::optional<RawTile> AsyncTileDataProvider::popFinishedRawTile() {
-    if (_concurrentJobManager.numFinishedJobs() > 0) {
+    std::shared_ptr<Job<RawTile>> job = _scheduler.popFinishedJob(*this);
+    if (job) {
         // Now the tile load job looses ownerwhip of the data pointer
-        RawTile product = _concurrentJobManager.popFinishedJob()->product();
+        RawTile product = job->product();
 
         const TileIndex::TileHashKey key = product.tileIndex.hashKey();
         // No longer enqueued. Remove from set of enqueued tiles
@@ -98,11 +118,12 @@ std::optional<RawTile> AsyncTileDataProvider::popFinishedRawTile() {
 }
 
 bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const TileIndex& tileIndex) {
-    // Only satisfies if it is not already enqueued. Also bumps the request to the top.
-    const bool alreadyEnqueued = _concurrentJobManager.touch(tileIndex.hashKey());
+    // Only satisfies if it is not already enqueued. Also keeps the request alive for
+    // this frame and raises its priority to the priority of the current request
+    const bool alreadyEnqueued = _scheduler.touch(*this, tileIndex);
 
-    // Concurrent job manager can start jobs which will pop them from enqueued, however
-    // they are still in _enqueuedTileRequests until finished
+    // The scheduler can start jobs which will remove them from the pending requests,
+    // however they are still in _enqueuedTileRequests until finished
     const auto it = _enqueuedTileRequests.find(tileIndex.hashKey());
     const bool notFoundAmongEnqueued = it == _enqueuedTileRequests.end();
 
@@ -111,7 +132,7 @@ bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const TileIndex& tileIndex)
 
 void AsyncTileDataProvider::endUnfinishedJobs() {
     std::vector<TileIndex::TileHashKey> unfinishedJobs =
-        _concurrentJobManager.keysToUnfinishedJobs();
+        _scheduler.cancelledRequests(*this);
     for (const TileIndex::TileHashKey& unfinishedJob : unfinishedJobs) {
         // When erasing the job before
         _enqueuedTileRequests.erase(unfinishedJob);
@@ -119,8 +140,7 @@ void AsyncTileDataProvider::endUnfinishedJobs() {
 }
 
 void AsyncTileDataProvider::endEnqueuedJobs() {
-    std::vector<TileIndex::TileHashKey> enqueuedJobs =
-        _concurrentJobManager.keysToEnqueuedJobs();
+    std::vector<TileIndex::TileHashKey> enqueuedJobs = _scheduler.cancelAll(*this);
     for (const TileIndex::TileHashKey& enqueuedJob : enqueuedJobs) {
         // When erasing the job before
         _enqueuedTileRequests.erase(enqueuedJob);
@@ -25,7 +25,8 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___ASYNC_TILE_DATAPROVIDER___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___ASYNC_TILE_DATAPROVIDER___H__
 
-#include <modules/globebrowsing/src/prioritizingconcurrentjobmanager.h>
+#include <modules/globebrowsing/src/disktilecache.h>
+#include <modules/globebrowsing/src/layergroupid.h>
 #include <modules/globebrowsing/src/rawtiledatareader.h>
 #include <modules/globebrowsing/src/tileindex.h>
 #include <ghoul/misc/boolean.h>
@@ -38,24 +39,31 @@ namespace openspace { class GlobeBrowsingModule; }
 namespace openspace::globebrowsing {
 
 struct RawTile;
+class TileIOScheduler;
 
 /**
  * The responsibility of this class is to enqueue tile requests and fetching finished
- * <code>RawTile</code>s that has been asynchronously loaded.
+ * <code>RawTile</code>s that has been asynchronously loaded. The tiles are loaded by
+ * the TileIOScheduler that is shared between all providers.
  */
 class AsyncTileDataProvider {
 public:
     /**
      * \param rawTileDataReader is the reader that will be used for the asynchronous
      * tile loading.
+     * \param layerGroup is the group of the layer the tiles are loaded for, which is
+     * used to prioritize the requests of different layers for the same tile
      */
     AsyncTileDataProvider(std::string name,
-        std::unique_ptr<RawTileDataReader> rawTileDataReader);
+        std::unique_ptr<RawTileDataReader> rawTileDataReader,
+        layergroupid::GroupID layerGroup = layergroupid::GroupID::Unknown);
 
     ~AsyncTileDataProvider();
 
     /**
-     * Creates a job which asynchronously loads a raw tile. This job is enqueued.
+     * Creates a job which asynchronously loads a raw tile. This job is enqueued. If the
+     * tile is stored in the disk tile cache, the job reads it from there instead of
+     * going through GDAL.
      */
     bool enqueueTileIO(const TileIndex& tileIndex);
 
@@ -94,9 +102,9 @@ protected:
     bool satisfiesEnqueueCriteria(const TileIndex& tileIndex);
 
     /**
-     * An unfinished job is a load tile job that has been popped from the thread pool due
-     * to its low priority. Once it has been popped, it is marked as unfinished and needs
-     * to be explicitly ended.
+     * An unfinished job is a load tile job that has been cancelled by the
+     * TileIOScheduler as it was no longer requested. Once it has been cancelled, it is
+     * marked as unfinished and needs to be explicitly ended.
      */
     void endUnfinishedJobs();
 
@@ -106,12 +114,15 @@ protected:
 
 private:
     const std::string _name;
+    const layergroupid::GroupID _layerGroup;
     GlobeBrowsingModule* _globeBrowsingModule;
+    TileIOScheduler& _scheduler;
     /// The reader used for asynchronous reading
     std::unique_ptr<RawTileDataReader> _rawTileDataReader;
 
-    PrioritizingConcurrentJobManager<RawTile, TileIndex::TileHashKey>
-        _concurrentJobManager;
+    /// The persistent cache that is checked before a tile is read, may be nullptr
+    cache::DiskTileCache* _diskTileCache = nullptr;
+    cache::DiskTileCache::DatasetIdentifier _datasetIdentifier = 0;
 
     std::set<TileIndex::TileHashKey> _enqueuedTileRequests;
 
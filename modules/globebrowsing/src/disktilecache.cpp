@@ -0,0 +1,419 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/disktilecache.h>
+
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <ghoul/filesystem/directory.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace {
+    constexpr const char* _loggerCat = "DiskTileCache";
+
+    constexpr const char* IndexFileName = "index.bin";
+    constexpr const char* TileExtension = ".tile";
+    constexpr const char* TemporaryExtension = ".tmp";
+
+    // Changing the layout of the tile or index files requires bumping the version
+    constexpr const uint32_t TileMagic = 0x454C4954; // 'TILE'
+    constexpr const uint32_t IndexMagic = 0x58444E49; // 'INDX'
+    constexpr const uint32_t FileVersion = 1;
+
+    // The image data of a tile file starts at a multiple of this alignment
+    constexpr const uint32_t DataAlignment = 64;
+
+    struct TileFileHeader {
+        uint32_t magic = TileMagic;
+        uint32_t version = FileVersion;
+        uint64_t dataset = 0;
+        uint64_t tile = 0;
+        uint64_t nBytes = 0;
+        uint32_t nRasters = 0;
+        uint32_t dataOffset = 0;
+    };
+
+    struct IndexFileHeader {
+        uint32_t magic = IndexMagic;
+        uint32_t version = FileVersion;
+        uint64_t nEntries = 0;
+    };
+
+    struct IndexFileEntry {
+        uint64_t dataset;
+        uint64_t tile;
+        uint64_t size;
+    };
+
+    // The meta data consists of the maximum and minimum values and the missing data
+    // flag of each raster
+    size_t metaDataSize(size_t nRasters) {
+        return nRasters * (2 * sizeof(float) + sizeof(uint8_t));
+    }
+
+    uint32_t dataOffset(size_t nRasters) {
+        const size_t size = sizeof(TileFileHeader) + metaDataSize(nRasters);
+        return static_cast<uint32_t>(
+            (size + DataAlignment - 1) / DataAlignment * DataAlignment
+        );
+    }
+
+    uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    uint64_t fnv1a(uint64_t hash, const T& value) {
+        return fnv1a(hash, &value, sizeof(T));
+    }
+
+    // Returns the size and the modification time of the file at \p path, or zeros if it
+    // does not exist locally, for example for a remote dataset
+    std::pair<uint64_t, int64_t> fileStatus(const std::string& path) {
+#ifdef WIN32
+        struct _stat64 status;
+        if (_stat64(path.c_str(), &status) == 0) {
+#else // WIN32
+        struct stat status;
+        if (stat(path.c_str(), &status) == 0) {
+#endif // WIN32
+            return {
+                static_cast<uint64_t>(status.st_size),
+                static_cast<int64_t>(status.st_mtime)
+            };
+        }
+        return { 0, 0 };
+    }
+
+    bool endsWith(const std::string& str, const std::string& suffix) {
+        return str.size() >= suffix.size() &&
+               str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+DiskTileCache::DiskTileCache(std::string directory, uint64_t maximumSize)
+    : _directory(std::move(directory))
+    , _index(static_cast<size_t>(maximumSize))
+{
+    if (!FileSys.directoryExists(_directory)) {
+        FileSys.createDirectory(
+            _directory,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
+    readIndex();
+}
+
+DiskTileCache::~DiskTileCache() {
+    writeIndex();
+}
+
+DiskTileCache::DatasetIdentifier DiskTileCache::datasetIdentifier(
+                                                             const std::string& filePath,
+                                                     const TileTextureInitData& initData,
+                                                               bool performPreprocessing)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = fnv1a(hash, filePath.data(), filePath.size());
+    // A local file that is replaced or modified must not serve the old tiles
+    const std::pair<uint64_t, int64_t> status = fileStatus(filePath);
+    hash = fnv1a(hash, status.first);
+    hash = fnv1a(hash, status.second);
+    hash = fnv1a(hash, initData.hashKey);
+    hash = fnv1a(hash, initData.padTiles);
+    hash = fnv1a(hash, performPreprocessing);
+    return hash;
+}
+
+std::optional<RawTile> DiskTileCache::get(DatasetIdentifier dataset,
+                                          const TileIndex& tileIndex, size_t nBytes)
+{
+    const Key key = { dataset, tileIndex.hashKey() };
+    {
+        std::lock_guard lock(_mutex);
+        if (!_index.tryGet(key)) {
+            return std::nullopt;
+        }
+    }
+
+    // Reading the file does not need to hold the lock. If the tile is evicted in the
+    // meantime, either the reading fails or the file is kept alive by the open handle
+    const std::string path = tilePath(key);
+    std::ifstream file(path, std::ifstream::binary);
+
+    TileFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(TileFileHeader));
+    const bool validHeader = file.good() && header.magic == TileMagic &&
+        header.version == FileVersion && header.dataset == key.dataset &&
+        header.tile == key.tile && header.nBytes == nBytes &&
+        header.dataOffset == dataOffset(header.nRasters);
+
+    RawTile tile;
+    bool success = false;
+    if (validHeader) {
+        std::vector<char> metaData(header.dataOffset - sizeof(TileFileHeader));
+        file.read(metaData.data(), metaData.size());
+
+        const size_t n = header.nRasters;
+        tile.tileMetaData.maxValues.resize(n);
+        tile.tileMetaData.minValues.resize(n);
+        tile.tileMetaData.hasMissingData.resize(n);
+        const char* p = metaData.data();
+        std::memcpy(tile.tileMetaData.maxValues.data(), p, n * sizeof(float));
+        p += n * sizeof(float);
+        std::memcpy(tile.tileMetaData.minValues.data(), p, n * sizeof(float));
+        p += n * sizeof(float);
+        for (size_t i = 0; i < n; ++i) {
+            tile.tileMetaData.hasMissingData[i] = (p[i] != 0);
+        }
+
+        tile.imageData = std::unique_ptr<std::byte[]>(new std::byte[nBytes]);
+        file.read(reinterpret_cast<char*>(tile.imageData.get()), nBytes);
+        success = file.good();
+    }
+
+    if (!success) {
+        // The file is missing or corrupt, so we can just as well forget about it
+        file.close();
+        std::lock_guard lock(_mutex);
+        if (_index.erase(key)) {
+            std::remove(path.c_str());
+        }
+        return std::nullopt;
+    }
+
+    tile.tileIndex = tileIndex;
+    return tile;
+}
+
+void DiskTileCache::put(DatasetIdentifier dataset, const RawTile& tile, size_t nBytes) {
+    if (tile.error != RawTile::ReadError::None || !tile.imageData) {
+        return;
+    }
+
+    const Key key = { dataset, tile.tileIndex.hashKey() };
+    const TileMetaData& meta = tile.tileMetaData;
+
+    TileFileHeader header;
+    header.dataset = key.dataset;
+    header.tile = key.tile;
+    header.nBytes = nBytes;
+    header.nRasters = static_cast<uint32_t>(meta.maxValues.size());
+    header.dataOffset = dataOffset(header.nRasters);
+
+    // Meta data and the padding up to the aligned start of the image data
+    std::vector<char> metaData(header.dataOffset - sizeof(TileFileHeader), 0);
+    char* p = metaData.data();
+    const size_t n = header.nRasters;
+    std::memcpy(p, meta.maxValues.data(), n * sizeof(float));
+    p += n * sizeof(float);
+    std::memcpy(p, meta.minValues.data(), n * sizeof(float));
+    p += n * sizeof(float);
+    for (size_t i = 0; i < n; ++i) {
+        p[i] = meta.hasMissingData[i] ? 1 : 0;
+    }
+
+    // The tile is written to a temporary file first so that a concurrent reader never
+    // sees a partially written tile
+    const std::string path = tilePath(key);
+    const std::string temporaryPath = fmt::format(
+        "{}.{}{}", path, _nTemporaryFiles++, TemporaryExtension
+    );
+    {
+        std::ofstream file(temporaryPath, std::ofstream::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(TileFileHeader));
+        file.write(metaData.data(), metaData.size());
+        file.write(reinterpret_cast<const char*>(tile.imageData.get()), nBytes);
+        if (!file.good()) {
+            LWARNING(fmt::format("Error writing tile file '{}'", temporaryPath));
+            file.close();
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+    }
+
+    const uint64_t fileSize = header.dataOffset + nBytes;
+
+    std::lock_guard lock(_mutex);
+    // Renaming does not replace existing files on all platforms
+    std::remove(path.c_str());
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        _index.erase(key);
+        return;
+    }
+    removeFiles(_index.putAndFetchPopped(key, fileSize, static_cast<size_t>(fileSize)));
+}
+
+bool DiskTileCache::exist(DatasetIdentifier dataset, const TileIndex& tileIndex) const {
+    std::lock_guard lock(_mutex);
+    return _index.exist({ dataset, tileIndex.hashKey() });
+}
+
+uint64_t DiskTileCache::size() const {
+    std::lock_guard lock(_mutex);
+    return _index.totalCost();
+}
+
+void DiskTileCache::setMaximumSize(uint64_t maximumSize) {
+    std::lock_guard lock(_mutex);
+    std::vector<std::pair<Key, uint64_t>> evicted;
+    while (_index.totalCost() > maximumSize) {
+        evicted.push_back(_index.popLRU());
+    }
+    removeFiles(evicted);
+    _index.setMaximumCacheSize(static_cast<size_t>(maximumSize));
+}
+
+void DiskTileCache::clear() {
+    std::lock_guard lock(_mutex);
+    std::vector<std::pair<Key, uint64_t>> evicted;
+    while (!_index.isEmpty()) {
+        evicted.push_back(_index.popLRU());
+    }
+    removeFiles(evicted);
+}
+
+std::string DiskTileCache::tilePath(const Key& key) const {
+    return fmt::format("{}/{:016x}-{:016x}{}", _directory, key.dataset, key.tile,
+        TileExtension);
+}
+
+std::string DiskTileCache::indexPath() const {
+    return _directory + '/' + IndexFileName;
+}
+
+void DiskTileCache::readIndex() {
+    const std::string path = indexPath();
+    std::ifstream file(path, std::ifstream::binary);
+
+    IndexFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(IndexFileHeader));
+    bool validHeader = file.good() && header.magic == IndexMagic &&
+        header.version == FileVersion;
+    if (validHeader) {
+        // The number of entries has to match the size of the file before it is used to
+        // allocate memory, as the file might be truncated or corrupted
+        const std::streampos entriesBegin = file.tellg();
+        file.seekg(0, std::ifstream::end);
+        const uint64_t entriesSize = static_cast<uint64_t>(file.tellg() - entriesBegin);
+        file.seekg(entriesBegin);
+        validHeader = file.good() && entriesSize % sizeof(IndexFileEntry) == 0 &&
+            header.nEntries == entriesSize / sizeof(IndexFileEntry);
+    }
+    if (validHeader) {
+        std::vector<IndexFileEntry> entries(header.nEntries);
+        file.read(
+            reinterpret_cast<char*>(entries.data()),
+            entries.size() * sizeof(IndexFileEntry)
+        );
+
+        if (file.good()) {
+            // The entries are stored from the least to the most recently used
+            std::vector<std::pair<Key, uint64_t>> evicted;
+            for (const IndexFileEntry& e : entries) {
+                const Key key = { e.dataset, e.tile };
+                std::vector<std::pair<Key, uint64_t>> popped = _index.putAndFetchPopped(
+                    key,
+                    e.size,
+                    static_cast<size_t>(e.size)
+                );
+                evicted.insert(evicted.end(), popped.begin(), popped.end());
+            }
+            // The maximum size might have shrunk since the last session
+            removeFiles(evicted);
+            _index.resetStatistics();
+
+            // Remove the index file so that it is only present after a clean shutdown.
+            // Otherwise, we could not tell which tile files are tracked by the index
+            file.close();
+            std::remove(path.c_str());
+            return;
+        }
+    }
+
+    // Without a valid index we do not know which tiles are stored, so we start over
+    file.close();
+    std::remove(path.c_str());
+    ghoul::filesystem::Directory directory(_directory);
+    int nRemoved = 0;
+    for (const std::string& f : directory.readFiles()) {
+        if (endsWith(f, TileExtension) || endsWith(f, TemporaryExtension)) {
+            std::remove(f.c_str());
+            ++nRemoved;
+        }
+    }
+    if (nRemoved > 0) {
+        LWARNING(fmt::format(
+            "No valid index found in '{}'. Removed {} stale tile files",
+            _directory, nRemoved
+        ));
+    }
+}
+
+void DiskTileCache::writeIndex() {
+    std::lock_guard lock(_mutex);
+
+    std::vector<IndexFileEntry> entries;
+    entries.reserve(_index.size());
+    while (!_index.isEmpty()) {
+        const std::pair<Key, uint64_t> item = _index.popLRU();
+        entries.push_back({ item.first.dataset, item.first.tile, item.second });
+    }
+
+    IndexFileHeader header;
+    header.nEntries = entries.size();
+
+    std::ofstream file(indexPath(), std::ofstream::binary);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(IndexFileHeader));
+    file.write(
+        reinterpret_cast<const char*>(entries.data()),
+        entries.size() * sizeof(IndexFileEntry)
+    );
+    if (!file.good()) {
+        LERROR(fmt::format("Error writing tile cache index '{}'", indexPath()));
+    }
+}
+
+void DiskTileCache::removeFiles(
+                              const std::vector<std::pair<Key, uint64_t>>& evicted) const
+{
+    for (const std::pair<Key, uint64_t>& item : evicted) {
+        std::remove(tilePath(item.first).c_str());
+    }
+}
+
+} // namespace openspace::globebrowsing::cache
@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+
+#include <modules/globebrowsing/src/lrucache.h>
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace openspace::globebrowsing { class TileTextureInitData; }
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * A persistent second level cache for preprocessed <code>RawTile</code>s that survives
+ * between sessions. Each tile is stored in its own file in the cache directory, named
+ * after the identity of the dataset it was read from and its <code>TileIndex</code>. A
+ * tile file consists of a fixed size header, the <code>TileMetaData</code> of the tile,
+ * and the raw image data, which starts at a 64 byte aligned offset. A cache hit opens the
+ * file and reads the header, the meta data, and the image data into a newly allocated
+ * <code>RawTile</code> with three sequential reads, which is far cheaper than reading
+ * and preprocessing the tile from its dataset again. As the tiles are stored in separate
+ * files, single tiles can be replaced and deleted without touching the other ones.
+ *
+ * The cache keeps an in-memory index of all stored tiles in least-recently-used order,
+ * in which each tile costs its file size. If the total size exceeds the maximum size,
+ * the least recently used tiles are deleted. The index is written to the cache directory
+ * when the cache is destroyed and read back on construction. If no index is found, for
+ * example after a crash, all tile files in the directory are removed as their use order
+ * is unknown.
+ *
+ * All public methods are thread-safe and are called from the tile loading threads.
+ */
+class DiskTileCache {
+public:
+    /// Identifies the contents of a dataset, see #datasetIdentifier
+    using DatasetIdentifier = uint64_t;
+
+    /**
+     * \param directory The directory in which the tiles are stored. It is created if it
+     *        does not exist
+     * \param maximumSize The maximum total size of all stored tiles in bytes
+     */
+    DiskTileCache(std::string directory, uint64_t maximumSize);
+    ~DiskTileCache();
+
+    /**
+     * Returns an identifier for tiles read from the dataset at \p filePath with the
+     * texture layout \p initData. Two datasets only share an identifier if all of the
+     * parameters are equal, which means that their tiles are interchangeable. For a
+     * local file, its size and modification time are part of the identifier as well, so
+     * changing the file invalidates its cached tiles.
+     */
+    static DatasetIdentifier datasetIdentifier(const std::string& filePath,
+        const TileTextureInitData& initData, bool performPreprocessing);
+
+    /**
+     * Reads the tile \p tileIndex of the \p dataset from disk. Only the image data, the
+     * tile meta data, and the tile index of the returned tile are set.
+     *
+     * \return The stored tile, or <code>std::nullopt</code> if the tile is not cached or
+     *         the stored tile does not consist of exactly \p nBytes bytes of image data
+     */
+    std::optional<RawTile> get(DatasetIdentifier dataset, const TileIndex& tileIndex,
+        size_t nBytes);
+
+    /**
+     * Stores the \p tile of the \p dataset on disk, replacing a previously stored
+     * version, and evicts least recently used tiles if the cache is full. Tiles that
+     * were read with an error are ignored.
+     */
+    void put(DatasetIdentifier dataset, const RawTile& tile, size_t nBytes);
+
+    bool exist(DatasetIdentifier dataset, const TileIndex& tileIndex) const;
+
+    /// Returns the total size of all stored tiles in bytes
+    uint64_t size() const;
+
+    void setMaximumSize(uint64_t maximumSize);
+
+    /// Removes all stored tiles from disk
+    void clear();
+
+private:
+    struct Key {
+        DatasetIdentifier dataset = 0;
+        TileIndex::TileHashKey tile = 0;
+
+        bool operator==(const Key& rhs) const {
+            return dataset == rhs.dataset && tile == rhs.tile;
+        }
+    };
+
+    struct KeyHasher {
+        unsigned long long operator()(const Key& key) const {
+            return key.dataset ^ (key.tile * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    std::string tilePath(const Key& key) const;
+    std::string indexPath() const;
+
+    void readIndex();
+    void writeIndex();
+
+    /// Deletes the files of the evicted tiles. The mutex must be held by the caller
+    void removeFiles(const std::vector<std::pair<Key, uint64_t>>& evicted) const;
+
+    const std::string _directory;
+
+    mutable std::mutex _mutex;
+    /// Maps stored tiles to their file size in bytes
+    LRUCache<Key, uint64_t, KeyHasher> _index;
+
+    /// Used to create unique names for partially written tile files
+    std::atomic<unsigned int> _nTemporaryFiles = 0;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
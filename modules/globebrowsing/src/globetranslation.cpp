@@ -165,7 +165,7 @@ GlobeTranslation::GlobeTranslation(const ghoul::Dictionary& dictionary)
 
 void GlobeTranslation::fillAttachedNode() {
     SceneGraphNode* n = sceneGraphNode(_globe);
-    if (n->renderable() && dynamic_cast<RenderableGlobe*>(n->renderable())) {
+    if (n && n->renderable() && dynamic_cast<RenderableGlobe*>(n->renderable())) {
         _attachedNode = dynamic_cast<RenderableGlobe*>(n->renderable());
     }
     else {
@@ -173,20 +173,31 @@ void GlobeTranslation::fillAttachedNode() {
             "GlobeTranslation",
             "Could not set attached node as it does not have a RenderableGlobe"
         );
-        // Reset the globe name to it's previous name
-        _globe = _attachedNode->identifier();
+        if (_attachedNode) {
+            // Reset the globe name to it's previous name
+            _globe = _attachedNode->identifier();
+        }
     }
 }
 
-glm::dvec3 GlobeTranslation::position(const UpdateData&) const {
+bool GlobeTranslation::update(const UpdateData& data) {
+    // The globe might be loaded after this translation has been created. As nodes with
+    // this translation are updated on their own, it is safe to look it up here
     if (!_attachedNode) {
-        // @TODO(abock): The const cast should be removed on a redesign of the translation
-        //               to make the position function not constant. Const casting this
-        //               away is fine as the factories that create the translations don't
-        //               create them as constant objects
-        const_cast<GlobeTranslation*>(this)->fillAttachedNode();
+        fillAttachedNode();
         _positionIsDirty = true;
     }
+    return Translation::update(data);
+}
+
+bool GlobeTranslation::readsOtherNodes() const {
+    return true;
+}
+
+glm::dvec3 GlobeTranslation::position(const UpdateData&) const {
+    if (!_attachedNode) {
+        return _position;
+    }
 
     if (!_useFixedAltitude) {
         // If we don't use the fixed altitude, we have to compute the height every frame
@@ -39,8 +39,12 @@ class GlobeTranslation : public Translation {
 public:
     GlobeTranslation(const ghoul::Dictionary& dictionary);
 
+    bool update(const UpdateData& data) override;
     glm::dvec3 position(const UpdateData& data) const override;
 
+    /// The position depends on the globe's RenderableGlobe and its height information
+    bool readsOtherNodes() const override;
+
     static documentation::Documentation Documentation();
 
 private:
@@ -55,7 +59,7 @@ private:
     RenderableGlobe* _attachedNode = nullptr;
 
     mutable bool _positionIsDirty = true;
-    mutable glm::dvec3 _position;
+    mutable glm::dvec3 _position = glm::dvec3(0.0);
 };
 
 } // namespace openspace::globebrowsing
@@ -0,0 +1,202 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/heightcache.h>
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Same cut-off as is used in the shader. If one of the samples is a no data value
+    // that was replaced with the lowest float during preprocessing, the interpolated
+    // value might not be equal to it anymore
+    constexpr const float MinimumValidValue = -100000.f;
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+unsigned long long HeightCache::KeyHasher::operator()(
+                                                const TileIndex::TileHashKey& key) const
+{
+    return key * 0x9E3779B97F4A7C15ULL;
+}
+
+HeightCache::HeightCache(size_t maximumSize, TileDepthTransform depthTransform,
+                         float noDataValue)
+    : _depthTransform(depthTransform)
+    , _noDataValue(noDataValue)
+    , _tiles(maximumSize)
+{}
+
+void HeightCache::put(const RawTile& rawTile) {
+    if (!rawTile.imageData || !rawTile.textureInitData ||
+        rawTile.error != RawTile::ReadError::None)
+    {
+        return;
+    }
+    put(rawTile.tileIndex, *rawTile.textureInitData, rawTile.imageData.get());
+}
+
+void HeightCache::put(const TileIndex& tileIndex, const TileTextureInitData& initData,
+                      const void* values)
+{
+    if (!values || initData.glType != GL_FLOAT || initData.nRasters != 1) {
+        return;
+    }
+
+    HeightTile tile;
+    tile.dimensions = glm::ivec2(initData.dimensions);
+    tile.pixelStartOffset = initData.tilePixelStartOffset;
+    tile.pixelSizeDifference = initData.tilePixelSizeDifference;
+    tile.values.resize(static_cast<size_t>(tile.dimensions.x) * tile.dimensions.y);
+    std::memcpy(tile.values.data(), values, tile.values.size() * sizeof(float));
+
+    const size_t cost = tile.values.size() * sizeof(float);
+    std::lock_guard lock(_mutex);
+    _maxLevel = std::max(_maxLevel, tileIndex.level);
+    _tiles.put(tileIndex.hashKey(), std::move(tile), cost);
+}
+
+bool HeightCache::exist(const TileIndex& tileIndex) const {
+    std::lock_guard lock(_mutex);
+    return _tiles.exist(tileIndex.hashKey());
+}
+
+std::optional<float> HeightCache::height(const Geodetic2& position) {
+    std::lock_guard lock(_mutex);
+    return heightLocked(position);
+}
+
+std::vector<std::optional<float>> HeightCache::heights(
+                                                  const std::vector<Geodetic2>& positions)
+{
+    std::vector<std::optional<float>> result;
+    result.reserve(positions.size());
+
+    std::lock_guard lock(_mutex);
+    for (const Geodetic2& p : positions) {
+        result.push_back(heightLocked(p));
+    }
+    return result;
+}
+
+void HeightCache::clear() {
+    std::lock_guard lock(_mutex);
+    _tiles.clear();
+    _maxLevel = -1;
+}
+
+size_t HeightCache::size() const {
+    std::lock_guard lock(_mutex);
+    return _tiles.size();
+}
+
+std::optional<float> HeightCache::heightLocked(const Geodetic2& position) {
+    // Same mapping from geodetic coordinates to tile index space as in TileIndex
+    const double u = 0.5 + position.lon / glm::two_pi<double>();
+    const double v = 0.25 - position.lat / glm::two_pi<double>();
+
+    for (int level = _maxLevel; level >= 0; --level) {
+        const int nIndices = 1 << level;
+        const double xIndexSpace = u * nIndices;
+        const double yIndexSpace = v * nIndices;
+        const int x = std::clamp(
+            static_cast<int>(std::floor(xIndexSpace)),
+            0,
+            nIndices - 1
+        );
+        const int y = std::clamp(
+            static_cast<int>(std::floor(yIndexSpace)),
+            0,
+            std::max(nIndices / 2 - 1, 0)
+        );
+
+        const HeightTile* tile = _tiles.tryGet(TileIndex(x, y, level).hashKey());
+        if (tile) {
+            // The y axis of the tile index space points south, the y axis of the tile
+            // data points north
+            const glm::vec2 uv = glm::vec2(
+                static_cast<float>(xIndexSpace - x),
+                static_cast<float>(1.0 - (yIndexSpace - y))
+            );
+            const std::optional<float> value = sample(*tile, uv);
+            if (!value) {
+                return std::nullopt;
+            }
+            return _depthTransform.offset + _depthTransform.scale * *value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<float> HeightCache::sample(const HeightTile& tile,
+                                         const glm::vec2& uv) const
+{
+    // Padded tiles contain a border of pixels outside of the tile, see
+    // Layer::tileUvToTextureSamplePosition
+    const glm::vec2 dimensions = glm::vec2(tile.dimensions);
+    const glm::vec2 sourceSize = dimensions + glm::vec2(tile.pixelSizeDifference);
+    const glm::vec2 textureUv = (dimensions / sourceSize) *
+        (uv - glm::vec2(tile.pixelStartOffset) / sourceSize);
+    const glm::vec2 samplePos = textureUv * dimensions;
+
+    const glm::ivec2 maxPos = tile.dimensions - glm::ivec2(1);
+    const glm::ivec2 pos00 = glm::clamp(
+        glm::ivec2(glm::floor(samplePos)),
+        glm::ivec2(0),
+        maxPos
+    );
+    const glm::ivec2 pos11 = glm::min(pos00 + glm::ivec2(1), maxPos);
+    const glm::vec2 fract = glm::clamp(
+        samplePos - glm::vec2(pos00),
+        glm::vec2(0.f),
+        glm::vec2(1.f)
+    );
+
+    auto value = [&tile](int x, int y) {
+        return tile.values[static_cast<size_t>(y) * tile.dimensions.x + x];
+    };
+    const float sample00 = value(pos00.x, pos00.y);
+    const float sample10 = value(pos11.x, pos00.y);
+    const float sample01 = value(pos00.x, pos11.y);
+    const float sample11 = value(pos11.x, pos11.y);
+
+    for (float s : { sample00, sample10, sample01, sample11 }) {
+        if (std::isnan(s) || s == _noDataValue) {
+            return std::nullopt;
+        }
+    }
+
+    const float sample0 = sample00 * (1.f - fract.x) + sample10 * fract.x;
+    const float sample1 = sample01 * (1.f - fract.x) + sample11 * fract.x;
+    const float sample = sample0 * (1.f - fract.y) + sample1 * fract.y;
+    if (sample <= MinimumValidValue) {
+        return std::nullopt;
+    }
+    return sample;
+}
+
+} // namespace openspace::globebrowsing::cache
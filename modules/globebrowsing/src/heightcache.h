@@ -0,0 +1,130 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_CACHE___H__
+
+#include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/lrucache.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <ghoul/glm.h>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace openspace::globebrowsing { struct RawTile; }
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * A CPU-resident pyramid of the height values of a single height map dataset. The
+ * cache is fed with the <code>RawTile</code>s of the dataset as they are loaded and
+ * answers height queries by bilinearly interpolating the finest tile that covers the
+ * queried position. As only copies of the raw tile data are accessed, queries never
+ * touch any OpenGL objects.
+ *
+ * Each tile costs its size in bytes. If the total cost exceeds the maximum size, the
+ * least recently used tiles are evicted and queries fall back to coarser levels.
+ *
+ * All public methods are thread-safe.
+ */
+class HeightCache {
+public:
+    /**
+     * \param maximumSize The maximum total size of all stored tiles in bytes
+     * \param depthTransform The transform that converts the stored values into meters
+     * \param noDataValue The value of the dataset that signals missing data
+     */
+    HeightCache(size_t maximumSize, TileDepthTransform depthTransform,
+        float noDataValue);
+
+    /**
+     * Stores a copy of the height values of the \p rawTile. Tiles that do not consist
+     * of a single raster of <code>GL_FLOAT</code> values or that failed to load are
+     * ignored.
+     */
+    void put(const RawTile& rawTile);
+
+    /**
+     * Stores a copy of the height values of the tile \p tileIndex, which are laid out as
+     * described by the \p initData. This makes it possible to restore a tile from the
+     * CPU copy of its texture after it was evicted from this cache. Tiles that do not
+     * consist of a single raster of <code>GL_FLOAT</code> values are ignored.
+     */
+    void put(const TileIndex& tileIndex, const TileTextureInitData& initData,
+        const void* values);
+
+    /// Returns whether the tile \p tileIndex is stored, without marking it as used
+    bool exist(const TileIndex& tileIndex) const;
+
+    /**
+     * Returns the height in meters at the geodetic \p position, interpolated from the
+     * finest stored tile that covers it. Returns <code>std::nullopt</code> if no tile
+     * covers the position or if the tile has no valid data at the position.
+     */
+    std::optional<float> height(const Geodetic2& position);
+
+    /**
+     * Returns the heights for all \p positions, see #height. The cache is only locked
+     * once, which makes this cheaper than querying the positions individually.
+     */
+    std::vector<std::optional<float>> heights(const std::vector<Geodetic2>& positions);
+
+    /// Removes all stored tiles
+    void clear();
+
+    /// Returns the number of stored tiles
+    size_t size() const;
+
+private:
+    struct HeightTile {
+        std::vector<float> values;
+        glm::ivec2 dimensions = glm::ivec2(0);
+        glm::ivec2 pixelStartOffset = glm::ivec2(0);
+        glm::ivec2 pixelSizeDifference = glm::ivec2(0);
+    };
+
+    struct KeyHasher {
+        unsigned long long operator()(const TileIndex::TileHashKey& key) const;
+    };
+
+    /// Has to be called with the _mutex locked
+    std::optional<float> heightLocked(const Geodetic2& position);
+
+    /// Bilinearly interpolates the raw value at the \p uv coordinates of the \p tile
+    std::optional<float> sample(const HeightTile& tile, const glm::vec2& uv) const;
+
+    const TileDepthTransform _depthTransform;
+    const float _noDataValue;
+
+    mutable std::mutex _mutex;
+    LRUCache<TileIndex::TileHashKey, HeightTile, KeyHasher> _tiles;
+    /// The finest level of all tiles that have been stored
+    int _maxLevel = -1;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_CACHE___H__
@@ -25,29 +25,49 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 
-#include <list>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
 #include <vector>
 
 namespace openspace::globebrowsing::cache {
 
 /**
  * Templated class implementing a Least-Recently-Used Cache.
- * <code>KeyType</code> needs to be an enumerable type.
+ * <code>KeyType</code> needs to be an enumerable type, both <code>KeyType</code> and
+ * <code>ValueType</code> need to be default constructible.
+ *
+ * All entries are stored in a single contiguous slab and are linked into the LRU order
+ * through indices stored inside the entries themselves. The lookup from a key to its
+ * entry is done through an open-addressing hash table of entry indices. Thus, neither
+ * inserting nor touching an item allocates memory once the slab has grown to its working
+ * size and all operations are O(1).
+ *
+ * Every item has a cost that counts towards the maximum size of the cache. By default
+ * every item costs 1, so the maximum size is the maximum number of items. If a cost is
+ * provided, for example the number of bytes occupied by the value, the cache evicts
+ * least recently used items until the total cost fits into the maximum size.
  */
 template <typename KeyType, typename ValueType, typename HasherType>
 class LRUCache {
 public:
     using Item = std::pair<KeyType, ValueType>;
-    using Items = std::list<Item>;
+
+    struct Statistics {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
 
     /**
-     * \param size is the maximum size of the cache given in number of cached items.
+     * \param size is the maximum size of the cache given as the total cost of all cached
+     *        items. With the default cost of 1 per item, this is the number of items.
      */
     LRUCache(size_t size);
 
-    void put(KeyType key, ValueType value);
-    std::vector<Item> putAndFetchPopped(KeyType key, ValueType value);
+    void put(KeyType key, ValueType value, size_t cost = 1);
+    std::vector<Item> putAndFetchPopped(KeyType key, ValueType value, size_t cost = 1);
     void clear();
     bool exist(const KeyType& key) const;
 
@@ -59,6 +79,27 @@ public:
     bool isEmpty() const;
     ValueType get(const KeyType& key);
 
+    /**
+     * If the value exists, the value is bumped to the front of the queue and a pointer to
+     * it is returned. The pointer is valid until the cache is modified the next time.
+     * \returns a pointer to the value of this key or <code>nullptr</code> if it does not
+     *          exist
+     */
+    ValueType* tryGet(const KeyType& key);
+
+    /**
+     * Removes the item with the key from the cache without counting it as an eviction.
+     * \returns true if an item with this key existed.
+     */
+    bool erase(const KeyType& key);
+
+    /**
+     * Removes the item with the key from the cache without counting it as an eviction
+     * and returns its value, so that the resources it refers to can be released.
+     * \returns the value of this key or <code>std::nullopt</code> if it does not exist
+     */
+    std::optional<ValueType> extract(const KeyType& key);
+
     /**
      * Pops the front of the queue.
      */
@@ -71,16 +112,65 @@ public:
     size_t size() const;
     size_t maximumCacheSize() const;
 
+    /**
+     * Sets the maximum total cost of the cache and evicts items until the current cost
+     * fits into it.
+     */
+    void setMaximumCacheSize(size_t size);
+
+    /// Returns the sum of the costs of all items currently in the cache
+    size_t totalCost() const;
+
+    /// Returns the number of cache hits, misses, and evictions since the last reset
+    const Statistics& statistics() const;
+    void resetStatistics();
+
 private:
-    void putWithoutCleaning(KeyType key, ValueType value);
+    using Index = uint32_t;
+    static constexpr const Index Invalid = UINT32_MAX;
+    // The lookup table starts with 2^(64 - InitialBucketShift) = 16 buckets
+    static constexpr const int InitialBucketShift = 60;
+
+    struct Entry {
+        KeyType key;
+        ValueType value;
+        unsigned long long hash = 0;
+        size_t cost = 0;
+        Index prev = Invalid;
+        Index next = Invalid;
+    };
+
+    void putWithoutCleaning(KeyType key, ValueType value, size_t cost);
     void clean();
-
     std::vector<Item> cleanAndFetchPopped();
 
-    Items _itemList;
-    std::unordered_map<KeyType, typename Items::const_iterator, HasherType> _itemMap;
+    /// Removes the entry from the LRU list and the lookup table and frees its slot
+    Item remove(Index entry);
+
+    void linkFront(Index entry);
+    void unlink(Index entry);
+    void moveToFront(Index entry);
+
+    size_t homeBucket(unsigned long long hash) const;
+
+    /// Returns the bucket that contains the entry for the key, or an empty bucket
+    size_t findBucket(const KeyType& key, unsigned long long hash) const;
+    void eraseBucket(size_t bucket);
+    void growBuckets();
+
+    std::vector<Entry> _entries;
+    Index _freeList = Invalid;
+    Index _head = Invalid;
+    Index _tail = Invalid;
+
+    // Open-addressing table with linear probing that maps to indices into _entries
+    std::vector<Index> _buckets;
+    int _bucketShift;
 
+    size_t _nItems = 0;
+    size_t _totalCost = 0;
     size_t _maximumCacheSize;
+    Statistics _statistics;
 };
 
 } // namespace openspace::globebrowsing::cache
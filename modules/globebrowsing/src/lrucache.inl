@@ -23,97 +23,130 @@
  ****************************************************************************************/
 
 #include <ghoul/misc/assert.h>
+#include <algorithm>
 
 namespace openspace::globebrowsing::cache {
 
 template<typename KeyType, typename ValueType, typename HasherType>
 LRUCache<KeyType, ValueType, HasherType>::LRUCache(size_t size)
-    : _maximumCacheSize(size)
+    : _buckets(size_t(1) << (64 - InitialBucketShift), Invalid)
+    , _bucketShift(InitialBucketShift)
+    , _maximumCacheSize(size)
 {}
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clear() {
-    _itemList.clear();
-    _itemMap.clear();
+    _entries.clear();
+    _freeList = Invalid;
+    _head = Invalid;
+    _tail = Invalid;
+    std::fill(_buckets.begin(), _buckets.end(), Invalid);
+    _nItems = 0;
+    _totalCost = 0;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
-void LRUCache<KeyType, ValueType, HasherType>::put(KeyType key, ValueType value) {
-    putWithoutCleaning(std::move(key), std::move(value));
+void LRUCache<KeyType, ValueType, HasherType>::put(KeyType key, ValueType value,
+                                                   size_t cost)
+{
+    putWithoutCleaning(std::move(key), std::move(value), cost);
     clean();
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::vector<std::pair<KeyType, ValueType>>
-LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueType value)
+LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueType value,
+                                                            size_t cost)
 {
-    putWithoutCleaning(std::move(key), std::move(value));
+    putWithoutCleaning(std::move(key), std::move(value), cost);
     return cleanAndFetchPopped();
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
-    return (_itemMap.count(key) > 0);
+    const size_t bucket = findBucket(key, HasherType()(key));
+    return _buckets[bucket] != Invalid;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) { // Found in cache
-        ValueType value = it->second->second;
-        // Remove from current position
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
-        // Bump to front
-        _itemList.emplace_front(key, value);
-        _itemMap.emplace(key, _itemList.begin());
-
+    const size_t bucket = findBucket(key, HasherType()(key));
+    if (_buckets[bucket] != Invalid) { // Found in cache
+        moveToFront(_buckets[bucket]);
         return true;
-    } else {
+    }
+    else {
         return false;
     }
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::isEmpty() const {
-    return (_itemMap.size() == 0);
+    return (_nItems == 0);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 ValueType LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
-    //ghoul_assert(exist(key), "Key " << key << " must exist");
-    const auto it = _itemMap.find(key);
-    // Move list iterator pointing to value
-    _itemList.splice(_itemList.begin(), _itemList, it->second);
-    return it->second->second;
+    ValueType* value = tryGet(key);
+    ghoul_assert(value, "Key must exist in the cache");
+    return *value;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
-std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
+ValueType* LRUCache<KeyType, ValueType, HasherType>::tryGet(const KeyType& key) {
+    const size_t bucket = findBucket(key, HasherType()(key));
+    const Index entry = _buckets[bucket];
+    if (entry == Invalid) {
+        ++_statistics.misses;
+        return nullptr;
+    }
 
-    auto first_it = _itemList.begin();
-    _itemMap.erase(first_it->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.front();
-    _itemList.pop_front();
-    return toReturn;
+    ++_statistics.hits;
+    moveToFront(entry);
+    return &_entries[entry].value;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
-std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popLRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
+bool LRUCache<KeyType, ValueType, HasherType>::erase(const KeyType& key) {
+    const size_t bucket = findBucket(key, HasherType()(key));
+    if (_buckets[bucket] != Invalid) {
+        remove(_buckets[bucket]);
+        return true;
+    }
+    else {
+        return false;
+    }
+}
 
-    auto lastIt = _itemList.end();
-    lastIt--;
-    _itemMap.erase(lastIt->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.back();
-    _itemList.pop_back();
-    return toReturn;
+template<typename KeyType, typename ValueType, typename HasherType>
+std::optional<ValueType> LRUCache<KeyType, ValueType, HasherType>::extract(
+                                                                       const KeyType& key)
+{
+    const size_t bucket = findBucket(key, HasherType()(key));
+    if (_buckets[bucket] != Invalid) {
+        return remove(_buckets[bucket]).second;
+    }
+    else {
+        return std::nullopt;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
+    ghoul_assert(_head != Invalid, "Cannot pop LRU cache. Ensure cache is not empty.");
+    return remove(_head);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popLRU() {
+    ghoul_assert(_tail != Invalid, "Cannot pop LRU cache. Ensure cache is not empty.");
+    ++_statistics.evictions;
+    return remove(_tail);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 size_t LRUCache<KeyType, ValueType, HasherType>::size() const {
-    return _itemMap.size();
+    return _nItems;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -121,26 +154,79 @@ size_t LRUCache<KeyType, ValueType, HasherType>::maximumCacheSize() const {
     return _maximumCacheSize;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::setMaximumCacheSize(size_t size) {
+    _maximumCacheSize = size;
+    clean();
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::totalCost() const {
+    return _totalCost;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+const typename LRUCache<KeyType, ValueType, HasherType>::Statistics&
+LRUCache<KeyType, ValueType, HasherType>::statistics() const
+{
+    return _statistics;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::resetStatistics() {
+    _statistics = Statistics();
+}
+
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(KeyType key,
-                                                                  ValueType value)
+                                                                  ValueType value,
+                                                                  size_t cost)
 {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) {
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
+    const unsigned long long hash = HasherType()(key);
+    size_t bucket = findBucket(key, hash);
+    if (_buckets[bucket] != Invalid) {
+        // The key already exists, so we replace the value and bump it to the front
+        Entry& e = _entries[_buckets[bucket]];
+        e.value = std::move(value);
+        _totalCost = _totalCost - e.cost + cost;
+        e.cost = cost;
+        moveToFront(_buckets[bucket]);
+        return;
+    }
+
+    // Keep the load factor of the lookup table at or below 50%
+    if ((_nItems + 1) * 2 > _buckets.size()) {
+        growBuckets();
+        bucket = findBucket(key, hash);
+    }
+
+    Index entry = _freeList;
+    if (entry != Invalid) {
+        _freeList = _entries[entry].next;
+    }
+    else {
+        ghoul_assert(_entries.size() < Invalid, "Too many entries in the cache");
+        entry = static_cast<Index>(_entries.size());
+        _entries.emplace_back();
     }
-    _itemList.emplace_front(key, std::move(value));
-    _itemMap.emplace(std::move(key), _itemList.begin());
+
+    Entry& e = _entries[entry];
+    e.key = std::move(key);
+    e.value = std::move(value);
+    e.hash = hash;
+    e.cost = cost;
+    _buckets[bucket] = entry;
+    linkFront(entry);
+
+    ++_nItems;
+    _totalCost += cost;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clean() {
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        _itemList.pop_back();
+    while (_totalCost > _maximumCacheSize && _tail != Invalid) {
+        ++_statistics.evictions;
+        remove(_tail);
     }
 }
 
@@ -149,14 +235,139 @@ std::vector<std::pair<KeyType, ValueType>>
 LRUCache<KeyType, ValueType, HasherType>::cleanAndFetchPopped()
 {
     std::vector<std::pair<KeyType, ValueType>> toReturn;
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        toReturn.push_back(_itemList.back());
-        _itemList.pop_back();
+    while (_totalCost > _maximumCacheSize && _tail != Invalid) {
+        ++_statistics.evictions;
+        toReturn.push_back(remove(_tail));
     }
     return toReturn;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::remove(
+                                                                              Index entry)
+{
+    Entry& e = _entries[entry];
+    unlink(entry);
+    eraseBucket(findBucket(e.key, e.hash));
+
+    std::pair<KeyType, ValueType> item = { std::move(e.key), std::move(e.value) };
+    // Reset the slot so that it does not keep any resources alive while it is unused
+    e.key = KeyType();
+    e.value = ValueType();
+    e.next = _freeList;
+    _freeList = entry;
+
+    --_nItems;
+    _totalCost -= e.cost;
+    return item;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::linkFront(Index entry) {
+    Entry& e = _entries[entry];
+    e.prev = Invalid;
+    e.next = _head;
+    if (_head != Invalid) {
+        _entries[_head].prev = entry;
+    }
+    _head = entry;
+    if (_tail == Invalid) {
+        _tail = entry;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::unlink(Index entry) {
+    Entry& e = _entries[entry];
+    if (e.prev != Invalid) {
+        _entries[e.prev].next = e.next;
+    }
+    else {
+        _head = e.next;
+    }
+
+    if (e.next != Invalid) {
+        _entries[e.next].prev = e.prev;
+    }
+    else {
+        _tail = e.prev;
+    }
+    e.prev = Invalid;
+    e.next = Invalid;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::moveToFront(Index entry) {
+    if (entry != _head) {
+        unlink(entry);
+        linkFront(entry);
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::homeBucket(unsigned long long hash) const
+{
+    // Fibonacci hashing spreads out keys whose entropy is only in the low or high bits,
+    // like the tile indices
+    return static_cast<size_t>((hash * 11400714819323198485ULL) >> _bucketShift);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::findBucket(const KeyType& key,
+                                                         unsigned long long hash) const
+{
+    const size_t mask = _buckets.size() - 1;
+    size_t bucket = homeBucket(hash);
+    while (true) {
+        const Index entry = _buckets[bucket];
+        if (entry == Invalid ||
+            (_entries[entry].hash == hash && _entries[entry].key == key))
+        {
+            return bucket;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::eraseBucket(size_t bucket) {
+    // Backward shift deletion; move every following entry of the probe sequence into the
+    // hole unless its home bucket lies between the hole and its current position
+    const size_t mask = _buckets.size() - 1;
+    size_t hole = bucket;
+    size_t current = bucket;
+    while (true) {
+        current = (current + 1) & mask;
+        const Index entry = _buckets[current];
+        if (entry == Invalid) {
+            break;
+        }
+
+        const size_t home = homeBucket(_entries[entry].hash);
+        const bool isInPlace = (hole < current) ?
+            (hole < home && home <= current) :
+            (hole < home || home <= current);
+        if (!isInPlace) {
+            _buckets[hole] = entry;
+            hole = current;
+        }
+    }
+    _buckets[hole] = Invalid;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::growBuckets() {
+    _buckets.assign(_buckets.size() * 2, Invalid);
+    --_bucketShift;
+
+    const size_t mask = _buckets.size() - 1;
+    for (Index entry = _head; entry != Invalid; entry = _entries[entry].next) {
+        size_t bucket = homeBucket(_entries[entry].hash);
+        while (_buckets[bucket] != Invalid) {
+            bucket = (bucket + 1) & mask;
+        }
+        _buckets[bucket] = entry;
+    }
+}
+
 } // namespace openspace::globebrowsing::cache
@@ -29,6 +29,7 @@
 #include <modules/globebrowsing/src/rawtile.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
+#include <algorithm>
 #include <numeric>
 
 namespace {
@@ -54,6 +55,27 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo HitsPerFrameInfo = {
+        "TileCacheHitsPerFrame",
+        "Tile cache hits per frame",
+        "This value denotes the number of tile requests in the last frame that were "
+        "answered from the tile cache."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MissesPerFrameInfo = {
+        "TileCacheMissesPerFrame",
+        "Tile cache misses per frame",
+        "This value denotes the number of tile requests in the last frame for tiles that "
+        "were not present in the tile cache."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo EvictionsPerFrameInfo = {
+        "TileCacheEvictionsPerFrame",
+        "Tile cache evictions per frame",
+        "This value denotes the number of tiles that were evicted from the tile cache in "
+        "the last frame to make room for new tiles."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo ApplyTileCacheInfo = {
         "ApplyTileCacheSize",
         "Apply tile cache size",
@@ -190,46 +212,19 @@ namespace openspace::globebrowsing::cache {
 //
 // TextureContainer
 //
-MemoryAwareTileCache::TextureContainer::TextureContainer(TileTextureInitData initData,
-                                                         size_t numTextures)
+MemoryAwareTileCache::TextureContainer::TextureContainer(TileTextureInitData initData)
     : _initData(std::move(initData))
-    , _numTextures(numTextures)
-{
-    reset();
-}
+{}
 
 void MemoryAwareTileCache::TextureContainer::reset() {
     _textures.clear();
-    _freeTexture = 0;
-    for (size_t i = 0; i < _numTextures; ++i) {
-        using namespace ghoul::opengl;
-        std::unique_ptr<Texture> tex = std::make_unique<Texture>(
-            _initData.dimensions,
-            _initData.ghoulTextureFormat,
-            toGlTextureFormat(_initData.glType, _initData.ghoulTextureFormat),
-            _initData.glType,
-            Texture::FilterMode::Linear,
-            Texture::WrappingMode::ClampToEdge,
-            Texture::AllocateData(_initData.shouldAllocateDataOnCPU)
-        );
-
-        tex->setDataOwnership(Texture::TakeOwnership::Yes);
-        tex->uploadTexture();
-        tex->setFilter(Texture::FilterMode::AnisotropicMipMap);
-
-        _textures.push_back(std::move(tex));
-    }
-}
-
-void MemoryAwareTileCache::TextureContainer::reset(size_t numTextures) {
-    _numTextures = numTextures;
-    reset();
+    _releasedTextures.clear();
 }
 
 ghoul::opengl::Texture* MemoryAwareTileCache::TextureContainer::getTextureIfFree() {
-    if (_freeTexture < _textures.size()) {
-        ghoul::opengl::Texture* texture = _textures[_freeTexture].get();
-        _freeTexture++;
+    if (!_releasedTextures.empty()) {
+        ghoul::opengl::Texture* texture = _releasedTextures.back();
+        _releasedTextures.pop_back();
         return texture;
     }
     else {
@@ -237,6 +232,57 @@ ghoul::opengl::Texture* MemoryAwareTileCache::TextureContainer::getTextureIfFree
     }
 }
 
+ghoul::opengl::Texture* MemoryAwareTileCache::TextureContainer::allocateTexture() {
+    using namespace ghoul::opengl;
+    std::unique_ptr<Texture> tex = std::make_unique<Texture>(
+        _initData.dimensions,
+        _initData.ghoulTextureFormat,
+        toGlTextureFormat(_initData.glType, _initData.ghoulTextureFormat),
+        _initData.glType,
+        Texture::FilterMode::Linear,
+        Texture::WrappingMode::ClampToEdge,
+        Texture::AllocateData(_initData.shouldAllocateDataOnCPU)
+    );
+
+    tex->setDataOwnership(Texture::TakeOwnership::Yes);
+    tex->uploadTexture();
+    tex->setFilter(Texture::FilterMode::AnisotropicMipMap);
+
+    _textures.push_back(std::move(tex));
+    return _textures.back().get();
+}
+
+void MemoryAwareTileCache::TextureContainer::releaseTexture(
+                                                          ghoul::opengl::Texture* texture)
+{
+    if (texture) {
+        _releasedTextures.push_back(texture);
+    }
+}
+
+void MemoryAwareTileCache::TextureContainer::destroyReleasedTextures() {
+    if (_releasedTextures.empty()) {
+        return;
+    }
+
+    std::sort(_releasedTextures.begin(), _releasedTextures.end());
+    _textures.erase(
+        std::remove_if(
+            _textures.begin(),
+            _textures.end(),
+            [this](const std::unique_ptr<ghoul::opengl::Texture>& t) {
+                return std::binary_search(
+                    _releasedTextures.begin(),
+                    _releasedTextures.end(),
+                    t.get()
+                );
+            }
+        ),
+        _textures.end()
+    );
+    _releasedTextures.clear();
+}
+
 const TileTextureInitData&
 MemoryAwareTileCache::TextureContainer::tileTextureInitData() const
 {
@@ -253,10 +299,14 @@ size_t MemoryAwareTileCache::TextureContainer::size() const {
 
 MemoryAwareTileCache::MemoryAwareTileCache()
     : PropertyOwner({ "TileCache" })
+    , _tileCache(0)
     , _numTextureBytesAllocatedOnCPU(0)
     , _cpuAllocatedTileData(CpuAllocatedDataInfo, 1024, 128, 16384, 1)
     , _gpuAllocatedTileData(GpuAllocatedDataInfo, 1024, 128, 16384, 1)
     , _tileCacheSize(TileCacheSizeInfo, 1024, 128, 16384, 1)
+    , _hitsPerFrame(HitsPerFrameInfo, 0, 0, std::numeric_limits<int>::max())
+    , _missesPerFrame(MissesPerFrameInfo, 0, 0, std::numeric_limits<int>::max())
+    , _evictionsPerFrame(EvictionsPerFrameInfo, 0, 0, std::numeric_limits<int>::max())
     , _applyTileCacheSize(ApplyTileCacheInfo)
     , _clearTileCache(ClearTileCacheInfo)
 {
@@ -287,17 +337,24 @@ MemoryAwareTileCache::MemoryAwareTileCache()
     );
     addProperty(_tileCacheSize);
 
+    _hitsPerFrame.setReadOnly(true);
+    addProperty(_hitsPerFrame);
+    _missesPerFrame.setReadOnly(true);
+    addProperty(_missesPerFrame);
+    _evictionsPerFrame.setReadOnly(true);
+    addProperty(_evictionsPerFrame);
+
     setSizeEstimated(_tileCacheSize * 1024 * 1024);
 }
 
 void MemoryAwareTileCache::clear() {
     LINFO("Clearing tile cache");
     _numTextureBytesAllocatedOnCPU = 0;
-    using K = TileTextureInitData::HashKey;
-    using V = TextureContainerTileCache;
-    for (std::pair<const K, V>& p : _textureContainerMap) {
-        p.second.first->reset();
-        p.second.second->clear();
+    _tileCache.clear();
+    for (std::pair<const TileTextureInitData::HashKey,
+                   std::unique_ptr<TextureContainer>>& p : _textureContainerMap)
+    {
+        p.second->reset();
     }
     LINFO("Tile cache cleared");
 }
@@ -317,80 +374,40 @@ void MemoryAwareTileCache::assureTextureContainerExists(
 {
     TileTextureInitData::HashKey initDataKey = initData.hashKey;
     if (_textureContainerMap.find(initDataKey) == _textureContainerMap.end()) {
-        // For now create 500 textures of this type
-        _textureContainerMap.emplace(initDataKey,
-            TextureContainerTileCache(
-                std::make_unique<TextureContainer>(initData, 500),
-                std::make_unique<TileCache>(std::numeric_limits<std::size_t>::max())
-            )
+        _textureContainerMap.emplace(
+            initDataKey,
+            std::make_unique<TextureContainer>(initData)
         );
     }
 }
 
 void MemoryAwareTileCache::setSizeEstimated(size_t estimatedSize) {
     LDEBUG("Resetting tile cache size");
-    ghoul_assert(!_textureContainerMap.empty(), "Texture containers must exist.");
-
-    const size_t sumTextureTypeSize = std::accumulate(
-        _textureContainerMap.cbegin(),
-        _textureContainerMap.cend(),
-        size_t(0),
-        [](size_t s, const std::pair<const TileTextureInitData::HashKey,
-                                     TextureContainerTileCache>& p)
-        {
-            return s + p.second.first->tileTextureInitData().totalNumBytes;
-        }
-    );
 
-    if (sumTextureTypeSize > 0) {
-        const size_t numTexturesPerType = estimatedSize / sumTextureTypeSize;
-        resetTextureContainerSize(numTexturesPerType);
-    }
-    else {
-        resetTextureContainerSize(0);
+    // The tiles that no longer fit are evicted here, as the cache itself would discard
+    // them without returning their textures
+    while (_tileCache.totalCost() > estimatedSize && !_tileCache.isEmpty()) {
+        releaseTexture(_tileCache.popLRU().second);
     }
-    LINFO("Tile cache size was reset");
-}
+    _tileCache.setMaximumCacheSize(estimatedSize);
 
-void MemoryAwareTileCache::resetTextureContainerSize(size_t numTexturesPerTextureType) {
-    _numTextureBytesAllocatedOnCPU = 0;
     for (std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p : _textureContainerMap)
+                   std::unique_ptr<TextureContainer>>& p : _textureContainerMap)
     {
-        p.second.first->reset(numTexturesPerTextureType);
-        p.second.second->clear();
+        p.second->destroyReleasedTextures();
     }
+    LINFO("Tile cache size was reset");
 }
 
 bool MemoryAwareTileCache::exist(const ProviderTileKey& key) const {
-    const TextureContainerMap::const_iterator result = std::find_if(
-        _textureContainerMap.cbegin(),
-        _textureContainerMap.cend(),
-        [&](const std::pair<const TileTextureInitData::HashKey,
-                            TextureContainerTileCache>& p)
-        {
-            return p.second.second->exist(key);
-        }
-    );
-    return result != _textureContainerMap.cend();
+    return _tileCache.exist(key);
 }
 
 Tile MemoryAwareTileCache::get(const ProviderTileKey& key) {
-    const TextureContainerMap::const_iterator it = std::find_if(
-        _textureContainerMap.cbegin(),
-        _textureContainerMap.cend(),
-        [&](const std::pair<const TileTextureInitData::HashKey,
-                            TextureContainerTileCache>& p)
-        {
-            return p.second.second->exist(key);
-        }
-    );
-    if (it != _textureContainerMap.cend()) {
-        return it->second.second->get(key);
-    }
-    else {
-        return Tile();
+    if (CachedTile* cachedTile = _tileCache.tryGet(key)) {
+        return cachedTile->tile;
     }
+    return Tile();
 }
 
 ghoul::opengl::Texture* MemoryAwareTileCache::texture(
@@ -398,19 +415,34 @@ ghoul::opengl::Texture* MemoryAwareTileCache::texture(
 {
     // if this texture type does not exist among the texture containers
     // it needs to be created
-    TileTextureInitData::HashKey initDataKey = initData.hashKey;
     assureTextureContainerExists(initData);
-    // Now we know that the texture container exists,
-    // check if there are any unused textures
-    ghoul::opengl::Texture* texture =
-        _textureContainerMap[initDataKey].first->getTextureIfFree();
-    // Second option. No more textures available. Pop from the LRU cache
-    if (!texture) {
-        Tile oldTile = _textureContainerMap[initDataKey].second->popLRU().second;
-        // Use the old tile's texture
-        texture = oldTile.texture;
+    TextureContainer& container = *_textureContainerMap[initData.hashKey];
+
+    // First option. Reuse a texture of a tile that has left the cache
+    ghoul::opengl::Texture* texture = container.getTextureIfFree();
+    if (texture) {
+        return texture;
+    }
+
+    // Second option. Allocate a new texture. To stay within the byte budget, unused
+    // textures of other types are destroyed and the least recently used tiles are
+    // evicted first. An evicted tile of the same type hands its texture over directly
+    for (std::pair<const TileTextureInitData::HashKey,
+                   std::unique_ptr<TextureContainer>>& p : _textureContainerMap)
+    {
+        p.second->destroyReleasedTextures();
     }
-    return texture;
+    while (gpuAllocatedDataSize() + initData.totalNumBytes >
+           _tileCache.maximumCacheSize() && !_tileCache.isEmpty())
+    {
+        CachedTile evicted = _tileCache.popLRU().second;
+        if (evicted.initDataKey == initData.hashKey && evicted.tile.texture) {
+            return evicted.tile.texture;
+        }
+        releaseTexture(evicted);
+        _textureContainerMap[evicted.initDataKey]->destroyReleasedTextures();
+    }
+    return container.allocateTexture();
 }
 
 void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile) {
@@ -453,8 +485,7 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile
         }
         tex->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
         Tile tile{ tex, std::move(rawTile.tileMetaData), Tile::Status::OK };
-        TileTextureInitData::HashKey initDataKey = initData.hashKey;
-        _textureContainerMap[initDataKey].second->put(std::move(key), std::move(tile));
+        putIntoTileCache(key, initData.hashKey, std::move(tile));
     }
 }
 
@@ -462,7 +493,36 @@ void MemoryAwareTileCache::put(const ProviderTileKey& key,
                                const TileTextureInitData::HashKey& initDataKey,
                                Tile tile)
 {
-    _textureContainerMap[initDataKey].second->put(key, std::move(tile));
+    putIntoTileCache(key, initDataKey, std::move(tile));
+}
+
+void MemoryAwareTileCache::putIntoTileCache(const ProviderTileKey& key,
+                                          const TileTextureInitData::HashKey& initDataKey,
+                                            Tile tile)
+{
+    const TextureContainerMap::const_iterator it = _textureContainerMap.find(initDataKey);
+    ghoul_assert(it != _textureContainerMap.end(), "Texture container must exist");
+    const size_t cost = it->second->tileTextureInitData().totalNumBytes;
+
+    // A tile that is replaced gives its texture back, unless the new tile reuses it
+    std::optional<CachedTile> replaced = _tileCache.extract(key);
+    if (replaced && replaced->tile.texture != tile.texture) {
+        releaseTexture(*replaced);
+    }
+
+    // Tiles that are evicted to stay within the byte budget give their textures back
+    std::vector<std::pair<ProviderTileKey, CachedTile>> evicted =
+        _tileCache.putAndFetchPopped(key, { std::move(tile), initDataKey }, cost);
+    for (std::pair<ProviderTileKey, CachedTile>& p : evicted) {
+        releaseTexture(p.second);
+    }
+}
+
+void MemoryAwareTileCache::releaseTexture(const CachedTile& cachedTile) {
+    auto it = _textureContainerMap.find(cachedTile.initDataKey);
+    if (it != _textureContainerMap.end()) {
+        it->second->releaseTexture(cachedTile.tile.texture);
+    }
 }
 
 void MemoryAwareTileCache::update() {
@@ -473,6 +533,12 @@ void MemoryAwareTileCache::update() {
 
     _cpuAllocatedTileData = static_cast<int>(dataSizeCPU / ByteToMegaByte);
     _gpuAllocatedTileData = static_cast<int>(dataSizeGPU / ByteToMegaByte);
+
+    const TileCache::Statistics& statistics = _tileCache.statistics();
+    _hitsPerFrame = static_cast<int>(statistics.hits);
+    _missesPerFrame = static_cast<int>(statistics.misses);
+    _evictionsPerFrame = static_cast<int>(statistics.evictions);
+    _tileCache.resetStatistics();
 }
 
 size_t MemoryAwareTileCache::gpuAllocatedDataSize() const {
@@ -481,9 +547,9 @@ size_t MemoryAwareTileCache::gpuAllocatedDataSize() const {
         _textureContainerMap.cend(),
         size_t(0),
         [](size_t s, const std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p)
+        std::unique_ptr<TextureContainer>>& p)
         {
-            const TextureContainer& textureContainer = *p.second.first;
+            const TextureContainer& textureContainer = *p.second;
             const size_t nBytes = textureContainer.tileTextureInitData().totalNumBytes;
             return s + nBytes * textureContainer.size();
         }
@@ -496,9 +562,9 @@ size_t MemoryAwareTileCache::cpuAllocatedDataSize() const {
         _textureContainerMap.cend(),
         size_t(0),
         [](size_t s, const std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p)
+        std::unique_ptr<TextureContainer>>& p)
         {
-            const TextureContainer& textureContainer = *p.second.first;
+            const TextureContainer& textureContainer = *p.second;
             const TileTextureInitData& initData = textureContainer.tileTextureInitData();
             if (initData.shouldAllocateDataOnCPU) {
                 size_t bytesPerTexture = initData.totalNumBytes;
@@ -510,4 +576,8 @@ size_t MemoryAwareTileCache::cpuAllocatedDataSize() const {
     return dataSize + _numTextureBytesAllocatedOnCPU;
 }
 
+size_t MemoryAwareTileCache::tileDataSize() const {
+    return _tileCache.totalCost();
+}
+
 } // namespace openspace::globebrowsing::cache
@@ -100,31 +100,49 @@ public:
     size_t gpuAllocatedDataSize() const;
     size_t cpuAllocatedDataSize() const;
 
+    /// Returns the number of texture bytes that are used by the tiles in the cache
+    size_t tileDataSize() const;
+
 private:
     /**
      * Owner of texture data used for tiles. Instead of dynamically allocating textures
-     * one by one, they are created once and reused.
+     * for every tile, the textures of tiles that leave the cache are kept and reused.
      */
     class TextureContainer {
     public:
         /**
          * \param initData is the description of the texture type.
-         * \param numTextures is the number of textures to allocate.
          */
-        TextureContainer(TileTextureInitData initData, size_t numTextures);
+        TextureContainer(TileTextureInitData initData);
 
         ~TextureContainer() = default;
 
+        /// Destroys all textures of this container
         void reset();
-        void reset(size_t numTextures);
 
         /**
-         * \return A pointer to a texture if there is one texture never used before. If
-         *         there are no textures left, nullptr is returned. TextureContainer still
-         *         owns the texture so no delete should be called on the raw pointer.
+         * \return A pointer to a texture that was released before. If there is none,
+         *         nullptr is returned. TextureContainer still owns the texture so no
+         *         delete should be called on the raw pointer.
          */
         ghoul::opengl::Texture* getTextureIfFree();
 
+        /**
+         * Creates a new texture that is owned by this TextureContainer.
+         */
+        ghoul::opengl::Texture* allocateTexture();
+
+        /**
+         * Returns a texture that was handed out by this container, for example when the
+         * tile using it was evicted from the cache, so that it can be reused.
+         */
+        void releaseTexture(ghoul::opengl::Texture* texture);
+
+        /**
+         * Destroys all textures that were released and not handed out again.
+         */
+        void destroyReleasedTextures();
+
         const TileTextureInitData& tileTextureInitData() const;
 
         /**
@@ -134,34 +152,43 @@ private:
 
     private:
         std::vector<std::unique_ptr<ghoul::opengl::Texture>> _textures;
+        std::vector<ghoul::opengl::Texture*> _releasedTextures;
 
         const TileTextureInitData _initData;
-        size_t _freeTexture = 0;
-        size_t _numTextures;
     };
 
+    struct CachedTile {
+        Tile tile;
+        TileTextureInitData::HashKey initDataKey = 0;
+    };
 
     void createDefaultTextureContainers();
     void assureTextureContainerExists(const TileTextureInitData& initData);
-    void resetTextureContainerSize(size_t numTexturesPerTextureType);
+    void putIntoTileCache(const ProviderTileKey& key,
+        const TileTextureInitData::HashKey& initDataKey, Tile tile);
 
-    using TileCache = LRUCache<ProviderTileKey, Tile, ProviderTileHasher>;
-    using TextureContainerTileCache = std::pair<
-        std::unique_ptr<TextureContainer>,
-        std::unique_ptr<TileCache>
-    >;
+    /// Returns the texture of the \p cachedTile to the container it belongs to
+    void releaseTexture(const CachedTile& cachedTile);
+
+    using TileCache = LRUCache<ProviderTileKey, CachedTile, ProviderTileHasher>;
     using TextureContainerMap = std::unordered_map<
         TileTextureInitData::HashKey,
-        TextureContainerTileCache
+        std::unique_ptr<TextureContainer>
     >;
 
     TextureContainerMap _textureContainerMap;
+
+    // All tiles share one cache, which is budgeted by the bytes of their textures
+    TileCache _tileCache;
     size_t _numTextureBytesAllocatedOnCPU;
 
     // Properties
     properties::IntProperty _cpuAllocatedTileData;
     properties::IntProperty _gpuAllocatedTileData;
     properties::IntProperty _tileCacheSize;
+    properties::IntProperty _hitsPerFrame;
+    properties::IntProperty _missesPerFrame;
+    properties::IntProperty _evictionsPerFrame;
     properties::TriggerProperty _applyTileCacheSize;
     properties::TriggerProperty _clearTileCache;
 };
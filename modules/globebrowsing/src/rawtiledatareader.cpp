@@ -26,6 +26,7 @@
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
+#include <modules/globebrowsing/src/tilepreprocessing.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/moduleengine.h>
 #include <ghoul/fmt.h>
@@ -121,30 +122,6 @@ enum class Side {
     Bottom
 };
 
-float interpretFloat(GLenum glType, const std::byte* src) {
-    switch (glType) {
-        case GL_UNSIGNED_BYTE:
-            return static_cast<float>(*reinterpret_cast<const GLubyte*>(src));
-        case GL_UNSIGNED_SHORT:
-            return static_cast<float>(*reinterpret_cast<const GLushort*>(src));
-        case GL_SHORT:
-            return static_cast<float>(*reinterpret_cast<const GLshort*>(src));
-        case GL_UNSIGNED_INT:
-            return static_cast<float>(*reinterpret_cast<const GLuint*>(src));
-        case GL_INT:
-            return static_cast<float>(*reinterpret_cast<const GLint*>(src));
-        case GL_HALF_FLOAT:
-            return static_cast<float>(*reinterpret_cast<const GLhalf*>(src));
-        case GL_FLOAT:
-            return static_cast<float>(*reinterpret_cast<const GLfloat*>(src));
-        case GL_DOUBLE:
-            return static_cast<float>(*reinterpret_cast<const GLdouble*>(src));
-        default:
-            ghoul_assert(false, "Unknown data type");
-            throw ghoul::MissingCaseException();
-    }
-}
-
 GDALDataType toGDALDataType(GLenum glType) {
     switch (glType) {
         case GL_UNSIGNED_BYTE:
@@ -807,6 +784,18 @@ glm::ivec2 RawTileDataReader::fullPixelSize() const {
     return geodeticToPixel(Geodetic2{ 90.0, 180.0 }, _padfTransform);
 }
 
+const std::string& RawTileDataReader::datasetFilePath() const {
+    return _datasetFilePath;
+}
+
+const TileTextureInitData& RawTileDataReader::tileTextureInitData() const {
+    return _initData;
+}
+
+bool RawTileDataReader::performsPreprocessing() const {
+    return _preprocess;
+}
+
 RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
                                                          const IODescription& fullIO,
                                                          char* dataDestination,
@@ -925,52 +914,22 @@ RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
 TileMetaData RawTileDataReader::tileMetaData(RawTile& rawTile,
                                              const PixelRegion& region) const
 {
-    const size_t bytesPerLine = _initData.bytesPerPixel * region.numPixels.x;
-
-    TileMetaData preprocessData;
-    preprocessData.maxValues.resize(_initData.nRasters);
-    preprocessData.minValues.resize(_initData.nRasters);
-    preprocessData.hasMissingData.resize(_initData.nRasters);
-
-    std::vector<float> noDataValues(_initData.nRasters);
-    for (size_t raster = 0; raster < _initData.nRasters; ++raster) {
-        preprocessData.maxValues[raster] = -FLT_MAX;
-        preprocessData.minValues[raster] = FLT_MAX;
-        preprocessData.hasMissingData[raster] = false;
-        noDataValues[raster] = noDataValueAsFloat();
-    }
+    const size_t nValues = static_cast<size_t>(region.numPixels.x) *
+        static_cast<size_t>(region.numPixels.y) * _initData.nRasters;
+
+    TileMetaData preprocessData = calculateTileMetaData(
+        rawTile.imageData.get(),
+        nValues,
+        _initData.nRasters,
+        _initData.glType,
+        _noDataValue
+    );
 
+    // A raster without any valid value keeps a minimum that is larger than its maximum
     bool allIsMissing = true;
-    for (int y = 0; y < region.numPixels.y; ++y) {
-        const size_t yi = (region.numPixels.y - 1 - y) * bytesPerLine;
-        size_t i = 0;
-        for (int x = 0; x < region.numPixels.x; ++x) {
-            for (size_t raster = 0; raster < _initData.nRasters; ++raster) {
-                const float noDataValue = noDataValueAsFloat();
-                const float val = interpretFloat(
-                    _initData.glType,
-                    &(rawTile.imageData.get()[yi + i])
-                );
-                if (val != noDataValue && val == val) {
-                    preprocessData.maxValues[raster] = std::max(
-                        val,
-                        preprocessData.maxValues[raster]
-                    );
-                    preprocessData.minValues[raster] = std::min(
-                        val,
-                        preprocessData.minValues[raster]
-                    );
-                    allIsMissing = false;
-                }
-                else {
-                    preprocessData.hasMissingData[raster] = true;
-                    float& floatToRewrite = reinterpret_cast<float&>(
-                        rawTile.imageData[yi + i]
-                    );
-                    floatToRewrite = -std::numeric_limits<float>::max();
-                }
-                i += _initData.bytesPerDatum;
-            }
+    for (size_t raster = 0; raster < _initData.nRasters; ++raster) {
+        if (preprocessData.minValues[raster] <= preprocessData.maxValues[raster]) {
+            allIsMissing = false;
         }
     }
 
@@ -64,6 +64,10 @@ public:
     const TileDepthTransform& depthTransform() const;
     glm::ivec2 fullPixelSize() const;
 
+    const std::string& datasetFilePath() const;
+    const TileTextureInitData& tileTextureInitData() const;
+    bool performsPreprocessing() const;
+
 private:
     void initialize();
 
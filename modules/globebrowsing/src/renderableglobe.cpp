@@ -29,6 +29,7 @@
 #include <modules/globebrowsing/src/layer.h>
 #include <modules/globebrowsing/src/layergroup.h>
 #include <modules/globebrowsing/src/renderableglobe.h>
+#include <modules/globebrowsing/src/tileioscheduler.h>
 #include <modules/globebrowsing/src/tileprovider.h>
 #include <modules/debugging/rendering/debugrenderer.h>
 #include <openspace/engine/globals.h>
@@ -36,6 +37,7 @@
 #include <openspace/performance/performancemeasurement.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -44,6 +46,7 @@
 #include <ghoul/opengl/textureunit.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
 #include <numeric>
 #include <queue>
 
@@ -85,8 +88,9 @@ namespace {
     constexpr const int DefaultSkirtedGridSegments = 64;
     constexpr const int UnknownDesiredLevel = -1;
 
-    const openspace::globebrowsing::GeodeticPatch Coverage =
-        openspace::globebrowsing::GeodeticPatch(0, 0, 90, 180);
+    // Below this number of chunks, the overhead of distributing the chunk evaluation
+    // across the threads is larger than the work itself
+    constexpr const size_t MinChunksPerTask = 64;
 
     const openspace::globebrowsing::TileIndex LeftHemisphereIndex =
         openspace::globebrowsing::TileIndex(0, 0, 1);
@@ -196,34 +200,51 @@ using namespace openspace::properties;
 
 namespace openspace::globebrowsing {
 
-struct BoundingHeights {
-    float min;
-    float max;
-    bool available;
-};
-
 namespace {
 
 bool isLeaf(const Chunk& cn) {
     return cn.children[0] == nullptr;
 }
 
-const Chunk& findChunkNode(const Chunk& node, const Geodetic2& location) {
-    const Chunk* n = &node;
-
-    while (!isLeaf(*n)) {
-        const Geodetic2 center = n->surfacePatch.center();
-        int index = 0;
-        if (center.lon < location.lon) {
-            ++index;
+template <typename ChunkUpdate>
+void flattenChunkTree(Chunk& cn, std::vector<ChunkUpdate>& result) {
+    const size_t index = result.size();
+    result.push_back({ &cn, 0, UnknownDesiredLevel });
+    if (!isLeaf(cn)) {
+        for (Chunk* child : cn.children) {
+            flattenChunkTree(*child, result);
         }
-        if (location.lat < center.lat) {
-            ++index;
-            ++index;
+    }
+    result[index].subtreeEnd = result.size();
+}
+
+// Calls func(i) for all i in [0, n), split into batches that are executed by the
+// global TaskScheduler. The calling thread takes part in the work while waiting
+template <typename Func>
+void parallelFor(size_t n, Func func) {
+    TaskScheduler& scheduler = global::taskScheduler;
+    const size_t nBatches = std::min(
+        n / MinChunksPerTask,
+        static_cast<size_t>(scheduler.numberOfThreads() + 1)
+    );
+    if (nBatches < 2) {
+        for (size_t i = 0; i < n; ++i) {
+            func(i);
         }
-        n = n->children[static_cast<Quad>(index)];
+        return;
+    }
+
+    TaskGroup group(scheduler);
+    const size_t batchSize = (n + nBatches - 1) / nBatches;
+    for (size_t begin = 0; begin < n; begin += batchSize) {
+        const size_t end = std::min(begin + batchSize, n);
+        group.run([&func, begin, end]() {
+            for (size_t i = begin; i < end; ++i) {
+                func(i);
+            }
+        });
     }
-    return *n;
+    group.wait();
 }
 
 std::vector<std::pair<ChunkTile, const LayerRenderSettings*>>
@@ -302,10 +323,9 @@ BoundingHeights boundingHeightsForChunk(const Chunk& chunk, const LayerManager&
 }
 
 std::array<glm::dvec4, 8> boundingCornersForChunk(const Chunk& chunk,
-                                                  const LayerManager& lm,
                                                   const Ellipsoid& ellipsoid)
 {
-    const BoundingHeights& boundingHeight = boundingHeightsForChunk(chunk, lm);
+    const BoundingHeights& boundingHeight = chunk.boundingHeights;
 
     // assume worst case
     const double patchCenterRadius = ellipsoid.maximumRadius();
@@ -749,8 +769,7 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&) {
         _localRenderer.updatedSinceLastCall = false;
     }
 
-    updateChunkTree(_leftRoot, data);
-    updateChunkTree(_rightRoot, data);
+    updateChunkTree(data);
     _chunkCornersDirty = false;
 
     // Calculate the MVP matrix
@@ -873,40 +892,21 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&) {
     std::array<const Chunk*, ChunkBufferSize> local;
     int localCount = 0;
 
-    auto traversal = [&global, &globalCount, &local, &localCount,
-          cutoff = _debugProperties.modelSpaceRenderingCutoffLevel](const Chunk& node)
-    {
-        std::vector<const Chunk*> Q;
-        Q.reserve(256);
-
-        // Loop through nodes in breadths first order
-        Q.push_back(&node);
-        while (!Q.empty()) {
-            const Chunk* n = Q.front();
-            Q.erase(Q.begin());
-
-            if (isLeaf(*n) && n->isVisible) {
-                if (n->tileIndex.level < cutoff) {
-                    global[globalCount] = n;
-                    ++globalCount;
-                }
-                else {
-                    local[localCount] = n;
-                    ++localCount;
-                }
+    const int cutoff = _debugProperties.modelSpaceRenderingCutoffLevel;
+    for (const Chunk* n : _visibleChunks) {
+        if (n->tileIndex.level < cutoff) {
+            if (globalCount < ChunkBufferSize) {
+                global[globalCount] = n;
             }
-
-            // Add children to queue, if any
-            if (!isLeaf(*n)) {
-                for (int i = 0; i < 4; ++i) {
-                    Q.push_back(n->children[i]);
-                }
+            ++globalCount;
+        }
+        else {
+            if (localCount < ChunkBufferSize) {
+                local[localCount] = n;
             }
+            ++localCount;
         }
-    };
-
-    traversal(_leftRoot);
-    traversal(_rightRoot);
+    }
 
     // Render all chunks that want to be rendered globally
     _globalRenderer.program->activate();
@@ -948,6 +948,7 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&) {
 void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData& data) {
     //PerfMeasure("globally");
     const TileIndex& tileIndex = chunk.tileIndex;
+    TileIOScheduler::ScopedRequestPriority priority(chunk.tileRequestPriority);
     ghoul::opengl::ProgramObject& program = *_globalRenderer.program;
 
     const std::array<LayerGroup*, LayerManager::NumLayerGroups>& layerGroups =
@@ -1005,6 +1006,7 @@ void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData&
 void RenderableGlobe::renderChunkLocally(const Chunk& chunk, const RenderData& data) {
     //PerfMeasure("locally");
     const TileIndex& tileIndex = chunk.tileIndex;
+    TileIOScheduler::ScopedRequestPriority priority(chunk.tileRequestPriority);
     ghoul::opengl::ProgramObject& program = *_localRenderer.program;
 
     const std::array<LayerGroup*, LayerManager::NumLayerGroups>& layerGroups =
@@ -1459,19 +1461,19 @@ SurfacePositionHandle RenderableGlobe::calculateSurfacePositionHandle(
     };
 }
 
-bool RenderableGlobe::testIfCullable(const Chunk& chunk,
-                                     const RenderData& renderData) const
+bool RenderableGlobe::testIfCullable(const Chunk& chunk, const RenderData& renderData,
+                                     const glm::dmat4& mvp) const
 {
     return (PreformHorizonCulling && isCullableByHorizon(chunk, renderData)) ||
-           (PerformFrustumCulling && isCullableByFrustum(chunk, renderData));
+           (PerformFrustumCulling && isCullableByFrustum(chunk, mvp));
 }
 
-int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderData) const
+int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderData,
+                                  int levelByAvailableData) const
 {
     const int desiredLevel = _debugProperties.levelByProjectedAreaElseDistance ?
         desiredLevelByProjectedArea(chunk, renderData) :
         desiredLevelByDistance(chunk, renderData);
-    const int levelByAvailableData = desiredLevelByAvailableTileData(chunk);
 
     if (LimitLevelByAvailableData && (levelByAvailableData != UnknownDesiredLevel)) {
         const int l = glm::min(desiredLevel, levelByAvailableData);
@@ -1485,45 +1487,7 @@ int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderDa
 float RenderableGlobe::getHeight(const glm::dvec3& position) const {
     float height = 0;
 
-    // Get the uv coordinates to sample from
     const Geodetic2 geodeticPosition = _ellipsoid.cartesianToGeodetic2(position);
-    const Chunk& node = geodeticPosition.lon < Coverage.center().lon ?
-        findChunkNode(_leftRoot, geodeticPosition) :
-        findChunkNode(_rightRoot, geodeticPosition);
-    const int chunkLevel = node.tileIndex.level;
-
-
-    //TileIndex::TileIndex(const Geodetic2& point, int level_)
-    //    : level(level_)
-    //{
-    const int numIndicesAtLevel = 1 << chunkLevel;
-    const double u = 0.5 + geodeticPosition.lon / glm::two_pi<double>();
-    const double v = 0.25 - geodeticPosition.lat / glm::two_pi<double>();
-    const double xIndexSpace = u * numIndicesAtLevel;
-    const double yIndexSpace = v * numIndicesAtLevel;
-
-    const int x = static_cast<int>(floor(xIndexSpace));
-    const int y = static_cast<int>(floor(yIndexSpace));
-
-    const TileIndex tileIndex(x, y, chunkLevel);
-    const GeodeticPatch patch = GeodeticPatch(tileIndex);
-
-    const Geodetic2 northEast = patch.corner(Quad::NORTH_EAST);
-    const Geodetic2 southWest = patch.corner(Quad::SOUTH_WEST);
-
-    const Geodetic2 geoDiffPatch = {
-        northEast.lat - southWest.lat,
-        northEast.lon - southWest.lon
-    };
-
-    const Geodetic2 geoDiffPoint = {
-        geodeticPosition.lat - southWest.lat,
-        geodeticPosition.lon - southWest.lon
-    };
-    const glm::vec2 patchUV = glm::vec2(
-        geoDiffPoint.lon / geoDiffPatch.lon,
-        geoDiffPoint.lat / geoDiffPatch.lat
-    );
 
     // Get the tile providers for the height maps
     const std::vector<Layer*>& heightMapLayers =
@@ -1534,97 +1498,18 @@ float RenderableGlobe::getHeight(const glm::dvec3& position) const {
         if (!tileProvider) {
             continue;
         }
-        // Transform the uv coordinates to the current tile texture
-        const ChunkTile chunkTile = tileprovider::chunkTile(*tileProvider, tileIndex);
-        const Tile& tile = chunkTile.tile;
-        const TileUvTransform& uvTransform = chunkTile.uvTransform;
-        const TileDepthTransform& depthTransform =
-            tileprovider::depthTransform(*tileProvider);
-        if (tile.status != Tile::Status::OK) {
-            return 0;
-        }
-
-        ghoul::opengl::Texture* tileTexture = tile.texture;
-        if (!tileTexture) {
-            return 0;
-        }
-
-        glm::vec2 transformedUv = layer->tileUvToTextureSamplePosition(
-            uvTransform,
-            patchUV,
-            glm::uvec2(tileTexture->dimensions())
-        );
 
-        // Sample and do linear interpolation
-        // (could possibly be moved as a function in ghoul texture)
-        // Suggestion: a function in ghoul::opengl::Texture that takes uv coordinates
-        // in range [0,1] and uses the set interpolation method and clamping.
-
-        const glm::uvec3 dimensions = tileTexture->dimensions();
-
-        const glm::vec2 samplePos = transformedUv * glm::vec2(dimensions);
-        glm::uvec2 samplePos00 = samplePos;
-        samplePos00 = glm::clamp(
-            samplePos00,
-            glm::uvec2(0, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
-
-        const glm::uvec2 samplePos10 = glm::min(
-            samplePos00 + glm::uvec2(1, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos01 = glm::min(
-            samplePos00 + glm::uvec2(0, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
+        // The heights are sampled from the CPU copies of the height tiles, so no
+        // textures are accessed. Missing or no data values don't use this height map
+        const std::optional<float> sample = tileprovider::height(
+            *tileProvider,
+            geodeticPosition
         );
-        const glm::uvec2 samplePos11 = glm::min(
-            samplePos00 + glm::uvec2(1, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-
-        const float sample00 = tileTexture->texelAsFloat(samplePos00).x;
-        const float sample10 = tileTexture->texelAsFloat(samplePos10).x;
-        const float sample01 = tileTexture->texelAsFloat(samplePos01).x;
-        const float sample11 = tileTexture->texelAsFloat(samplePos11).x;
-
-        // In case the texture has NaN or no data values don't use this height map.
-        const bool anySampleIsNaN =
-            std::isnan(sample00) ||
-            std::isnan(sample01) ||
-            std::isnan(sample10) ||
-            std::isnan(sample11);
-
-        const bool anySampleIsNoData =
-            sample00 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample01 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample10 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample11 == tileprovider::noDataValueAsFloat(*tileProvider);
-
-        if (anySampleIsNaN || anySampleIsNoData) {
-            continue;
-        }
-
-        const float sample0 = sample00 * (1.f - samplePosFract.x) +
-            sample10 * samplePosFract.x;
-        const float sample1 = sample01 * (1.f - samplePosFract.x) +
-            sample11 * samplePosFract.x;
-
-        const float sample = sample0 * (1.f - samplePosFract.y) +
-            sample1 * samplePosFract.y;
-
-        // Same as is used in the shader. This is not a perfect solution but
-        // if the sample is actually a no-data-value (min_float) the interpolated
-        // value might not be. Therefore we have a cut-off. Assuming no data value
-        // is smaller than -100000
-        if (sample > -100000) {
-            // Perform depth transform to get the value in meters
-            height = depthTransform.offset + depthTransform.scale * sample;
+        if (sample) {
             // Make sure that the height value follows the layer settings.
             // For example if the multiplier is set to a value bigger than one,
             // the sampled height should be modified as well.
-            height = layer->renderSettings().performLayerSettings(height);
+            height = layer->renderSettings().performLayerSettings(*sample);
         }
     }
     // Return the result
@@ -1778,8 +1663,7 @@ int RenderableGlobe::desiredLevelByDistance(const Chunk& chunk,
     const glm::dvec3 patchNormal = _ellipsoid.geodeticSurfaceNormal(pointOnPatch);
     glm::dvec3 patchPosition = _ellipsoid.cartesianSurfacePosition(pointOnPatch);
 
-    const BoundingHeights heights = boundingHeightsForChunk(chunk, _layerManager);
-    const double heightToChunk = heights.min;
+    const double heightToChunk = chunk.boundingHeights.min;
 
     // Offset position according to height
     patchPosition += patchNormal * heightToChunk;
@@ -1833,7 +1717,7 @@ int RenderableGlobe::desiredLevelByProjectedArea(const Chunk& chunk,
     //    +-----------------+  <-- south east corner
 
     const Geodetic2 center = chunk.surfacePatch.center();
-    const BoundingHeights heights = boundingHeightsForChunk(chunk, _layerManager);
+    const BoundingHeights& heights = chunk.boundingHeights;
     const Geodetic3 c = { center, heights.min };
     const Geodetic3 c1 = { Geodetic2{ center.lat, closestCorner.lon }, heights.min };
     const Geodetic3 c2 = { Geodetic2{ closestCorner.lat, center.lon }, heights.min };
@@ -1897,25 +1781,37 @@ int RenderableGlobe::desiredLevelByAvailableTileData(const Chunk& chunk) const {
     return currLevel - 1;
 }
 
+float RenderableGlobe::tileRequestPriority(const Chunk& chunk,
+                                           const RenderData& data) const
+{
+    // Calculations are done in the reference frame of the globe
+    const glm::dvec3 cameraPosition = glm::dvec3(_cachedInverseModelTransform *
+        glm::dvec4(data.camera.positionVec3(), 1.0));
+
+    const Geodetic2 pointOnPatch = chunk.surfacePatch.closestPoint(
+        _ellipsoid.cartesianToGeodetic2(cameraPosition)
+    );
+    const glm::dvec3 patchPosition = _ellipsoid.cartesianSurfacePosition(pointOnPatch);
+    const double distance = glm::length(patchPosition - cameraPosition);
+
+    const double size = 2.0 * chunk.surfacePatch.halfSize().lat *
+        _ellipsoid.minimumRadius();
+    return static_cast<float>(size / std::max(distance, 1.0));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //  Culling
 //////////////////////////////////////////////////////////////////////////////////////////
 
 bool RenderableGlobe::isCullableByFrustum(const Chunk& chunk,
-                                          const RenderData& renderData) const
+                                          const glm::dmat4& mvp) const
 {
-    // Calculate the MVP matrix
-    const glm::dmat4 viewTransform = glm::dmat4(renderData.camera.combinedViewMatrix());
-    const glm::dmat4 modelViewProjectionTransform = glm::dmat4(
-        renderData.camera.sgctInternal.projectionMatrix()
-    ) * viewTransform * _cachedModelTransform;
-
     const std::array<glm::dvec4, 8>& corners = chunk.corners;
 
     // Create a bounding box that fits the patch corners
     AABB3 bounds; // in screen space
     for (size_t i = 0; i < 8; ++i) {
-        const glm::dvec4 cornerClippingSpace = modelViewProjectionTransform * corners[i];
+        const glm::dvec4 cornerClippingSpace = mvp * corners[i];
         const glm::dvec3 ndc = glm::dvec3(
             (1.f / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace
         );
@@ -1931,7 +1827,7 @@ bool RenderableGlobe::isCullableByHorizon(const Chunk& chunk,
     // Calculations are done in the reference frame of the globe. Hence, the camera
     // position needs to be transformed with the inverse model matrix
     const GeodeticPatch& patch = chunk.surfacePatch;
-    const float maxHeight = boundingHeightsForChunk(chunk, _layerManager).max;
+    const float maxHeight = chunk.boundingHeights.max;
     const glm::dvec3 globePos = glm::dvec3(0, 0, 0); // In model space it is 0
     const double minimumGlobeRadius = _ellipsoid.minimumRadius();
 
@@ -2005,9 +1901,12 @@ void RenderableGlobe::splitChunkNode(Chunk& cn, int depth) {
             cn.children[i] = new (memory[i]) Chunk(
                 cn.tileIndex.child(static_cast<Quad>(i))
             );
+            cn.children[i]->boundingHeights = boundingHeightsForChunk(
+                *cn.children[i],
+                _layerManager
+            );
             cn.children[i]->corners = boundingCornersForChunk(
                 *cn.children[i],
-                _layerManager,
                 _ellipsoid
             );
         }
@@ -2040,46 +1939,88 @@ void RenderableGlobe::mergeChunkNode(Chunk& cn) {
     cn.children.fill(nullptr);
 }
 
-bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data) {
-    // abock:  I tried turning this into a queue and use iteration, rather than recursion
-    //         but that made the code harder to understand as the breadth-first traversal
-    //         requires parents to be passed through the pipe twice (first to add the
-    //         children and then again it self to be processed after the children finish).
-    //         In addition, this didn't even improve performance ---  2018-10-04
-    if (isLeaf(cn)) {
-        updateChunk(cn, data);
-        if (cn.status == Chunk::Status::WantSplit) {
-            splitChunkNode(cn, 1);
+void RenderableGlobe::updateChunkTree(const RenderData& data) {
+    _chunkUpdates.clear();
+    flattenChunkTree(_leftRoot, _chunkUpdates);
+    flattenChunkTree(_rightRoot, _chunkUpdates);
+
+    // The priorities are needed before the tiles are requested in the next step
+    parallelFor(_chunkUpdates.size(), [this, &data](size_t i) {
+        Chunk& chunk = *_chunkUpdates[i].chunk;
+        chunk.tileRequestPriority = tileRequestPriority(chunk, data);
+    });
+
+    // Accessing the tiles touches the tile caches and enqueues tile requests, neither of
+    // which is thread-safe, so everything that depends on the tiles is gathered here
+    for (ChunkUpdate& u : _chunkUpdates) {
+        TileIOScheduler::ScopedRequestPriority priority(u.chunk->tileRequestPriority);
+        u.chunk->boundingHeights = boundingHeightsForChunk(*u.chunk, _layerManager);
+        if (LimitLevelByAvailableData) {
+            u.levelByAvailableData = desiredLevelByAvailableTileData(*u.chunk);
         }
-        return cn.status == Chunk::Status::WantMerge;
     }
-    else {
-        char requestedMergeMask = 0;
-        for (int i = 0; i < 4; ++i) {
-            if (updateChunkTree(*cn.children[i], data)) {
-                requestedMergeMask |= (1 << i);
-            }
-        }
 
-        const bool allChildrenWantsMerge = requestedMergeMask == 0xf;
-        updateChunk(cn, data);
+    // The camera caches its combined view matrix, so it must not be accessed from the
+    // worker threads
+    const glm::dmat4 mvp = glm::dmat4(data.camera.sgctInternal.projectionMatrix()) *
+        data.camera.combinedViewMatrix() * _cachedModelTransform;
+    parallelFor(_chunkUpdates.size(), [this, &data, &mvp](size_t i) {
+        const ChunkUpdate& u = _chunkUpdates[i];
+        updateChunk(*u.chunk, data, mvp, u.levelByAvailableData);
+    });
 
-        if (allChildrenWantsMerge && (cn.status != Chunk::Status::WantSplit)) {
-            mergeChunkNode(cn);
+    // Apply the splits and merges. Since the chunks are stored in pre-order, the children
+    // of a chunk are still unmodified when it is visited, and the subtree of a merged
+    // chunk can be skipped as a whole
+    _visibleChunks.clear();
+    size_t i = 0;
+    while (i < _chunkUpdates.size()) {
+        Chunk& cn = *_chunkUpdates[i].chunk;
+        if (isLeaf(cn)) {
+            if (cn.status == Chunk::Status::WantSplit) {
+                splitChunkNode(cn, 1);
+                for (const Chunk* child : cn.children) {
+                    _visibleChunks.push_back(child);
+                }
+            }
+            else if (cn.isVisible) {
+                _visibleChunks.push_back(&cn);
+            }
+            ++i;
         }
+        else {
+            const bool allChildrenWantMerge = std::all_of(
+                cn.children.begin(),
+                cn.children.end(),
+                [](const Chunk* c) {
+                    return isLeaf(*c) && c->status == Chunk::Status::WantMerge;
+                }
+            );
 
-        return false;
+            if (allChildrenWantMerge && (cn.status != Chunk::Status::WantSplit)) {
+                mergeChunkNode(cn);
+                if (cn.isVisible) {
+                    _visibleChunks.push_back(&cn);
+                }
+                i = _chunkUpdates[i].subtreeEnd;
+            }
+            else {
+                ++i;
+            }
+        }
     }
 }
 
-void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data) const {
+void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data,
+                                  const glm::dmat4& mvp, int levelByAvailableData) const
+{
     if (_chunkCornersDirty) {
-        chunk.corners = boundingCornersForChunk(chunk, _layerManager, _ellipsoid);
+        chunk.corners = boundingCornersForChunk(chunk, _ellipsoid);
 
         // The flag gets set to false globally after the updateChunkTree calls
     }
 
-    if (testIfCullable(chunk, data)) {
+    if (testIfCullable(chunk, data, mvp)) {
         chunk.isVisible = false;
         chunk.status = Chunk::Status::WantMerge;
         return;
@@ -2088,7 +2029,7 @@ void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data) const {
         chunk.isVisible = true;
     }
 
-    const int dl = desiredLevel(chunk, data);
+    const int dl = desiredLevel(chunk, data, levelByAvailableData);
 
     if (dl < chunk.tileIndex.level) {
         chunk.status = Chunk::Status::WantMerge;
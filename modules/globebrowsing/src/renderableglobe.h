@@ -39,6 +39,7 @@
 #include <ghoul/misc/memorypool.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <cstddef>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
@@ -49,6 +50,12 @@ struct TileIndex;
 namespace chunklevelevaluator { class Evaluator; }
 namespace culling { class ChunkCuller; }
 
+struct BoundingHeights {
+    float min;
+    float max;
+    bool available;
+};
+
 struct Chunk {
     enum class Status : uint8_t {
         DoNothing,
@@ -64,6 +71,10 @@ struct Chunk {
     Status status;
 
     bool isVisible = true;
+    /// The minimum and maximum height of the height layers, updated every frame
+    BoundingHeights boundingHeights = { 0.f, 0.f, false };
+    /// The priority of the tiles requested for this chunk, see tileRequestPriority
+    float tileRequestPriority = 0.f;
     std::array<glm::dvec4, 8> corners;
     std::array<Chunk*, 4> children = { { nullptr, nullptr, nullptr, nullptr } };
 };
@@ -128,7 +139,8 @@ private:
      * Goes through all available <code>ChunkCuller</code>s and check if any of them
      * allows culling of the <code>Chunk</code>s in question.
      */
-    bool testIfCullable(const Chunk& chunk, const RenderData& renderData) const;
+    bool testIfCullable(const Chunk& chunk, const RenderData& renderData,
+        const glm::dmat4& mvp) const;
 
     /**
      * Gets the desired level which can be used to determine if a chunk should split
@@ -140,7 +152,8 @@ private:
      * <code>Chunk</code>, it wants to split. If it is lower, it wants to merge with
      * its siblings.
      */
-    int desiredLevel(const Chunk& chunk, const RenderData& renderData) const;
+    int desiredLevel(const Chunk& chunk, const RenderData& renderData,
+        int levelByAvailableData) const;
 
     /**
      * Calculates the height from the surface of the reference ellipsoid to the
@@ -183,13 +196,20 @@ private:
     void debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp,
         bool renderBounds, bool renderAABB) const;
 
-    bool isCullableByFrustum(const Chunk& chunk, const RenderData& renderData) const;
+    bool isCullableByFrustum(const Chunk& chunk, const glm::dmat4& mvp) const;
     bool isCullableByHorizon(const Chunk& chunk, const RenderData& renderData) const;
 
     int desiredLevelByDistance(const Chunk& chunk, const RenderData& data) const;
     int desiredLevelByProjectedArea(const Chunk& chunk, const RenderData& data) const;
     int desiredLevelByAvailableTileData(const Chunk& chunk) const;
 
+    /**
+     * Returns the priority with which the tiles of the \p chunk should be loaded. The
+     * priority is the ratio between the size of the chunk and its distance to the
+     * camera, which is proportional to the screen space error if the chunk is rendered
+     * with a lower resolution tile.
+     */
+    float tileRequestPriority(const Chunk& chunk, const RenderData& data) const;
 
     void calculateEclipseShadows(ghoul::opengl::ProgramObject& programObject,
         const RenderData& data);
@@ -203,8 +223,16 @@ private:
 
     void splitChunkNode(Chunk& cn, int depth);
     void mergeChunkNode(Chunk& cn);
-    bool updateChunkTree(Chunk& cn, const RenderData& data);
-    void updateChunk(Chunk& chunk, const RenderData& data) const;
+
+    /**
+     * Updates the level of detail of the chunk tree for the current frame and collects
+     * the visible leaf chunks into <code>_visibleChunks</code>. The culling and level
+     * evaluation of all chunks is performed in parallel, the resulting splits and merges
+     * are applied afterwards on the calling thread.
+     */
+    void updateChunkTree(const RenderData& data);
+    void updateChunk(Chunk& chunk, const RenderData& data, const glm::dmat4& mvp,
+        int levelByAvailableData) const;
     void freeChunkNode(Chunk* n);
 
     Ellipsoid _ellipsoid;
@@ -219,6 +247,17 @@ private:
     Chunk _leftRoot;  // Covers all negative longitudes
     Chunk _rightRoot; // Covers all positive longitudes
 
+    struct ChunkUpdate {
+        Chunk* chunk;
+        /// The index one past the last descendant of the chunk in _chunkUpdates
+        size_t subtreeEnd;
+        int levelByAvailableData;
+    };
+    /// All chunks of the tree in depth-first pre-order, rebuilt every frame
+    std::vector<ChunkUpdate> _chunkUpdates;
+    /// The leaf chunks that are visible in the current frame
+    std::vector<const Chunk*> _visibleChunks;
+
     // Two different shader programs. One for global and one for local rendering.
     struct {
         std::unique_ptr<ghoul::opengl::ProgramObject> program;
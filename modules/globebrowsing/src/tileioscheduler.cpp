@@ -0,0 +1,293 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/tileioscheduler.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <functional>
+
+namespace {
+    constexpr const char* _loggerCat = "TileIOScheduler";
+
+    // The priority that is assigned to requests on this thread. Only requests from the
+    // main thread are expected, but this avoids a data race if that ever changes
+    thread_local float CurrentRequestPriority = 0.f;
+} // namespace
+
+namespace openspace::globebrowsing {
+
+TileIOScheduler::ScopedRequestPriority::ScopedRequestPriority(float priority)
+    : _previousPriority(CurrentRequestPriority)
+{
+    CurrentRequestPriority = priority;
+}
+
+TileIOScheduler::ScopedRequestPriority::~ScopedRequestPriority() {
+    CurrentRequestPriority = _previousPriority;
+}
+
+size_t TileIOScheduler::RequestKeyHasher::operator()(const RequestKey& key) const {
+    const size_t client = std::hash<const AsyncTileDataProvider*>()(key.client);
+    return client ^ (key.tile * 0x9E3779B97F4A7C15ULL);
+}
+
+TileIOScheduler::TileIOScheduler(unsigned int nThreads) {
+    ghoul_assert(nThreads > 0, "Need at least one thread");
+    _workers.reserve(nThreads);
+    for (unsigned int i = 0; i < nThreads; ++i) {
+        _workers.emplace_back([this]() { work(); });
+    }
+}
+
+TileIOScheduler::~TileIOScheduler() {
+    {
+        std::lock_guard lock(_mutex);
+        _shouldStop = true;
+        _pendingRequests.clear();
+        _requestHeap.clear();
+    }
+    _workAvailable.notify_all();
+    for (std::thread& t : _workers) {
+        t.join();
+    }
+}
+
+void TileIOScheduler::enqueue(AsyncTileDataProvider& client, const TileIndex& tileIndex,
+                              layergroupid::GroupID layerGroup,
+                              std::shared_ptr<TileJob> job)
+{
+    {
+        std::lock_guard lock(_mutex);
+        _clients[&client];
+        const RequestKey key = { &client, tileIndex.hashKey() };
+        Request& request = _pendingRequests[key];
+        request = {
+            std::move(job),
+            CurrentRequestPriority,
+            tileIndex.level,
+            layerGroup,
+            _frame,
+            0
+        };
+        pushToHeap(key, request);
+    }
+    _workAvailable.notify_one();
+}
+
+bool TileIOScheduler::touch(AsyncTileDataProvider& client, const TileIndex& tileIndex) {
+    std::lock_guard lock(_mutex);
+    const auto it = _pendingRequests.find({ &client, tileIndex.hashKey() });
+    if (it == _pendingRequests.end()) {
+        return false;
+    }
+
+    Request& r = it->second;
+    // A tile can be requested by multiple chunks in a frame, the most important one wins
+    const float priority = (r.lastFrame == _frame) ?
+        std::max(r.priority, CurrentRequestPriority) :
+        CurrentRequestPriority;
+    r.lastFrame = _frame;
+    if (priority != r.priority) {
+        r.priority = priority;
+        pushToHeap(it->first, r);
+    }
+    return true;
+}
+
+std::vector<TileIndex::TileHashKey> TileIOScheduler::cancelledRequests(
+                                                            AsyncTileDataProvider& client)
+{
+    std::lock_guard lock(_mutex);
+    const auto it = _clients.find(&client);
+    if (it == _clients.end()) {
+        return {};
+    }
+    std::vector<TileIndex::TileHashKey> res;
+    std::swap(res, it->second.cancelledRequests);
+    return res;
+}
+
+std::vector<TileIndex::TileHashKey> TileIOScheduler::cancelAll(
+                                                            AsyncTileDataProvider& client)
+{
+    std::vector<TileIndex::TileHashKey> res;
+    std::lock_guard lock(_mutex);
+    for (auto it = _pendingRequests.begin(); it != _pendingRequests.end();) {
+        if (it->first.client == &client) {
+            res.push_back(it->first.tile);
+            it = _pendingRequests.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return res;
+}
+
+std::shared_ptr<TileIOScheduler::TileJob> TileIOScheduler::popFinishedJob(
+                                                            AsyncTileDataProvider& client)
+{
+    std::lock_guard lock(_mutex);
+    const auto it = _clients.find(&client);
+    if (it == _clients.end() || it->second.finishedJobs.empty()) {
+        return nullptr;
+    }
+    std::shared_ptr<TileJob> job = std::move(it->second.finishedJobs.front());
+    it->second.finishedJobs.pop_front();
+    return job;
+}
+
+void TileIOScheduler::removeClient(AsyncTileDataProvider& client) {
+    cancelAll(client);
+
+    std::unique_lock lock(_mutex);
+    _jobFinished.wait(lock, [this, &client]() {
+        const auto it = _clients.find(&client);
+        return it == _clients.end() || it->second.nRunningJobs == 0;
+    });
+    _clients.erase(&client);
+}
+
+void TileIOScheduler::update() {
+    std::lock_guard lock(_mutex);
+    for (auto it = _pendingRequests.begin(); it != _pendingRequests.end();) {
+        if (it->second.lastFrame < _frame) {
+            _clients[it->first.client].cancelledRequests.push_back(it->first.tile);
+            it = _pendingRequests.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    ++_frame;
+
+    // Outdated entries are only removed from the heap when they reach its front, so the
+    // heap is compacted once they make up the majority of it
+    if (_requestHeap.size() > 2 * _pendingRequests.size()) {
+        rebuildHeap();
+    }
+}
+
+unsigned int TileIOScheduler::numberOfThreads() const {
+    return static_cast<unsigned int>(_workers.size());
+}
+
+size_t TileIOScheduler::numberOfPendingRequests() const {
+    std::lock_guard lock(_mutex);
+    return _pendingRequests.size();
+}
+
+bool TileIOScheduler::isLessImportant(const HeapEntry& a, const HeapEntry& b) {
+    if (a.priority != b.priority) {
+        return a.priority < b.priority;
+    }
+    if (a.level != b.level) {
+        return a.level > b.level;
+    }
+    if (a.key.tile != b.key.tile) {
+        return a.key.tile > b.key.tile;
+    }
+    return a.layerGroup > b.layerGroup;
+}
+
+void TileIOScheduler::pushToHeap(const RequestKey& key, Request& request) {
+    request.version = _nextVersion++;
+    _requestHeap.push_back(
+        { key, request.priority, request.level, request.layerGroup, request.version }
+    );
+    std::push_heap(_requestHeap.begin(), _requestHeap.end(), isLessImportant);
+}
+
+void TileIOScheduler::rebuildHeap() {
+    _requestHeap.clear();
+    for (const std::pair<const RequestKey, Request>& p : _pendingRequests) {
+        const Request& r = p.second;
+        _requestHeap.push_back({ p.first, r.priority, r.level, r.layerGroup, r.version });
+    }
+    std::make_heap(_requestHeap.begin(), _requestHeap.end(), isLessImportant);
+}
+
+void TileIOScheduler::work() {
+    while (true) {
+        RequestKey key;
+        std::shared_ptr<TileJob> job;
+        {
+            std::unique_lock lock(_mutex);
+            _workAvailable.wait(lock, [this]() {
+                return _shouldStop || !_pendingRequests.empty();
+            });
+            if (_shouldStop) {
+                return;
+            }
+
+            // Every pending request has an up to date entry in the heap, so this finds
+            // the most important one after skipping the outdated entries in front of it
+            auto best = _pendingRequests.end();
+            while (best == _pendingRequests.end()) {
+                ghoul_assert(!_requestHeap.empty(), "Pending request missing in heap");
+                std::pop_heap(_requestHeap.begin(), _requestHeap.end(), isLessImportant);
+                const HeapEntry entry = _requestHeap.back();
+                _requestHeap.pop_back();
+
+                const auto it = _pendingRequests.find(entry.key);
+                if (it != _pendingRequests.end() && it->second.version == entry.version) {
+                    best = it;
+                }
+            }
+
+            key = best->first;
+            job = std::move(best->second.job);
+            _pendingRequests.erase(best);
+            _clients[key.client].nRunningJobs++;
+        }
+
+        bool success = true;
+        try {
+            job->execute();
+        }
+        catch (const std::exception& e) {
+            LERROR(fmt::format("Error loading tile: {}", e.what()));
+            success = false;
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            ClientState& state = _clients[key.client];
+            state.nRunningJobs--;
+            if (success) {
+                state.finishedJobs.push_back(std::move(job));
+            }
+            else {
+                // Let the client know that this tile will not arrive
+                state.cancelledRequests.push_back(key.tile);
+            }
+        }
+        _jobFinished.notify_all();
+    }
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,216 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_IO_SCHEDULER___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_IO_SCHEDULER___H__
+
+#include <modules/globebrowsing/src/layergroupid.h>
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <openspace/util/job.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace::globebrowsing {
+
+class AsyncTileDataProvider;
+
+/**
+ * The TileIOScheduler executes the tile loading jobs of all AsyncTileDataProvider%s of
+ * all globes on a single, fixed size pool of threads. Instead of running in the order
+ * in which they were enqueued, the pending jobs are executed in order of their priority:
+ *
+ *  1. The request priority, which is the size of the requesting chunk on screen and thus
+ *     the visual error that is caused by the tile missing. It is set by the globe for all
+ *     requests made within the lifetime of a ScopedRequestPriority
+ *  2. The tile level, so that coarser tiles, which are used as fallbacks, come first
+ *  3. The tile index, so that requests from different layers for the same tile are
+ *     ordered next to each other. They are still executed as separate jobs
+ *  4. The layer group, with height layers first as they change the geometry
+ *
+ * A request that is not repeated in a frame (see #update) is considered to have left the
+ * view and is cancelled. The keys of cancelled requests are reported to their provider
+ * through #cancelledRequests.
+ *
+ * All methods except the worker threads are expected to be called from the main thread.
+ */
+class TileIOScheduler {
+public:
+    using TileJob = Job<RawTile>;
+
+    /**
+     * While an object of this class is alive, all requests made on the calling thread
+     * are assigned the \p priority. Requests with a higher priority are executed first.
+     */
+    class ScopedRequestPriority {
+    public:
+        explicit ScopedRequestPriority(float priority);
+        ~ScopedRequestPriority();
+
+    private:
+        float _previousPriority;
+    };
+
+    /**
+     * Creates the scheduler and starts \p nThreads worker threads
+     */
+    explicit TileIOScheduler(unsigned int nThreads);
+
+    /**
+     * Cancels all pending requests and joins the worker threads after the currently
+     * executing jobs are finished.
+     */
+    ~TileIOScheduler();
+
+    /**
+     * Enqueues the \p job that loads the tile \p tileIndex for the \p client with the
+     * current request priority. A previously enqueued job for the same tile is replaced.
+     */
+    void enqueue(AsyncTileDataProvider& client, const TileIndex& tileIndex,
+        layergroupid::GroupID layerGroup, std::shared_ptr<TileJob> job);
+
+    /**
+     * Marks the request for the tile \p tileIndex of the \p client as still being needed
+     * in this frame and raises its priority to the current request priority.
+     *
+     * \return true if the request is pending, false otherwise
+     */
+    bool touch(AsyncTileDataProvider& client, const TileIndex& tileIndex);
+
+    /**
+     * Returns the keys of all requests of the \p client that have been cancelled since
+     * the last call to this function because they were not requested anymore.
+     */
+    std::vector<TileIndex::TileHashKey> cancelledRequests(AsyncTileDataProvider& client);
+
+    /**
+     * Cancels all pending requests of the \p client and returns their keys. Jobs that
+     * are currently executed will still finish.
+     */
+    std::vector<TileIndex::TileHashKey> cancelAll(AsyncTileDataProvider& client);
+
+    /**
+     * Returns one finished job of the \p client, or <code>nullptr</code> if there is none
+     */
+    std::shared_ptr<TileJob> popFinishedJob(AsyncTileDataProvider& client);
+
+    /**
+     * Cancels all pending requests of the \p client, waits for its executing jobs to
+     * finish, and discards its finished jobs. Has to be called before the client is
+     * destroyed.
+     */
+    void removeClient(AsyncTileDataProvider& client);
+
+    /**
+     * Finishes the current frame and cancels all requests that were neither enqueued
+     * nor touched during it.
+     */
+    void update();
+
+    unsigned int numberOfThreads() const;
+
+    /// Returns the number of requests that are waiting to be executed
+    size_t numberOfPendingRequests() const;
+
+private:
+    struct RequestKey {
+        const AsyncTileDataProvider* client = nullptr;
+        TileIndex::TileHashKey tile = 0;
+
+        bool operator==(const RequestKey& rhs) const {
+            return client == rhs.client && tile == rhs.tile;
+        }
+    };
+
+    struct RequestKeyHasher {
+        size_t operator()(const RequestKey& key) const;
+    };
+
+    struct Request {
+        std::shared_ptr<TileJob> job;
+        float priority;
+        int level;
+        layergroupid::GroupID layerGroup;
+        uint64_t lastFrame;
+        /// Identifies the entry in the request heap that is up to date for this request
+        uint64_t version;
+    };
+
+    /**
+     * The ordering values of a request at the time it was pushed to the request heap.
+     * Instead of being updated in place, a new entry is pushed whenever a request is
+     * enqueued or its priority changes. An entry whose \c version no longer matches its
+     * pending request is outdated and skipped when it is popped.
+     */
+    struct HeapEntry {
+        RequestKey key;
+        float priority;
+        int level;
+        layergroupid::GroupID layerGroup;
+        uint64_t version;
+    };
+
+    struct ClientState {
+        std::deque<std::shared_ptr<TileJob>> finishedJobs;
+        std::vector<TileIndex::TileHashKey> cancelledRequests;
+        int nRunningJobs = 0;
+    };
+
+    /**
+     * Returns true if request \p a should be executed after request \p b. This is the
+     * ordering of the request heap, which keeps the most important request at the front.
+     */
+    static bool isLessImportant(const HeapEntry& a, const HeapEntry& b);
+
+    /// Pushes the current state of the \p request to the request heap
+    void pushToHeap(const RequestKey& key, Request& request);
+
+    /// Rebuilds the request heap from the pending requests, dropping outdated entries
+    void rebuildHeap();
+
+    void work();
+
+    std::vector<std::thread> _workers;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _jobFinished;
+    bool _shouldStop = false;
+
+    std::unordered_map<RequestKey, Request, RequestKeyHasher> _pendingRequests;
+    // A binary heap with the most important request first. Contains one up to date entry
+    // for every pending request, and any number of outdated ones
+    std::vector<HeapEntry> _requestHeap;
+    uint64_t _nextVersion = 0;
+    std::unordered_map<const AsyncTileDataProvider*, ClientState> _clients;
+    uint64_t _frame = 0;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_IO_SCHEDULER___H__
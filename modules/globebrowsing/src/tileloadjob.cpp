@@ -28,8 +28,12 @@
 
 namespace openspace::globebrowsing {
 
-TileLoadJob::TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex)
+TileLoadJob::TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex,
+                         cache::DiskTileCache* diskTileCache,
+                         cache::DiskTileCache::DatasetIdentifier dataset)
     : _rawTileDataReader(rawTileDataReader)
+    , _diskTileCache(diskTileCache)
+    , _dataset(dataset)
     , _chunkIndex(std::move(tileIndex))
 {}
 
@@ -40,8 +44,27 @@ TileLoadJob::~TileLoadJob() {
 }
 
 void TileLoadJob::execute() {
+    const TileTextureInitData& initData = _rawTileDataReader.tileTextureInitData();
+    if (_diskTileCache) {
+        std::optional<RawTile> tile = _diskTileCache->get(
+            _dataset,
+            _chunkIndex,
+            initData.totalNumBytes
+        );
+        if (tile) {
+            _rawTile = std::move(*tile);
+            _rawTile.textureInitData = initData;
+            _hasTile = true;
+            return;
+        }
+    }
+
     _rawTile = _rawTileDataReader.readTileData(_chunkIndex);
     _hasTile = true;
+
+    if (_diskTileCache) {
+        _diskTileCache->put(_dataset, _rawTile, initData.totalNumBytes);
+    }
 }
 
 RawTile TileLoadJob::product() {
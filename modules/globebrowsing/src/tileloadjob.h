@@ -27,6 +27,7 @@
 
 #include <openspace/util/job.h>
 
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/rawtile.h>
 #include <modules/globebrowsing/src/tileindex.h>
 
@@ -40,8 +41,14 @@ struct TileLoadJob : public Job<RawTile> {
      * ownership of this data will be released. If <code>product()</code> has not been
      * called before the TileLoadJob is finished, the data will be deleted as it has not
      * been exposed outside of this object.
+     *
+     * If a \p diskTileCache is provided, the tile is read from it instead of the
+     * RawTileDataReader if it is available and successfully read tiles are stored in
+     * it under the \p dataset identifier.
      */
-    TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex);
+    TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex,
+        cache::DiskTileCache* diskTileCache = nullptr,
+        cache::DiskTileCache::DatasetIdentifier dataset = 0);
 
     /**
      * Destroys the allocated data pointer if it has been allocated and the TileLoadJob
@@ -65,6 +72,8 @@ struct TileLoadJob : public Job<RawTile> {
 
 protected:
     RawTileDataReader& _rawTileDataReader;
+    cache::DiskTileCache* _diskTileCache;
+    const cache::DiskTileCache::DatasetIdentifier _dataset;
     RawTile _rawTile;
     const TileIndex _chunkIndex;
     bool _hasTile = false;
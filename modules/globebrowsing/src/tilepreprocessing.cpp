@@ -0,0 +1,256 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/tilepreprocessing.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OPENSPACE_TILE_PREPROCESSING_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPENSPACE_TILE_PREPROCESSING_SSE2
+#endif
+
+namespace openspace::globebrowsing {
+
+namespace {
+
+template <typename T>
+constexpr T missingValue() {
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(-FLT_MAX);
+    }
+    else {
+        return std::numeric_limits<T>::lowest();
+    }
+}
+
+bool isValid(float value, float noDataValue) {
+    // value == value is false for NaN
+    return value != noDataValue && value == value;
+}
+
+#if defined(OPENSPACE_TILE_PREPROCESSING_AVX2)
+
+using Vec = __m256;
+constexpr const size_t VecWidth = 8;
+constexpr const int FullMask = 0xFF;
+
+Vec vecSet(float v) { return _mm256_set1_ps(v); }
+Vec vecMin(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+Vec vecMax(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+Vec vecSelect(Vec mask, Vec a, Vec b) { return _mm256_blendv_ps(b, a, mask); }
+int vecMoveMask(Vec v) { return _mm256_movemask_ps(v); }
+void vecStore(float* dst, Vec v) { _mm256_storeu_ps(dst, v); }
+
+Vec vecValid(Vec v, Vec noData) {
+    return _mm256_and_ps(
+        _mm256_cmp_ps(v, noData, _CMP_NEQ_UQ),
+        _mm256_cmp_ps(v, v, _CMP_ORD_Q)
+    );
+}
+
+Vec vecLoad(const float* src) { return _mm256_loadu_ps(src); }
+
+Vec vecLoad(const uint16_t* src) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v));
+}
+
+Vec vecLoad(const int16_t* src) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v));
+}
+
+#elif defined(OPENSPACE_TILE_PREPROCESSING_SSE2)
+
+using Vec = __m128;
+constexpr const size_t VecWidth = 4;
+constexpr const int FullMask = 0xF;
+
+Vec vecSet(float v) { return _mm_set1_ps(v); }
+Vec vecMin(Vec a, Vec b) { return _mm_min_ps(a, b); }
+Vec vecMax(Vec a, Vec b) { return _mm_max_ps(a, b); }
+int vecMoveMask(Vec v) { return _mm_movemask_ps(v); }
+void vecStore(float* dst, Vec v) { _mm_storeu_ps(dst, v); }
+
+Vec vecSelect(Vec mask, Vec a, Vec b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+Vec vecValid(Vec v, Vec noData) {
+    return _mm_and_ps(_mm_cmpneq_ps(v, noData), _mm_cmpord_ps(v, v));
+}
+
+Vec vecLoad(const float* src) { return _mm_loadu_ps(src); }
+
+Vec vecLoad(const uint16_t* src) {
+    const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, _mm_setzero_si128()));
+}
+
+Vec vecLoad(const int16_t* src) {
+    // Move the 16 bit values into the upper half and sign-extend by shifting back
+    const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+}
+
+#endif
+
+template <typename T>
+constexpr bool HasVectorLoad = std::is_same_v<T, float> ||
+    std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>;
+
+template <typename T>
+TileMetaData calculate(T* values, size_t nValues, size_t nRasters, float noDataValue) {
+    TileMetaData result;
+    result.maxValues.resize(nRasters, -FLT_MAX);
+    result.minValues.resize(nRasters, FLT_MAX);
+    result.hasMissingData.resize(nRasters, false);
+
+    size_t i = 0;
+
+#if defined(OPENSPACE_TILE_PREPROCESSING_AVX2) || \
+    defined(OPENSPACE_TILE_PREPROCESSING_SSE2)
+    // Every lane of the vector belongs to the same raster throughout the loop as long as
+    // the number of rasters divides the vector width
+    if constexpr (HasVectorLoad<T>) {
+        if (VecWidth % nRasters == 0) {
+            const Vec noData = vecSet(noDataValue);
+            const Vec lowest = vecSet(-FLT_MAX);
+            const Vec highest = vecSet(FLT_MAX);
+            Vec minimum = highest;
+            Vec maximum = lowest;
+            int missingLanes = 0;
+
+            for (; i + VecWidth <= nValues; i += VecWidth) {
+                const Vec v = vecLoad(values + i);
+                const Vec valid = vecValid(v, noData);
+                minimum = vecMin(minimum, vecSelect(valid, v, highest));
+                maximum = vecMax(maximum, vecSelect(valid, v, lowest));
+
+                const int validLanes = vecMoveMask(valid);
+                if (validLanes != FullMask) {
+                    // Missing values are rare, so they are patched up one by one
+                    missingLanes |= ~validLanes & FullMask;
+                    for (size_t lane = 0; lane < VecWidth; ++lane) {
+                        if (!(validLanes & (1 << lane))) {
+                            values[i + lane] = missingValue<T>();
+                        }
+                    }
+                }
+            }
+
+            float minLanes[VecWidth];
+            float maxLanes[VecWidth];
+            vecStore(minLanes, minimum);
+            vecStore(maxLanes, maximum);
+            for (size_t lane = 0; lane < VecWidth; ++lane) {
+                const size_t raster = lane % nRasters;
+                float& min = result.minValues[raster];
+                float& max = result.maxValues[raster];
+                min = std::min(min, minLanes[lane]);
+                max = std::max(max, maxLanes[lane]);
+                if (missingLanes & (1 << lane)) {
+                    result.hasMissingData[raster] = true;
+                }
+            }
+        }
+    }
+#endif
+
+    // Scalar fallback that also handles the remainder of the vectorized loop
+    size_t raster = i % nRasters;
+    for (; i < nValues; ++i) {
+        const float value = static_cast<float>(values[i]);
+        if (isValid(value, noDataValue)) {
+            result.minValues[raster] = std::min(result.minValues[raster], value);
+            result.maxValues[raster] = std::max(result.maxValues[raster], value);
+        }
+        else {
+            result.hasMissingData[raster] = true;
+            values[i] = missingValue<T>();
+        }
+
+        raster = (raster + 1 == nRasters) ? 0 : raster + 1;
+    }
+
+    return result;
+}
+
+} // namespace
+
+TileMetaData calculateTileMetaData(std::byte* data, size_t nValues, size_t nRasters,
+                                   GLenum glType, float noDataValue)
+{
+    ghoul_assert(nRasters > 0, "Tile must have at least one raster");
+    ghoul_assert(nValues % nRasters == 0, "Values must be a multiple of the rasters");
+
+    switch (glType) {
+        case GL_UNSIGNED_BYTE:
+            return calculate(
+                reinterpret_cast<GLubyte*>(data), nValues, nRasters, noDataValue
+            );
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            // Half floats are interpreted as their raw 16 bit value, as GLhalf is an
+            // unsigned short
+            return calculate(
+                reinterpret_cast<uint16_t*>(data), nValues, nRasters, noDataValue
+            );
+        case GL_SHORT:
+            return calculate(
+                reinterpret_cast<int16_t*>(data), nValues, nRasters, noDataValue
+            );
+        case GL_UNSIGNED_INT:
+            return calculate(
+                reinterpret_cast<GLuint*>(data), nValues, nRasters, noDataValue
+            );
+        case GL_INT:
+            return calculate(
+                reinterpret_cast<GLint*>(data), nValues, nRasters, noDataValue
+            );
+        case GL_FLOAT:
+            return calculate(
+                reinterpret_cast<GLfloat*>(data), nValues, nRasters, noDataValue
+            );
+        case GL_DOUBLE:
+            return calculate(
+                reinterpret_cast<GLdouble*>(data), nValues, nRasters, noDataValue
+            );
+        default:
+            ghoul_assert(false, "Unknown data type");
+            throw ghoul::MissingCaseException();
+    }
+}
+
+} // namespace openspace::globebrowsing
@@ -22,61 +22,38 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#include <ghoul/misc/assert.h>
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PREPROCESSING___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PREPROCESSING___H__
 
-namespace openspace::globebrowsing {
-
-template <typename P, typename KeyType>
-PrioritizingConcurrentJobManager<P, KeyType>::PrioritizingConcurrentJobManager(
-                                                              LRUThreadPool<KeyType> pool)
-    : _threadPool(std::move(pool))
-{}
-
-template <typename P, typename KeyType>
-void PrioritizingConcurrentJobManager<P, KeyType>::enqueueJob(std::shared_ptr<Job<P>> job,
-                                                              KeyType key)
-{
-    _threadPool.enqueue([this, job]() {
-        job->execute();
-        std::lock_guard lock(_finishedJobsMutex);
-        _finishedJobs.push(job);
-    }, key);
-}
-
-template <typename P, typename KeyType>
-std::vector<KeyType>
-PrioritizingConcurrentJobManager<P, KeyType>::keysToUnfinishedJobs() {
-    return _threadPool.getUnqueuedTasksKeys();
-}
-
-template <typename P, typename KeyType>
-std::vector<KeyType>
-PrioritizingConcurrentJobManager<P, KeyType>::keysToEnqueuedJobs() {
-    return _threadPool.getQueuedTasksKeys();
-}
+#include <modules/globebrowsing/src/basictypes.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <cstddef>
 
-template <typename P, typename KeyType>
-bool PrioritizingConcurrentJobManager<P, KeyType>::touch(KeyType key) {
-    return _threadPool.touch(key);
-}
-
-template <typename P, typename KeyType>
-void PrioritizingConcurrentJobManager<P, KeyType>::clearEnqueuedJobs() {
-    _threadPool.clearEnqueuedTasks();
-}
-
-template <typename P, typename KeyType>
-std::shared_ptr<Job<P>> PrioritizingConcurrentJobManager<P, KeyType>::popFinishedJob() {
-    ghoul_assert(!_finishedJobs.empty(), "There is no finished job to pop!");
-
-    std::lock_guard lock(_finishedJobsMutex);
-    std::shared_ptr<Job<P>> result = _finishedJobs.pop();
-    return result;
-}
+namespace openspace::globebrowsing {
 
-template <typename P, typename KeyType>
-size_t PrioritizingConcurrentJobManager<P, KeyType>::numFinishedJobs() const {
-    return _finishedJobs.size();
-}
+/**
+ * Calculates the minimum and maximum value of each raster of the interleaved tile
+ * \p data in a single pass and flags the rasters that contain missing values. A value
+ * is missing if it is equal to the \p noDataValue or is NaN. Missing values are
+ * overwritten in place with the lowest value representable by the data type, or
+ * <code>-FLT_MAX</code> for floating point data, so that they can be recognized on the
+ * GPU. If a raster only contains missing values, its minimum value will be larger than
+ * its maximum value.
+ *
+ * The kernel is specialized for every \p glType at compile time. Float, unsigned short,
+ * and short data is processed with AVX2 or SSE2 instructions if they are available and
+ * the number of rasters divides the vector width, otherwise a scalar loop is used.
+ *
+ * \param data The tile data that is preprocessed and updated in place
+ * \param nValues The total number of values in \p data, which is the number of pixels
+ *        times \p nRasters
+ * \param nRasters The number of interleaved rasters in \p data
+ * \param glType The OpenGL data type of each value in \p data
+ * \param noDataValue The value of the dataset that signals missing data
+ */
+TileMetaData calculateTileMetaData(std::byte* data, size_t nValues, size_t nRasters,
+    GLenum glType, float noDataValue);
 
 } // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PREPROCESSING___H__
@@ -27,6 +27,7 @@
 #include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/src/asynctiledataprovider.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
+#include <modules/globebrowsing/src/heightcache.h>
 #include <modules/globebrowsing/src/layermanager.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
 #include <modules/globebrowsing/src/rawtiledatareader.h>
@@ -80,6 +81,10 @@ Tile DefaultTile = Tile{ nullptr, std::nullopt, Tile::Status::Unavailable };
 
 constexpr const char* KeyFilePath = "FilePath";
 
+// The maximum size of the CPU copies of the tiles of each height layer. A default height
+// tile of 64x64 floats takes 16 kB
+constexpr const size_t HeightCacheSize = 16 * 1024 * 1024;
+
 namespace defaultprovider {
     constexpr const char* KeyPerformPreProcessing = "PerformPreProcessing";
     constexpr const char* KeyTilePixelSize = "TilePixelSize";
@@ -158,8 +163,17 @@ void initAsyncTileDataReader(DefaultTileProvider& t, TileTextureInitData initDat
             t.filePath,
             initData,
             RawTileDataReader::PerformPreprocessing(t.performPreProcessing)
-        )
+        ),
+        t.layerGroupID
     );
+
+    if (t.layerGroupID == layergroupid::GroupID::HeightLayers) {
+        t.heightCache = std::make_unique<cache::HeightCache>(
+            HeightCacheSize,
+            t.asyncTextureDataProvider->rawTileDataReader().depthTransform(),
+            t.asyncTextureDataProvider->noDataValueAsFloat()
+        );
+    }
 }
 
 void initTexturesFromLoadedData(DefaultTileProvider& t) {
@@ -168,6 +182,9 @@ void initTexturesFromLoadedData(DefaultTileProvider& t) {
         if (tile) {
             const cache::ProviderTileKey key = { tile->tileIndex, t.uniqueIdentifier };
             ghoul_assert(!t.tileCache->exist(key), "Tile must not be existing in cache");
+            if (t.heightCache) {
+                t.heightCache->put(*tile);
+            }
             t.tileCache->createTileAndPut(key, std::move(tile.value()));
         }
     }
@@ -871,6 +888,17 @@ Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
                 if (!tile.texture) {
                     t.asyncTextureDataProvider->enqueueTileIO(tileIndex);
                 }
+                else if (t.heightCache && !t.heightCache->exist(tileIndex)) {
+                    // The tile was evicted from the height cache but is still in use, so
+                    // it is restored from the CPU copy of its texture
+                    const RawTileDataReader& reader =
+                        t.asyncTextureDataProvider->rawTileDataReader();
+                    t.heightCache->put(
+                        tileIndex,
+                        reader.tileTextureInitData(),
+                        tile.texture->pixelData()
+                    );
+                }
 
                 return tile;
             }
@@ -1068,10 +1096,57 @@ TileDepthTransform depthTransform(TileProvider& tp) {
     }
 }
 
-
-
-
-
+std::optional<float> height(TileProvider& tp, const Geodetic2& position) {
+    switch (tp.type) {
+        case Type::DefaultTileProvider: {
+            DefaultTileProvider& t = static_cast<DefaultTileProvider&>(tp);
+            return t.heightCache ? t.heightCache->height(position) : std::nullopt;
+        }
+        case Type::SingleImageTileProvider:
+            return std::nullopt;
+        case Type::SizeReferenceTileProvider:
+            return std::nullopt;
+        case Type::TileIndexTileProvider:
+            return std::nullopt;
+        case Type::ByIndexTileProvider: {
+            TileProviderByIndex& t = static_cast<TileProviderByIndex&>(tp);
+            return height(*t.defaultTileProvider, position);
+        }
+        case Type::ByLevelTileProvider: {
+            // Ask the provider of the finest level first
+            TileProviderByLevel& t = static_cast<TileProviderByLevel&>(tp);
+            int previousIndex = -1;
+            for (auto it = t.providerIndices.rbegin();
+                 it != t.providerIndices.rend();
+                 ++it)
+            {
+                if (*it == -1 || *it == previousIndex) {
+                    continue;
+                }
+                previousIndex = *it;
+                std::optional<float> h = height(*t.levelTileProviders[*it], position);
+                if (h) {
+                    return h;
+                }
+            }
+            return std::nullopt;
+        }
+        case Type::TemporalTileProvider: {
+            // The provider is not updated here, so until the first update there is no
+            // current provider and thus no height
+            TemporalTileProvider& t = static_cast<TemporalTileProvider&>(tp);
+            TileProvider* current = t.currentTileProvider;
+            if (t.successfulInitialization && current) {
+                return height(*current, position);
+            }
+            else {
+                return std::nullopt;
+            }
+        }
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
 
 void update(TileProvider& tp) {
     switch (tp.type) {
@@ -1142,6 +1217,9 @@ void reset(TileProvider& tp) {
         case Type::DefaultTileProvider: {
             DefaultTileProvider& t = static_cast<DefaultTileProvider&>(tp);
             t.tileCache->clear();
+            if (t.heightCache) {
+                t.heightCache->clear();
+            }
             if (t.asyncTextureDataProvider) {
                 t.asyncTextureDataProvider->prepareToBeDeleted();
             }
@@ -35,6 +35,8 @@
 #include <modules/globebrowsing/src/timequantizer.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <atomic>
+#include <optional>
 #include <unordered_map>
 
 struct CPLXMLNode;
@@ -50,7 +52,10 @@ namespace openspace::globebrowsing {
     class AsyncTileDataProvider;
     struct RawTile;
     struct TileIndex;
-    namespace cache { class MemoryAwareTileCache; }
+    namespace cache {
+        class HeightCache;
+        class MemoryAwareTileCache;
+    } // namespace cache
 } // namespace openspace::globebrowsing
 
 namespace openspace::globebrowsing::tileprovider {
@@ -86,6 +91,8 @@ struct DefaultTileProvider : public TileProvider {
     std::unique_ptr<AsyncTileDataProvider> asyncTextureDataProvider;
 
     cache::MemoryAwareTileCache* tileCache = nullptr;
+    /// CPU copies of the loaded tiles for height queries, only used for height layers
+    std::unique_ptr<cache::HeightCache> heightCache;
 
     properties::StringProperty filePath;
     properties::IntProperty tilePixelSize;
@@ -178,7 +185,8 @@ struct TemporalTileProvider : public TileProvider {
 
     std::unordered_map<TimeKey, std::unique_ptr<TileProvider>> tileProviderMap;
 
-    TileProvider* currentTileProvider = nullptr;
+    // Read by height queries that might run on other threads than the update
+    std::atomic<TileProvider*> currentTileProvider = nullptr;
 
     TimeFormatType timeFormat;
     TimeQuantizer timeQuantizer;
@@ -219,6 +227,16 @@ Tile::Status tileStatus(TileProvider& tp, const TileIndex& index);
  */
 TileDepthTransform depthTransform(TileProvider& tp);
 
+/**
+ * Returns the height in meters at the geodetic \p position as far as it is known from
+ * the tiles that have been loaded so far, or <code>std::nullopt</code> if it is unknown.
+ * Only CPU copies of the tiles are accessed, never their textures, so the result might
+ * come from a coarser level than the tile that is currently rendered. No tile provider is
+ * updated by this function, so it can be called from other threads while the providers
+ * are updated, but not while they are created or destroyed.
+ */
+std::optional<float> height(TileProvider& tp, const Geodetic2& position);
+
 /**
  * This method should be called once per frame. Here, TileProviders
  * are given the opportunity to update their internal state.
@@ -27,9 +27,13 @@
 
 #include <ghoul/misc/templatefactory.h>
 #include <openspace/json.h>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace ghoul::io { class Socket; }
 
@@ -37,37 +41,111 @@ namespace openspace {
 
 using TopicId = size_t;
 
+class TaskScheduler;
 class Topic;
 
 class Connection {
 public:
+    /**
+     * The encoding of the messages of a connection. All connections start out with JSON
+     * messages, one per socket message. A client can request MessagePack by sending
+     * <code>{ "encoding": "msgpack" }</code> as its very first message. The server
+     * answers with the JSON message <code>{ "encoding": "msgpack" }</code> if the request
+     * was accepted or <code>{ "encoding": "json" }</code> if it was not. After an
+     * accepted request, every message in both directions is a MessagePack encoded object
+     * with the same structure as the JSON messages, preceded by its size in bytes as an
+     * unsigned 32-bit integer. The only exception are the updates of a property
+     * subscription, which omit the <code>Description</code> of the property after the
+     * first update (see SubscriptionTopic). MessagePack is only available for TcpSocket
+     * interfaces.
+     */
+    enum class Encoding {
+        Json = 0,
+        MessagePack
+    };
+
+    /**
+     * Creates a connection for the socket \p s. If a \p sendScheduler is provided,
+     * outgoing messages are serialized and written to the socket by its worker threads,
+     * otherwise they are written immediately on the calling thread.
+     */
     Connection(
         std::unique_ptr<ghoul::io::Socket> s,
         std::string address,
         bool authorized = false,
-        const std::string& password = ""
+        const std::string& password = "",
+        TaskScheduler* sendScheduler = nullptr
     );
 
+    /**
+     * Receives the next message from the socket, blocking until one is available, and
+     * negotiates the encoding if the message is the first one of the connection. Returns
+     * \c false if the socket was disconnected. This function must only be called from
+     * the connection's thread.
+     */
+    bool receiveMessage(std::string& message);
+
     void handleMessage(const std::string& message);
-    void sendMessage(const std::string& message);
+    void sendMessage(std::string message);
     void handleJson(const nlohmann::json& json);
-    void sendJson(const nlohmann::json& json);
+    void sendJson(nlohmann::json json);
+
+    /**
+     * Queues a message whose content is created by calling \p serialize. The function
+     * is executed on one of the send scheduler's worker threads, so it must not access
+     * any state that is owned by the render thread. Messages of a single connection are
+     * always sent in the order in which they were queued.
+     */
+    void sendDeferred(std::function<std::string()> serialize);
+
+    /// Gives all topics of this connection the opportunity to send pending updates
+    void updateTopics();
+
     void setAuthorized(bool status);
 
     bool isAuthorized() const;
+    Encoding encoding() const;
 
     ghoul::io::Socket* socket();
     std::thread& thread();
     void setThread(std::thread&& thread);
 
 private:
+    struct OutgoingMessage {
+        std::function<std::string()> serialize;
+        /// Determines whether the message is sent as is or preceded by its size
+        Encoding encoding;
+    };
+
+    /// The messages that are waiting to be written to the socket by a worker thread
+    struct Outbox {
+        std::shared_ptr<ghoul::io::Socket> socket;
+        std::mutex mutex;
+        std::vector<OutgoingMessage> messages;
+        bool isFlushScheduled = false;
+    };
+
+    bool negotiateEncoding(const std::string& message);
+    bool receiveFrame(std::string& message);
+    void queueMessage(OutgoingMessage message);
+    static void writeMessage(ghoul::io::Socket& socket, Encoding encoding,
+        const std::string& message);
+    static void flushOutbox(Outbox& outbox);
+
     ghoul::TemplateFactory<Topic> _topicFactory;
     std::map<TopicId, std::unique_ptr<Topic>> _topics;
-    std::unique_ptr<ghoul::io::Socket> _socket;
+    std::shared_ptr<ghoul::io::Socket> _socket;
     std::thread _thread;
 
+    // The outbox is shared with the flush tasks so that the socket stays alive until
+    // all queued messages have been written, even if the connection is removed earlier
+    std::shared_ptr<Outbox> _outbox;
+    TaskScheduler* _sendScheduler = nullptr;
+
     std::string _address;
     bool _isAuthorized = false;
+    std::atomic<Encoding> _encoding = Encoding::Json;
+    bool _hasReceivedMessage = false;
     std::map<TopicId, std::string> _messageQueue;
     std::map<TopicId, std::chrono::system_clock::time_point> _sentMessages;
 };
@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SERVER___MESSAGEPACKWRITER___H__
+#define __OPENSPACE_MODULE_SERVER___MESSAGEPACKWRITER___H__
+
+#include <openspace/json.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace openspace {
+
+/**
+ * Appends values in the MessagePack format (https://msgpack.org) to a string without
+ * building an intermediate JSON tree. Maps and arrays are written by first writing their
+ * header with the number of elements, followed by the elements themselves; for maps, the
+ * key and the value of each entry are written alternately.
+ */
+class MessagePackWriter {
+public:
+    /// Creates a writer that appends all values to the provided \p buffer
+    explicit MessagePackWriter(std::string& buffer);
+
+    void writeMap(uint32_t nEntries);
+    void writeArray(uint32_t nElements);
+    void writeNil();
+    void writeBool(bool value);
+    void writeInteger(int64_t value);
+    void writeUnsignedInteger(uint64_t value);
+    void writeDouble(double value);
+    void writeString(std::string_view value);
+
+    /// Writes the value represented by the \p json tree
+    void writeJson(const nlohmann::json& json);
+
+    /**
+     * Writes the value that is represented by the JSON-encoded \p text. Literals,
+     * numbers, and flat arrays of numbers are converted directly, all other values are
+     * parsed into a JSON tree first.
+     */
+    void writeJsonText(std::string_view text);
+
+private:
+    bool writeNumber(std::string_view text);
+    bool writeNumberArray(std::string_view text);
+
+    template <typename T>
+    void writeBigEndian(uint8_t type, T value);
+
+    std::string& _buffer;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___MESSAGEPACKWRITER___H__
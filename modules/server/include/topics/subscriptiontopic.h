@@ -27,10 +27,22 @@
 
 #include <modules/server/include/topics/topic.h>
 
+#include <chrono>
+#include <memory>
+
 namespace openspace::properties { class Property; }
 
 namespace openspace {
 
+/**
+ * A subscription to changes of a single property. Changes of the property only mark the
+ * subscription as dirty; the latest value is sent from #update at most once per frame or
+ * at most at the rate that was requested by the client, so intermediate values of a
+ * property that changes faster than that are never sent. Only the property's value is
+ * captured on the main thread, the message is created by the connection's send workers.
+ * For MessagePack connections, the description of the property is only sent with the
+ * first value, all later updates only contain the value.
+ */
 class SubscriptionTopic : public Topic {
 public:
     SubscriptionTopic() = default;
@@ -38,9 +50,11 @@ public:
 
     void handleJson(const nlohmann::json& json) override;
     bool isDone() const override;
+    void update() override;
 
 private:
     void resetCallbacks();
+    void sendValue();
 
     const int UnsetCallbackHandle = -1;
 
@@ -49,6 +63,14 @@ private:
     int _onChangeHandle = UnsetCallbackHandle;
     int _onDeleteHandle = UnsetCallbackHandle;
     properties::Property* _prop = nullptr;
+
+    /// The description of the property, which is created once per subscription
+    std::shared_ptr<const nlohmann::json> _description;
+    bool _hasSentDescription = false;
+    bool _isDirty = false;
+    std::chrono::steady_clock::duration _minUpdateInterval =
+        std::chrono::steady_clock::duration::zero();
+    std::chrono::steady_clock::time_point _lastUpdateTime;
 };
 
 } // namespace openspace
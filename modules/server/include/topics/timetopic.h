@@ -41,6 +41,8 @@ public:
 private:
     const int UnsetOnChangeHandle = -1;
 
+    void sendCurrentTime();
+    void sendDeltaTime();
     nlohmann::json currentTime();
     nlohmann::json deltaTime();
 
@@ -43,6 +43,9 @@ public:
     virtual void handleJson(const nlohmann::json& json) = 0;
     virtual bool isDone() const = 0;
 
+    /// Called once per frame on the main thread to let the topic send pending updates
+    virtual void update() {};
+
 protected:
     size_t _topicId;
     Connection* _connection;
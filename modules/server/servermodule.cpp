@@ -28,6 +28,7 @@
 #include <modules/server/include/connection.h>
 #include <modules/server/include/topics/topic.h>
 #include <openspace/engine/globalscallbacks.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/fmt.h>
 #include <ghoul/io/socket/socket.h>
 #include <ghoul/io/socket/tcpsocketserver.h>
@@ -38,6 +39,8 @@
 
 namespace {
     constexpr const char* KeyInterfaces = "Interfaces";
+    constexpr const char* KeySendWorkers = "SendWorkers";
+    constexpr const unsigned int DefaultSendWorkers = 2;
 } // namespace
 
 namespace openspace {
@@ -52,6 +55,8 @@ ServerModule::ServerModule()
 ServerModule::~ServerModule() {
     disconnectAll();
     cleanUpFinishedThreads();
+    // Wait for the send workers before the connections are destroyed
+    _sendScheduler = nullptr;
 }
 
 ServerInterface* ServerModule::serverInterfaceByIdentifier(const std::string& identifier)
@@ -72,6 +77,15 @@ ServerInterface* ServerModule::serverInterfaceByIdentifier(const std::string& id
 void ServerModule::internalInitialize(const ghoul::Dictionary& configuration) {
     using namespace ghoul::io;
 
+    unsigned int nSendWorkers = DefaultSendWorkers;
+    if (configuration.hasValue<double>(KeySendWorkers)) {
+        nSendWorkers = std::max(
+            1u,
+            static_cast<unsigned int>(configuration.value<double>(KeySendWorkers))
+        );
+    }
+    _sendScheduler = std::make_unique<TaskScheduler>(nSendWorkers);
+
     if (configuration.hasValue<ghoul::Dictionary>(KeyInterfaces)) {
         ghoul::Dictionary interfaces =
             configuration.value<ghoul::Dictionary>(KeyInterfaces);
@@ -125,7 +139,8 @@ void ServerModule::preSync() {
                 std::move(socket),
                 address,
                 false,
-                serverInterface->password()
+                serverInterface->password(),
+                _sendScheduler.get()
             );
             connection->setThread(std::thread(
                 [this, connection] () { handleConnection(connection); }
@@ -140,6 +155,11 @@ void ServerModule::preSync() {
     // Consume all messages put into the message queue by the socket threads.
     consumeMessages();
 
+    // Let the topics send the latest values of everything that changed since last frame
+    for (ConnectionData& connectionData : _connections) {
+        connectionData.connection->updateTopics();
+    }
+
     // Join threads for sockets that disconnected.
     cleanUpFinishedThreads();
 }
@@ -180,7 +200,7 @@ void ServerModule::disconnectAll() {
 
 void ServerModule::handleConnection(std::shared_ptr<Connection> connection) {
     std::string messageString;
-    while (connection->socket()->getMessage(messageString)) {
+    while (connection->receiveMessage(messageString)) {
         std::lock_guard<std::mutex> lock(_messageQueueMutex);
         _messageQueue.push_back({ connection, std::move(messageString) });
     }
@@ -40,6 +40,7 @@ constexpr int SOCKET_API_VERSION_MINOR = 1;
 constexpr int SOCKET_API_VERSION_PATCH = 0;
 
 class Connection;
+class TaskScheduler;
 
 struct Message {
     std::weak_ptr<Connection> connection;
@@ -73,6 +74,9 @@ private:
     std::mutex _messageQueueMutex;
     std::deque<Message> _messageQueue;
 
+    // Serializes and writes outgoing messages of all connections
+    std::unique_ptr<TaskScheduler> _sendScheduler;
+
     std::vector<ConnectionData> _connections;
     std::vector<std::unique_ptr<ServerInterface>> _interfaces;
     properties::PropertyOwner _interfaceOwner;
@@ -37,7 +37,9 @@
 #include <modules/server/include/topics/versiontopic.h>
 #include <openspace/engine/configuration.h>
 #include <openspace/engine/globals.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/io/socket/socket.h>
+#include <ghoul/io/socket/tcpsocket.h>
 #include <ghoul/io/socket/tcpsocketserver.h>
 #include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/logging/logmanager.h>
@@ -49,6 +51,13 @@ namespace {
     constexpr const char* MessageKeyType = "type";
     constexpr const char* MessageKeyPayload = "payload";
     constexpr const char* MessageKeyTopic = "topic";
+    constexpr const char* MessageKeyEncoding = "encoding";
+
+    constexpr const char* JsonEncoding = "json";
+    constexpr const char* MessagePackEncoding = "msgpack";
+
+    // Larger MessagePack messages are considered to be corrupt
+    constexpr const uint32_t MaxMessageSize = 16 * 1024 * 1024;
 
     constexpr const char* VersionTopicKey = "version";
     constexpr const char* AuthenticationTopicKey = "authorize";
@@ -67,12 +76,16 @@ namespace openspace {
 Connection::Connection(std::unique_ptr<ghoul::io::Socket> s,
                        std::string address,
                        bool authorized,
-                       const std::string& password)
+                       const std::string& password,
+                       TaskScheduler* sendScheduler)
     : _socket(std::move(s))
+    , _outbox(std::make_shared<Outbox>())
+    , _sendScheduler(sendScheduler)
     , _address(std::move(address))
     , _isAuthorized(authorized)
 {
     ghoul_assert(_socket, "Socket must not be nullptr");
+    _outbox->socket = _socket;
 
     _topicFactory.registerClass(
         AuthenticationTopicKey,
@@ -94,7 +107,11 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s,
 
 void Connection::handleMessage(const std::string& message) {
     try {
-        nlohmann::json j = nlohmann::json::parse(message.c_str());
+        nlohmann::json j = _encoding == Encoding::MessagePack ?
+            nlohmann::json::from_msgpack(
+                std::vector<uint8_t>(message.begin(), message.end())
+            ) :
+            nlohmann::json::parse(message.c_str());
         try {
             handleJson(j);
         } catch (const std::domain_error& e) {
@@ -184,18 +201,185 @@ void Connection::handleJson(const nlohmann::json& json) {
     }
 }
 
-void Connection::sendMessage(const std::string& message) {
-    _socket->putMessage(message);
+bool Connection::receiveMessage(std::string& message) {
+    if (_encoding == Encoding::MessagePack) {
+        return receiveFrame(message);
+    }
+
+    if (!_socket->getMessage(message)) {
+        return false;
+    }
+    if (_hasReceivedMessage) {
+        return true;
+    }
+    _hasReceivedMessage = true;
+
+    // Only the first message of a connection can negotiate the encoding, which makes it
+    // possible to change the framing before anything else is read from the socket
+    if (negotiateEncoding(message)) {
+        return receiveMessage(message);
+    }
+    return true;
 }
 
-void Connection::sendJson(const nlohmann::json& json) {
-    sendMessage(json.dump());
+bool Connection::negotiateEncoding(const std::string& message) {
+    if (message.find(MessageKeyEncoding) == std::string::npos) {
+        return false;
+    }
+
+    nlohmann::json json;
+    try {
+        json = nlohmann::json::parse(message.c_str());
+    }
+    catch (...) {
+        return false;
+    }
+    auto encodingJson = json.find(MessageKeyEncoding);
+    if (!json.is_object() || encodingJson == json.end() || !encodingJson->is_string() ||
+        json.find(MessageKeyTopic) != json.end())
+    {
+        return false;
+    }
+
+    // MessagePack messages are framed by their size, which the other socket types
+    // cannot represent
+    const bool isAccepted = (*encodingJson == MessagePackEncoding) &&
+                            dynamic_cast<ghoul::io::TcpSocket*>(_socket.get());
+
+    // The answer is the last message that is sent as JSON. No topic can exist yet, so
+    // nothing else can be queued concurrently
+    const nlohmann::json answer = {
+        { MessageKeyEncoding, isAccepted ? MessagePackEncoding : JsonEncoding }
+    };
+    queueMessage({ [m = answer.dump()]() { return m; }, Encoding::Json });
+    if (isAccepted) {
+        _encoding = Encoding::MessagePack;
+    }
+    else {
+        LWARNING(fmt::format(
+            "Requested encoding '{}' is not available for {}",
+            encodingJson->get<std::string>(), _address
+        ));
+    }
+    return true;
+}
+
+bool Connection::receiveFrame(std::string& message) {
+    ghoul::io::TcpSocket& socket = static_cast<ghoul::io::TcpSocket&>(*_socket);
+
+    uint32_t size = 0;
+    if (!socket.get(reinterpret_cast<char*>(&size), sizeof(uint32_t))) {
+        return false;
+    }
+    if (size > MaxMessageSize) {
+        LERROR(fmt::format(
+            "Message of {} bytes from {} exceeds the maximum size. Disconnecting.",
+            size, _address
+        ));
+        socket.disconnect();
+        return false;
+    }
+    message.resize(size);
+    return socket.get(message.data(), size);
+}
+
+void Connection::sendMessage(std::string message) {
+    sendDeferred([m = std::move(message)]() { return m; });
+}
+
+void Connection::sendJson(nlohmann::json json) {
+    if (_encoding == Encoding::MessagePack) {
+        sendDeferred([j = std::move(json)]() {
+            const std::vector<uint8_t> bytes = nlohmann::json::to_msgpack(j);
+            return std::string(bytes.begin(), bytes.end());
+        });
+    }
+    else {
+        sendDeferred([j = std::move(json)]() { return j.dump(); });
+    }
+}
+
+void Connection::sendDeferred(std::function<std::string()> serialize) {
+    queueMessage({ std::move(serialize), _encoding });
+}
+
+void Connection::queueMessage(OutgoingMessage message) {
+    if (!_sendScheduler) {
+        writeMessage(*_socket, message.encoding, message.serialize());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_outbox->mutex);
+        _outbox->messages.push_back(std::move(message));
+        if (_outbox->isFlushScheduled) {
+            // The running flush task will pick up the new message as well
+            return;
+        }
+        _outbox->isFlushScheduled = true;
+    }
+    // Only one flush task per connection is in flight at any time, which keeps the
+    // messages of this connection in order without locking the socket
+    _sendScheduler->enqueue([outbox = _outbox]() { flushOutbox(*outbox); });
+}
+
+void Connection::writeMessage(ghoul::io::Socket& socket, Encoding encoding,
+                              const std::string& message)
+{
+    if (encoding == Encoding::Json) {
+        socket.putMessage(message);
+        return;
+    }
+
+    // The encoding can only have been negotiated for a TcpSocket
+    ghoul::io::TcpSocket& tcpSocket = static_cast<ghoul::io::TcpSocket&>(socket);
+    const uint32_t size = static_cast<uint32_t>(message.size());
+    if (tcpSocket.put(reinterpret_cast<const char*>(&size), sizeof(uint32_t))) {
+        tcpSocket.put(message.data(), message.size());
+    }
+}
+
+void Connection::flushOutbox(Outbox& outbox) {
+    std::vector<OutgoingMessage> messages;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(outbox.mutex);
+            if (outbox.messages.empty()) {
+                outbox.isFlushScheduled = false;
+                return;
+            }
+            std::swap(messages, outbox.messages);
+        }
+
+        for (OutgoingMessage& message : messages) {
+            if (!outbox.socket->isConnected()) {
+                break;
+            }
+            try {
+                writeMessage(*outbox.socket, message.encoding, message.serialize());
+            }
+            catch (const std::exception& e) {
+                LERROR(fmt::format("Could not serialize message: {}", e.what()));
+            }
+        }
+        messages.clear();
+    }
+}
+
+void Connection::updateTopics() {
+    for (const std::pair<const TopicId, std::unique_ptr<Topic>>& it : _topics) {
+        it.second->update();
+    }
 }
 
 bool Connection::isAuthorized() const {
     return _isAuthorized;
 }
 
+Connection::Encoding Connection::encoding() const {
+    return _encoding;
+}
+
 void Connection::setThread(std::thread&& thread) {
     _thread = std::move(thread);
 }
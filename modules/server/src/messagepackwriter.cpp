@@ -0,0 +1,280 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/include/messagepackwriter.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    constexpr const size_t MaxNumberLength = 63;
+
+    std::string_view trimmed(std::string_view text) {
+        constexpr const char* Whitespace = " \t\r\n";
+        const size_t begin = text.find_first_not_of(Whitespace);
+        if (begin == std::string_view::npos) {
+            return std::string_view();
+        }
+        const size_t end = text.find_last_not_of(Whitespace);
+        return text.substr(begin, end - begin + 1);
+    }
+
+    struct Number {
+        enum class Type { Integer, UnsignedInteger, Double };
+        Type type = Type::Double;
+        long long integer = 0;
+        unsigned long long unsignedInteger = 0;
+        double value = 0.0;
+    };
+
+    bool parseNumber(std::string_view text, Number& number) {
+        if (text.empty() || text.size() > MaxNumberLength ||
+            text.find_first_not_of("+-0123456789.eE") != std::string_view::npos)
+        {
+            return false;
+        }
+
+        // strtod and strtoll require a null-terminated string
+        char buffer[MaxNumberLength + 1];
+        *std::copy(text.begin(), text.end(), buffer) = '\0';
+        char* end = nullptr;
+
+        if (text.find_first_of(".eE") == std::string_view::npos) {
+            errno = 0;
+            number.integer = std::strtoll(buffer, &end, 10);
+            if (end == buffer + text.size() && errno == 0) {
+                number.type = Number::Type::Integer;
+                return true;
+            }
+
+            // Positive integers above the signed range still fit into a uint64, but
+            // strtoull would silently wrap negative numbers around
+            if (text.front() != '-') {
+                errno = 0;
+                number.unsignedInteger = std::strtoull(buffer, &end, 10);
+                if (end == buffer + text.size() && errno == 0) {
+                    number.type = Number::Type::UnsignedInteger;
+                    return true;
+                }
+            }
+        }
+
+        number.type = Number::Type::Double;
+        number.value = std::strtod(buffer, &end);
+        return end == buffer + text.size();
+    }
+} // namespace
+
+namespace openspace {
+
+MessagePackWriter::MessagePackWriter(std::string& buffer) : _buffer(buffer) {}
+
+template <typename T>
+void MessagePackWriter::writeBigEndian(uint8_t type, T value) {
+    static_assert(std::is_integral_v<T>, "T must be an integer type");
+    _buffer.push_back(static_cast<char>(type));
+    for (int i = sizeof(T) - 1; i >= 0; --i) {
+        _buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+void MessagePackWriter::writeMap(uint32_t nEntries) {
+    if (nEntries < 16) {
+        _buffer.push_back(static_cast<char>(0x80 | nEntries));
+    }
+    else if (nEntries <= std::numeric_limits<uint16_t>::max()) {
+        writeBigEndian(0xde, static_cast<uint16_t>(nEntries));
+    }
+    else {
+        writeBigEndian(0xdf, nEntries);
+    }
+}
+
+void MessagePackWriter::writeArray(uint32_t nElements) {
+    if (nElements < 16) {
+        _buffer.push_back(static_cast<char>(0x90 | nElements));
+    }
+    else if (nElements <= std::numeric_limits<uint16_t>::max()) {
+        writeBigEndian(0xdc, static_cast<uint16_t>(nElements));
+    }
+    else {
+        writeBigEndian(0xdd, nElements);
+    }
+}
+
+void MessagePackWriter::writeNil() {
+    _buffer.push_back(static_cast<char>(0xc0));
+}
+
+void MessagePackWriter::writeBool(bool value) {
+    _buffer.push_back(static_cast<char>(value ? 0xc3 : 0xc2));
+}
+
+void MessagePackWriter::writeInteger(int64_t value) {
+    if (value >= 0) {
+        if (value < 128) {
+            _buffer.push_back(static_cast<char>(value));
+        }
+        else if (value <= std::numeric_limits<uint8_t>::max()) {
+            writeBigEndian(0xcc, static_cast<uint8_t>(value));
+        }
+        else if (value <= std::numeric_limits<uint16_t>::max()) {
+            writeBigEndian(0xcd, static_cast<uint16_t>(value));
+        }
+        else if (value <= std::numeric_limits<uint32_t>::max()) {
+            writeBigEndian(0xce, static_cast<uint32_t>(value));
+        }
+        else {
+            writeBigEndian(0xcf, static_cast<uint64_t>(value));
+        }
+    }
+    else {
+        if (value >= -32) {
+            _buffer.push_back(static_cast<char>(value));
+        }
+        else if (value >= std::numeric_limits<int8_t>::min()) {
+            writeBigEndian(0xd0, static_cast<uint8_t>(value));
+        }
+        else if (value >= std::numeric_limits<int16_t>::min()) {
+            writeBigEndian(0xd1, static_cast<uint16_t>(value));
+        }
+        else if (value >= std::numeric_limits<int32_t>::min()) {
+            writeBigEndian(0xd2, static_cast<uint32_t>(value));
+        }
+        else {
+            writeBigEndian(0xd3, static_cast<uint64_t>(value));
+        }
+    }
+}
+
+void MessagePackWriter::writeUnsignedInteger(uint64_t value) {
+    if (value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        writeInteger(static_cast<int64_t>(value));
+    }
+    else {
+        writeBigEndian(0xcf, value);
+    }
+}
+
+void MessagePackWriter::writeDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(double));
+    writeBigEndian(0xcb, bits);
+}
+
+void MessagePackWriter::writeString(std::string_view value) {
+    const size_t size = value.size();
+    if (size < 32) {
+        _buffer.push_back(static_cast<char>(0xa0 | size));
+    }
+    else if (size <= std::numeric_limits<uint8_t>::max()) {
+        writeBigEndian(0xd9, static_cast<uint8_t>(size));
+    }
+    else if (size <= std::numeric_limits<uint16_t>::max()) {
+        writeBigEndian(0xda, static_cast<uint16_t>(size));
+    }
+    else {
+        writeBigEndian(0xdb, static_cast<uint32_t>(size));
+    }
+    _buffer.append(value.data(), size);
+}
+
+void MessagePackWriter::writeJson(const nlohmann::json& json) {
+    const std::vector<uint8_t> bytes = nlohmann::json::to_msgpack(json);
+    _buffer.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+void MessagePackWriter::writeJsonText(std::string_view text) {
+    text = trimmed(text);
+    if (text == "true" || text == "false") {
+        writeBool(text == "true");
+    }
+    else if (text == "null") {
+        writeNil();
+    }
+    else if (!writeNumber(text) && !writeNumberArray(text)) {
+        writeJson(nlohmann::json::parse(std::string(text)));
+    }
+}
+
+bool MessagePackWriter::writeNumber(std::string_view text) {
+    Number number;
+    if (!parseNumber(text, number)) {
+        return false;
+    }
+    switch (number.type) {
+        case Number::Type::Integer:
+            writeInteger(number.integer);
+            break;
+        case Number::Type::UnsignedInteger:
+            writeUnsignedInteger(number.unsignedInteger);
+            break;
+        case Number::Type::Double:
+            writeDouble(number.value);
+            break;
+    }
+    return true;
+}
+
+bool MessagePackWriter::writeNumberArray(std::string_view text) {
+    if (text.size() < 2 || text.front() != '[' || text.back() != ']') {
+        return false;
+    }
+    const std::string_view content = trimmed(text.substr(1, text.size() - 2));
+
+    // Validate all elements before anything is written, so that nested or mixed arrays
+    // can still be handled by the generic path
+    uint32_t nElements = 0;
+    if (!content.empty()) {
+        Number number;
+        size_t begin = 0;
+        while (true) {
+            const size_t end = content.find(',', begin);
+            if (!parseNumber(trimmed(content.substr(begin, end - begin)), number)) {
+                return false;
+            }
+            ++nElements;
+            if (end == std::string_view::npos) {
+                break;
+            }
+            begin = end + 1;
+        }
+    }
+
+    writeArray(nElements);
+    size_t begin = 0;
+    for (uint32_t i = 0; i < nElements; ++i) {
+        const size_t end = content.find(',', begin);
+        writeNumber(trimmed(content.substr(begin, end - begin)));
+        begin = end + 1;
+    }
+    return true;
+}
+
+} // namespace openspace
@@ -25,7 +25,7 @@
 #include <modules/server/include/topics/subscriptiontopic.h>
 
 #include <modules/server/include/connection.h>
-#include <modules/server/include/jsonconverters.h>
+#include <modules/server/include/messagepackwriter.h>
 #include <openspace/properties/property.h>
 #include <openspace/query/query.h>
 #include <openspace/util/timemanager.h>
@@ -36,6 +36,7 @@ namespace {
     constexpr const char* _loggerCat = "SubscriptionTopic";
     constexpr const char* PropertyKey = "property";
     constexpr const char* EventKey = "event";
+    constexpr const char* RateKey = "rate";
 
     constexpr const char* StartSubscription = "start_subscription";
     constexpr const char* StopSubscription = "stop_subscription";
@@ -72,25 +73,43 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     const std::string& event = json.at(EventKey).get<std::string>();
 
     if (event == StartSubscription) {
-        _prop = property(key);
         resetCallbacks();
+        _prop = property(key);
 
         if (_prop) {
             _requestedResourceIsSubscribable = true;
             _isSubscribedTo = true;
-            auto onChange = [this, k = std::move(key)]() {
-                _connection->sendJson(wrappedPayload(_prop));
-            };
 
-            _onChangeHandle = _prop->onChange(onChange);
+            // The optional rate is the maximum number of updates per second; without it,
+            // the latest value is sent at most once per frame
+            _minUpdateInterval = std::chrono::steady_clock::duration::zero();
+            auto rate = json.find(RateKey);
+            if (rate != json.end() && rate->is_number() && rate->get<double>() > 0.0) {
+                _minUpdateInterval = std::chrono::duration_cast<
+                    std::chrono::steady_clock::duration
+                >(std::chrono::duration<double>(1.0 / rate->get<double>()));
+            }
+
+            nlohmann::json description = nlohmann::json::parse(
+                _prop->generateBaseJsonDescription()
+            );
+            description["description"] = _prop->description();
+            _description = std::make_shared<const nlohmann::json>(
+                std::move(description)
+            );
+            _hasSentDescription = false;
+
+            _onChangeHandle = _prop->onChange([this]() { _isDirty = true; });
             _onDeleteHandle = _prop->onDelete([this]() {
                 _onChangeHandle = UnsetCallbackHandle;
                 _onDeleteHandle = UnsetCallbackHandle;
                 _isSubscribedTo = false;
+                _isDirty = false;
+                _prop = nullptr;
             });
 
             // immediately send the value
-            onChange();
+            sendValue();
         }
         else {
             LWARNING(fmt::format("Could not subscribe. Property '{}' not found", key));
@@ -98,14 +117,71 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     }
     if (event == StopSubscription) {
         _isSubscribedTo = false;
-        if (_prop && _onChangeHandle != UnsetCallbackHandle) {
-            _prop->removeOnChange(_onChangeHandle);
-            _onChangeHandle = UnsetCallbackHandle;
-        }
-        if (_prop && !_onDeleteHandle) {
-            _prop->removeOnDelete(_onDeleteHandle);
-            _onDeleteHandle = UnsetCallbackHandle;
-        }
+        _isDirty = false;
+        resetCallbacks();
+    }
+}
+
+void SubscriptionTopic::update() {
+    if (!_isDirty || !_prop) {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - _lastUpdateTime < _minUpdateInterval) {
+        return;
+    }
+    sendValue();
+}
+
+void SubscriptionTopic::sendValue() {
+    _isDirty = false;
+    _lastUpdateTime = std::chrono::steady_clock::now();
+
+    // Only the value is requested from the property here, parsing it and creating the
+    // message happens on one of the connection's send workers
+    if (_connection->encoding() == Connection::Encoding::MessagePack) {
+        // The description does not change, so it is only sent with the first value
+        std::shared_ptr<const nlohmann::json> description =
+            _hasSentDescription ? nullptr : _description;
+        _hasSentDescription = true;
+
+        _connection->sendDeferred(
+            [topicId = _topicId, d = std::move(description), v = _prop->jsonValue()]()
+            {
+                std::string message;
+                MessagePackWriter writer(message);
+                writer.writeMap(2);
+                writer.writeString("topic");
+                writer.writeInteger(static_cast<int64_t>(topicId));
+                writer.writeString("payload");
+                writer.writeMap(d ? 2 : 1);
+                if (d) {
+                    writer.writeString("Description");
+                    writer.writeJson(*d);
+                }
+                writer.writeString("Value");
+                writer.writeJsonText(v);
+                return message;
+            }
+        );
+    }
+    else {
+        _connection->sendDeferred(
+            [topicId = _topicId, description = _description, v = _prop->jsonValue()]()
+            {
+                const nlohmann::json message = {
+                    { "topic", topicId },
+                    {
+                        "payload", {
+                            { "Description", *description },
+                            { "Value", nlohmann::json::parse(v) }
+                        }
+                    }
+                };
+                return message.dump();
+            }
+        );
     }
 }
 
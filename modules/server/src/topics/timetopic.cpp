@@ -25,6 +25,7 @@
 #include "modules/server/include/topics/timetopic.h"
 
 #include <modules/server/include/connection.h>
+#include <modules/server/include/messagepackwriter.h>
 #include <openspace/engine/globals.h>
 #include <openspace/properties/property.h>
 #include <openspace/query/query.h>
@@ -78,11 +79,11 @@ void TimeTopic::handleJson(const nlohmann::json& json) {
         _timeCallbackHandle = global::timeManager.addTimeChangeCallback([this]() {
             std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
             if (now - _lastUpdateTime > TimeUpdateInterval) {
-                _connection->sendJson(currentTime());
+                sendCurrentTime();
                 _lastUpdateTime = now;
             }
         });
-        _connection->sendJson(currentTime());
+        sendCurrentTime();
     }
     else if (requestedKey == DeltaTimeKey) {
         _deltaTimeCallbackHandle = global::timeManager.addDeltaTimeChangeCallback(
@@ -90,16 +91,16 @@ void TimeTopic::handleJson(const nlohmann::json& json) {
                 std::chrono::system_clock::time_point now =
                     std::chrono::system_clock::now();
                 if (now - _lastUpdateTime > TimeUpdateInterval) {
-                    _connection->sendJson(deltaTime());
+                    sendDeltaTime();
                     if (_timeCallbackHandle != UnsetOnChangeHandle) {
-                        _connection->sendJson(currentTime());
+                        sendCurrentTime();
                         _lastUpdateTime = std::chrono::system_clock::now();
                     }
                     _lastUpdateTime = now;
                 }
             }
         );
-        _connection->sendJson(deltaTime());
+        sendDeltaTime();
     }
     else {
         LWARNING("Cannot get " + requestedKey);
@@ -107,6 +108,47 @@ void TimeTopic::handleJson(const nlohmann::json& json) {
     }
 }
 
+void TimeTopic::sendCurrentTime() {
+    if (_connection->encoding() != Connection::Encoding::MessagePack) {
+        _connection->sendJson(currentTime());
+        return;
+    }
+
+    char buffer[DateBufferSize];
+    std::string message;
+    MessagePackWriter writer(message);
+    writer.writeMap(2);
+    writer.writeString("topic");
+    writer.writeInteger(static_cast<int64_t>(_topicId));
+    writer.writeString("payload");
+    writer.writeMap(1);
+    writer.writeString("time");
+    writer.writeString(global::timeManager.time().ISO8601(buffer));
+    _connection->sendMessage(std::move(message));
+}
+
+void TimeTopic::sendDeltaTime() {
+    if (_connection->encoding() != Connection::Encoding::MessagePack) {
+        _connection->sendJson(deltaTime());
+        return;
+    }
+
+    std::string message;
+    MessagePackWriter writer(message);
+    writer.writeMap(2);
+    writer.writeString("topic");
+    writer.writeInteger(static_cast<int64_t>(_topicId));
+    writer.writeString("payload");
+    writer.writeMap(3);
+    writer.writeString("deltaTime");
+    writer.writeDouble(global::timeManager.deltaTime());
+    writer.writeString("targetDeltaTime");
+    writer.writeDouble(global::timeManager.targetDeltaTime());
+    writer.writeString("isPaused");
+    writer.writeBool(global::timeManager.isPaused());
+    _connection->sendMessage(std::move(message));
+}
+
 json TimeTopic::currentTime() {
     json timeJson = { { "time", global::timeManager.time().ISO8601() } };
     return wrappedPayload(timeJson);
@@ -26,6 +26,7 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
@@ -37,6 +38,7 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <fstream>
@@ -788,79 +790,40 @@ void RenderableStars::loadData() {
 
 void RenderableStars::readSpeckFile() {
     std::string _file = _speckFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _file));
+    speck::Dataset dataset;
+    if (!speck::loadSpeckFile(_file, dataset, &global::taskScheduler)) {
         return;
     }
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty()) {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> _nValuesPerStar;
-
-            std::string name;
-            str >> name;
-
-            _dataNames.push_back(name);
-            _nValuesPerStar += 1; // We want the number, but the index is 0 based
-        }
+    for (const speck::Variable& variable : dataset.variables) {
+        _dataNames.push_back(variable.name);
     }
-
     _otherDataOption.clearOptions();
     _otherDataOption.addOptions(_dataNames);
 
-    _nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
-
-    do {
-        std::vector<float> values(_nValuesPerStar);
-
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerStar; ++i) {
-            str >> values[i];
-        }
-        bool nullArray = true;
-        for (float v : values) {
-            if (v != 0.0) {
-                nullArray = false;
-                break;
-            }
+    _nValuesPerStar = dataset.valuesPerEntry;
+
+    // Stars whose values are all 0 are removed by moving the remaining ones to the front
+    std::vector<float>& values = dataset.values;
+    const size_t n = static_cast<size_t>(_nValuesPerStar);
+    size_t nStars = 0;
+    for (size_t i = 0; i < values.size(); i += n) {
+        const auto begin = values.begin() + i;
+        const bool isNull = std::all_of(
+            begin,
+            begin + n,
+            [](float v) { return v == 0.f; }
+        );
+        if (isNull) {
+            continue;
         }
-        if (!nullArray) {
-            _fullData.insert(_fullData.end(), values.begin(), values.end());
+        if (nStars * n != i) {
+            std::copy(begin, begin + n, values.begin() + nStars * n);
         }
-    } while (!file.eof());
+        ++nStars;
+    }
+    values.resize(nStars * n);
+    _fullData = std::move(values);
 }
 
 bool RenderableStars::loadCachedFile(const std::string& file) {
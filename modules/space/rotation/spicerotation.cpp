@@ -24,8 +24,11 @@
 
 #include <modules/space/rotation/spicerotation.h>
 
+#include <modules/space/spacemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
@@ -116,11 +119,23 @@ SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
     addProperty(_sourceFrame);
     addProperty(_destinationFrame);
 
-    _sourceFrame.onChange([this]() { requireUpdate(); });
-    _destinationFrame.onChange([this]() { requireUpdate(); });
+    _sourceFrame.onChange([this]() {
+        updateSeries();
+        requireUpdate();
+    });
+    _destinationFrame.onChange([this]() {
+        updateSeries();
+        requireUpdate();
+    });
+
+    updateSeries();
 }
 
 glm::dmat3 SpiceRotation::matrix(const UpdateData& data) const {
+    if (_series) {
+        return _series->rotation(data.time.j2000Seconds());
+    }
+
     return SpiceManager::ref().positionTransformMatrix(
         _sourceFrame,
         _destinationFrame,
@@ -128,4 +143,9 @@ glm::dmat3 SpiceRotation::matrix(const UpdateData& data) const {
     );
 }
 
+void SpiceRotation::updateSeries() {
+    EphemerisCache* cache = global::moduleEngine.module<SpaceModule>()->ephemerisCache();
+    _series = cache ? cache->rotationSeries(_sourceFrame, _destinationFrame) : nullptr;
+}
+
 } // namespace openspace
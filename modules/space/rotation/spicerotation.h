@@ -27,6 +27,7 @@
 
 #include <openspace/scene/rotation.h>
 
+#include <modules/space/util/ephemeriscache.h>
 #include <openspace/properties/stringproperty.h>
 
 namespace openspace {
@@ -43,8 +44,13 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    void updateSeries();
+
     properties::StringProperty _sourceFrame;
     properties::StringProperty _destinationFrame;
+
+    /// The cached rotations between the current frames, may be nullptr
+    std::shared_ptr<EphemerisCache::Series> _series;
 };
 
 } // namespace openspace
@@ -49,6 +49,14 @@ namespace {
         "If enabled, errors from SPICE will be thrown and show up in the log. If "
         "disabled, the errors will be ignored silently."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo EphemerisCacheInfo = {
+        "UseEphemerisCache",
+        "Use Ephemeris Cache",
+        "If enabled, the positions and rotations of SpiceTranslations and SpiceRotations "
+        "are interpolated from polynomials that are fitted to SPICE in the background. "
+        "If disabled, SPICE is queried directly every frame."
+    };
 } // namespace
 
 namespace openspace {
@@ -58,14 +66,25 @@ ghoul::opengl::ProgramObjectManager SpaceModule::ProgramObjectManager;
 SpaceModule::SpaceModule()
     : OpenSpaceModule(Name)
     , _showSpiceExceptions(SpiceExceptionInfo, true)
+    , _useEphemerisCache(EphemerisCacheInfo, true)
 {
     _showSpiceExceptions.onChange([&t = _showSpiceExceptions](){
         SpiceManager::ref().setExceptionHandling(SpiceManager::UseException(t));
     });
     addProperty(_showSpiceExceptions);
+
+    _useEphemerisCache.onChange([this]() {
+        if (_ephemerisCache) {
+            _ephemerisCache->setEnabled(_useEphemerisCache);
+        }
+    });
+    addProperty(_useEphemerisCache);
 }
 
 void SpaceModule::internalInitialize(const ghoul::Dictionary&) {
+    _ephemerisCache = std::make_unique<EphemerisCache>();
+    _ephemerisCache->setEnabled(_useEphemerisCache);
+
     FactoryManager::ref().addFactory(
         std::make_unique<ghoul::TemplateFactory<planetgeometry::PlanetGeometry>>(),
         "PlanetGeometry"
@@ -99,10 +118,19 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary&) {
     fGeometry->registerClass<planetgeometry::SimpleSphereGeometry>("SimpleSphere");
 }
 
+void SpaceModule::internalDeinitialize() {
+    // Waits for the background refills, which need the SpiceManager
+    _ephemerisCache = nullptr;
+}
+
 void SpaceModule::internalDeinitializeGL() {
     ProgramObjectManager.releaseAll(ghoul::opengl::ProgramObjectManager::Warnings::Yes);
 }
 
+EphemerisCache* SpaceModule::ephemerisCache() {
+    return _ephemerisCache.get();
+}
+
 std::vector<documentation::Documentation> SpaceModule::documentations() const {
     return {
         RenderableConstellationBounds::Documentation(),
@@ -27,6 +27,7 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/space/util/ephemeriscache.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <ghoul/opengl/programobjectmanager.h>
 
@@ -40,13 +41,21 @@ public:
     virtual ~SpaceModule() = default;
     std::vector<documentation::Documentation> documentations() const override;
 
+    /// Returns the cache for SPICE positions and rotations, or nullptr if the module is
+    /// not initialized
+    EphemerisCache* ephemerisCache();
+
     static ghoul::opengl::ProgramObjectManager ProgramObjectManager;
 
 private:
     void internalInitialize(const ghoul::Dictionary&) override;
+    void internalDeinitialize() override;
     void internalDeinitializeGL() override;
 
     properties::BoolProperty _showSpiceExceptions;
+    properties::BoolProperty _useEphemerisCache;
+
+    std::unique_ptr<EphemerisCache> _ephemerisCache;
 };
 
 } // namespace openspace
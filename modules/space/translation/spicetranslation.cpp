@@ -24,8 +24,11 @@
 
 #include <modules/space/translation/spicetranslation.h>
 
+#include <modules/space/spacemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
@@ -157,6 +160,7 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     }
 
     auto update = [this](){
+        updateSeries();
         requireUpdate();
         notifyObservers();
     };
@@ -169,9 +173,15 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
 
     _frame.onChange(update);
     addProperty(_frame);
+
+    updateSeries();
 }
 
 glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
+    if (_series) {
+        return _series->position(data.time.j2000Seconds()) * glm::pow(10.0, 3.0);
+    }
+
     double lightTime = 0.0;
     return SpiceManager::ref().targetPosition(
         _target,
@@ -183,4 +193,9 @@ glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
     ) * glm::pow(10.0, 3.0);
 }
 
+void SpiceTranslation::updateSeries() {
+    EphemerisCache* cache = global::moduleEngine.module<SpaceModule>()->ephemerisCache();
+    _series = cache ? cache->positionSeries(_target, _observer, _frame) : nullptr;
+}
+
 } // namespace openspace
@@ -27,6 +27,7 @@
 
 #include <openspace/scene/translation.h>
 
+#include <modules/space/util/ephemeriscache.h>
 #include <openspace/properties/stringproperty.h>
 
 namespace openspace {
@@ -40,10 +41,15 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    void updateSeries();
+
     properties::StringProperty _target;
     properties::StringProperty _observer;
     properties::StringProperty _frame;
 
+    /// The cached positions for the current target, observer, and frame, may be nullptr
+    std::shared_ptr<EphemerisCache::Series> _series;
+
     glm::dvec3 _position;
 };
 
@@ -0,0 +1,430 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/util/ephemeriscache.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/util/spicemanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // Number of SPICE samples per window, which is one more than the polynomial degree
+    constexpr const int NumberOfNodes = 16;
+
+    // Number of additional SPICE samples per window that are used to verify the fit
+    constexpr const int NumberOfChecks = 4;
+
+    // The maximum number of windows that are kept per series
+    constexpr const size_t MaxWindows = 4;
+
+    // Window lengths in seconds. A window that cannot be fitted at the minimum length is
+    // forwarded to the SpiceManager
+    constexpr const double MinimumWindowLength = 1.0;
+    constexpr const double MaximumWindowLength = 8.0 * 24.0 * 60.0 * 60.0;
+    constexpr const double InitialWindowLength = 24.0 * 60.0 * 60.0;
+
+    // The window length is doubled after this many consecutive windows could be fitted
+    // on the first attempt
+    constexpr const int SuccessfulFitsBeforeGrowing = 4;
+
+    // Maximum absolute error of the fitted positions in km and rotation matrix elements
+    constexpr const double PositionTolerance = 1e-5;
+    constexpr const double RotationTolerance = 1e-11;
+
+    std::string seriesKey(const std::vector<std::string>& names) {
+        std::string key;
+        for (const std::string& name : names) {
+            key += name;
+            key += '|';
+        }
+        return key;
+    }
+} // namespace
+
+namespace openspace {
+
+EphemerisCache::EphemerisCache() : _refills(global::taskScheduler) {}
+
+EphemerisCache::~EphemerisCache() {
+    {
+        std::lock_guard lock(_seriesMutex);
+        for (const std::pair<const std::string, std::weak_ptr<Series>>& p : _series) {
+            std::shared_ptr<Series> s = p.second.lock();
+            if (s) {
+                std::lock_guard seriesLock(s->_mutex);
+                s->_cache = nullptr;
+            }
+        }
+        _series.clear();
+    }
+    _refills.wait();
+}
+
+std::shared_ptr<EphemerisCache::Series> EphemerisCache::positionSeries(
+                                                               const std::string& target,
+                                                             const std::string& observer,
+                                                                const std::string& frame)
+{
+    return series(SeriesType::Position, { target, observer, frame });
+}
+
+std::shared_ptr<EphemerisCache::Series> EphemerisCache::rotationSeries(
+                                                          const std::string& sourceFrame,
+                                                     const std::string& destinationFrame)
+{
+    return series(SeriesType::Rotation, { sourceFrame, destinationFrame });
+}
+
+void EphemerisCache::setEnabled(bool enabled) {
+    _isEnabled = enabled;
+}
+
+bool EphemerisCache::isEnabled() const {
+    return _isEnabled;
+}
+
+std::shared_ptr<EphemerisCache::Series> EphemerisCache::series(SeriesType type,
+                                                           std::vector<std::string> names)
+{
+    const std::string key = std::to_string(static_cast<int>(type)) + '|' +
+                            seriesKey(names);
+
+    std::lock_guard lock(_seriesMutex);
+    std::weak_ptr<Series>& entry = _series[key];
+    std::shared_ptr<Series> s = entry.lock();
+    if (!s) {
+        s = std::make_shared<Series>(*this, type, std::move(names));
+        entry = s;
+    }
+
+    // Remove the entries of series that are no longer used by anyone
+    for (auto it = _series.begin(); it != _series.end();) {
+        if (it->second.expired()) {
+            it = _series.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return s;
+}
+
+void EphemerisCache::scheduleRefill(std::shared_ptr<Series> series, double time) {
+    _refills.run(
+        [s = std::move(series), time]() { s->refill(time); },
+        TaskScheduler::Priority::Low
+    );
+}
+
+EphemerisCache::Series::Series(EphemerisCache& cache, SeriesType type,
+                               std::vector<std::string> names)
+    : _type(type)
+    , _names(std::move(names))
+    , _nComponents(type == SeriesType::Position ? 3 : 9)
+    , _cache(&cache)
+    , _windowLength(InitialWindowLength)
+{
+    ghoul_assert(
+        _names.size() == (type == SeriesType::Position ? 3 : 2),
+        "Wrong number of names"
+    );
+}
+
+glm::dvec3 EphemerisCache::Series::position(double time) {
+    ghoul_assert(_type == SeriesType::Position, "Series does not contain positions");
+
+    glm::dvec3 result;
+    evaluate(time, glm::value_ptr(result));
+    return result;
+}
+
+glm::dmat3 EphemerisCache::Series::rotation(double time) {
+    ghoul_assert(_type == SeriesType::Rotation, "Series does not contain rotations");
+
+    glm::dmat3 result;
+    evaluate(time, glm::value_ptr(result));
+    return result;
+}
+
+void EphemerisCache::Series::evaluate(double time, double* result) {
+    const unsigned int generation = SpiceManager::ref().kernelGeneration();
+    {
+        std::lock_guard lock(_mutex);
+        if (_cache && _cache->isEnabled()) {
+            const auto it = std::find_if(
+                _windows.begin(),
+                _windows.end(),
+                [time, generation](const Window& w) {
+                    return w.generation == generation && time >= w.start && time < w.end;
+                }
+            );
+
+            if (it == _windows.end()) {
+                requestWindow(time, generation);
+            }
+            else if (!it->coefficients.empty()) {
+                evaluate(*it, time, result);
+
+                // Prepare the adjacent window in the direction that we are approaching
+                if (time >= 0.5 * (it->start + it->end)) {
+                    requestWindow(it->end, generation);
+                }
+                else {
+                    requestWindow(
+                        std::nextafter(it->start, -std::numeric_limits<double>::max()),
+                        generation
+                    );
+                }
+                return;
+            }
+        }
+    }
+
+    sample(time, result);
+}
+
+void EphemerisCache::Series::evaluate(const Window& window, double time,
+                                      double* result) const
+{
+    // Clenshaw recurrence for the Chebyshev series of every component
+    const double x = (2.0 * time - window.start - window.end) /
+                     (window.end - window.start);
+    for (int c = 0; c < _nComponents; ++c) {
+        const double* coefficients = window.coefficients.data() + c * NumberOfNodes;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        for (int j = NumberOfNodes - 1; j > 0; --j) {
+            const double b0 = 2.0 * x * b1 - b2 + coefficients[j];
+            b2 = b1;
+            b1 = b0;
+        }
+        result[c] = x * b1 - b2 + coefficients[0];
+    }
+}
+
+void EphemerisCache::Series::sample(double time, double* result) const {
+    if (_type == SeriesType::Position) {
+        double lightTime = 0.0;
+        const glm::dvec3 position = SpiceManager::ref().targetPosition(
+            _names[0],
+            _names[1],
+            _names[2],
+            {},
+            time,
+            lightTime
+        );
+        std::copy_n(glm::value_ptr(position), 3, result);
+    }
+    else {
+        const glm::dmat3 rotation = SpiceManager::ref().positionTransformMatrix(
+            _names[0],
+            _names[1],
+            time
+        );
+        std::copy_n(glm::value_ptr(rotation), 9, result);
+    }
+}
+
+void EphemerisCache::Series::sample(const std::vector<double>& times,
+                                    double* result) const
+{
+    // Query all times in one batch so that the refills of different series do not have
+    // to compete for CSPICE for every single sample
+    if (_type == SeriesType::Position) {
+        const std::vector<glm::dvec3> positions = SpiceManager::ref().targetPositions(
+            _names[0],
+            _names[1],
+            _names[2],
+            {},
+            times
+        );
+        for (size_t i = 0; i < positions.size(); ++i) {
+            std::copy_n(glm::value_ptr(positions[i]), 3, result + 3 * i);
+        }
+    }
+    else {
+        const std::vector<glm::dmat3> rotations =
+            SpiceManager::ref().positionTransformMatrices(_names[0], _names[1], times);
+        for (size_t i = 0; i < rotations.size(); ++i) {
+            std::copy_n(glm::value_ptr(rotations[i]), 9, result + 9 * i);
+        }
+    }
+}
+
+bool EphemerisCache::Series::fit(Window& window) const {
+    const double center = 0.5 * (window.start + window.end);
+    const double halfLength = 0.5 * (window.end - window.start);
+
+    // Sample at the Chebyshev nodes and compute the coefficients by the discrete
+    // Chebyshev transform
+    std::vector<double> nodeTimes(NumberOfNodes);
+    for (int k = 0; k < NumberOfNodes; ++k) {
+        const double x = std::cos(glm::pi<double>() * (k + 0.5) / NumberOfNodes);
+        nodeTimes[k] = center + halfLength * x;
+    }
+    std::array<double, NumberOfNodes * MaxComponents> samples;
+    sample(nodeTimes, samples.data());
+
+    window.coefficients.assign(static_cast<size_t>(_nComponents) * NumberOfNodes, 0.0);
+    for (int j = 0; j < NumberOfNodes; ++j) {
+        for (int k = 0; k < NumberOfNodes; ++k) {
+            const double w = std::cos(glm::pi<double>() * j * (k + 0.5) / NumberOfNodes);
+            for (int c = 0; c < _nComponents; ++c) {
+                window.coefficients[c * NumberOfNodes + j] +=
+                    w * samples[k * _nComponents + c];
+            }
+        }
+    }
+    for (int c = 0; c < _nComponents; ++c) {
+        for (int j = 0; j < NumberOfNodes; ++j) {
+            const double scale = (j == 0) ? 1.0 : 2.0;
+            window.coefficients[c * NumberOfNodes + j] *= scale / NumberOfNodes;
+        }
+    }
+
+    // Verify the fit between the nodes
+    const double tolerance =
+        (_type == SeriesType::Position) ? PositionTolerance : RotationTolerance;
+    std::vector<double> checkTimes(NumberOfChecks);
+    for (int i = 0; i < NumberOfChecks; ++i) {
+        checkTimes[i] = window.start +
+                        (window.end - window.start) * (i + 0.5) / NumberOfChecks;
+    }
+    std::array<double, NumberOfChecks * MaxComponents> expected;
+    sample(checkTimes, expected.data());
+    for (int i = 0; i < NumberOfChecks; ++i) {
+        std::array<double, MaxComponents> fitted;
+        evaluate(window, checkTimes[i], fitted.data());
+        for (int c = 0; c < _nComponents; ++c) {
+            if (std::abs(expected[i * _nComponents + c] - fitted[c]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void EphemerisCache::Series::refill(double time) {
+    Window window;
+    window.generation = SpiceManager::ref().kernelGeneration();
+
+    double length = 0.0;
+    {
+        std::lock_guard lock(_mutex);
+        length = _windowLength;
+    }
+
+    bool isFitted = false;
+    bool isFirstAttempt = true;
+    while (true) {
+        window.start = std::floor(time / length) * length;
+        window.end = window.start + length;
+        try {
+            isFitted = fit(window);
+        }
+        catch (const SpiceManager::SpiceException&) {
+            // SPICE cannot answer queries in this window, so all queries are forwarded
+            // to the SpiceManager which will report the error
+            break;
+        }
+        if (isFitted || length * 0.5 < MinimumWindowLength) {
+            break;
+        }
+        length *= 0.5;
+        isFirstAttempt = false;
+    }
+    if (!isFitted) {
+        window.coefficients.clear();
+    }
+
+    std::lock_guard lock(_mutex);
+    _isRefilling = false;
+    if (window.generation != SpiceManager::ref().kernelGeneration()) {
+        // The kernel pool changed while we were sampling
+        return;
+    }
+
+    if (isFitted) {
+        if (isFirstAttempt) {
+            _nSuccessfulFits++;
+            if (_nSuccessfulFits >= SuccessfulFitsBeforeGrowing) {
+                length = std::min(length * 2.0, MaximumWindowLength);
+                _nSuccessfulFits = 0;
+            }
+        }
+        else {
+            _nSuccessfulFits = 0;
+        }
+        _windowLength = length;
+    }
+
+    // Remove outdated windows and make room for the new window by removing the one that
+    // is the farthest away from it
+    _windows.erase(
+        std::remove_if(
+            _windows.begin(),
+            _windows.end(),
+            [generation = window.generation](const Window& w) {
+                return w.generation != generation;
+            }
+        ),
+        _windows.end()
+    );
+    if (_windows.size() >= MaxWindows) {
+        auto distance = [time](const Window& w) {
+            return std::abs(0.5 * (w.start + w.end) - time);
+        };
+        _windows.erase(std::max_element(
+            _windows.begin(),
+            _windows.end(),
+            [&distance](const Window& lhs, const Window& rhs) {
+                return distance(lhs) < distance(rhs);
+            }
+        ));
+    }
+    _windows.push_back(std::move(window));
+}
+
+void EphemerisCache::Series::requestWindow(double time, unsigned int generation) {
+    if (_isRefilling || !_cache) {
+        return;
+    }
+
+    const bool hasWindow = std::any_of(
+        _windows.begin(),
+        _windows.end(),
+        [time, generation](const Window& w) {
+            return w.generation == generation && time >= w.start && time < w.end;
+        }
+    );
+    if (!hasWindow) {
+        _isRefilling = true;
+        _cache->scheduleRefill(shared_from_this(), time);
+    }
+}
+
+} // namespace openspace
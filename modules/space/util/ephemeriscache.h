@@ -0,0 +1,167 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___EPHEMERISCACHE___H__
+#define __OPENSPACE_MODULE_SPACE___EPHEMERISCACHE___H__
+
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/glm.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The EphemerisCache answers SPICE position and rotation queries from piecewise Chebyshev
+ * polynomials instead of querying the SpiceManager every frame. Every distinct query
+ * (target, observer, and frame for positions; source and destination frame for
+ * rotations) is represented by a Series, which is shared between all users of the same
+ * query. A Series samples SPICE at the Chebyshev nodes of a window of time and fits one
+ * polynomial per component. The fit is verified against additional SPICE samples and the
+ * window is halved until the fit is within the tolerance, so that windows adapt to
+ * quickly changing ephemerides such as spacecraft flybys.
+ *
+ * Windows are sampled by the global TaskScheduler. When a query falls into the second
+ * half of a window, the adjacent window in that direction is fitted in the background so
+ * that it is available by the time it is needed. Queries for which no window is
+ * available yet are answered by the SpiceManager directly, which also applies to queries
+ * that SPICE cannot answer at all, so that all errors surface exactly as they would
+ * without the cache. All windows are invalidated whenever a kernel is loaded or
+ * unloaded.
+ */
+class EphemerisCache {
+public:
+    class Series;
+
+    enum class SeriesType {
+        Position = 0,
+        Rotation
+    };
+
+    EphemerisCache();
+
+    /// Waits for all background refills to finish and detaches all Series
+    ~EphemerisCache();
+
+    /**
+     * Returns the Series for the position of \p target relative to \p observer in the
+     * \p frame in kilometers, without any aberration correction.
+     */
+    std::shared_ptr<Series> positionSeries(const std::string& target,
+        const std::string& observer, const std::string& frame);
+
+    /**
+     * Returns the Series for the rotation matrix that transforms positions from the
+     * \p sourceFrame into the \p destinationFrame.
+     */
+    std::shared_ptr<Series> rotationSeries(const std::string& sourceFrame,
+        const std::string& destinationFrame);
+
+    /**
+     * Enables or disables the cache. While disabled, all Series forward all queries to
+     * the SpiceManager.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+private:
+    friend class Series;
+
+    std::shared_ptr<Series> series(SeriesType type, std::vector<std::string> names);
+
+    /// Fits the window that contains \p time for the \p series on a worker thread
+    void scheduleRefill(std::shared_ptr<Series> series, double time);
+
+    std::mutex _seriesMutex;
+    std::map<std::string, std::weak_ptr<Series>> _series;
+
+    std::atomic_bool _isEnabled = true;
+    TaskGroup _refills;
+};
+
+/**
+ * A single query that is answered by the EphemerisCache. All methods are thread-safe.
+ */
+class EphemerisCache::Series : public std::enable_shared_from_this<Series> {
+public:
+    Series(EphemerisCache& cache, SeriesType type, std::vector<std::string> names);
+
+    /// Returns the position in kilometers at the ephemeris \p time
+    glm::dvec3 position(double time);
+
+    /// Returns the rotation matrix at the ephemeris \p time
+    glm::dmat3 rotation(double time);
+
+private:
+    friend class EphemerisCache;
+
+    static constexpr const int MaxComponents = 9;
+
+    struct Window {
+        double start = 0.0;
+        double end = 0.0;
+        /// The generation of the kernel pool that the window was sampled from
+        unsigned int generation = 0;
+        /// The Chebyshev coefficients of all components after each other. If empty, the
+        /// window could not be fitted and all queries are forwarded to the SpiceManager
+        std::vector<double> coefficients;
+    };
+
+    void evaluate(double time, double* result);
+    void evaluate(const Window& window, double time, double* result) const;
+
+    /// Queries the SpiceManager directly
+    void sample(double time, double* result) const;
+    void sample(const std::vector<double>& times, double* result) const;
+
+    /// Returns whether the \p window could be fitted within the tolerance
+    bool fit(Window& window) const;
+
+    /// Fits the window that contains \p time, called from a worker thread
+    void refill(double time);
+
+    /// Requests a refill if no valid window contains \p time. Requires a locked _mutex
+    void requestWindow(double time, unsigned int generation);
+
+    const SeriesType _type;
+    const std::vector<std::string> _names;
+    const int _nComponents;
+
+    std::mutex _mutex;
+    /// The cache that schedules refills, or nullptr after it has been destroyed
+    EphemerisCache* _cache;
+    std::vector<Window> _windows;
+    double _windowLength;
+    int _nSuccessfulFits = 0;
+    bool _isRefilling = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___EPHEMERISCACHE___H__
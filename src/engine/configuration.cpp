@@ -65,6 +65,7 @@ namespace {
     constexpr const char* KeyDisableRenderingOnMaster = "DisableRenderingOnMaster";
     constexpr const char* KeyDisableSceneOnMaster = "DisableSceneOnMaster";
     constexpr const char* KeyDisableInGameConsole = "DisableInGameConsole";
+    constexpr const char* KeyCompressSyncData = "CompressSyncData";
     constexpr const char* KeyScreenshotUseDate = "ScreenshotUseDate";
     constexpr const char* KeyHttpProxy = "HttpProxy";
     constexpr const char* KeyAddress = "Address";
@@ -290,6 +291,7 @@ void parseLuaState(Configuration& configuration) {
     getValue(s, KeyDisableRenderingOnMaster, c.isRenderingOnMasterDisabled);
     getValue(s, KeyDisableSceneOnMaster, c.isSceneTranslationOnMasterDisabled);
     getValue(s, KeyDisableInGameConsole, c.isConsoleDisabled);
+    getValue(s, KeyCompressSyncData, c.isSyncCompressionEnabled);
     getValue(s, KeyRenderingMethod, c.renderingMethod);
 
     getValue(s, KeyLogging, c.logging);
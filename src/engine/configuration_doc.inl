@@ -266,6 +266,15 @@ documentation::Documentation Configuration::Documentation = {
             "interaction and it is thus desired to disable the transformation. The "
             "default is false."
         },
+        {
+            KeyCompressSyncData,
+            new BoolVerifier,
+            Optional::Yes,
+            "If this value is set to 'true', the data that is synchronized from the "
+            "master to the other nodes of a cluster every frame is compressed. This "
+            "trades some processing time for less network bandwidth. The default is "
+            "false."
+        },
         {
             KeyScreenshotUseDate,
             new BoolVerifier,
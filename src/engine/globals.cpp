@@ -40,6 +40,7 @@
 #include <openspace/network/networkengine.h>
 #include <openspace/network/parallelpeer.h>
 #include <openspace/performance/performancemanager.h>
+#include <openspace/properties/propertyindex.h>
 #include <openspace/properties/propertyowner.h>
 #include <openspace/rendering/dashboard.h>
 #include <openspace/rendering/deferredcastermanager.h>
@@ -49,6 +50,7 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/scriptscheduler.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/glm.h>
 #include <ghoul/font/fontmanager.h>
@@ -129,6 +131,11 @@ SyncEngine& gSyncEngine() {
     return g;
 }
 
+TaskScheduler& gTaskScheduler() {
+    static TaskScheduler g;
+    return g;
+}
+
 TimeManager& gTimeManager() {
     static TimeManager g;
     return g;
@@ -180,6 +187,11 @@ performance::PerformanceManager& gPerformanceManager() {
     return g;
 }
 
+properties::PropertyIndex& gPropertyIndex() {
+    static properties::PropertyIndex g;
+    return g;
+}
+
 properties::PropertyOwner& gRootPropertyOwner() {
     static properties::PropertyOwner g({ "" });
     return g;
@@ -203,6 +215,8 @@ scripting::ScriptScheduler& gScriptScheduler() {
 } // namespace detail
 
 void initialize() {
+    global::rootPropertyOwner.setPropertyIndex(&global::propertyIndex);
+
     global::rootPropertyOwner.addPropertySubOwner(global::moduleEngine);
 
     global::navigationHandler.setPropertyOwner(&global::rootPropertyOwner);
@@ -319,6 +319,9 @@ void OpenSpaceEngine::initialize() {
     writeStaticDocumentation();
 
     _shutdown.waitTime = global::configuration.shutdownCountdown;
+    global::syncEngine.setCompressionEnabled(
+        global::configuration.isSyncCompressionEnabled
+    );
 
     global::navigationHandler.initialize();
 
@@ -636,9 +639,9 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
 
     std::unique_ptr<SceneInitializer> sceneInitializer;
     if (global::configuration.useMultithreadedInitialization) {
-        unsigned int nAvailableThreads = std::thread::hardware_concurrency();
-        unsigned int nThreads = nAvailableThreads == 0 ? 2 : nAvailableThreads - 1;
-        sceneInitializer = std::make_unique<MultiThreadedSceneInitializer>(nThreads);
+        sceneInitializer = std::make_unique<MultiThreadedSceneInitializer>(
+            global::taskScheduler
+        );
     } else {
         sceneInitializer = std::make_unique<SingleThreadedSceneInitializer>();
     }
@@ -25,8 +25,51 @@
 #include <openspace/engine/syncengine.h>
 
 #include <openspace/util/syncdata.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
+#include <lz4.h>
 #include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr const char* _loggerCat = "SyncEngine";
+
+    // A frame consists of a header followed by the records of all changed Syncables,
+    // which are LZ4 compressed if the FlagCompressed is set:
+    //   uint8_t  flags
+    //   uint32_t number of Syncables
+    //   uint32_t size of the uncompressed records (only if compressed)
+    //   records: { uint32_t index, uint32_t size, char[size] data }
+    constexpr const uint8_t FlagKeyframe = 1 << 0;
+    constexpr const uint8_t FlagCompressed = 1 << 1;
+    constexpr const size_t HeaderSize = sizeof(uint8_t) + sizeof(uint32_t);
+
+    // A full state is sent periodically, so that a slave that missed a keyframe, for
+    // example as it registered its Syncables later than the master, recovers
+    constexpr const unsigned int KeyframeInterval = 120;
+
+    // Smaller payloads are not worth compressing
+    constexpr const size_t MinimumCompressionSize = 256;
+
+    // LZ4 cannot compress data by more than this factor, so a frame that claims a larger
+    // uncompressed size is malformed
+    constexpr const size_t MaximumCompressionRatio = 255;
+
+    template <typename T>
+    void append(std::vector<char>& buffer, const T& value) {
+        const size_t offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T read(const char* data) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+} // namespace
 
 namespace openspace {
 
@@ -38,28 +81,145 @@ SyncEngine::SyncEngine(unsigned int syncBufferSize)
 
 // should be called on sgct master
 std::vector<char> SyncEngine::encodeSyncables() {
-    for (Syncable* syncable : _syncables) {
-        syncable->encode(&_syncBuffer);
+    if (_records.size() != _syncables.size()) {
+        _records.resize(_syncables.size());
+        _needsKeyframe = true;
     }
+    if (++_nFramesSinceKeyframe >= KeyframeInterval) {
+        _needsKeyframe = true;
+    }
+
+    _payload.clear();
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        const size_t begin = _syncBuffer.encodedSize();
+        _syncables[i]->encode(&_syncBuffer);
+        const char* data = _syncBuffer.encodedData() + begin;
+        const size_t size = _syncBuffer.encodedSize() - begin;
 
-    std::vector<char> data = _syncBuffer.data();
+        std::vector<char>& record = _records[i];
+        const bool hasChanged = size != record.size() ||
+                                (size > 0 && std::memcmp(data, record.data(), size) != 0);
+        if (hasChanged || _needsKeyframe) {
+            record.assign(data, data + size);
+            append(_payload, static_cast<uint32_t>(i));
+            append(_payload, static_cast<uint32_t>(size));
+            _payload.insert(_payload.end(), data, data + size);
+        }
+    }
     _syncBuffer.reset();
-    return data;
-
-    //_dataStream.resize(_encodeOffset);
-    //_synchronizationBuffer->setVal(_dataStream);
-    //sgct::SharedData::instance()->writeVector(_synchronizationBuffer.get());
-    //_dataStream.resize(_n);
-    //_encodeOffset = 0;
-    //_decodeOffset = 0;
-    //_syncBuffer.write();
+
+    uint8_t flags = _needsKeyframe ? FlagKeyframe : 0;
+    if (_needsKeyframe) {
+        _nFramesSinceKeyframe = 0;
+        _needsKeyframe = false;
+    }
+
+    std::vector<char> frame;
+    if (_isCompressionEnabled && _payload.size() >= MinimumCompressionSize) {
+        const int bound = LZ4_compressBound(static_cast<int>(_payload.size()));
+        frame.resize(HeaderSize + sizeof(uint32_t) + bound);
+        const int compressedSize = LZ4_compress_default(
+            _payload.data(),
+            frame.data() + HeaderSize + sizeof(uint32_t),
+            static_cast<int>(_payload.size()),
+            bound
+        );
+        if (compressedSize > 0 && static_cast<size_t>(compressedSize) < _payload.size()) {
+            flags |= FlagCompressed;
+            frame.resize(HeaderSize + sizeof(uint32_t) + compressedSize);
+            const uint32_t nSyncables = static_cast<uint32_t>(_syncables.size());
+            const uint32_t payloadSize = static_cast<uint32_t>(_payload.size());
+            std::memcpy(frame.data(), &flags, sizeof(uint8_t));
+            std::memcpy(frame.data() + sizeof(uint8_t), &nSyncables, sizeof(uint32_t));
+            std::memcpy(frame.data() + HeaderSize, &payloadSize, sizeof(uint32_t));
+            return frame;
+        }
+        // Incompressible data is sent as is
+        frame.clear();
+    }
+
+    frame.reserve(HeaderSize + _payload.size());
+    append(frame, flags);
+    append(frame, static_cast<uint32_t>(_syncables.size()));
+    frame.insert(frame.end(), _payload.begin(), _payload.end());
+    return frame;
 }
 
 //should be called on sgct slaves
 void SyncEngine::decodeSyncables(std::vector<char> data) {
-    _syncBuffer.setData(std::move(data));
-    for (Syncable* syncable : _syncables) {
-        syncable->decode(&_syncBuffer);
+    if (data.size() < HeaderSize) {
+        LERROR(fmt::format("Received incomplete frame of {} bytes", data.size()));
+        return;
+    }
+    const uint8_t flags = read<uint8_t>(data.data());
+    const uint32_t nSyncables = read<uint32_t>(data.data() + sizeof(uint8_t));
+    if (nSyncables != _syncables.size()) {
+        LERROR(fmt::format(
+            "Received frame for {} Syncables, but {} are registered",
+            nSyncables, _syncables.size()
+        ));
+        return;
+    }
+    if (_needsKeyframe && !(flags & FlagKeyframe)) {
+        // Deltas can only be applied once the full state has been received
+        LWARNING("Discarding frame while waiting for a keyframe");
+        return;
+    }
+
+    const char* payload = data.data() + HeaderSize;
+    size_t payloadSize = data.size() - HeaderSize;
+    if (flags & FlagCompressed) {
+        if (payloadSize < sizeof(uint32_t)) {
+            LERROR("Received incomplete compressed frame");
+            return;
+        }
+        const uint32_t uncompressedSize = read<uint32_t>(payload);
+        const size_t compressedSize = payloadSize - sizeof(uint32_t);
+        if (uncompressedSize > LZ4_MAX_INPUT_SIZE ||
+            uncompressedSize > compressedSize * MaximumCompressionRatio)
+        {
+            // Checked before the buffer is resized, as the size comes from the network
+            LERROR(fmt::format(
+                "Received frame with an invalid uncompressed size of {} bytes",
+                uncompressedSize
+            ));
+            return;
+        }
+        _payload.resize(uncompressedSize);
+        const int size = LZ4_decompress_safe(
+            payload + sizeof(uint32_t),
+            _payload.data(),
+            static_cast<int>(compressedSize),
+            static_cast<int>(uncompressedSize)
+        );
+        if (size < 0 || static_cast<uint32_t>(size) != uncompressedSize) {
+            LERROR("Could not decompress frame");
+            return;
+        }
+        payload = _payload.data();
+        payloadSize = uncompressedSize;
+    }
+
+    _records.resize(_syncables.size());
+    size_t offset = 0;
+    while (offset + 2 * sizeof(uint32_t) <= payloadSize) {
+        const uint32_t index = read<uint32_t>(payload + offset);
+        const uint32_t size = read<uint32_t>(payload + offset + sizeof(uint32_t));
+        offset += 2 * sizeof(uint32_t);
+        if (index >= _records.size() || offset + size > payloadSize) {
+            LERROR("Received malformed frame");
+            break;
+        }
+        _records[index].assign(payload + offset, payload + offset + size);
+        offset += size;
+    }
+    _needsKeyframe = false;
+
+    // Unchanged Syncables are decoded from their last state so that they observe the
+    // same data as if the full state had been sent
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        _syncBuffer.setDataView(_records[i].data(), _records[i].size());
+        _syncables[i]->decode(&_syncBuffer);
     }
 
     _syncBuffer.reset();
@@ -77,10 +237,19 @@ void SyncEngine::postSynchronization(IsMaster isMaster) {
     }
 }
 
+void SyncEngine::setCompressionEnabled(bool enabled) {
+    _isCompressionEnabled = enabled;
+}
+
+bool SyncEngine::isCompressionEnabled() const {
+    return _isCompressionEnabled;
+}
+
 void SyncEngine::addSyncable(Syncable* syncable) {
     ghoul_assert(syncable, "synable must not be nullptr");
 
     _syncables.push_back(syncable);
+    _needsKeyframe = true;
 }
 
 void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables) {
@@ -95,6 +264,7 @@ void SyncEngine::removeSyncable(Syncable* syncable) {
         std::remove(_syncables.begin(), _syncables.end(), syncable),
         _syncables.end()
     );
+    _needsKeyframe = true;
 }
 
 void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
@@ -0,0 +1,200 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/recordingblocks.h>
+
+#include <ghoul/misc/assert.h>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace {
+    constexpr const size_t EntryHeaderSize = sizeof(char) + 3 * sizeof(double);
+
+    uint32_t roundUpToBlockSize(size_t size) {
+        using openspace::interaction::RecordingBlockWriter;
+        const size_t nBlocks =
+            (size + RecordingBlockWriter::BlockSize - 1) / RecordingBlockWriter::BlockSize;
+        return static_cast<uint32_t>(nBlocks * RecordingBlockWriter::BlockSize);
+    }
+} // namespace
+
+namespace openspace::interaction {
+
+uint32_t RecordingBlockHeader::nEntries() const {
+    return nCameraEntries + nTimeEntries + nScriptEntries;
+}
+
+void RecordingBlockWriter::addEntry(std::ostream& out, const char* data, size_t size) {
+    ghoul_assert(size >= EntryHeaderSize, "Entry must contain type and timestamps");
+
+    if (!_data.empty() && sizeof(RecordingBlockHeader) + _data.size() + size > BlockSize)
+    {
+        flush(out);
+    }
+
+    if (_data.empty()) {
+        std::memcpy(&_header.firstTimestampApplication, data + 1, sizeof(double));
+        std::memcpy(
+            &_header.firstTimestampRecorded,
+            data + 1 + sizeof(double),
+            sizeof(double)
+        );
+        std::memcpy(
+            &_header.firstTimestampSimulation,
+            data + 1 + 2 * sizeof(double),
+            sizeof(double)
+        );
+    }
+
+    switch (data[0]) {
+        case 'c':
+            _header.nCameraEntries++;
+            break;
+        case 't':
+            _header.nTimeEntries++;
+            break;
+        case 's':
+            _header.nScriptEntries++;
+            break;
+        default:
+            ghoul_assert(false, "Unknown entry type");
+    }
+    _data.insert(_data.end(), data, data + size);
+}
+
+void RecordingBlockWriter::checkpoint(std::ostream& out) {
+    if (_nCheckpointedBytes == _data.size()) {
+        return;
+    }
+
+    writePending(out);
+    out.flush();
+}
+
+void RecordingBlockWriter::flush(std::ostream& out) {
+    if (_data.empty()) {
+        return;
+    }
+
+    writePending(out);
+
+    const size_t padding = _header.blockSize - sizeof(RecordingBlockHeader) - _data.size();
+    const std::vector<char> zeros(padding, 0);
+    out.write(zeros.data(), zeros.size());
+
+    _header = RecordingBlockHeader();
+    _data.clear();
+    _nCheckpointedBytes = 0;
+}
+
+void RecordingBlockWriter::writePending(std::ostream& out) {
+    // The entries are written and flushed before the header that counts them, so an
+    // interruption in between leaves a header that only describes complete entries
+    if (_nCheckpointedBytes == 0) {
+        _blockOffset = static_cast<uint64_t>(out.tellp());
+        RecordingBlockHeader placeholder;
+        placeholder.blockSize =
+            roundUpToBlockSize(sizeof(RecordingBlockHeader) + _data.size());
+        out.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+    }
+    else {
+        // Parts of the block were written before, so the new entries are appended to
+        // the ones that are already in the stream
+        out.seekp(_blockOffset + sizeof(RecordingBlockHeader) + _nCheckpointedBytes);
+    }
+    out.write(_data.data() + _nCheckpointedBytes, _data.size() - _nCheckpointedBytes);
+    out.flush();
+
+    _header.dataSize = static_cast<uint32_t>(_data.size());
+    _header.blockSize = roundUpToBlockSize(sizeof(RecordingBlockHeader) + _data.size());
+    out.seekp(_blockOffset);
+    out.write(reinterpret_cast<const char*>(&_header), sizeof(RecordingBlockHeader));
+    out.seekp(_blockOffset + sizeof(RecordingBlockHeader) + _data.size());
+    _nCheckpointedBytes = _data.size();
+}
+
+bool RecordingBlockReader::readIndex(std::istream& in) {
+    _blocks.clear();
+
+    const std::streamoff begin = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff end = in.tellg();
+
+    std::streamoff offset = begin;
+    while (offset + static_cast<std::streamoff>(sizeof(RecordingBlockHeader)) <= end) {
+        Block block;
+        block.offset = static_cast<uint64_t>(offset);
+        in.seekg(offset);
+        in.read(reinterpret_cast<char*>(&block.header), sizeof(RecordingBlockHeader));
+        if (!in) {
+            return false;
+        }
+
+        const RecordingBlockHeader& h = block.header;
+        if (h.blockSize > 0 && h.dataSize == 0 && h.nEntries() == 0) {
+            // The recording was interrupted before the first entries of this block were
+            // written, so only its placeholder header exists
+            break;
+        }
+        const bool isValid = h.blockSize > 0 &&
+            h.blockSize % RecordingBlockWriter::BlockSize == 0 &&
+            sizeof(RecordingBlockHeader) + h.dataSize <= h.blockSize &&
+            h.nEntries() > 0;
+        if (!isValid) {
+            return false;
+        }
+
+        const std::streamoff dataEnd = offset + sizeof(RecordingBlockHeader) + h.dataSize;
+        if (dataEnd > end) {
+            // The recording was interrupted while this block was written
+            break;
+        }
+        _blocks.push_back(block);
+        offset += h.blockSize;
+    }
+
+    in.clear();
+    in.seekg(begin);
+    return true;
+}
+
+const std::vector<RecordingBlockReader::Block>& RecordingBlockReader::blocks() const {
+    return _blocks;
+}
+
+bool RecordingBlockReader::readBlockData(std::istream& in, size_t block,
+                                         std::vector<char>& data) const
+{
+    ghoul_assert(block < _blocks.size(), "Invalid block index");
+
+    const Block& b = _blocks[block];
+    data.resize(b.header.dataSize);
+    in.clear();
+    in.seekg(b.offset + sizeof(RecordingBlockHeader));
+    in.read(data.data(), data.size());
+    return static_cast<bool>(in);
+}
+
+} // namespace openspace::interaction
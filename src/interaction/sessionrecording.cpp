@@ -48,10 +48,70 @@
 
 #include <openspace/rendering/renderengine.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <limits>
 
 namespace {
     constexpr const char* _loggerCat = "SessionRecording";
+
+    template <typename T>
+    void appendToEntry(std::vector<char>& entry, const T& value) {
+        entry.insert(
+            entry.end(),
+            reinterpret_cast<const char*>(&value),
+            reinterpret_cast<const char*>(&value) + sizeof(T)
+        );
+    }
+
+    // Returns the size of the binary entry starting at data in a recording that was
+    // written without blocks, or 0 if the entry is invalid or incomplete
+    size_t unblockedEntrySize(const char* data, size_t size) {
+        constexpr const size_t HeaderSize = sizeof(char) + 3 * sizeof(double);
+        if (size < HeaderSize) {
+            return 0;
+        }
+
+        size_t entrySize = 0;
+        switch (data[0]) {
+            case 'c': {
+                // position, rotation, follow rotation, name length, name, scale, time
+                const size_t nameOffset = HeaderSize + sizeof(glm::dvec3) +
+                    sizeof(glm::dquat) + sizeof(char);
+                if (size < nameOffset + sizeof(int)) {
+                    return 0;
+                }
+                int nameLength;
+                std::memcpy(&nameLength, data + nameOffset, sizeof(int));
+                if (nameLength < 0) {
+                    return 0;
+                }
+                entrySize = nameOffset + sizeof(int) + nameLength + sizeof(float) +
+                    sizeof(double);
+                break;
+            }
+            case 't':
+                // delta time, paused, requires time jump
+                entrySize = HeaderSize + sizeof(double) + 2 * sizeof(char);
+                break;
+            case 's': {
+                if (size < HeaderSize + sizeof(size_t)) {
+                    return 0;
+                }
+                size_t strLen;
+                std::memcpy(&strLen, data + HeaderSize, sizeof(size_t));
+                if (strLen > size) {
+                    return 0;
+                }
+                entrySize = HeaderSize + sizeof(size_t) + strLen;
+                break;
+            }
+            default:
+                return 0;
+        }
+        return entrySize <= size ? entrySize : 0;
+    }
 } // namespace
 
 #include "sessionrecording_lua.inl"
@@ -95,11 +155,12 @@ bool SessionRecording::startRecording(const std::string& filename) {
         return false;
     }
     _recordFile << _fileHeaderTitle;
-    _recordFile.write(_fileHeaderVersion, _fileHeaderVersionLength);
     if (isDataModeBinary()) {
+        _recordFile.write(_fileHeaderVersionBlocks, _fileHeaderVersionLength);
         _recordFile << dataFormatBinaryTag;
     }
     else {
+        _recordFile.write(_fileHeaderVersion, _fileHeaderVersionLength);
         _recordFile << dataFormatAsciiTag;
     }
     _recordFile << '\n';
@@ -111,6 +172,9 @@ bool SessionRecording::startRecording(const std::string& filename) {
 
 void SessionRecording::stopRecording() {
     if (_state == SessionState::Recording) {
+        if (isDataModeBinary()) {
+            _recordBlocks.flush(_recordFile);
+        }
         _state = SessionState::Idle;
         LINFO("Session recording stopped");
     }
@@ -153,7 +217,7 @@ bool SessionRecording::startPlayback(const std::string& filename,
         cleanUpPlayback();
         return false;
     }
-    readHeaderElement(_fileHeaderVersionLength);
+    std::string readVersion = readHeaderElement(_fileHeaderVersionLength);
     std::string readDataMode = readHeaderElement(1);
     if (readDataMode[0] == dataFormatAsciiTag) {
         _recordingDataMode = RecordedDataMode::Ascii;
@@ -178,6 +242,31 @@ bool SessionRecording::startPlayback(const std::string& filename,
                                                sizeof('\n');
         _playbackFile.read(reinterpret_cast<char*>(&_keyframeBuffer),
                            throwAwayHeaderReadSize);
+
+        _playbackUsesBlocks = std::equal(
+            readVersion.begin(),
+            readVersion.end(),
+            _fileHeaderVersionBlocks
+        );
+        if (_playbackUsesBlocks) {
+            if (!_playbackBlocks.readIndex(_playbackFile)) {
+                LERROR(fmt::format("Invalid block index in playback file {}", filename));
+                cleanUpPlayback();
+                return false;
+            }
+        }
+        else {
+            // Recordings without blocks are parsed from memory in their entirety
+            const std::streampos begin = _playbackFile.tellg();
+            _playbackFile.seekg(0, std::ios::end);
+            _playbackBuffer.resize(
+                static_cast<size_t>(_playbackFile.tellg() - begin)
+            );
+            _playbackFile.seekg(begin);
+            _playbackFile.read(_playbackBuffer.data(), _playbackBuffer.size());
+            _playbackBufferPosition = 0;
+            _playbackBufferFailed = false;
+        }
     }
 
     if (!_playbackFile.is_open() || !_playbackFile.good()) {
@@ -205,6 +294,7 @@ bool SessionRecording::startPlayback(const std::string& filename,
     global::scriptScheduler.setTimeReferenceMode(timeMode);
 
     _setSimulationTimeWithNextCameraKeyframe = forceSimTimeAtStart;
+    _forceSimTimeAtStart = forceSimTimeAtStart;
     if (!playbackAddEntriesToTimeline()) {
         cleanUpPlayback();
         return false;
@@ -213,12 +303,22 @@ bool SessionRecording::startPlayback(const std::string& filename,
     _hasHitEndOfCameraKeyframes = false;
     findFirstCameraKeyframeInTimeline();
 
-    LINFO(fmt::format(
-        "Playback session started: ({:8.3f},0.0,{:13.3f}) with {}/{}/{} entries, "
-        "forceTime={}",
-        now, _timestampPlaybackStarted_simulation, _keyframesCamera.size(),
-        _keyframesTime.size(), _keyframesScript.size(), (forceSimTimeAtStart ? 1 : 0)
-    ));
+    if (_playbackUsesBlocks) {
+        LINFO(fmt::format(
+            "Playback session started: ({:8.3f},0.0,{:13.3f}) with {} blocks, "
+            "forceTime={}",
+            now, _timestampPlaybackStarted_simulation, _playbackBlocks.blocks().size(),
+            (forceSimTimeAtStart ? 1 : 0)
+        ));
+    }
+    else {
+        LINFO(fmt::format(
+            "Playback session started: ({:8.3f},0.0,{:13.3f}) with {}/{}/{} entries, "
+            "forceTime={}",
+            now, _timestampPlaybackStarted_simulation, _keyframesCamera.size(),
+            _keyframesTime.size(), _keyframesScript.size(), (forceSimTimeAtStart ? 1 : 0)
+        ));
+    }
 
     global::navigationHandler.triggerPlaybackStart();
     global::scriptScheduler.triggerPlaybackStart();
@@ -231,6 +331,10 @@ bool SessionRecording::startPlayback(const std::string& filename,
 void SessionRecording::findFirstCameraKeyframeInTimeline() {
     bool foundCameraKeyframe = false;
     for (unsigned int i = 0; i < _timeline.size(); i++) {
+        if (i == _timeline.size() - 1 && !doesTimelineEntryContainCamera(i)) {
+            // The blocks loaded so far only contain non-camera entries
+            loadNextPlaybackBlock();
+        }
         if (doesTimelineEntryContainCamera(i)) {
             _idxTimeline_cameraFirstInTimeline = i;
             _idxTimeline_cameraPtrPrev = _idxTimeline_cameraFirstInTimeline;
@@ -299,19 +403,29 @@ void SessionRecording::cleanUpPlayback() {
 
     _playbackFile.close();
 
+    clearPlaybackTimeline();
+    _playbackBuffer.clear();
+    _playbackBuffer.shrink_to_fit();
+    _playbackUsesBlocks = false;
+    _playbackBlocks = RecordingBlockReader();
+    _nextPlaybackBlock = 0;
+
+    _cleanupNeeded = false;
+}
+
+void SessionRecording::clearPlaybackTimeline() {
     //Clear all timelines and keyframes
     _timeline.clear();
     _keyframesCamera.clear();
     _keyframesTime.clear();
     _keyframesScript.clear();
+    _loadedPlaybackBlocks.clear();
     _idxTimeline_nonCamera = 0;
     _idxTime = 0;
     _idxScript = 0;
     _idxTimeline_cameraPtrNext = 0;
     _idxTimeline_cameraPtrPrev = 0;
     _hasHitEndOfCameraKeyframes = false;
-
-    _cleanupNeeded = false;
 }
 
 bool SessionRecording::isDataModeBinary() {
@@ -348,38 +462,39 @@ void SessionRecording::writeToFileBuffer(const bool b) {
     _bufferIndex += writeSize_bytes;
 }
 
-void SessionRecording::saveStringToFile(const std::string& s) {
-    size_t strLen = s.size();
-    size_t writeSize_bytes = sizeof(size_t);
-
-    _bufferIndex = 0;
-    unsigned char const *p = reinterpret_cast<unsigned char const*>(&strLen);
-    memcpy((_keyframeBuffer + _bufferIndex), p, writeSize_bytes);
-    _bufferIndex += static_cast<unsigned int>(writeSize_bytes);
-    saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
-
-    _recordFile.write(s.c_str(), s.size());
+void SessionRecording::readFromPlayback(void* result, size_t size) {
+    if (_playbackBufferFailed || _playbackBufferPosition + size > _playbackBuffer.size())
+    {
+        _playbackBufferFailed = true;
+        std::memset(result, 0, size);
+        return;
+    }
+    std::memcpy(result, _playbackBuffer.data() + _playbackBufferPosition, size);
+    _playbackBufferPosition += size;
 }
 
 void SessionRecording::readFromPlayback(unsigned char& result) {
-    _playbackFile.read(reinterpret_cast<char*>(&result), sizeof(unsigned char));
+    readFromPlayback(&result, sizeof(unsigned char));
 }
 
 void SessionRecording::readFromPlayback(double& result) {
-    _playbackFile.read(reinterpret_cast<char*>(&result), sizeof(double));
+    readFromPlayback(&result, sizeof(double));
 }
 
 void SessionRecording::readFromPlayback(float& result) {
-    _playbackFile.read(reinterpret_cast<char*>(&result), sizeof(float));
+    readFromPlayback(&result, sizeof(float));
 }
 
 void SessionRecording::readFromPlayback(size_t& result) {
-    _playbackFile.read(reinterpret_cast<char*>(&result), sizeof(size_t));
+    readFromPlayback(&result, sizeof(size_t));
 }
 
 void SessionRecording::readFromPlayback(bool& result) {
     unsigned char b;
-    _playbackFile.read(reinterpret_cast<char*>(&b), sizeof(unsigned char));
+    readFromPlayback(b);
+    if (_playbackBufferFailed) {
+        return;
+    }
     if (b == 0) {
         result = false;
     }
@@ -394,13 +509,41 @@ void SessionRecording::readFromPlayback(bool& result) {
 void SessionRecording::readFromPlayback(std::string& result) {
     result.erase();
     size_t strLen;
-    //Read string length from file
-    _playbackFile.read(reinterpret_cast<char*>(&strLen), sizeof(strLen));
-    //Read back full string
-    std::vector<char> temp(strLen + 1);
-    _playbackFile.read(temp.data(), strLen);
-    temp[strLen] = '\0';
-    result = temp.data();
+    readFromPlayback(strLen);
+    if (_playbackBufferFailed ||
+        strLen > _playbackBuffer.size() - _playbackBufferPosition)
+    {
+        _playbackBufferFailed = true;
+        return;
+    }
+    //Read back full string, up to the first null character like the recording did
+    const char* begin = _playbackBuffer.data() + _playbackBufferPosition;
+    result.assign(begin, std::find(begin, begin + strLen, '\0'));
+    _playbackBufferPosition += strLen;
+}
+
+void SessionRecording::readFromPlayback(datamessagestructures::CameraKeyframe& result) {
+    readFromPlayback(&result._position, sizeof(result._position));
+    readFromPlayback(&result._rotation, sizeof(result._rotation));
+    unsigned char followNodeRotation;
+    readFromPlayback(followNodeRotation);
+    result._followNodeRotation = (followNodeRotation == 1);
+
+    int nodeNameLength;
+    readFromPlayback(&nodeNameLength, sizeof(nodeNameLength));
+    if (_playbackBufferFailed || nodeNameLength < 0 ||
+        static_cast<size_t>(nodeNameLength) >
+        _playbackBuffer.size() - _playbackBufferPosition)
+    {
+        _playbackBufferFailed = true;
+        return;
+    }
+    const char* begin = _playbackBuffer.data() + _playbackBufferPosition;
+    result._focusNode.assign(begin, std::find(begin, begin + nodeNameLength, '\0'));
+    _playbackBufferPosition += nodeNameLength;
+
+    readFromPlayback(result._scale);
+    readFromPlayback(result._timestamp);
 }
 
 bool SessionRecording::hasCameraChangedFromPrev(
@@ -542,10 +685,19 @@ void SessionRecording::saveScriptKeyframe(std::string scriptToSave) {
         writeToFileBuffer(sm._timestamp);
         writeToFileBuffer(sm._timestamp - _timestampRecordStarted);
         writeToFileBuffer(global::timeManager.time().j2000Seconds());
-        //Write header to file
-        saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
 
-        saveStringToFile(scriptToSave);
+        // Scripts can be longer than the keyframe buffer, so the entry is assembled
+        // separately to be stored in a single block
+        const size_t strLen = scriptToSave.size();
+        std::vector<char> entry(_keyframeBuffer, _keyframeBuffer + _bufferIndex);
+        entry.insert(
+            entry.end(),
+            reinterpret_cast<const char*>(&strLen),
+            reinterpret_cast<const char*>(&strLen) + sizeof(strLen)
+        );
+        entry.insert(entry.end(), scriptToSave.begin(), scriptToSave.end());
+        _recordBlocks.addEntry(_recordFile, entry.data(), entry.size());
+        _recordBlocks.checkpoint(_recordFile);
     }
     else {
         unsigned int numLinesInScript = static_cast<unsigned int>(
@@ -574,6 +726,7 @@ void SessionRecording::preSynchronization() {
         }
     }
     else if (_state == SessionState::Playback) {
+        streamPlaybackBlocks();
         moveAheadInTime();
     }
     else if (_cleanupNeeded) {
@@ -589,44 +742,242 @@ bool SessionRecording::isPlayingBack() const {
     return (_state == SessionState::Playback);
 }
 
-bool SessionRecording::playbackAddEntriesToTimeline() {
-    bool parsingErrorsFound = false;
+bool SessionRecording::seekPlayback(double recordedTime) {
+    if (_state != SessionState::Playback) {
+        LERROR("Unable to seek since no playback is in progress");
+        return false;
+    }
+    if (_playbackTimeReferenceMode != KeyframeTimeRef::Relative_recordedStart) {
+        LERROR("Seeking is only possible for playback relative to the recording start");
+        return false;
+    }
 
-    if (isDataModeBinary()) {
-        unsigned char frameType;
-        bool fileReadOk = true;
-
-        while (fileReadOk) {
-            readFromPlayback(frameType);
-            //Check if have reached EOF
-            if (!_playbackFile) {
-                LINFO(fmt::format(
-                    "Finished parsing {} entries from playback file {}",
-                    _playbackLineNum - 1, _playbackFilename.c_str()
+    if (_playbackUsesBlocks) {
+        // Reload starting with the last block that begins before the requested time
+        using Block = RecordingBlockReader::Block;
+        const std::vector<Block>& blocks = _playbackBlocks.blocks();
+        auto it = std::upper_bound(
+            blocks.begin(),
+            blocks.end(),
+            recordedTime,
+            [](double t, const Block& b) { return t < b.header.firstTimestampRecorded; }
+        );
+
+        clearPlaybackTimeline();
+        _nextPlaybackBlock = (it == blocks.begin()) ?
+            0 :
+            static_cast<size_t>(std::distance(blocks.begin(), it) - 1);
+        _setSimulationTimeWithNextCameraKeyframe = _forceSimTimeAtStart;
+        while (_loadedPlaybackBlocks.size() < _playbackBlocksInMemory &&
+               loadNextPlaybackBlock())
+        {}
+    }
+
+    if (_timeline.empty()) {
+        LERROR(fmt::format("No keyframes found to seek to time {}", recordedTime));
+        return false;
+    }
+
+    auto next = std::lower_bound(
+        _timeline.begin(),
+        _timeline.end(),
+        recordedTime,
+        [](const timelineEntry& e, double t) { return e.timestamp < t; }
+    );
+    _idxTimeline_nonCamera = std::min(
+        static_cast<unsigned int>(std::distance(_timeline.begin(), next)),
+        static_cast<unsigned int>(_timeline.size()) - 1
+    );
+
+    _playbackActive_camera = true;
+    _playbackActive_script = true;
+    _playbackActive_time = _usingTimeKeyframes;
+    _hasHitEndOfCameraKeyframes = false;
+    findFirstCameraKeyframeInTimeline();
+    for (unsigned int i = _idxTimeline_cameraFirstInTimeline;
+         i < _timeline.size() && _timeline[i].timestamp <= recordedTime;
+         ++i)
+    {
+        if (doesTimelineEntryContainCamera(i)) {
+            _idxTimeline_cameraPtrPrev = i;
+            _idxTimeline_cameraPtrNext = i;
+        }
+    }
+
+    const double start = global::windowDelegate.applicationTime() - recordedTime;
+    _timestampPlaybackStarted_application = start;
+    global::navigationHandler.keyframeNavigator().setTimeReferenceMode(
+        _playbackTimeReferenceMode,
+        start
+    );
+
+    LINFO(fmt::format("Playback moved to {:8.3f} seconds", recordedTime));
+    return true;
+}
+
+bool SessionRecording::convertToBinary(const std::string& inFilename,
+                                       const std::string& outFilename)
+{
+    std::ifstream in(inFilename, std::ios::binary);
+    if (!in.good()) {
+        LERROR(fmt::format("Unable to open file {} for conversion", inFilename));
+        return false;
+    }
+
+    std::string title(_fileHeaderTitle.length(), '\0');
+    in.read(&title[0], title.size());
+    std::string version(_fileHeaderVersionLength, '\0');
+    in.read(&version[0], version.size());
+    char dataMode = 0;
+    in.read(&dataMode, sizeof(char));
+    std::string throwawayNewlineChar;
+    std::getline(in, throwawayNewlineChar);
+    if (!in || title != _fileHeaderTitle) {
+        LERROR("Specified conversion file does not contain expected header.");
+        return false;
+    }
+    const bool isBlocks =
+        std::equal(version.begin(), version.end(), _fileHeaderVersionBlocks);
+    if (dataMode == dataFormatBinaryTag && isBlocks) {
+        LERROR(fmt::format("File {} is already stored in blocks", inFilename));
+        return false;
+    }
+    if (dataMode != dataFormatBinaryTag && dataMode != dataFormatAsciiTag) {
+        LERROR("Unknown data type in header (should be Ascii or Binary)");
+        return false;
+    }
+
+    std::ofstream out(outFilename, std::ios::binary);
+    if (!out.good()) {
+        LERROR(fmt::format("Unable to open file {} for conversion", outFilename));
+        return false;
+    }
+    out << _fileHeaderTitle;
+    out.write(_fileHeaderVersionBlocks, _fileHeaderVersionLength);
+    out << dataFormatBinaryTag << '\n';
+
+    RecordingBlockWriter writer;
+    size_t nEntries = 0;
+    if (dataMode == dataFormatBinaryTag) {
+        // Binary entries without blocks carry no size, so they have to be parsed
+        const std::vector<char> data = std::vector<char>(
+            std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>()
+        );
+        size_t offset = 0;
+        while (offset < data.size()) {
+            const size_t size = unblockedEntrySize(
+                data.data() + offset,
+                data.size() - offset
+            );
+            if (size == 0) {
+                LERROR(fmt::format(
+                    "Invalid entry {} in file {}", nEntries + 1, inFilename
                 ));
-                fileReadOk = false;
-                break;
+                return false;
             }
-            if (frameType == 'c') {
-                playbackCamera();
+            writer.addEntry(out, data.data() + offset, size);
+            offset += size;
+            nEntries++;
+        }
+    }
+    else {
+        std::vector<char> entry;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
             }
-            else if (frameType == 't') {
-                playbackTimeChange();
+            std::istringstream iss(line);
+            std::string entryType;
+            double timeOs, timeRec, timeSim;
+            iss >> entryType >> timeOs >> timeRec >> timeSim;
+
+            entry.clear();
+            entry.push_back(entryType.empty() ? '\0' : entryType[0]);
+            appendToEntry(entry, timeOs);
+            appendToEntry(entry, timeRec);
+            appendToEntry(entry, timeSim);
+
+            if (entryType == "camera") {
+                datamessagestructures::CameraKeyframe kf;
+                std::string rotationFollowing;
+                iss >> kf._position.x >> kf._position.y >> kf._position.z
+                    >> kf._rotation.x >> kf._rotation.y >> kf._rotation.z
+                    >> kf._rotation.w >> kf._scale >> rotationFollowing
+                    >> kf._focusNode;
+                kf._followNodeRotation = (rotationFollowing == "F");
+                kf._timestamp = timeOs;
+                kf.serialize(entry);
             }
-            else if (frameType == 's') {
-                playbackScript();
+            else if (entryType == "time") {
+                double dt;
+                std::string paused, jump;
+                iss >> dt >> paused >> jump;
+                appendToEntry(entry, dt);
+                entry.push_back(paused == "P" ? 1 : 0);
+                entry.push_back(jump == "J" ? 1 : 0);
+            }
+            else if (entryType == "script") {
+                unsigned int numScriptLines;
+                iss >> numScriptLines;
+                std::string script;
+                std::getline(iss, script);
+                if (!script.empty() && script.front() == ' ') {
+                    script.erase(script.begin());
+                }
+                for (unsigned int i = 1; i < numScriptLines; ++i) {
+                    std::string scriptLine;
+                    std::getline(in, scriptLine);
+                    script.append("\n");
+                    script.append(scriptLine);
+                }
+                appendToEntry(entry, script.size());
+                entry.insert(entry.end(), script.begin(), script.end());
             }
             else {
                 LERROR(fmt::format(
-                    "Unknown frame type {} @ index {} of playback file {}",
-                    frameType, _playbackLineNum - 1, _playbackFilename.c_str()
+                    "Unknown frame type {} @ line {} of file {}",
+                    entryType, nEntries + 2, inFilename
                 ));
-                parsingErrorsFound = true;
-                break;
+                return false;
             }
 
-            _playbackLineNum++;
+            if (iss.fail()) {
+                LERROR(fmt::format(
+                    "Error parsing line {} of file {}", nEntries + 2, inFilename
+                ));
+                return false;
+            }
+            writer.addEntry(out, entry.data(), entry.size());
+            nEntries++;
         }
+    }
+    writer.flush(out);
+
+    LINFO(fmt::format(
+        "Converted {} entries from {} to {}", nEntries, inFilename, outFilename
+    ));
+    return true;
+}
+
+bool SessionRecording::playbackAddEntriesToTimeline() {
+    bool parsingErrorsFound = false;
+
+    if (isDataModeBinary() && _playbackUsesBlocks) {
+        // Only the first blocks are loaded, the rest is streamed during playback
+        _nextPlaybackBlock = 0;
+        while (_loadedPlaybackBlocks.size() < _playbackBlocksInMemory &&
+               loadNextPlaybackBlock())
+        {}
+        parsingErrorsFound = _timeline.empty();
+    }
+    else if (isDataModeBinary()) {
+        parsingErrorsFound = !parseBinaryEntries();
+        LINFO(fmt::format(
+            "Finished parsing {} entries from playback file {}",
+            _playbackLineNum - 1, _playbackFilename.c_str()
+        ));
     } else {
         while (std::getline(_playbackFile, _playbackLineParsing)) {
             _playbackLineNum++;
@@ -668,6 +1019,151 @@ bool SessionRecording::playbackAddEntriesToTimeline() {
     return !parsingErrorsFound;
 }
 
+bool SessionRecording::parseBinaryEntries() {
+    while (_playbackBufferPosition < _playbackBuffer.size()) {
+        unsigned char frameType;
+        readFromPlayback(frameType);
+        if (frameType == 'c') {
+            playbackCamera();
+        }
+        else if (frameType == 't') {
+            playbackTimeChange();
+        }
+        else if (frameType == 's') {
+            playbackScript();
+        }
+        else {
+            LERROR(fmt::format(
+                "Unknown frame type {} @ index {} of playback file {}",
+                frameType, _playbackLineNum - 1, _playbackFilename.c_str()
+            ));
+            return false;
+        }
+
+        if (_playbackBufferFailed) {
+            return false;
+        }
+        _playbackLineNum++;
+    }
+    return true;
+}
+
+bool SessionRecording::hasMorePlaybackBlocks() const {
+    return _playbackUsesBlocks && _nextPlaybackBlock < _playbackBlocks.blocks().size();
+}
+
+bool SessionRecording::loadNextPlaybackBlock() {
+    if (!hasMorePlaybackBlocks()) {
+        return false;
+    }
+
+    const size_t block = _nextPlaybackBlock++;
+    if (!_playbackBlocks.readBlockData(_playbackFile, block, _playbackBuffer)) {
+        LERROR(fmt::format(
+            "Error reading block {} of playback file {}", block, _playbackFilename
+        ));
+        _nextPlaybackBlock = _playbackBlocks.blocks().size();
+        return false;
+    }
+    _playbackBufferPosition = 0;
+    _playbackBufferFailed = false;
+
+    const size_t nTimeline = _timeline.size();
+    const size_t nCamera = _keyframesCamera.size();
+    const size_t nTime = _keyframesTime.size();
+    const size_t nScript = _keyframesScript.size();
+    if (!parseBinaryEntries()) {
+        LERROR(fmt::format(
+            "Error parsing block {} of playback file {}", block, _playbackFilename
+        ));
+    }
+    _loadedPlaybackBlocks.push_back({
+        static_cast<unsigned int>(_timeline.size() - nTimeline),
+        static_cast<unsigned int>(_keyframesCamera.size() - nCamera),
+        static_cast<unsigned int>(_keyframesTime.size() - nTime),
+        static_cast<unsigned int>(_keyframesScript.size() - nScript)
+    });
+    return true;
+}
+
+void SessionRecording::streamPlaybackBlocks() {
+    if (!_playbackUsesBlocks) {
+        return;
+    }
+
+    // Evict the oldest blocks whose entries have been played back entirely. The previous
+    // camera keyframe is still needed for the interpolation
+    const bool isNonCameraPlaybackActive = _playbackActive_time || _playbackActive_script;
+    const unsigned int idxPlayed = std::min({
+        isNonCameraPlaybackActive ?
+            _idxTimeline_nonCamera :
+            std::numeric_limits<unsigned int>::max(),
+        _idxTimeline_cameraPtrPrev,
+        _idxTimeline_cameraPtrNext
+    });
+    unsigned int nEvicted = 0;
+    LoadedBlock evicted = { 0, 0, 0, 0 };
+    while (_loadedPlaybackBlocks.size() > 1 &&
+           nEvicted + _loadedPlaybackBlocks.front().nTimelineEntries <= idxPlayed)
+    {
+        const LoadedBlock& b = _loadedPlaybackBlocks.front();
+        nEvicted += b.nTimelineEntries;
+        evicted.nCameraKeyframes += b.nCameraKeyframes;
+        evicted.nTimeKeyframes += b.nTimeKeyframes;
+        evicted.nScriptKeyframes += b.nScriptKeyframes;
+        _loadedPlaybackBlocks.pop_front();
+    }
+
+    if (nEvicted > 0) {
+        _timeline.erase(_timeline.begin(), _timeline.begin() + nEvicted);
+        _keyframesCamera.erase(
+            _keyframesCamera.begin(),
+            _keyframesCamera.begin() + evicted.nCameraKeyframes
+        );
+        _keyframesTime.erase(
+            _keyframesTime.begin(),
+            _keyframesTime.begin() + evicted.nTimeKeyframes
+        );
+        _keyframesScript.erase(
+            _keyframesScript.begin(),
+            _keyframesScript.begin() + evicted.nScriptKeyframes
+        );
+        for (timelineEntry& e : _timeline) {
+            switch (e.keyframeType) {
+                case RecordedType::Camera:
+                    e.idxIntoKeyframeTypeArray -= evicted.nCameraKeyframes;
+                    break;
+                case RecordedType::Time:
+                    e.idxIntoKeyframeTypeArray -= evicted.nTimeKeyframes;
+                    break;
+                case RecordedType::Script:
+                    e.idxIntoKeyframeTypeArray -= evicted.nScriptKeyframes;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        _idxTimeline_nonCamera -= std::min(_idxTimeline_nonCamera, nEvicted);
+        _idxTimeline_cameraPtrPrev -= nEvicted;
+        _idxTimeline_cameraPtrNext -= nEvicted;
+        _idxTime -= std::min(_idxTime, evicted.nTimeKeyframes);
+        _idxScript -= std::min(_idxScript, evicted.nScriptKeyframes);
+        if (_idxTimeline_cameraFirstInTimeline < nEvicted) {
+            // The previous camera keyframe has moved past the evicted first keyframe
+            _idxTimeline_cameraFirstInTimeline = std::numeric_limits<unsigned int>::max();
+        }
+        else {
+            _idxTimeline_cameraFirstInTimeline -= nEvicted;
+        }
+    }
+
+    // Read ahead so that the next keyframes are in memory before they are needed
+    while (_loadedPlaybackBlocks.size() < _playbackBlocksInMemory &&
+           loadNextPlaybackBlock())
+    {}
+}
+
 double SessionRecording::appropriateTimestamp(double timeOs, double timeRec,
                                               double timeSim)
 {
@@ -732,23 +1228,7 @@ void SessionRecording::playbackCamera() {
         readFromPlayback(timeOs);
         readFromPlayback(timeRec);
         readFromPlayback(timeSim);
-        try {
-            kf.read(&_playbackFile);
-        }
-        catch (std::bad_alloc&) {
-            LERROR(fmt::format(
-                "Allocation error with camera playback from keyframe entry {}",
-                _playbackLineNum - 1
-            ));
-            return;
-        }
-        catch (std::length_error&) {
-            LERROR(fmt::format(
-                "length_error with camera playback from keyframe entry {}",
-                _playbackLineNum - 1
-            ));
-            return;
-        }
+        readFromPlayback(kf);
 
         timeOs = kf._timestamp;
 
@@ -758,7 +1238,7 @@ void SessionRecording::playbackCamera() {
         pbFrame.scale = kf._scale;
         pbFrame.followFocusNodeRotation = kf._followNodeRotation;
 
-        if (!_playbackFile) {
+        if (_playbackBufferFailed) {
             LINFO(fmt::format(
                 "Error reading camera playback from keyframe entry {}",
                 _playbackLineNum - 1
@@ -813,7 +1293,7 @@ void SessionRecording::playbackTimeChange() {
         readFromPlayback(pbFrame._dt);
         readFromPlayback(pbFrame._paused);
         readFromPlayback(pbFrame._requiresTimeJump);
-        if (!_playbackFile) {
+        if (_playbackBufferFailed) {
             LERROR(fmt::format(
                 "Error reading time playback from keyframe entry {}",
                 _playbackLineNum - 1
@@ -866,25 +1346,9 @@ void SessionRecording::playbackScript() {
         readFromPlayback(timeOs);
         readFromPlayback(timeRec);
         readFromPlayback(timeSim);
-        try {
-            readFromPlayback(pbFrame._script);
-        }
-        catch (std::bad_alloc&) {
-            LERROR(fmt::format(
-                "Allocation error with script playback from keyframe entry {}",
-                _playbackLineNum - 1
-            ));
-            return;
-        }
-        catch (std::length_error&) {
-            LERROR(fmt::format(
-                "length_error with script playback from keyframe entry {}",
-                _playbackLineNum - 1
-            ));
-            return;
-        }
+        readFromPlayback(pbFrame._script);
 
-        if (!_playbackFile) {
+        if (_playbackBufferFailed) {
             LERROR(fmt::format(
                 "Error reading script playback from keyframe entry {}",
                 _playbackLineNum - 1
@@ -984,7 +1448,9 @@ void SessionRecording::lookForNonCameraKeyframesThatHaveComeDue(double currTime)
             break;
         }
 
-        if (++_idxTimeline_nonCamera >= _timeline.size()) {
+        ++_idxTimeline_nonCamera;
+        while (_idxTimeline_nonCamera >= _timeline.size() && loadNextPlaybackBlock()) {}
+        if (_idxTimeline_nonCamera >= _timeline.size()) {
             _idxTimeline_nonCamera--;
             if (_playbackActive_time) {
                 signalPlaybackFinishedForComponent(RecordedType::Time);
@@ -1024,6 +1490,9 @@ bool SessionRecording::findNextFutureCameraIndex(double currTime) {
     unsigned int seekAheadIndex = _idxTimeline_cameraPtrPrev;
     while (true) {
         seekAheadIndex++;
+        while (seekAheadIndex >= static_cast<unsigned int>(_timeline.size()) &&
+               loadNextPlaybackBlock())
+        {}
         if (seekAheadIndex >= static_cast<unsigned int>(_timeline.size())) {
             seekAheadIndex = static_cast<unsigned int>(_timeline.size()) - 1;
         }
@@ -1033,7 +1502,9 @@ bool SessionRecording::findNextFutureCameraIndex(double currTime) {
                 _timeline[seekAheadIndex].idxIntoKeyframeTypeArray;
             double seekAheadKeyframeTimestamp = _timeline[seekAheadIndex].timestamp;
 
-            if (indexIntoCameraKeyframes >= (_keyframesCamera.size() - 1)) {
+            if (indexIntoCameraKeyframes >= (_keyframesCamera.size() - 1) &&
+                !hasMorePlaybackBlocks())
+            {
                 _hasHitEndOfCameraKeyframes = true;
             }
 
@@ -1174,7 +1645,11 @@ bool SessionRecording::processScriptKeyframe() {
         nextScript = nextKeyframeObj(
             _idxScript,
             _keyframesScript,
-            ([&]() { signalPlaybackFinishedForComponent(RecordedType::Script); })
+            ([&]() {
+                if (!hasMorePlaybackBlocks()) {
+                    signalPlaybackFinishedForComponent(RecordedType::Script);
+                }
+            })
         );
         global::scriptEngine.queueScript(
             nextScript,
@@ -1237,7 +1712,10 @@ SessionRecording::RecordedType SessionRecording::getPrevKeyframeType() {
 }
 
 void SessionRecording::saveKeyframeToFileBinary(unsigned char* buffer, size_t size) {
-    _recordFile.write(reinterpret_cast<char*>(buffer), size);
+    _recordBlocks.addEntry(_recordFile, reinterpret_cast<char*>(buffer), size);
+    // Like the ASCII lines, every entry is written immediately so that an interrupted
+    // recording loses at most the entry that was being saved
+    _recordBlocks.checkpoint(_recordFile);
 }
 
 void SessionRecording::saveKeyframeToFile(std::string entry) {
@@ -1318,6 +1796,25 @@ scripting::LuaLibrary SessionRecording::luaLibrary() {
                 {},
                 "void",
                 "Stops a playback session before playback of all keyframes is complete"
+            },
+            {
+                "seekPlayback",
+                &luascriptfunctions::seekPlayback,
+                {},
+                "number",
+                "Moves a playback session that is relative to the time since the "
+                "recording was started to the provided number of seconds since the "
+                "start of the recording"
+            },
+            {
+                "convertToBinary",
+                &luascriptfunctions::convertToBinary,
+                {},
+                "string, string",
+                "Converts the ASCII or older binary recording in the first argument into "
+                "a block-based binary recording that is saved in the file provided as "
+                "the second argument. Block-based recordings are streamed during "
+                "playback and support seeking."
             }
         }
     };
@@ -142,4 +142,36 @@ int stopPlayback(lua_State* L) {
     return 0;
 }
 
+int seekPlayback(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::seekPlayback");
+
+    const double recordedTime = ghoul::lua::value<double>(
+        L,
+        1,
+        ghoul::lua::PopValue::Yes
+    );
+
+    global::sessionRecording.seekPlayback(recordedTime);
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
+int convertToBinary(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 2, "lua::convertToBinary");
+
+    const std::string inFilePath = ghoul::lua::value<std::string>(L, 1);
+    const std::string outFilePath = ghoul::lua::value<std::string>(L, 2);
+    lua_settop(L, 0);
+
+    if (inFilePath.empty() || outFilePath.empty()) {
+        return luaL_error(L, "filepath string is empty");
+    }
+
+    global::sessionRecording.convertToBinary(inFilePath, outFilePath);
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
 } // namespace openspace::luascriptfunctions
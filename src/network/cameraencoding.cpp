@@ -0,0 +1,248 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/cameraencoding.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace {
+    constexpr const int ComponentBits = 20;
+    constexpr const uint64_t ComponentMask = (uint64_t(1) << ComponentBits) - 1;
+    // The three smallest components of a unit quaternion lie in [-1/sqrt(2), 1/sqrt(2)]
+    constexpr const double ComponentRange = 0.707106781186547524;
+
+    // A new reference is sent once the camera has moved further away from the reference
+    // position than this many meters. The bound is absolute since the world position of
+    // the camera says nothing about how close it is to the focus node. It keeps the error
+    // of the single precision offset below 0.1 mm, regardless of the reference position
+    constexpr const double MaxOffset = 1000.0;
+
+    constexpr const uint8_t FollowNodeRotationFlag = 1;
+
+    constexpr const size_t CompactKeyframeSize = sizeof(uint8_t) + sizeof(glm::vec3) +
+        sizeof(uint64_t) + sizeof(float) + sizeof(double);
+
+    template <typename T>
+    void append(std::vector<char>& buffer, const T& value) {
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&value),
+            reinterpret_cast<const char*>(&value) + sizeof(T)
+        );
+    }
+
+    template <typename T>
+    bool read(const std::vector<char>& buffer, size_t& offset, T& value) {
+        if (offset + sizeof(T) > buffer.size()) {
+            return false;
+        }
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+} // namespace
+
+namespace openspace::datamessagestructures {
+
+uint64_t quantizeRotation(const glm::dquat& rotation) {
+    const glm::dquat q = glm::normalize(rotation);
+    const std::array<double, 4> c = { q.x, q.y, q.z, q.w };
+
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (std::abs(c[i]) > std::abs(c[largest])) {
+            largest = i;
+        }
+    }
+    // q and -q represent the same rotation, so the dropped component can always be made
+    // positive by flipping the signs of the remaining ones
+    const double sign = c[largest] < 0.0 ? -1.0 : 1.0;
+
+    uint64_t packed = static_cast<uint64_t>(largest) << (3 * ComponentBits);
+    int shift = 2 * ComponentBits;
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        const double v = glm::clamp(sign * c[i] / ComponentRange, -1.0, 1.0);
+        const uint64_t quantized = static_cast<uint64_t>(
+            std::round((v * 0.5 + 0.5) * ComponentMask)
+        );
+        packed |= quantized << shift;
+        shift -= ComponentBits;
+    }
+    return packed;
+}
+
+glm::dquat dequantizeRotation(uint64_t packed) {
+    const int largest = static_cast<int>((packed >> (3 * ComponentBits)) & 3);
+
+    std::array<double, 4> c;
+    double sumOfSquares = 0.0;
+    int shift = 2 * ComponentBits;
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        const double quantized = static_cast<double>((packed >> shift) & ComponentMask);
+        c[i] = (quantized / ComponentMask * 2.0 - 1.0) * ComponentRange;
+        sumOfSquares += c[i] * c[i];
+        shift -= ComponentBits;
+    }
+    c[largest] = std::sqrt(std::max(0.0, 1.0 - sumOfSquares));
+
+    return glm::normalize(glm::dquat(c[3], c[0], c[1], c[2]));
+}
+
+bool CameraKeyframeEncoder::encode(const CameraKeyframe& keyframe,
+                                   std::vector<char>& referenceBuffer,
+                                   std::vector<char>& keyframeBuffer)
+{
+    referenceBuffer.clear();
+    keyframeBuffer.clear();
+
+    const bool needsReference = !_hasReference || keyframe._focusNode != _focusNode ||
+        glm::length(keyframe._position - _referencePosition) > MaxOffset;
+
+    if (needsReference) {
+        auto it = _focusNodeIds.find(keyframe._focusNode);
+        const bool isNewFocusNode = (it == _focusNodeIds.end());
+        if (isNewFocusNode) {
+            if (_focusNodeIds.size() > std::numeric_limits<uint16_t>::max()) {
+                // Start over, every focus node name will be sent again
+                _focusNodeIds.clear();
+            }
+            const uint16_t id = static_cast<uint16_t>(_focusNodeIds.size());
+            it = _focusNodeIds.emplace(keyframe._focusNode, id).first;
+        }
+
+        _focusNode = keyframe._focusNode;
+        _referencePosition = keyframe._position;
+        _hasReference = true;
+
+        // The name is only included the first time a focus node is used
+        append(referenceBuffer, it->second);
+        const uint32_t nameLength =
+            isNewFocusNode ? static_cast<uint32_t>(_focusNode.size()) : 0;
+        append(referenceBuffer, nameLength);
+        referenceBuffer.insert(
+            referenceBuffer.end(),
+            _focusNode.data(),
+            _focusNode.data() + nameLength
+        );
+        append(referenceBuffer, _referencePosition);
+    }
+
+    const uint8_t flags = keyframe._followNodeRotation ? FollowNodeRotationFlag : 0;
+    append(keyframeBuffer, flags);
+    append(keyframeBuffer, glm::vec3(keyframe._position - _referencePosition));
+    append(keyframeBuffer, quantizeRotation(keyframe._rotation));
+    append(keyframeBuffer, keyframe._scale);
+    append(keyframeBuffer, keyframe._timestamp);
+
+    return needsReference;
+}
+
+void CameraKeyframeEncoder::reset() {
+    _focusNodeIds.clear();
+    _focusNode.clear();
+    _referencePosition = glm::dvec3(0.0);
+    _hasReference = false;
+}
+
+bool CameraKeyframeDecoder::decodeReference(const std::vector<char>& buffer) {
+    // The following keyframes are relative to this reference, so they have to be
+    // rejected rather than applied to the previous reference if this one is malformed
+    _hasReference = false;
+
+    size_t offset = 0;
+    uint16_t id = 0;
+    uint32_t nameLength = 0;
+    if (!read(buffer, offset, id) || !read(buffer, offset, nameLength) ||
+        offset + nameLength > buffer.size())
+    {
+        return false;
+    }
+
+    std::string_view name(buffer.data() + offset, nameLength);
+    offset += nameLength;
+    if (nameLength == 0 && (id >= _focusNodes.size() || _focusNodes[id].empty())) {
+        // The reference uses a focus node that has never been defined
+        return false;
+    }
+
+    glm::dvec3 position;
+    if (!read(buffer, offset, position)) {
+        return false;
+    }
+
+    if (nameLength > 0) {
+        if (id >= _focusNodes.size()) {
+            _focusNodes.resize(id + 1);
+        }
+        _focusNodes[id] = std::string(name);
+    }
+    _focusNodeId = id;
+    _referencePosition = position;
+    _hasReference = true;
+    return true;
+}
+
+bool CameraKeyframeDecoder::decode(const std::vector<char>& buffer,
+                                   CameraKeyframe& keyframe) const
+{
+    if (!_hasReference || buffer.size() != CompactKeyframeSize) {
+        return false;
+    }
+
+    size_t offset = 0;
+    uint8_t flags = 0;
+    glm::vec3 positionOffset;
+    uint64_t rotation = 0;
+    read(buffer, offset, flags);
+    read(buffer, offset, positionOffset);
+    read(buffer, offset, rotation);
+    read(buffer, offset, keyframe._scale);
+    read(buffer, offset, keyframe._timestamp);
+
+    keyframe._followNodeRotation = (flags & FollowNodeRotationFlag) != 0;
+    keyframe._position = _referencePosition + glm::dvec3(positionOffset);
+    keyframe._rotation = dequantizeRotation(rotation);
+    keyframe._focusNode = _focusNodes[_focusNodeId];
+    return true;
+}
+
+void CameraKeyframeDecoder::reset() {
+    _focusNodes.clear();
+    _focusNodeId = 0;
+    _referencePosition = glm::dvec3(0.0);
+    _hasReference = false;
+}
+
+} // namespace openspace::datamessagestructures
@@ -0,0 +1,106 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/messageoutbox.h>
+
+#include <algorithm>
+
+namespace openspace {
+
+MessageOutbox::MessageOutbox(SendFunction send, std::atomic_size_t& droppedKeyframes,
+                             int maxKeyframesInFlight)
+    : _send(std::move(send))
+    , _droppedKeyframes(droppedKeyframes)
+    , _maxKeyframesInFlight(maxKeyframesInFlight)
+{}
+
+bool MessageOutbox::push(EncodedMessage message, bool isCameraKeyframe) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (isCameraKeyframe) {
+        // A camera keyframe that is still waiting is outdated by the new one
+        auto stale = std::find_if(
+            _messages.begin(),
+            _messages.end(),
+            [](const Entry& e) { return e.isCameraKeyframe; }
+        );
+        if (stale != _messages.end()) {
+            _messages.erase(stale);
+            ++_droppedKeyframes;
+        }
+    }
+    _messages.push_back({ std::move(message), isCameraKeyframe });
+
+    if (_isFlushScheduled || !canSendNext()) {
+        return false;
+    }
+    _isFlushScheduled = true;
+    return true;
+}
+
+bool MessageOutbox::acknowledgeKeyframe() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _nKeyframesInFlight = std::max(_nKeyframesInFlight - 1, 0);
+
+    if (_isFlushScheduled || !canSendNext()) {
+        return false;
+    }
+    _isFlushScheduled = true;
+    return true;
+}
+
+void MessageOutbox::flush() {
+    while (true) {
+        Entry entry;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!canSendNext()) {
+                // The waiting keyframe is sent by the flush that follows the next
+                // acknowledgement
+                _isFlushScheduled = false;
+                return;
+            }
+            entry = std::move(_messages.front());
+            _messages.pop_front();
+            if (entry.isCameraKeyframe) {
+                ++_nKeyframesInFlight;
+            }
+        }
+        _send(*entry.message);
+    }
+}
+
+size_t MessageOutbox::nWaitingMessages() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _messages.size();
+}
+
+bool MessageOutbox::canSendNext() const {
+    if (_messages.empty()) {
+        return false;
+    }
+    return !_messages.front().isCameraKeyframe ||
+           _nKeyframesInFlight < _maxKeyframesInFlight;
+}
+
+} // namespace openspace
@@ -37,7 +37,7 @@ namespace {
 
 namespace openspace {
 
-const unsigned int ParallelConnection::ProtocolVersion = 5;
+const unsigned int ParallelConnection::ProtocolVersion = 7;
 
 ParallelConnection::Message::Message(MessageType t, std::vector<char> c)
     : type(t)
@@ -65,61 +65,79 @@ bool ParallelConnection::isConnectedOrConnecting() const {
 }
 
 void ParallelConnection::sendDataMessage(const DataMessage& dataMessage) {
-    const uint32_t dataMessageTypeOut = static_cast<uint32_t>(dataMessage.type);
-    const double dataMessageTimestamp = dataMessage.timestamp;
+    sendDataMessage(dataMessage.type, dataMessage.timestamp, dataMessage.content);
+}
+
+void ParallelConnection::sendDataMessage(datamessagestructures::Type type,
+                                         double timestamp,
+                                         const std::vector<char>& content)
+{
+    const uint32_t dataMessageTypeOut = static_cast<uint32_t>(type);
+    const uint32_t messageSize = static_cast<uint32_t>(
+        sizeof(uint32_t) + sizeof(double) + content.size()
+    );
+
+    // The whole message is assembled in the reused send buffer
+    _sendBuffer.clear();
+    appendHeader(_sendBuffer, MessageType::Data, messageSize);
 
-    std::vector<char> messageContent;
-    messageContent.insert(
-        messageContent.end(),
+    _sendBuffer.insert(
+        _sendBuffer.end(),
         reinterpret_cast<const char*>(&dataMessageTypeOut),
         reinterpret_cast<const char*>(&dataMessageTypeOut) + sizeof(uint32_t)
     );
 
-    messageContent.insert(
-        messageContent.end(),
-        reinterpret_cast<const char*>(&dataMessageTimestamp),
-        reinterpret_cast<const char*>(&dataMessageTimestamp) + sizeof(double)
+    _sendBuffer.insert(
+        _sendBuffer.end(),
+        reinterpret_cast<const char*>(&timestamp),
+        reinterpret_cast<const char*>(&timestamp) + sizeof(double)
     );
 
-    messageContent.insert(messageContent.end(),
-        dataMessage.content.begin(),
-        dataMessage.content.end()
-    );
+    _sendBuffer.insert(_sendBuffer.end(), content.begin(), content.end());
 
-    sendMessage(Message(MessageType::Data, messageContent));
+    sendEncodedMessage(_sendBuffer);
 }
 
 bool ParallelConnection::sendMessage(const Message& message) {
-    const uint32_t messageTypeOut = static_cast<uint32_t>(message.type);
-    const uint32_t messageSizeOut = static_cast<uint32_t>(message.content.size());
-    std::vector<char> header;
+    return sendEncodedMessage(encodeMessage(message));
+}
+
+void ParallelConnection::appendHeader(std::vector<char>& buffer, MessageType type,
+                                      uint32_t messageSize)
+{
+    const uint32_t messageTypeOut = static_cast<uint32_t>(type);
 
-    //insert header into buffer
-    header.push_back('O');
-    header.push_back('S');
+    buffer.push_back('O');
+    buffer.push_back('S');
 
-    header.insert(header.end(),
+    buffer.insert(buffer.end(),
         reinterpret_cast<const char*>(&ProtocolVersion),
         reinterpret_cast<const char*>(&ProtocolVersion) + sizeof(uint32_t)
     );
 
-    header.insert(header.end(),
+    buffer.insert(buffer.end(),
         reinterpret_cast<const char*>(&messageTypeOut),
         reinterpret_cast<const char*>(&messageTypeOut) + sizeof(uint32_t)
     );
 
-    header.insert(header.end(),
-        reinterpret_cast<const char*>(&messageSizeOut),
-        reinterpret_cast<const char*>(&messageSizeOut) + sizeof(uint32_t)
+    buffer.insert(buffer.end(),
+        reinterpret_cast<const char*>(&messageSize),
+        reinterpret_cast<const char*>(&messageSize) + sizeof(uint32_t)
     );
+}
 
-    if (!_socket->put<char>(header.data(), header.size())) {
-        return false;
-    }
-    if (!_socket->put<char>(message.content.data(), message.content.size())) {
-        return false;
-    }
-    return true;
+std::vector<char> ParallelConnection::encodeMessage(const Message& message) {
+    const uint32_t messageSizeOut = static_cast<uint32_t>(message.content.size());
+    std::vector<char> buffer;
+    buffer.reserve(HeaderSize + message.content.size());
+
+    appendHeader(buffer, message.type, messageSizeOut);
+    buffer.insert(buffer.end(), message.content.begin(), message.content.end());
+    return buffer;
+}
+
+bool ParallelConnection::sendEncodedMessage(const std::vector<char>& encodedMessage) {
+    return _socket->put<char>(encodedMessage.data(), encodedMessage.size());
 }
 
 void ParallelConnection::disconnect() {
@@ -133,11 +151,6 @@ ghoul::io::TcpSocket* ParallelConnection::socket() {
 }
 
 ParallelConnection::Message ParallelConnection::receiveMessage() {
-    // Header consists of...
-    constexpr size_t HeaderSize =
-        2 * sizeof(char) + // OS
-        3 * sizeof(uint32_t); // Protocol version, message type and message size
-
     // Create basic buffer for receiving first part of messages
     std::vector<char> headerBuffer(HeaderSize);
     std::vector<char> messageBuffer;
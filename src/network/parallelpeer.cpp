@@ -223,6 +223,14 @@ void ParallelPeer::handleMessage(const ParallelConnection::Message& message) {
     }
 }
 
+void ParallelPeer::acknowledgeKeyframe() {
+    // The server holds back further camera keyframes until earlier ones are acknowledged
+    _connection.sendMessage(ParallelConnection::Message(
+        ParallelConnection::MessageType::KeyframeAcknowledgement,
+        std::vector<char>()
+    ));
+}
+
 void ParallelPeer::analyzeTimeDifference(double messageTimestamp) {
     std::lock_guard<std::mutex> latencyLock(_latencyMutex);
 
@@ -279,22 +287,23 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message)
 
     switch (static_cast<datamessagestructures::Type>(type)) {
         case datamessagestructures::Type::CameraData: {
-            datamessagestructures::CameraKeyframe kf(buffer);
-            const double convertedTimestamp = convertTimestamp(kf._timestamp);
-
-            global::navigationHandler.keyframeNavigator().removeKeyframesAfter(
-                convertedTimestamp
-            );
-
-            interaction::KeyframeNavigator::CameraPose pose;
-            pose.focusNode = kf._focusNode;
-            pose.position = kf._position;
-            pose.rotation = kf._rotation;
-            pose.scale = kf._scale;
-            pose.followFocusNodeRotation = kf._followNodeRotation;
-
-            global::navigationHandler.keyframeNavigator().addKeyframe(convertedTimestamp,
-                                                                      pose);
+            acknowledgeKeyframe();
+            cameraKeyframeReceived(datamessagestructures::CameraKeyframe(buffer));
+            break;
+        }
+        case datamessagestructures::Type::CameraReference: {
+            if (!_cameraDecoder.decodeReference(buffer)) {
+                LERROR("Malformed camera reference message.");
+            }
+            break;
+        }
+        case datamessagestructures::Type::CompactCameraData: {
+            acknowledgeKeyframe();
+            datamessagestructures::CameraKeyframe kf;
+            // Keyframes that arrive before the first camera reference are skipped
+            if (_cameraDecoder.decode(buffer, kf)) {
+                cameraKeyframeReceived(kf);
+            }
             break;
         }
         case datamessagestructures::Type::TimelineData: {
@@ -362,6 +371,24 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message)
     }
 }
 
+void ParallelPeer::cameraKeyframeReceived(const datamessagestructures::CameraKeyframe& kf)
+{
+    const double convertedTimestamp = convertTimestamp(kf._timestamp);
+
+    global::navigationHandler.keyframeNavigator().removeKeyframesAfter(
+        convertedTimestamp
+    );
+
+    interaction::KeyframeNavigator::CameraPose pose;
+    pose.focusNode = kf._focusNode;
+    pose.position = kf._position;
+    pose.rotation = kf._rotation;
+    pose.scale = kf._scale;
+    pose.followFocusNodeRotation = kf._followNodeRotation;
+
+    global::navigationHandler.keyframeNavigator().addKeyframe(convertedTimestamp, pose);
+}
+
 void ParallelPeer::connectionStatusMessageReceived(const std::vector<char>& message)
  {
     if (message.size() < 2 * sizeof(uint32_t)) {
@@ -406,6 +433,10 @@ void ParallelPeer::connectionStatusMessageReceived(const std::vector<char>& mess
 
     setStatus(status);
 
+    // A new host starts with its own camera references
+    _cameraEncoder.reset();
+    _cameraDecoder.reset();
+
     global::navigationHandler.keyframeNavigator().clearKeyframes();
     global::timeManager.clearKeyframes();
 }
@@ -417,6 +448,10 @@ void ParallelPeer::nConnectionsMessageReceived(const std::vector<char>& message)
         return;
     }
     const uint32_t nConnections = *(reinterpret_cast<const uint32_t*>(&message[0]));
+    if (nConnections != _nConnections) {
+        // Peers that just joined do not know the focus nodes and the camera reference
+        _cameraEncoder.reset();
+    }
     setNConnections(nConnections);
 }
 
@@ -610,19 +645,26 @@ void ParallelPeer::sendCameraKeyframe() {
     // Timestamp as current runtime of OpenSpace instance
     kf._timestamp = global::windowDelegate.applicationTime();
 
-    // Create a buffer for the keyframe
-    std::vector<char> buffer;
-
-    // Fill the keyframe buffer
-    kf.serialize(buffer);
-
     const double timestamp = global::windowDelegate.applicationTime();
-    // Send message
-    _connection.sendDataMessage(ParallelConnection::DataMessage(
-        datamessagestructures::Type::CameraData,
+
+    // The buffers are reused between keyframes
+    const bool hasNewReference = _cameraEncoder.encode(
+        kf,
+        _cameraReferenceBuffer,
+        _cameraKeyframeBuffer
+    );
+    if (hasNewReference) {
+        _connection.sendDataMessage(
+            datamessagestructures::Type::CameraReference,
+            timestamp,
+            _cameraReferenceBuffer
+        );
+    }
+    _connection.sendDataMessage(
+        datamessagestructures::Type::CompactCameraData,
         timestamp,
-        buffer
-    ));
+        _cameraKeyframeBuffer
+    );
 }
 
 void ParallelPeer::sendTimeTimeline() {
@@ -27,7 +27,9 @@
 #include <ghoul/fmt.h>
 #include <ghoul/io/socket/tcpsocket.h>
 #include <ghoul/logging/logmanager.h>
+#include <cstring>
 #include <functional>
+#include <limits>
 
 // @TODO(abock): In the entire class remove std::shared_ptr<Peer> by const Peer& where
 //               possible to simplify the interface
@@ -72,12 +74,23 @@ void ParallelServer::handleNewPeers() {
         socket->startStreams();
 
         const size_t id = _nextConnectionId++;
+        std::shared_ptr<ParallelConnection> connection =
+            std::make_shared<ParallelConnection>(std::move(socket));
+        std::shared_ptr<MessageOutbox> outbox = std::make_shared<MessageOutbox>(
+            [connection](const std::vector<char>& message) {
+                if (connection->isConnectedOrConnecting()) {
+                    connection->sendEncodedMessage(message);
+                }
+            },
+            _nDroppedKeyframes
+        );
         std::shared_ptr<Peer> p = std::make_shared<Peer>(Peer{
             id,
             "",
-            ParallelConnection(std::move(socket)),
+            std::move(connection),
             ParallelConnection::Status::Connecting,
-            std::thread()
+            std::thread(),
+            std::move(outbox)
         });
         auto it = _peers.emplace(p->id, p);
         it.first->second->thread = std::thread([this, id]() {
@@ -102,11 +115,11 @@ void ParallelServer::handlePeer(size_t id) {
             return;
         }
 
-        if (!p->parallelConnection.isConnectedOrConnecting()) {
+        if (!p->parallelConnection->isConnectedOrConnecting()) {
             return;
         }
         try {
-            ParallelConnection::Message m = p->parallelConnection.receiveMessage();
+            ParallelConnection::Message m = p->parallelConnection->receiveMessage();
             _incomingMessages.push({id, m});
         } catch (const ParallelConnection::ConnectionLostError&) {
             LERROR(fmt::format("Connection lost to {}", p->id));
@@ -155,6 +168,9 @@ void ParallelServer::handlePeerMessage(PeerMessage peerMessage) {
         case ParallelConnection::MessageType::Disconnection:
             disconnect(*peer);
             break;
+        case ParallelConnection::MessageType::KeyframeAcknowledgement:
+            handleKeyframeAcknowledgement(*peer);
+            break;
         default:
             LERROR(fmt::format(
                 "Unsupported message type: {}", static_cast<int>(messageType)
@@ -200,7 +216,7 @@ void ParallelServer::handleAuthentication(std::shared_ptr<Peer> peer,
         defaultHostAddress = _defaultHostAddress;
     }
     if (_hostPeerId == 0 &&
-        peer->parallelConnection.socket()->address() == defaultHostAddress)
+        peer->parallelConnection->socket()->address() == defaultHostAddress)
     {
         // Directly promote the conenction to host (initialize)
         // if there is no host, and ip matches default host ip.
@@ -223,9 +239,33 @@ void ParallelServer::handleData(const Peer& peer, std::vector<char> data) {
         LINFO(fmt::format(
             "Connection {} tried to send data without being the host. Ignoring", peer.id
         ));
+        return;
     }
-    sendMessageToClients(ParallelConnection::MessageType::Data, data);
 
+    // Data messages start with their datamessagestructures::Type
+    uint32_t dataType = std::numeric_limits<uint32_t>::max();
+    if (data.size() >= sizeof(uint32_t)) {
+        std::memcpy(&dataType, data.data(), sizeof(uint32_t));
+    }
+    using datamessagestructures::Type;
+    const bool isCameraKeyframe =
+        dataType == static_cast<uint32_t>(Type::CameraData) ||
+        dataType == static_cast<uint32_t>(Type::CompactCameraData);
+
+    // The message is encoded once and the same buffer is sent to all clients
+    EncodedMessage message = std::make_shared<const std::vector<char>>(
+        ParallelConnection::encodeMessage(
+            ParallelConnection::Message(
+                ParallelConnection::MessageType::Data,
+                std::move(data)
+            )
+        )
+    );
+    for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
+        if (it.second->status == ParallelConnection::Status::ClientWithHost) {
+            queueMessage(*it.second, message, isCameraKeyframe);
+        }
+    }
 }
 
 void ParallelServer::handleHostshipRequest(std::shared_ptr<Peer> peer,
@@ -272,6 +312,12 @@ void ParallelServer::handleHostshipResignation(Peer& peer) {
     LINFO(fmt::format("Connection {} resigned as host.", peer.id));
 }
 
+void ParallelServer::handleKeyframeAcknowledgement(Peer& peer) {
+    if (peer.outbox->acknowledgeKeyframe()) {
+        scheduleFlush(peer.outbox);
+    }
+}
+
 bool ParallelServer::isConnected(const Peer& peer) const {
     return peer.status != ParallelConnection::Status::Connecting &&
            peer.status != ParallelConnection::Status::Disconnected;
@@ -281,29 +327,42 @@ void ParallelServer::sendMessage(Peer& peer,
                                  ParallelConnection::MessageType messageType,
                                  const std::vector<char>& message)
 {
-    peer.parallelConnection.sendMessage({ messageType, message });
+    queueMessage(
+        peer,
+        std::make_shared<const std::vector<char>>(
+            ParallelConnection::encodeMessage({ messageType, message })
+        ),
+        false
+    );
 }
 
 void ParallelServer::sendMessageToAll(ParallelConnection::MessageType messageType,
                                       const std::vector<char>& message)
 {
+    EncodedMessage encoded = std::make_shared<const std::vector<char>>(
+        ParallelConnection::encodeMessage({ messageType, message })
+    );
     for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
         if (isConnected(*it.second)) {
-            it.second->parallelConnection.sendMessage({ messageType, message });
+            queueMessage(*it.second, encoded, false);
         }
     }
 }
 
-void ParallelServer::sendMessageToClients(ParallelConnection::MessageType messageType,
-                                          const std::vector<char>& message)
+void ParallelServer::queueMessage(Peer& peer, EncodedMessage message,
+                                  bool isCameraKeyframe)
 {
-    for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
-        if (it.second->status == ParallelConnection::Status::ClientWithHost) {
-            it.second->parallelConnection.sendMessage({ messageType, message });
-        }
+    if (peer.outbox->push(std::move(message), isCameraKeyframe)) {
+        scheduleFlush(peer.outbox);
     }
 }
 
+void ParallelServer::scheduleFlush(std::shared_ptr<MessageOutbox> outbox) {
+    // The outbox only asks for a flush if none is pending, so only one flush task per
+    // peer is in flight at any time, which keeps the messages of each peer in order
+    _sendScheduler.enqueue([o = std::move(outbox)]() { o->flush(); });
+}
+
 void ParallelServer::disconnect(Peer& peer) {
     if (isConnected(peer)) {
         setNConnections(nConnections() - 1);
@@ -321,7 +380,7 @@ void ParallelServer::disconnect(Peer& peer) {
         setToClient(peer);
     }
 
-    peer.parallelConnection.disconnect();
+    peer.parallelConnection->disconnect();
     peer.thread.join();
     _peers.erase(peer.id);
 }
@@ -431,4 +490,8 @@ size_t ParallelServer::nConnections() const {
     return _nConnections;
 }
 
+size_t ParallelServer::nDroppedKeyframes() const {
+    return _nDroppedKeyframes;
+}
+
 } // namespace openspace
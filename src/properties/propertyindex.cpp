@@ -0,0 +1,179 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/properties/propertyindex.h>
+
+#include <openspace/properties/property.h>
+#include <openspace/properties/propertyowner.h>
+#include <algorithm>
+
+namespace {
+    bool startsWith(const std::string& s, const std::string& prefix) {
+        return s.compare(0, prefix.size(), prefix) == 0;
+    }
+} // namespace
+
+namespace openspace::properties {
+
+void PropertyIndex::addProperty(Property* prop) {
+    std::string uri = prop->fullyQualifiedIdentifier();
+    const bool inserted = _properties.emplace(uri, prop).second;
+    if (inserted) {
+        _sortedUris.emplace(uri, prop);
+        std::reverse(uri.begin(), uri.end());
+        _sortedReversedUris.emplace(std::move(uri), prop);
+    }
+}
+
+void PropertyIndex::removeProperty(Property* prop) {
+    std::string uri = prop->fullyQualifiedIdentifier();
+    const auto it = _properties.find(uri);
+    if (it == _properties.end() || it->second != prop) {
+        return;
+    }
+
+    _properties.erase(it);
+    _sortedUris.erase(uri);
+    std::reverse(uri.begin(), uri.end());
+    _sortedReversedUris.erase(uri);
+}
+
+void PropertyIndex::addPropertyOwner(const PropertyOwner& owner) {
+    for (Property* prop : owner.properties()) {
+        addProperty(prop);
+    }
+    for (PropertyOwner* subOwner : owner.propertySubOwners()) {
+        addPropertyOwner(*subOwner);
+    }
+}
+
+void PropertyIndex::removePropertyOwner(const PropertyOwner& owner) {
+    for (Property* prop : owner.properties()) {
+        removeProperty(prop);
+    }
+    for (PropertyOwner* subOwner : owner.propertySubOwners()) {
+        removePropertyOwner(*subOwner);
+    }
+}
+
+Property* PropertyIndex::property(const std::string& uri) const {
+    const auto it = _properties.find(uri);
+    return it != _properties.end() ? it->second : nullptr;
+}
+
+std::vector<Property*> PropertyIndex::matches(const std::string& pattern) const {
+    const size_t firstWildcard = pattern.find('*');
+    if (firstWildcard == std::string::npos) {
+        Property* prop = property(pattern);
+        return prop ? std::vector<Property*>{ prop } : std::vector<Property*>();
+    }
+
+    const std::string prefix = pattern.substr(0, firstWildcard);
+    std::string suffix = pattern.substr(pattern.rfind('*') + 1);
+    std::reverse(suffix.begin(), suffix.end());
+
+    // All matching URIs start with the prefix and end with the suffix, so each of them
+    // selects a contiguous range of candidates in the respective sorted map. We advance
+    // through both ranges in lockstep to find the smaller one without having to walk the
+    // larger one to its end
+    const auto prefixBegin = _sortedUris.lower_bound(prefix);
+    const auto suffixBegin = _sortedReversedUris.lower_bound(suffix);
+    auto prefixIt = prefixBegin;
+    auto suffixIt = suffixBegin;
+    while (true) {
+        if (prefixIt == _sortedUris.end() || !startsWith(prefixIt->first, prefix)) {
+            break;
+        }
+        if (suffixIt == _sortedReversedUris.end() ||
+            !startsWith(suffixIt->first, suffix))
+        {
+            break;
+        }
+        ++prefixIt;
+        ++suffixIt;
+    }
+
+    std::vector<Property*> result;
+    const bool isPrefixSmaller = prefixIt == _sortedUris.end() ||
+                                 !startsWith(prefixIt->first, prefix);
+    if (isPrefixSmaller) {
+        for (auto it = prefixBegin; it != prefixIt; ++it) {
+            if (matchesPattern(it->first, pattern)) {
+                result.push_back(it->second);
+            }
+        }
+    }
+    else {
+        // A pattern matches a URI if and only if the reversed pattern matches the
+        // reversed URI
+        std::string reversedPattern = pattern;
+        std::reverse(reversedPattern.begin(), reversedPattern.end());
+        for (auto it = suffixBegin; it != suffixIt; ++it) {
+            if (matchesPattern(it->first, reversedPattern)) {
+                result.push_back(it->second);
+            }
+        }
+    }
+    return result;
+}
+
+size_t PropertyIndex::size() const {
+    return _properties.size();
+}
+
+bool PropertyIndex::matchesPattern(std::string_view uri, std::string_view pattern) {
+    // Greedy matching that, on a mismatch, only backtracks to the most recent wildcard.
+    // This is sufficient as an earlier wildcard can never be required to consume more
+    // characters than the most recent one
+    constexpr const size_t NoWildcard = std::string_view::npos;
+    size_t u = 0;
+    size_t p = 0;
+    size_t wildcard = NoWildcard;
+    size_t wildcardUri = 0;
+    while (u < uri.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            wildcard = p;
+            wildcardUri = u;
+            ++p;
+        }
+        else if (p < pattern.size() && pattern[p] == uri[u]) {
+            ++p;
+            ++u;
+        }
+        else if (wildcard != NoWildcard) {
+            p = wildcard + 1;
+            ++wildcardUri;
+            u = wildcardUri;
+        }
+        else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+} // namespace openspace::properties
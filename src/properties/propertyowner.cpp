@@ -25,6 +25,7 @@
 #include <openspace/properties/propertyowner.h>
 
 #include <openspace/properties/property.h>
+#include <openspace/properties/propertyindex.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
@@ -163,6 +164,26 @@ bool PropertyOwner::hasPropertySubOwner(const std::string& identifier) const {
     return propertySubOwner(identifier) != nullptr;
 }
 
+void PropertyOwner::setPropertyIndex(PropertyIndex* index) {
+    ghoul_precondition(_owner == nullptr, "PropertyOwner must not have an owner");
+
+    if (_propertyIndex) {
+        _propertyIndex->removePropertyOwner(*this);
+    }
+    _propertyIndex = index;
+    if (_propertyIndex) {
+        _propertyIndex->addPropertyOwner(*this);
+    }
+}
+
+PropertyIndex* PropertyOwner::propertyIndex() const {
+    const PropertyOwner* root = this;
+    while (root->_owner) {
+        root = root->_owner;
+    }
+    return root->_propertyIndex;
+}
+
 void PropertyOwner::setPropertyGroupName(std::string groupID, std::string identifier) {
     _groupNames[std::move(groupID)] = std::move(identifier);
 }
@@ -212,6 +233,9 @@ void PropertyOwner::addProperty(Property* prop) {
         else {
             _properties.push_back(prop);
             prop->setPropertyOwner(this);
+            if (PropertyIndex* index = propertyIndex()) {
+                index->addProperty(prop);
+            }
         }
     }
 }
@@ -256,6 +280,9 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
         else {
             _subOwners.push_back(owner);
             owner->setPropertyOwner(this);
+            if (PropertyIndex* index = propertyIndex()) {
+                index->addPropertyOwner(*owner);
+            }
         }
     }
 }
@@ -276,6 +303,9 @@ void PropertyOwner::removeProperty(Property* prop) {
 
     // If we found the property identifier, we can delete it
     if (it != _properties.end() && (*it)->identifier() == prop->identifier()) {
+        if (PropertyIndex* index = propertyIndex()) {
+            index->removeProperty(*it);
+        }
         (*it)->setPropertyOwner(nullptr);
         _properties.erase(it);
     } else {
@@ -303,6 +333,10 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner*
 
     // If we found the propertyowner, we can delete it
     if (it != _subOwners.end() && (*it)->identifier() == owner->identifier()) {
+        if (PropertyIndex* index = propertyIndex()) {
+            index->removePropertyOwner(**it);
+        }
+        (*it)->setPropertyOwner(nullptr);
         _subOwners.erase(it);
     } else {
         LERROR(fmt::format(
@@ -325,7 +359,16 @@ void PropertyOwner::setIdentifier(std::string identifier) {
         "Identifier must contain any whitespaces"
     );
 
+    // The fully qualified identifiers of all Propertys in this subtree change with the
+    // identifier, so they have to be reindexed
+    PropertyIndex* index = propertyIndex();
+    if (index) {
+        index->removePropertyOwner(*this);
+    }
     _identifier = std::move(identifier);
+    if (index) {
+        index->addPropertyOwner(*this);
+    }
 }
 
 const std::string& PropertyOwner::identifier() const {
@@ -26,6 +26,8 @@
 
 #include <openspace/engine/globals.h>
 #include <openspace/engine/virtualpropertymanager.h>
+#include <openspace/properties/property.h>
+#include <openspace/properties/propertyindex.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
 
@@ -46,7 +48,7 @@ const Renderable* renderable(const std::string& name) {
 }
 
 properties::Property* property(const std::string& uri) {
-    properties::Property* property = global::rootPropertyOwner.property(uri);
+    properties::Property* property = global::propertyIndex.property(uri);
     return property;
 }
 
@@ -68,4 +70,19 @@ std::vector<properties::Property*> allProperties() {
     return properties;
 }
 
+std::vector<properties::Property*> matchingProperties(const std::string& uriPattern) {
+    std::vector<properties::Property*> properties =
+        global::propertyIndex.matches(uriPattern);
+
+    // The few virtual properties are not part of the index, see allProperties
+    for (properties::Property* p : global::virtualPropertyManager.properties()) {
+        const std::string& id = p->fullyQualifiedIdentifier();
+        if (properties::PropertyIndex::matchesPattern(id, uriPattern)) {
+            properties.push_back(p);
+        }
+    }
+
+    return properties;
+}
+
 }  // namespace
@@ -84,17 +84,29 @@ bool Rotation::initialize() {
     return true;
 }
 
+bool Rotation::readsOtherNodes() const {
+    return false;
+}
+
 const glm::dmat3& Rotation::matrix() const {
     return _cachedMatrix;
 }
 
-void Rotation::update(const UpdateData& data) {
-    if (!_needsUpdate && (data.time.j2000Seconds() == _cachedTime)) {
-        return;
+bool Rotation::update(const UpdateData& data) {
+    if (!_needsUpdate &&
+        (!isTimeDependent() || data.time.j2000Seconds() == _cachedTime))
+    {
+        return false;
     }
+    const glm::dmat3 oldMatrix = _cachedMatrix;
     _cachedMatrix = matrix(data);
     _cachedTime = data.time.j2000Seconds();
     _needsUpdate = false;
+    return oldMatrix != _cachedMatrix;
+}
+
+bool Rotation::isTimeDependent() const {
+    return true;
 }
 
 } // namespace openspace
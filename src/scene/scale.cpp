@@ -83,13 +83,25 @@ double Scale::scaleValue() const {
     return _cachedScale;
 }
 
-void Scale::update(const UpdateData& data) {
-    if (!_needsUpdate && data.time.j2000Seconds() == _cachedTime) {
-        return;
+bool Scale::update(const UpdateData& data) {
+    if (!_needsUpdate &&
+        (!isTimeDependent() || data.time.j2000Seconds() == _cachedTime))
+    {
+        return false;
     }
+    const double oldScale = _cachedScale;
     _cachedScale = scaleValue(data);
     _cachedTime = data.time.j2000Seconds();
     _needsUpdate = false;
+    return oldScale != _cachedScale;
+}
+
+bool Scale::isTimeDependent() const {
+    return true;
+}
+
+bool Scale::readsOtherNodes() const {
+    return false;
 }
 
 } // namespace openspace
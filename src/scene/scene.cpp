@@ -33,10 +33,12 @@
 #include <openspace/scene/sceneinitializer.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/camera.h>
+#include <openspace/util/taskscheduler.h>
 
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <algorithm>
 #include <string>
 #include <stack>
 
@@ -46,6 +48,11 @@ namespace {
     constexpr const char* _loggerCat = "Scene";
     constexpr const char* KeyIdentifier = "Identifier";
     constexpr const char* KeyParent = "Parent";
+
+    // Levels with fewer nodes are not worth the overhead of the task scheduler
+    constexpr const size_t MinimumNodesForConcurrentUpdate = 16;
+    // The number of nodes that are updated by a single task
+    constexpr const size_t NodesPerTask = 8;
 } // namespace
 
 namespace openspace {
@@ -121,6 +128,7 @@ void Scene::markNodeRegistryDirty() {
 
 void Scene::updateNodeRegistry() {
     sortTopologically();
+    computeDependencyLevels();
     _dirtyNodeRegistry = false;
 }
 
@@ -201,6 +209,45 @@ void Scene::sortTopologically() {
     _topologicallySortedNodes = nodes;
 }
 
+void Scene::computeDependencyLevels() {
+    _dependencyLevels.clear();
+
+    // As the nodes are sorted topologically, the levels of the parent and the
+    // dependencies of a node have already been computed when it is reached
+    std::unordered_map<SceneGraphNode*, size_t> levels;
+    for (SceneGraphNode* node : _topologicallySortedNodes) {
+        size_t level = 0;
+        if (node->parent()) {
+            level = levels[node->parent()] + 1;
+        }
+        for (SceneGraphNode* dependency : node->dependencies()) {
+            level = std::max(level, levels[dependency] + 1);
+        }
+        levels[node] = level;
+
+        if (level >= _dependencyLevels.size()) {
+            _dependencyLevels.resize(level + 1);
+        }
+        _dependencyLevels[level].push_back(node);
+    }
+
+    std::vector<TransformStore::Handle> order;
+    std::vector<TransformStore::Handle> parents;
+    order.reserve(_topologicallySortedNodes.size());
+    parents.reserve(_topologicallySortedNodes.size());
+    for (const std::vector<SceneGraphNode*>& nodes : _dependencyLevels) {
+        for (SceneGraphNode* node : nodes) {
+            order.push_back(node->transformHandle());
+            parents.push_back(
+                node->parent() ?
+                node->parent()->transformHandle() :
+                TransformStore::InvalidHandle
+            );
+        }
+    }
+    _transformStore.setLayout(order, parents);
+}
+
 void Scene::initializeNode(SceneGraphNode* node) {
     _initializer->initializeNode(node);
 }
@@ -291,10 +338,21 @@ void Scene::update(const UpdateData& data) {
     if (_dirtyNodeRegistry) {
         updateNodeRegistry();
     }
+
+    // The world transform of every node is computed before any node of the next level
+    // is updated, so parents and dependencies are always up to date. The levels occupy
+    // consecutive slots in the transform store
+    size_t firstSlot = 0;
+    for (const std::vector<SceneGraphNode*>& level : _dependencyLevels) {
+        updateTransforms(level, firstSlot, data);
+        firstSlot += level.size();
+    }
+
+    // Renderables might use OpenGL and are therefore updated on the main thread
     for (SceneGraphNode* node : _topologicallySortedNodes) {
         try {
             LTRACE("Scene::update(begin '" + node->identifier() + "')");
-            node->update(data);
+            node->updateRenderable(data);
             LTRACE("Scene::update(end '" + node->identifier() + "')");
         }
         catch (const ghoul::RuntimeError& e) {
@@ -303,6 +361,56 @@ void Scene::update(const UpdateData& data) {
     }
 }
 
+void Scene::updateTransforms(const std::vector<SceneGraphNode*>& nodes,
+                             size_t firstSlot, const UpdateData& data)
+{
+    auto updateTransform = [&data](SceneGraphNode* node) {
+        try {
+            node->updateTransform(data);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.what());
+        }
+    };
+
+    // The performance measurement synchronizes with the GPU around each update, which
+    // requires the update to happen on the main thread
+    if (data.doPerformanceMeasurement || nodes.size() < MinimumNodesForConcurrentUpdate) {
+        for (SceneGraphNode* node : nodes) {
+            if (node->canUpdateConcurrently()) {
+                updateTransform(node);
+            }
+        }
+    }
+    else {
+        TaskGroup group(global::taskScheduler);
+        for (size_t i = 0; i < nodes.size(); i += NodesPerTask) {
+            const size_t end = std::min(i + NodesPerTask, nodes.size());
+            group.run(
+                [&nodes, &updateTransform, i, end]() {
+                    for (size_t j = i; j < end; ++j) {
+                        if (nodes[j]->canUpdateConcurrently()) {
+                            updateTransform(nodes[j]);
+                        }
+                    }
+                },
+                TaskScheduler::Priority::High
+            );
+        }
+        group.wait();
+    }
+    _transformStore.composeWorldTransforms(firstSlot, firstSlot + nodes.size());
+
+    // These nodes read the world transforms of arbitrary other nodes. As all nodes of
+    // this level are finished and the next level has not started yet, they do not race
+    for (SceneGraphNode* node : nodes) {
+        if (!node->canUpdateConcurrently()) {
+            updateTransform(node);
+            _transformStore.composeWorldTransform(node->transformHandle());
+        }
+    }
+}
+
 void Scene::render(const RenderData& data, RendererTasks& tasks) {
     for (SceneGraphNode* node : _topologicallySortedNodes) {
         try {
@@ -325,6 +433,14 @@ const std::unordered_map<std::string, SceneGraphNode*>& Scene::nodesByIdentifier
     return _nodesByIdentifier;
 }
 
+TransformStore& Scene::transformStore() {
+    return _transformStore;
+}
+
+const TransformStore& Scene::transformStore() const {
+    return _transformStore;
+}
+
 SceneGraphNode* Scene::root() {
     return &_rootDummy;
 }
@@ -58,11 +58,11 @@ properties::PropertyOwner* findPropertyOwnerWithMatchingGroupTag(T* prop,
     return tagMatchOwner;
 }
 
-void applyRegularExpression(lua_State* L, const std::string& regex,
-                            const std::vector<properties::Property*>& properties,
-                            double interpolationDuration,
-                            const std::string& groupName,
-                            ghoul::EasingFunction easingFunction)
+void applyToMatchingProperties(lua_State* L, const std::string& uri,
+                               const std::vector<properties::Property*>& properties,
+                               double interpolationDuration,
+                               const std::string& groupName,
+                               ghoul::EasingFunction easingFunction)
 {
     using ghoul::lua::errorLocation;
     using ghoul::lua::luaTypeToString;
@@ -74,52 +74,45 @@ void applyRegularExpression(lua_State* L, const std::string& regex,
     // Stores whether we found at least one matching property. If this is false at the end
     // of the loop, the property name regex was probably misspelled.
     bool foundMatching = false;
-    std::regex r(regex);
     for (properties::Property* prop : properties) {
-        // Check the regular expression for all properties
-        const std::string& id = prop->fullyQualifiedIdentifier();
-
-        if (std::regex_match(id, r)) {
-            // If the fully qualified id matches the regular expression, we queue the
-            // value change if the types agree
-            if (isGroupMode) {
-                properties::PropertyOwner* matchingTaggedOwner =
-                    findPropertyOwnerWithMatchingGroupTag(
-                        prop,
-                        groupName
-                    );
-                if (!matchingTaggedOwner) {
-                    continue;
-                }
+        // We queue the value change if the types agree
+        if (isGroupMode) {
+            properties::PropertyOwner* matchingTaggedOwner =
+                findPropertyOwnerWithMatchingGroupTag(
+                    prop,
+                    groupName
+                );
+            if (!matchingTaggedOwner) {
+                continue;
             }
+        }
 
-            if (type != prop->typeLua()) {
-                LERRORC(
-                    "property_setValue",
-                    fmt::format(
-                        "{}: Property '{}' does not accept input of type '{}'. "
-                        "Requested type: '{}'",
-                        errorLocation(L),
-                        prop->fullyQualifiedIdentifier(),
-                        luaTypeToString(type),
-                        luaTypeToString(prop->typeLua())
-                    )
+        if (type != prop->typeLua()) {
+            LERRORC(
+                "property_setValue",
+                fmt::format(
+                    "{}: Property '{}' does not accept input of type '{}'. "
+                    "Requested type: '{}'",
+                    errorLocation(L),
+                    prop->fullyQualifiedIdentifier(),
+                    luaTypeToString(type),
+                    luaTypeToString(prop->typeLua())
+                )
+            );
+        } else {
+            foundMatching = true;
+
+            if (interpolationDuration == 0.0) {
+                global::renderEngine.scene()->removePropertyInterpolation(prop);
+                prop->setLuaValue(L);
+            }
+            else {
+                prop->setLuaInterpolationTarget(L);
+                global::renderEngine.scene()->addPropertyInterpolation(
+                    prop,
+                    static_cast<float>(interpolationDuration),
+                    easingFunction
                 );
-            } else {
-                foundMatching = true;
-
-                if (interpolationDuration == 0.0) {
-                    global::renderEngine.scene()->removePropertyInterpolation(prop);
-                    prop->setLuaValue(L);
-                }
-                else {
-                    prop->setLuaInterpolationTarget(L);
-                    global::renderEngine.scene()->addPropertyInterpolation(
-                        prop,
-                        static_cast<float>(interpolationDuration),
-                        easingFunction
-                    );
-                }
             }
         }
     }
@@ -130,12 +123,37 @@ void applyRegularExpression(lua_State* L, const std::string& regex,
             fmt::format(
                 "{}: No property matched the requested URI '{}'",
                 errorLocation(L),
-                regex
+                uri
             )
         );
     }
 }
 
+void applyRegularExpression(lua_State* L, const std::string& regex,
+                            const std::vector<properties::Property*>& properties,
+                            double interpolationDuration,
+                            const std::string& groupName,
+                            ghoul::EasingFunction easingFunction)
+{
+    std::regex r(regex);
+    std::vector<properties::Property*> matches;
+    for (properties::Property* prop : properties) {
+        // Check the regular expression for all properties
+        if (std::regex_match(prop->fullyQualifiedIdentifier(), r)) {
+            matches.push_back(prop);
+        }
+    }
+
+    applyToMatchingProperties(
+        L,
+        regex,
+        matches,
+        interpolationDuration,
+        groupName,
+        easingFunction
+    );
+}
+
 // Checks to see if URI contains a group tag (with { } around the first term). If so,
 // returns true and sets groupName with the tag
 bool doesUriContainGroupTag(const std::string& command, std::string& groupName) {
@@ -150,12 +168,7 @@ bool doesUriContainGroupTag(const std::string& command, std::string& groupName)
 
 std::string replaceUriWithGroupName(std::string uri, std::string ownerName) {
     size_t pos = uri.find_first_of(".");
-    return ownerName + "." + uri.substr(pos);
-}
-
-std::string extractUriWithoutGroupName(std::string uri) {
-    size_t pos = uri.find_first_of(".");
-    return uri.substr(pos);
+    return ownerName + uri.substr(pos);
 }
 
 } // namespace
@@ -272,39 +285,20 @@ int property_setValue(lua_State* L) {
     }
 
     if (optimization.empty()) {
-        // Replace all wildcards * with the correct regex (.*)
-        size_t startPos = uriOrRegex.find("*");
-        while (startPos != std::string::npos) {
-            uriOrRegex.replace(startPos, 1, "(.*)");
-            startPos += 4; // (.*)
-            startPos = uriOrRegex.find("*", startPos);
-        }
-
         std::string groupName;
         if (doesUriContainGroupTag(uriOrRegex, groupName)) {
-            std::string pathRemainderToMatch = extractUriWithoutGroupName(uriOrRegex);
-            // Remove group name from start of regex and replace with '.*'
-            uriOrRegex = replaceUriWithGroupName(uriOrRegex, ".*");
+            // Remove group name from start of the URI and replace with a wildcard
+            uriOrRegex = replaceUriWithGroupName(uriOrRegex, "*");
         }
 
-        try {
-            applyRegularExpression(
-                L,
-                uriOrRegex,
-                allProperties(),
-                interpolationDuration,
-                groupName,
-                easingMethod
-            );
-        }
-        catch (const std::regex_error& e) {
-            LERRORC(
-                "property_setValue",
-                fmt::format(
-                    "Malformed regular expression: '{}': {}", uriOrRegex, e.what()
-                )
-            );
-        }
+        applyToMatchingProperties(
+            L,
+            uriOrRegex,
+            matchingProperties(uriOrRegex),
+            interpolationDuration,
+            groupName,
+            easingMethod
+        );
         return 0;
     }
     else if (optimization == "regex") {
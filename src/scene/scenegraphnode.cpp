@@ -49,6 +49,9 @@ namespace {
 
     constexpr const char* KeyTimeFrame = "TimeFrame";
 
+    // Returned for nodes that are not part of a scene and thus have no transform
+    const glm::dmat3 IdentityRotation = glm::dmat3(1.0);
+
     constexpr openspace::properties::Property::PropertyInfo GuiPathInfo = {
         "GuiPath",
         "Gui Path",
@@ -309,6 +312,14 @@ void SceneGraphNode::traversePostOrder(const std::function<void(SceneGraphNode*)
 }
 
 void SceneGraphNode::update(const UpdateData& data) {
+    updateTransform(data);
+    if (_transformHandle != TransformStore::InvalidHandle) {
+        _scene->transformStore().composeWorldTransform(_transformHandle);
+    }
+    updateRenderable(data);
+}
+
+void SceneGraphNode::updateTransform(const UpdateData& data) {
     State s = _state;
     if (s != State::Initialized && _state != State::GLInitialized) {
         return;
@@ -317,19 +328,21 @@ void SceneGraphNode::update(const UpdateData& data) {
         return;
     }
 
+    // Only changed local transforms invalidate the world transforms of the subtree
+    bool hasChanged = false;
     if (_transform.translation) {
         if (data.doPerformanceMeasurement) {
             glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
-            _transform.translation->update(data);
+            hasChanged |= _transform.translation->update(data);
 
             glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeTranslation = (end - start).count();
         }
         else {
-            _transform.translation->update(data);
+            hasChanged |= _transform.translation->update(data);
         }
     }
 
@@ -338,14 +351,14 @@ void SceneGraphNode::update(const UpdateData& data) {
             glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
-            _transform.rotation->update(data);
+            hasChanged |= _transform.rotation->update(data);
 
             glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeRotation = (end - start).count();
         }
         else {
-            _transform.rotation->update(data);
+            hasChanged |= _transform.rotation->update(data);
         }
     }
 
@@ -354,44 +367,41 @@ void SceneGraphNode::update(const UpdateData& data) {
             glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
-            _transform.scale->update(data);
+            hasChanged |= _transform.scale->update(data);
 
             glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeScaling = (end - start).count();
         }
         else {
-            _transform.scale->update(data);
+            hasChanged |= _transform.scale->update(data);
         }
     }
-    UpdateData newUpdateData = data;
 
-    _worldRotationCached = calculateWorldRotation();
-    _worldScaleCached = calculateWorldScale();
-    // Assumes _worldRotationCached and _worldScaleCached have been calculated for parent
-    _worldPositionCached = calculateWorldPosition();
+    if (hasChanged && _transformHandle != TransformStore::InvalidHandle) {
+        _scene->transformStore().setLocalTransform(
+            _transformHandle,
+            position(),
+            rotationMatrix(),
+            scale()
+        );
+    }
+}
 
+void SceneGraphNode::updateRenderable(const UpdateData& data) {
+    State s = _state;
+    if (s != State::Initialized && _state != State::GLInitialized) {
+        return;
+    }
+    if (!isTimeFrameActive(data.time)) {
+        return;
+    }
+
+    UpdateData newUpdateData = data;
     newUpdateData.modelTransform.translation = worldPosition();
     newUpdateData.modelTransform.rotation = worldRotationMatrix();
     newUpdateData.modelTransform.scale = worldScale();
 
-    glm::dmat4 translation = glm::translate(
-        glm::dmat4(1.0),
-        newUpdateData.modelTransform.translation
-    );
-    glm::dmat4 rotation = glm::dmat4(newUpdateData.modelTransform.rotation);
-    glm::dmat4 scaling = glm::scale(
-        glm::dmat4(1.0),
-        glm::dvec3(
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale
-        )
-    );
-
-    _modelTransformCached = translation * rotation * scaling;
-    _inverseModelTransformCached = glm::inverse(_modelTransformCached);
-
     if (_renderable && _renderable->isReady()) {
         if (data.doPerformanceMeasurement) {
             glFinish();
@@ -409,14 +419,26 @@ void SceneGraphNode::update(const UpdateData& data) {
     }
 }
 
+bool SceneGraphNode::canUpdateConcurrently() const {
+    const bool translationReadsOtherNodes =
+        _transform.translation && _transform.translation->readsOtherNodes();
+    const bool rotationReadsOtherNodes =
+        _transform.rotation && _transform.rotation->readsOtherNodes();
+    const bool scaleReadsOtherNodes =
+        _transform.scale && _transform.scale->readsOtherNodes();
+    return !translationReadsOtherNodes && !rotationReadsOtherNodes &&
+           !scaleReadsOtherNodes;
+}
+
 void SceneGraphNode::render(const RenderData& data, RendererTasks& tasks) {
     if (_state != State::GLInitialized) {
         return;
     }
+    const glm::dvec3 worldPos = worldPosition();
     const psc thisPositionPSC = psc::CreatePowerScaledCoordinate(
-        _worldPositionCached.x,
-        _worldPositionCached.y,
-        _worldPositionCached.z
+        worldPos.x,
+        worldPos.y,
+        worldPos.z
     );
 
     RenderData newData = {
@@ -425,7 +447,7 @@ void SceneGraphNode::render(const RenderData& data, RendererTasks& tasks) {
         data.time,
         data.doPerformanceMeasurement,
         data.renderBinMask,
-        { _worldPositionCached, _worldRotationCached, _worldScaleCached }
+        { worldPos, worldRotationMatrix(), worldScale() }
     };
 
     if (!isTimeFrameActive(data.time)) {
@@ -623,23 +645,42 @@ double SceneGraphNode::scale() const {
 }
 
 glm::dvec3 SceneGraphNode::worldPosition() const {
-    return _worldPositionCached;
+    if (_transformHandle == TransformStore::InvalidHandle) {
+        return glm::dvec3(0.0);
+    }
+    return _scene->transformStore().worldPosition(_transformHandle);
 }
 
 const glm::dmat3& SceneGraphNode::worldRotationMatrix() const {
-    return _worldRotationCached;
+    if (_transformHandle == TransformStore::InvalidHandle) {
+        return IdentityRotation;
+    }
+    return _scene->transformStore().worldRotation(_transformHandle);
 }
 
 glm::dmat4 SceneGraphNode::modelTransform() const {
-    return _modelTransformCached;
+    if (_transformHandle == TransformStore::InvalidHandle) {
+        return glm::dmat4(1.0);
+    }
+    return _scene->transformStore().modelTransform(_transformHandle);
 }
 
 glm::dmat4 SceneGraphNode::inverseModelTransform() const {
-    return _inverseModelTransformCached;
+    if (_transformHandle == TransformStore::InvalidHandle) {
+        return glm::dmat4(1.0);
+    }
+    return _scene->transformStore().inverseModelTransform(_transformHandle);
 }
 
 double SceneGraphNode::worldScale() const {
-    return _worldScaleCached;
+    if (_transformHandle == TransformStore::InvalidHandle) {
+        return 1.0;
+    }
+    return _scene->transformStore().worldScale(_transformHandle);
+}
+
+TransformStore::Handle SceneGraphNode::transformHandle() const {
+    return _transformHandle;
 }
 
 std::string SceneGraphNode::guiPath() const {
@@ -650,21 +691,6 @@ bool SceneGraphNode::hasGuiHintHidden() const {
     return _guiHidden;
 }
 
-glm::dvec3 SceneGraphNode::calculateWorldPosition() const {
-    // recursive up the hierarchy if there are parents available
-    if (_parent) {
-        const glm::dvec3 wp = _parent->calculateWorldPosition();
-        const glm::dmat3 wrot = _parent->worldRotationMatrix();
-        const double ws = _parent->worldScale();
-        const glm::dvec3 p = position();
-
-        return wp + wrot * ws * p;
-    }
-    else {
-        return position();
-    }
-}
-
 bool SceneGraphNode::isTimeFrameActive(const Time& time) const {
     for (SceneGraphNode* dep : _dependencies) {
         if (!dep->isTimeFrameActive(time)) {
@@ -679,26 +705,6 @@ bool SceneGraphNode::isTimeFrameActive(const Time& time) const {
     return !_timeFrame || _timeFrame->isActive(time);
 }
 
-glm::dmat3 SceneGraphNode::calculateWorldRotation() const {
-    // recursive up the hierarchy if there are parents available
-    if (_parent) {
-        return rotationMatrix() * _parent->calculateWorldRotation();
-    }
-    else {
-        return rotationMatrix();
-    }
-}
-
-double SceneGraphNode::calculateWorldScale() const {
-    // recursive up the hierarchy if there are parents available
-    if (_parent) {
-        return _parent->calculateWorldScale() * scale();
-    }
-    else {
-        return scale();
-    }
-}
-
 SceneGraphNode* SceneGraphNode::parent() const {
     return _parent;
 }
@@ -712,8 +718,10 @@ void SceneGraphNode::setScene(Scene* scene) {
     traversePostOrder([](SceneGraphNode* node) {
         if (node->_scene) {
             node->_scene->unregisterNode(node);
+            node->_scene->transformStore().release(node->_transformHandle);
         }
         node->_scene = nullptr;
+        node->_transformHandle = TransformStore::InvalidHandle;
     });
 
     if (!scene) {
@@ -725,6 +733,13 @@ void SceneGraphNode::setScene(Scene* scene) {
         node->_scene = scene;
         if (scene) {
             scene->registerNode(node);
+            node->_transformHandle = scene->transformStore().allocate();
+            scene->transformStore().setLocalTransform(
+                node->_transformHandle,
+                node->position(),
+                node->rotationMatrix(),
+                node->scale()
+            );
         }
     });
 }
@@ -46,8 +46,8 @@ bool SingleThreadedSceneInitializer::isInitializing() const {
     return false;
 }
 
-MultiThreadedSceneInitializer::MultiThreadedSceneInitializer(unsigned int nThreads)
-    : _threadPool(nThreads)
+MultiThreadedSceneInitializer::MultiThreadedSceneInitializer(TaskScheduler& scheduler)
+    : _tasks(scheduler)
 {}
 
 void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
@@ -96,7 +96,7 @@ void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
 
     std::lock_guard<std::mutex> g(_mutex);
     _initializingNodes.insert(node);
-    _threadPool.enqueue(initFunction);
+    _tasks.run(initFunction);
 }
 
 std::vector<SceneGraphNode*> MultiThreadedSceneInitializer::takeInitializedNodes() {
@@ -0,0 +1,233 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scene/transformstore.h>
+
+#include <ghoul/misc/assert.h>
+
+namespace openspace {
+
+TransformStore::Handle TransformStore::allocate() {
+    Handle handle;
+    if (_freeHandles.empty()) {
+        handle = static_cast<Handle>(_slots.size());
+        _slots.push_back(0);
+    }
+    else {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+    }
+    _slots[handle] = static_cast<uint32_t>(_handles.size());
+    appendSlot(handle);
+    return handle;
+}
+
+void TransformStore::release(Handle handle) {
+    ghoul_assert(handle < _slots.size(), "Invalid handle");
+    _freeHandles.push_back(handle);
+}
+
+void TransformStore::setLayout(const std::vector<Handle>& order,
+                               const std::vector<Handle>& parents)
+{
+    ghoul_assert(order.size() == parents.size(), "Order and parents must match");
+
+    std::vector<bool> isPlaced(_slots.size(), false);
+    for (Handle handle : _freeHandles) {
+        isPlaced[handle] = true;
+    }
+
+    std::vector<Handle> handles = order;
+    for (Handle handle : order) {
+        isPlaced[handle] = true;
+    }
+    for (Handle handle = 0; handle < _slots.size(); ++handle) {
+        if (!isPlaced[handle]) {
+            handles.push_back(handle);
+        }
+    }
+
+    TransformStore store;
+    store._handles.reserve(handles.size());
+    store._parentSlots.reserve(handles.size());
+    store._localPositions.reserve(handles.size());
+    store._localRotations.reserve(handles.size());
+    store._localScales.reserve(handles.size());
+    store._worldPositions.reserve(handles.size());
+    store._worldRotations.reserve(handles.size());
+    store._worldScales.reserve(handles.size());
+    store._modelTransforms.reserve(handles.size());
+    store._inverseModelTransforms.reserve(handles.size());
+    store._isLocalDirty.resize(handles.size(), 1);
+    store._hasWorldChanged.resize(handles.size(), 1);
+    for (Handle handle : handles) {
+        const uint32_t s = _slots[handle];
+        store._handles.push_back(handle);
+        store._parentSlots.push_back(NoParent);
+        store._localPositions.push_back(_localPositions[s]);
+        store._localRotations.push_back(_localRotations[s]);
+        store._localScales.push_back(_localScales[s]);
+        store._worldPositions.push_back(_worldPositions[s]);
+        store._worldRotations.push_back(_worldRotations[s]);
+        store._worldScales.push_back(_worldScales[s]);
+        store._modelTransforms.push_back(_modelTransforms[s]);
+        store._inverseModelTransforms.push_back(_inverseModelTransforms[s]);
+    }
+
+    for (size_t i = 0; i < handles.size(); ++i) {
+        _slots[handles[i]] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = 0; i < parents.size(); ++i) {
+        if (parents[i] != InvalidHandle) {
+            ghoul_assert(_slots[parents[i]] < i, "Parent must precede its child");
+            store._parentSlots[i] = _slots[parents[i]];
+        }
+    }
+
+    _handles = std::move(store._handles);
+    _parentSlots = std::move(store._parentSlots);
+    _localPositions = std::move(store._localPositions);
+    _localRotations = std::move(store._localRotations);
+    _localScales = std::move(store._localScales);
+    _worldPositions = std::move(store._worldPositions);
+    _worldRotations = std::move(store._worldRotations);
+    _worldScales = std::move(store._worldScales);
+    _modelTransforms = std::move(store._modelTransforms);
+    _inverseModelTransforms = std::move(store._inverseModelTransforms);
+    _isLocalDirty = std::move(store._isLocalDirty);
+    _hasWorldChanged = std::move(store._hasWorldChanged);
+}
+
+void TransformStore::setLocalTransform(Handle handle, const glm::dvec3& position,
+                                       const glm::dmat3& rotation, double scale)
+{
+    const uint32_t s = _slots[handle];
+    _localPositions[s] = position;
+    _localRotations[s] = rotation;
+    _localScales[s] = scale;
+    _isLocalDirty[s] = 1;
+}
+
+void TransformStore::composeWorldTransforms(size_t begin, size_t end) {
+    ghoul_assert(end <= _handles.size(), "Invalid slot range");
+
+    for (size_t i = begin; i < end; ++i) {
+        const uint32_t p = _parentSlots[i];
+        const bool hasParentChanged = (p != NoParent) && _hasWorldChanged[p];
+        if (!_isLocalDirty[i] && !hasParentChanged) {
+            _hasWorldChanged[i] = 0;
+            continue;
+        }
+        _isLocalDirty[i] = 0;
+        _hasWorldChanged[i] = 1;
+
+        if (p == NoParent) {
+            _worldPositions[i] = _localPositions[i];
+            _worldRotations[i] = _localRotations[i];
+            _worldScales[i] = _localScales[i];
+        }
+        else {
+            _worldRotations[i] = _localRotations[i] * _worldRotations[p];
+            _worldScales[i] = _worldScales[p] * _localScales[i];
+            _worldPositions[i] = _worldPositions[p] +
+                _worldRotations[p] * _worldScales[p] * _localPositions[i];
+        }
+
+        // Equivalent to translate(position) * rotation * scale(scale)
+        const glm::dmat3 rs = _worldRotations[i] * _worldScales[i];
+        _modelTransforms[i] = glm::dmat4(
+            glm::dvec4(rs[0], 0.0),
+            glm::dvec4(rs[1], 0.0),
+            glm::dvec4(rs[2], 0.0),
+            glm::dvec4(_worldPositions[i], 1.0)
+        );
+        _inverseModelTransforms[i] = glm::inverse(_modelTransforms[i]);
+    }
+}
+
+void TransformStore::composeWorldTransform(Handle handle) {
+    const size_t s = _slots[handle];
+    composeWorldTransforms(s, s + 1);
+}
+
+bool TransformStore::hasWorldTransformChanged(Handle handle) const {
+    return _hasWorldChanged[_slots[handle]] != 0;
+}
+
+size_t TransformStore::slot(Handle handle) const {
+    return _slots[handle];
+}
+
+size_t TransformStore::size() const {
+    return _handles.size();
+}
+
+glm::dvec3 TransformStore::worldPosition(Handle handle) const {
+    return _worldPositions[_slots[handle]];
+}
+
+const glm::dmat3& TransformStore::worldRotation(Handle handle) const {
+    return _worldRotations[_slots[handle]];
+}
+
+double TransformStore::worldScale(Handle handle) const {
+    return _worldScales[_slots[handle]];
+}
+
+const glm::dmat4& TransformStore::modelTransform(Handle handle) const {
+    return _modelTransforms[_slots[handle]];
+}
+
+const glm::dmat4& TransformStore::inverseModelTransform(Handle handle) const {
+    return _inverseModelTransforms[_slots[handle]];
+}
+
+const std::vector<glm::dvec3>& TransformStore::worldPositions() const {
+    return _worldPositions;
+}
+
+const std::vector<glm::dmat3>& TransformStore::worldRotations() const {
+    return _worldRotations;
+}
+
+const std::vector<double>& TransformStore::worldScales() const {
+    return _worldScales;
+}
+
+void TransformStore::appendSlot(Handle handle) {
+    _handles.push_back(handle);
+    _parentSlots.push_back(NoParent);
+    _localPositions.emplace_back(0.0);
+    _localRotations.emplace_back(1.0);
+    _localScales.push_back(1.0);
+    _worldPositions.emplace_back(0.0);
+    _worldRotations.emplace_back(1.0);
+    _worldScales.push_back(1.0);
+    _modelTransforms.emplace_back(1.0);
+    _inverseModelTransforms.emplace_back(1.0);
+    _isLocalDirty.push_back(1);
+    _hasWorldChanged.push_back(1);
+}
+
+} // namespace openspace
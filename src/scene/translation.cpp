@@ -77,9 +77,11 @@ bool Translation::initialize() {
     return true;
 }
 
-void Translation::update(const UpdateData& data) {
-    if (!_needsUpdate && data.time.j2000Seconds() == _cachedTime) {
-        return;
+bool Translation::update(const UpdateData& data) {
+    if (!_needsUpdate &&
+        (!isTimeDependent() || data.time.j2000Seconds() == _cachedTime))
+    {
+        return false;
     }
     const glm::dvec3 oldPosition = _cachedPosition;
     _cachedPosition = position(data);
@@ -88,7 +90,17 @@ void Translation::update(const UpdateData& data) {
 
     if (oldPosition != _cachedPosition) {
         notifyObservers();
+        return true;
     }
+    return false;
+}
+
+bool Translation::isTimeDependent() const {
+    return true;
+}
+
+bool Translation::readsOtherNodes() const {
+    return false;
 }
 
 glm::dvec3 Translation::position() const {
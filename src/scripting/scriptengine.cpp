@@ -40,6 +40,9 @@ namespace {
     constexpr const char* _loggerCat = "ScriptEngine";
 
     constexpr const int TableOffset = -3; // top-first argument-second argument
+
+    // The maximum number of compiled scripts that are cached before the cache is reset
+    constexpr const size_t MaxCompiledScripts = 512;
 } // namespace
 
 namespace openspace::scripting {
@@ -71,6 +74,7 @@ void ScriptEngine::initialize() {
 }
 
 void ScriptEngine::deinitialize() {
+    clearCompiledScripts();
     _registeredLibraries.clear();
 }
 
@@ -172,21 +176,61 @@ bool ScriptEngine::runScript(const std::string& script) {
         writeLog(script);
     }
 
-    try {
-        ghoul::lua::runScript(_state, script);
-    }
-    catch (const ghoul::lua::LuaLoadingException& e) {
-        LERRORC(e.component, e.message);
+    const int chunk = compiledScript(script);
+    if (chunk == LUA_NOREF) {
         return false;
     }
-    catch (const ghoul::lua::LuaExecutionException& e) {
-        LERRORC(e.component, e.message);
+
+    lua_rawgeti(_state, LUA_REGISTRYINDEX, chunk);
+    if (lua_pcall(_state, 0, 0, 0) != LUA_OK) {
+        LERROR(fmt::format(
+            "Error executing script: {}",
+            ghoul::lua::value<std::string>(_state, -1, ghoul::lua::PopValue::Yes)
+        ));
         return false;
     }
 
     return true;
 }
 
+int ScriptEngine::compiledScript(const std::string& script) {
+    const auto it = _compiledScripts.find(script);
+    if (it != _compiledScripts.end()) {
+        return it->second;
+    }
+
+    // The script is its own chunk name, as it would be for luaL_loadstring
+    const int status = luaL_loadbuffer(
+        _state,
+        script.data(),
+        script.size(),
+        script.c_str()
+    );
+    if (status != LUA_OK) {
+        LERROR(fmt::format(
+            "Error loading script: {}",
+            ghoul::lua::value<std::string>(_state, -1, ghoul::lua::PopValue::Yes)
+        ));
+        return LUA_NOREF;
+    }
+
+    if (_compiledScripts.size() >= MaxCompiledScripts) {
+        // Most scripts are generated by user interfaces and do not repeat, so it is not
+        // worth keeping track of which cached scripts have been used recently
+        clearCompiledScripts();
+    }
+    const int reference = luaL_ref(_state, LUA_REGISTRYINDEX);
+    _compiledScripts[script] = reference;
+    return reference;
+}
+
+void ScriptEngine::clearCompiledScripts() {
+    for (const std::pair<const std::string, int>& p : _compiledScripts) {
+        luaL_unref(_state, LUA_REGISTRYINDEX, p.second);
+    }
+    _compiledScripts.clear();
+}
+
 bool ScriptEngine::runScriptFile(const std::string& filename) {
     if (filename.empty()) {
         LWARNING("Filename was empty");
@@ -639,56 +683,58 @@ void ScriptEngine::preSync(bool isMaster) {
         return;
     }
 
+    // All scripts that were queued since the last frame are synchronized as one batch
     _mutex.lock();
-    if (!_queuedScripts.empty()) {
-        _currentSyncedScript = _queuedScripts.back().first;
-        const bool remoteScripting = _queuedScripts.back().second;
-
-        // Not really a received script but the master also needs to run the script...
-        _receivedScripts.push_back(_currentSyncedScript);
-        _queuedScripts.pop_back();
-
+    for (std::pair<std::string, bool>& script : _queuedScripts) {
+        const bool remoteScripting = script.second;
         if (global::parallelPeer.isHost() && remoteScripting) {
-            global::parallelPeer.sendScript(_currentSyncedScript);
+            global::parallelPeer.sendScript(script.first);
         }
         if (global::sessionRecording.isRecording()) {
-            global::sessionRecording.saveScriptKeyframe(_currentSyncedScript);
+            global::sessionRecording.saveScriptKeyframe(script.first);
         }
+
+        // Not really a received script but the master also needs to run the script...
+        _receivedScripts.push_back(script.first);
+        _currentSyncedScripts.push_back(std::move(script.first));
     }
+    _queuedScripts.clear();
     _mutex.unlock();
 }
 
 void ScriptEngine::encode(SyncBuffer* syncBuffer) {
-    syncBuffer->encode(_currentSyncedScript);
-    _currentSyncedScript.clear();
+    syncBuffer->encode(static_cast<uint32_t>(_currentSyncedScripts.size()));
+    for (const std::string& script : _currentSyncedScripts) {
+        syncBuffer->encode(script);
+    }
+    _currentSyncedScripts.clear();
 }
 
 void ScriptEngine::decode(SyncBuffer* syncBuffer) {
-    syncBuffer->decode(_currentSyncedScript);
+    const uint32_t nScripts = syncBuffer->decode<uint32_t>();
 
-    if (!_currentSyncedScript.empty()) {
-        _mutex.lock();
-        _receivedScripts.push_back(_currentSyncedScript);
-        _mutex.unlock();
+    _mutex.lock();
+    for (uint32_t i = 0; i < nScripts; ++i) {
+        _receivedScripts.push_back(syncBuffer->decode());
     }
+    _mutex.unlock();
 }
 
 void ScriptEngine::postSync(bool) {
     std::vector<std::string> scripts;
 
     _mutex.lock();
-    scripts.assign(_receivedScripts.begin(), _receivedScripts.end());
-    _receivedScripts.clear();
+    scripts.swap(_receivedScripts);
     _mutex.unlock();
 
-    while (!scripts.empty()) {
+    // Run the scripts in the order in which they were queued
+    for (const std::string& script : scripts) {
         try {
-            runScript(scripts.back());
+            runScript(script);
         }
         catch (const ghoul::RuntimeError& e) {
             LERRORC(e.component, e.message);
         }
-        scripts.pop_back();
     }
 }
 
@@ -700,10 +746,7 @@ void ScriptEngine::queueScript(const std::string& script,
     }
 
     _mutex.lock();
-    _queuedScripts.insert(
-        _queuedScripts.begin(),
-        std::make_pair(script, remoteScripting)
-    );
+    _queuedScripts.emplace_back(script, remoteScripting);
     _mutex.unlock();
 }
 
@@ -0,0 +1,214 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <utility>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    constexpr const char* _loggerCat = "MemoryMappedFile";
+
+#ifndef WIN32
+    // Expands the byte range to whole pages, as required by madvise
+    std::pair<size_t, size_t> pageRange(size_t offset, size_t size, size_t fileSize) {
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t begin = offset - offset % pageSize;
+        const size_t end = std::min(offset + size, fileSize);
+        return { begin, end - begin };
+    }
+#endif // WIN32
+} // namespace
+
+namespace openspace {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filePath,
+                                   AccessPattern accessPattern)
+{
+#ifdef WIN32
+    _fileHandle = CreateFileA(
+        filePath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | (accessPattern == AccessPattern::Sequential ?
+            FILE_FLAG_SEQUENTIAL_SCAN :
+            FILE_FLAG_RANDOM_ACCESS),
+        nullptr
+    );
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        _fileHandle = nullptr;
+        throw ghoul::RuntimeError(
+            fmt::format("Error opening file '{}'", filePath),
+            _loggerCat
+        );
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(_fileHandle, &fileSize);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    if (_size == 0) {
+        CloseHandle(_fileHandle);
+        throw ghoul::RuntimeError(
+            fmt::format("Error mapping empty file '{}'", filePath),
+            _loggerCat
+        );
+    }
+
+    _mappingHandle = CreateFileMappingA(
+        _fileHandle,
+        nullptr,
+        PAGE_READONLY,
+        0,
+        0,
+        nullptr
+    );
+    if (!_mappingHandle) {
+        CloseHandle(_fileHandle);
+        throw ghoul::RuntimeError(
+            fmt::format("Error mapping file '{}'", filePath),
+            _loggerCat
+        );
+    }
+
+    _data = static_cast<const char*>(
+        MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0)
+    );
+    if (!_data) {
+        CloseHandle(_mappingHandle);
+        CloseHandle(_fileHandle);
+        throw ghoul::RuntimeError(
+            fmt::format("Error mapping file '{}'", filePath),
+            _loggerCat
+        );
+    }
+#else // WIN32
+    _fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (_fileDescriptor == -1) {
+        throw ghoul::RuntimeError(
+            fmt::format("Error opening file '{}'", filePath),
+            _loggerCat
+        );
+    }
+
+    struct stat fileStatus;
+    if (fstat(_fileDescriptor, &fileStatus) == -1 || fileStatus.st_size == 0) {
+        close(_fileDescriptor);
+        throw ghoul::RuntimeError(
+            fmt::format("Error mapping empty file '{}'", filePath),
+            _loggerCat
+        );
+    }
+    _size = static_cast<size_t>(fileStatus.st_size);
+
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fileDescriptor, 0);
+    if (data == MAP_FAILED) {
+        close(_fileDescriptor);
+        throw ghoul::RuntimeError(
+            fmt::format("Error mapping file '{}'", filePath),
+            _loggerCat
+        );
+    }
+    _data = static_cast<const char*>(data);
+
+    madvise(
+        data,
+        _size,
+        accessPattern == AccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM
+    );
+#endif // WIN32
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+#ifdef WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(_mappingHandle);
+    CloseHandle(_fileHandle);
+#else // WIN32
+    munmap(const_cast<char*>(_data), _size);
+    close(_fileDescriptor);
+#endif // WIN32
+}
+
+const char* MemoryMappedFile::data() const {
+    return _data;
+}
+
+size_t MemoryMappedFile::size() const {
+    return _size;
+}
+
+void MemoryMappedFile::prefetch(size_t offset, size_t size) const {
+    if (offset >= _size || size == 0) {
+        return;
+    }
+
+#ifdef WIN32
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<char*>(_data + offset);
+    range.NumberOfBytes = std::min(size, _size - offset);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else // WIN32
+    const auto [begin, length] = pageRange(offset, size, _size);
+    madvise(const_cast<char*>(_data + begin), length, MADV_WILLNEED);
+#endif // WIN32
+
+    // Touching one byte per page makes sure that the pages are resident when this
+    // function returns, as the advice above is asynchronous
+    constexpr const size_t MinimumPageSize = 4096;
+    const size_t end = std::min(offset + size, _size);
+    const volatile char* pages = _data;
+    for (size_t i = offset; i < end; i += MinimumPageSize) {
+        static_cast<void>(pages[i]);
+    }
+    static_cast<void>(pages[end - 1]);
+}
+
+void MemoryMappedFile::release(size_t offset, size_t size) const {
+    if (offset >= _size || size == 0) {
+        return;
+    }
+
+#ifdef WIN32
+    // Unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(const_cast<char*>(_data + offset), std::min(size, _size - offset));
+#else // WIN32
+    const auto [begin, length] = pageRange(offset, size, _size);
+    madvise(const_cast<char*>(_data + begin), length, MADV_DONTNEED);
+#endif // WIN32
+}
+
+} // namespace openspace
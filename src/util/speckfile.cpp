@@ -0,0 +1,479 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/speckfile.h>
+
+#include <openspace/util/memorymappedfile.h>
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace {
+    constexpr const char* _loggerCat = "SpeckFile";
+
+    // The data of files smaller than this is parsed on the calling thread
+    constexpr const size_t MinimumChunkSize = 4 * 1024 * 1024;
+
+    // The number of decimal digits that are guaranteed to fit into the 64 bit mantissa
+    constexpr const int MaxSignificantDigits = 19;
+
+    // The largest mantissa below which all integers are exact as doubles
+    constexpr const uint64_t MaxExactMantissa = uint64_t(1) << 53;
+
+    // All powers of ten up to 1e22 are exact as doubles
+    constexpr const std::array<double, 23> PowersOfTen = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+        1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    // Returns whether the double \p d lies exactly halfway between two normal floats. The
+    // 29 bits of its mantissa that a float does not have are 100...0 in that case
+    bool isHalfwayBetweenFloats(double d) {
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(double));
+        constexpr const uint64_t DroppedBits = (uint64_t(1) << 29) - 1;
+        return (bits & DroppedBits) == (uint64_t(1) << 28);
+    }
+
+    bool isWhitespace(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // Parses a decimal number at the beginning of [begin, end) into the value and returns
+    // the position after it, or begin if the range does not start with a number. The
+    // result is the correctly rounded float, identical to the one of strtof. Only the
+    // rare numbers that can't be converted exactly with doubles are passed to strtof
+    const char* parseNumber(const char* begin, const char* end, float& value) {
+        const char* it = begin;
+        const bool isNegative = (it != end && *it == '-');
+        if (it != end && (*it == '-' || *it == '+')) {
+            ++it;
+        }
+
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        int nSignificantDigits = 0;
+        bool hasDigits = false;
+        bool isTruncated = false;
+        for (; it != end && isDigit(*it); ++it) {
+            hasDigits = true;
+            if (nSignificantDigits < MaxSignificantDigits) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+                nSignificantDigits += (mantissa != 0) ? 1 : 0;
+            }
+            else {
+                // Digits beyond the precision of the mantissa only affect the magnitude
+                ++exponent;
+                isTruncated |= (*it != '0');
+            }
+        }
+        if (it != end && *it == '.') {
+            ++it;
+            for (; it != end && isDigit(*it); ++it) {
+                hasDigits = true;
+                if (nSignificantDigits < MaxSignificantDigits) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+                    nSignificantDigits += (mantissa != 0) ? 1 : 0;
+                    --exponent;
+                }
+                else {
+                    isTruncated |= (*it != '0');
+                }
+            }
+        }
+        if (!hasDigits) {
+            return begin;
+        }
+
+        if (it != end && (*it == 'e' || *it == 'E')) {
+            const char* e = it + 1;
+            const bool isNegativeExponent = (e != end && *e == '-');
+            if (e != end && (*e == '-' || *e == '+')) {
+                ++e;
+            }
+            if (e != end && isDigit(*e)) {
+                int exp = 0;
+                for (; e != end && isDigit(*e); ++e) {
+                    exp = std::min(exp * 10 + (*e - '0'), 100000);
+                }
+                exponent += isNegativeExponent ? -exp : exp;
+                it = e;
+            }
+        }
+
+        // With an exact mantissa and power of ten, the single multiplication or division
+        // gives the correctly rounded double. Rounding that to float gives the correctly
+        // rounded float, unless the double lies exactly halfway between two floats
+        const int n = static_cast<int>(PowersOfTen.size());
+        if (!isTruncated && mantissa <= MaxExactMantissa && std::abs(exponent) < n) {
+            double result = static_cast<double>(mantissa);
+            if (exponent > 0) {
+                result *= PowersOfTen[exponent];
+            }
+            else if (exponent < 0) {
+                result /= PowersOfTen[-exponent];
+            }
+
+            const bool isNormalFloat =
+                result >= std::numeric_limits<float>::min() &&
+                result <= std::numeric_limits<float>::max();
+            if (result == 0.0 || (isNormalFloat && !isHalfwayBetweenFloats(result))) {
+                value = static_cast<float>(isNegative ? -result : result);
+                return it;
+            }
+        }
+
+        value = std::strtof(std::string(begin, it).c_str(), nullptr);
+        return it;
+    }
+
+    std::unique_ptr<openspace::MemoryMappedFile> mapFile(const std::string& path,
+                                                         const char* type)
+    {
+        try {
+            return std::make_unique<openspace::MemoryMappedFile>(
+                path,
+                openspace::MemoryMappedFile::AccessPattern::Sequential
+            );
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(fmt::format("Failed to open {} file '{}': {}", type, path, e.message));
+            return nullptr;
+        }
+    }
+
+    int readIndex(openspace::speck::Scanner& scanner) {
+        float index = 0.f;
+        scanner.number(index);
+        return static_cast<int>(index);
+    }
+
+    // Each line that starts with a number is one entry of the dataset
+    size_t countEntries(const char* begin, const char* end) {
+        openspace::speck::Scanner scanner(begin, end);
+        size_t nEntries = 0;
+        float value;
+        while (scanner.nextLine()) {
+            nEntries += scanner.number(value) ? 1 : 0;
+        }
+        return nEntries;
+    }
+
+    void parseEntries(const char* begin, const char* end, int nValues, float* entries) {
+        openspace::speck::Scanner scanner(begin, end);
+        while (scanner.nextLine()) {
+            if (!scanner.number(entries[0])) {
+                continue;
+            }
+            int i = 1;
+            while (i < nValues && scanner.number(entries[i])) {
+                ++i;
+            }
+            std::fill(entries + i, entries + nValues, 0.f);
+            entries += nValues;
+        }
+    }
+
+    // Calls the function with the index of each chunk, concurrently if there are more
+    // than one
+    void forEachChunk(openspace::TaskScheduler* scheduler, size_t nChunks,
+                      const std::function<void(size_t)>& function)
+    {
+        if (nChunks == 1) {
+            function(0);
+            return;
+        }
+
+        openspace::TaskGroup group(*scheduler);
+        for (size_t i = 0; i < nChunks; ++i) {
+            group.run([&function, i]() { function(i); });
+        }
+        group.wait();
+    }
+} // namespace
+
+namespace openspace::speck {
+
+Scanner::Scanner(const char* begin, const char* end)
+    : _end(end)
+    , _next(begin)
+    , _lineBegin(begin)
+    , _lineEnd(begin)
+    , _cursor(begin)
+{}
+
+bool Scanner::nextLine() {
+    while (_next < _end) {
+        _lineBegin = _next;
+        const char* newline = static_cast<const char*>(
+            std::memchr(_next, '\n', static_cast<size_t>(_end - _next))
+        );
+        _lineEnd = newline ? newline : _end;
+        _next = newline ? newline + 1 : _end;
+
+        // Guard against files with Windows line endings
+        if (_lineEnd > _lineBegin && *(_lineEnd - 1) == '\r') {
+            --_lineEnd;
+        }
+
+        _cursor = _lineBegin;
+        skipWhitespace();
+        if (_cursor != _lineEnd && *_cursor != '#') {
+            return true;
+        }
+    }
+
+    _lineBegin = _end;
+    _lineEnd = _end;
+    _cursor = _end;
+    return false;
+}
+
+void Scanner::rewindLine() {
+    _cursor = _lineBegin;
+}
+
+bool Scanner::hasToken() {
+    skipWhitespace();
+    return _cursor != _lineEnd;
+}
+
+std::string_view Scanner::token() {
+    skipWhitespace();
+    const char* begin = _cursor;
+    while (_cursor != _lineEnd && !isWhitespace(*_cursor)) {
+        ++_cursor;
+    }
+    return std::string_view(begin, static_cast<size_t>(_cursor - begin));
+}
+
+bool Scanner::number(float& value) {
+    skipWhitespace();
+    float result;
+    const char* end = parseNumber(_cursor, _lineEnd, result);
+    if (end == _cursor || (end != _lineEnd && !isWhitespace(*end))) {
+        return false;
+    }
+    _cursor = end;
+    value = result;
+    return true;
+}
+
+const char* Scanner::lineBegin() const {
+    return _lineBegin;
+}
+
+void Scanner::skipWhitespace() {
+    while (_cursor != _lineEnd && isWhitespace(*_cursor)) {
+        ++_cursor;
+    }
+}
+
+size_t Dataset::numberOfEntries() const {
+    return values.size() / valuesPerEntry;
+}
+
+bool loadSpeckFile(const std::string& path, Dataset& dataset, TaskScheduler* scheduler) {
+    std::unique_ptr<MemoryMappedFile> file = mapFile(path, "Speck");
+    if (!file) {
+        return false;
+    }
+    const char* end = file->data() + file->size();
+
+    // The beginning of the speck file has a header that either contains comments
+    // (signaled by a preceding '#') or information about the structure of the file
+    // (signaled by keywords such as 'datavar', 'texturevar', and 'texture'). The first
+    // line starting with a number is the first line of data
+    dataset = Dataset();
+    int nValues = 0;
+    const char* dataBegin = end;
+    Scanner scanner(file->data(), end);
+    while (scanner.nextLine()) {
+        const std::string_view keyword = scanner.token();
+        if (keyword == "datavar") {
+            // datavar lines are structured as follows:
+            // datavar # description
+            // where # is the index of the data variable
+            Variable variable;
+            variable.index = readIndex(scanner);
+            variable.name = scanner.token();
+
+            const bool isOrientation =
+                variable.name == "orientation" || variable.name == "ori";
+            // The orientation consists of the two 3d vectors u and v
+            nValues = std::max(nValues, variable.index + (isOrientation ? 6 : 1));
+            dataset.variables.push_back(std::move(variable));
+        }
+        else if (keyword == "texturevar") {
+            dataset.textureVariable = readIndex(scanner);
+        }
+        else if (keyword == "polyorivar") {
+            dataset.orientationVariable = readIndex(scanner);
+        }
+        else if (keyword == "texture") {
+            // texture lines are structured as follows:
+            // texture [-option ...] # filename
+            float index = 0.f;
+            while (scanner.hasToken() && !scanner.number(index)) {
+                scanner.token();
+            }
+            Texture texture;
+            texture.index = static_cast<int>(index);
+            texture.file = scanner.token();
+            dataset.textures.push_back(std::move(texture));
+        }
+        else {
+            float value;
+            scanner.rewindLine();
+            if (scanner.number(value)) {
+                dataBegin = scanner.lineBegin();
+                break;
+            }
+            // Other header lines, such as 'maxcomment', are not used
+        }
+    }
+    dataset.valuesPerEntry = 3 + nValues;
+
+    // The data is split into chunks of lines that are counted first, so that each chunk
+    // can be parsed directly into its place in the values
+    const size_t dataSize = static_cast<size_t>(end - dataBegin);
+    size_t nChunks = 1;
+    if (scheduler) {
+        nChunks = std::clamp(
+            dataSize / MinimumChunkSize,
+            size_t(1),
+            static_cast<size_t>(scheduler->numberOfThreads()) + 1
+        );
+    }
+
+    std::vector<const char*> boundaries(nChunks + 1, end);
+    boundaries[0] = dataBegin;
+    for (size_t i = 1; i < nChunks; ++i) {
+        const char* split = dataBegin + dataSize * i / nChunks;
+        const char* newline = static_cast<const char*>(
+            std::memchr(split, '\n', static_cast<size_t>(end - split))
+        );
+        boundaries[i] = newline ? newline + 1 : end;
+    }
+
+    std::vector<size_t> firstEntries(nChunks + 1, 0);
+    forEachChunk(scheduler, nChunks, [&](size_t i) {
+        firstEntries[i + 1] = countEntries(boundaries[i], boundaries[i + 1]);
+    });
+    for (size_t i = 0; i < nChunks; ++i) {
+        firstEntries[i + 1] += firstEntries[i];
+    }
+
+    const int n = dataset.valuesPerEntry;
+    dataset.values.resize(firstEntries.back() * n);
+    forEachChunk(scheduler, nChunks, [&](size_t i) {
+        float* entries = dataset.values.data() + firstEntries[i] * n;
+        parseEntries(boundaries[i], boundaries[i + 1], n, entries);
+    });
+
+    return true;
+}
+
+bool loadLabelFile(const std::string& path, std::vector<Label>& labels) {
+    std::unique_ptr<MemoryMappedFile> file = mapFile(path, "Label");
+    if (!file) {
+        return false;
+    }
+
+    Scanner scanner(file->data(), file->data() + file->size());
+    while (scanner.nextLine()) {
+        // Header lines, such as 'textcolor', do not start with a number and are not used
+        Label label;
+        if (!scanner.number(label.position.x)) {
+            continue;
+        }
+        if (!scanner.number(label.position.y) || !scanner.number(label.position.z)) {
+            LWARNING(fmt::format("Skipping malformed label in '{}'", path));
+            continue;
+        }
+
+        scanner.token(); // text keyword
+
+        for (std::string_view t = scanner.token(); !t.empty(); t = scanner.token()) {
+            if (t == "#") {
+                break;
+            }
+            if (!label.text.empty()) {
+                label.text += ' ';
+            }
+            label.text += t;
+        }
+        labels.push_back(std::move(label));
+    }
+
+    return true;
+}
+
+bool loadColorMapFile(const std::string& path, std::vector<glm::vec4>& colors) {
+    std::unique_ptr<MemoryMappedFile> file = mapFile(path, "Color Map");
+    if (!file) {
+        return false;
+    }
+
+    // The first line that starts with a number is the number of colors
+    Scanner scanner(file->data(), file->data() + file->size());
+    float numberOfColors = -1.f;
+    while (scanner.nextLine() && !scanner.number(numberOfColors)) {}
+    if (numberOfColors < 0.f) {
+        LERROR(fmt::format("Missing number of colors in Color Map file '{}'", path));
+        return false;
+    }
+
+    const size_t nColors = static_cast<size_t>(numberOfColors);
+    colors.reserve(colors.size() + nColors);
+    size_t i = 0;
+    for (; i < nColors && scanner.nextLine(); ++i) {
+        glm::vec4 color(0.f);
+        for (int j = 0; j < 4 && scanner.number(color[j]); ++j) {}
+        colors.push_back(color);
+    }
+    if (i < nColors) {
+        LWARNING(fmt::format(
+            "Color Map file '{}' contains {} instead of {} colors", path, i, nColors
+        ));
+    }
+
+    return true;
+}
+
+} // namespace openspace::speck
@@ -169,7 +169,9 @@ SpiceManager::TerminatorType SpiceManager::terminatorTypeFromString(
     return Mapping.at(type);
 }
 
-SpiceManager::SpiceManager() {
+SpiceManager::SpiceManager()
+    : _snapshot(std::make_shared<const Snapshot>())
+{
     // Set the SPICE library to not exit the program if an error occurs
     erract_c("SET", 0, const_cast<char*>("REPORT")); // NOLINT
     // But we do not want SPICE to print the errors, we will fetch them ourselves
@@ -207,6 +209,7 @@ SpiceManager& SpiceManager::ref() {
 }
 
 SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!filePath.empty(), "Empty file path");
     ghoul_assert(
         FileSys.fileExists(filePath),
@@ -246,6 +249,8 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
     LINFO(fmt::format("Loading SPICE kernel '{}'", path));
     // Load the kernel
     furnsh_c(path.c_str());
+    ++_kernelGeneration;
+    resetSnapshot();
 
     // Reset the current directory to the previous one
     FileSys.setCurrentDirectory(currentDirectory);
@@ -262,6 +267,7 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
     else if (fileExtension == "bsp" || fileExtension == "BSP") {
         findSpkCoverage(path); // binary spk kernel
     }
+    resetSnapshot();
 
     KernelHandle kernelId = ++_lastAssignedKernel;
     ghoul_assert(kernelId != 0, fmt::format("Kernel Handle wrapped around to 0"));
@@ -270,6 +276,7 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
 }
 
 void SpiceManager::unloadKernel(KernelHandle kernelId) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(kernelId <= _lastAssignedKernel, "Invalid unassigned kernel");
     ghoul_assert(kernelId != KernelHandle(0), "Invalid zero handle");
 
@@ -285,6 +292,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             // No need to check for errors as we do not allow empty path names
             LINFO(fmt::format("Unloading SPICE kernel '{}'", it->path));
             unload_c(it->path.c_str());
+            ++_kernelGeneration;
+            resetSnapshot();
             _loadedKernels.erase(it);
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -296,6 +305,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
 }
 
 void SpiceManager::unloadKernel(std::string filePath) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!filePath.empty(), "Empty filename");
 
     std::string path = absPath(std::move(filePath));
@@ -321,6 +331,8 @@ void SpiceManager::unloadKernel(std::string filePath) {
         if (it->refCount == 1) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", path));
             unload_c(path.c_str());
+            ++_kernelGeneration;
+            resetSnapshot();
             _loadedKernels.erase(it);
         }
         else {
@@ -335,8 +347,9 @@ bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
     ghoul_assert(!target.empty(), "Empty target");
 
     const int id = naifId(target);
-    const auto it = _spkIntervals.find(id);
-    if (it != _spkIntervals.end()) {
+    const std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&_snapshot);
+    const auto it = snapshot->spkIntervals.find(id);
+    if (it != snapshot->spkIntervals.end()) {
         const std::vector<std::pair<double, double>>& intervalVector = it->second;
         for (const std::pair<double, double>& vecElement : intervalVector) {
             if ((vecElement.first < et) && (vecElement.second > et)) {
@@ -351,8 +364,9 @@ bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
     ghoul_assert(!frame.empty(), "Empty target");
 
     const int id = frameId(frame);
-    const auto it = _ckIntervals.find(id);
-    if (it != _ckIntervals.end()) {
+    const std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&_snapshot);
+    const auto it = snapshot->ckIntervals.find(id);
+    if (it != snapshot->ckIntervals.end()) {
         const std::vector<std::pair<double, double>>& intervalVector = it->second;
         for (const std::pair<double, double>& i : intervalVector) {
             if ((i.first < et) && (i.second > et)) {
@@ -364,6 +378,7 @@ bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
 }
 
 bool SpiceManager::hasValue(int naifId, const std::string& item) const {
+    std::lock_guard lock(_mutex);
     return bodfnd_c(naifId, item.c_str());
 }
 
@@ -378,41 +393,79 @@ bool SpiceManager::hasValue(const std::string& body, const std::string& item) co
 int SpiceManager::naifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    const std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&_snapshot);
+    const auto it = snapshot->naifIds.find(body);
+    if (it != snapshot->naifIds.end()) {
+        return it->second;
+    }
+
+    std::lock_guard lock(_mutex);
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
     if (!success && _useExceptions) {
         throw SpiceException(fmt::format("Could not find NAIF ID of body '{}'", body));
     }
+    if (success) {
+        publishId(&Snapshot::naifIds, body, id);
+    }
     return id;
 }
 
 bool SpiceManager::hasNaifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    const std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&_snapshot);
+    if (snapshot->naifIds.find(body) != snapshot->naifIds.end()) {
+        return true;
+    }
+
+    std::lock_guard lock(_mutex);
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
     reset_c();
+    if (success) {
+        publishId(&Snapshot::naifIds, body, id);
+    }
     return success;
 }
 
 int SpiceManager::frameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    const std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&_snapshot);
+    const auto it = snapshot->frameIds.find(frame);
+    if (it != snapshot->frameIds.end()) {
+        return it->second;
+    }
+
+    std::lock_guard lock(_mutex);
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
     if (id == 0 && _useExceptions) {
         throw SpiceException(fmt::format("Could not find NAIF ID of frame '{}'", frame));
     }
+    if (id != 0) {
+        publishId(&Snapshot::frameIds, frame, id);
+    }
     return id;
 }
 
 bool SpiceManager::hasFrameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    const std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&_snapshot);
+    if (snapshot->frameIds.find(frame) != snapshot->frameIds.end()) {
+        return true;
+    }
+
+    std::lock_guard lock(_mutex);
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
+    if (id != 0) {
+        publishId(&Snapshot::frameIds, frame, id);
+    }
     return id != 0;
 }
 
@@ -432,36 +485,42 @@ void getValueInternal(const std::string& body, const std::string& value, int siz
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             double& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 1, &v);
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec2& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 2, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec3& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 3, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec4& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 4, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             std::vector<double>& v) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!v.empty(), "Array for values has to be preallocaed");
 
     getValueInternal(body, value, static_cast<int>(v.size()), v.data());
 }
 
 double SpiceManager::spacecraftClockToET(const std::string& craft, double craftTicks) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!craft.empty(), "Empty craft");
 
     int craftId = naifId(craft);
@@ -474,6 +533,7 @@ double SpiceManager::spacecraftClockToET(const std::string& craft, double craftT
 }
 
 double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!timeString.empty(), "Empty timeString");
 
     double et;
@@ -485,6 +545,7 @@ double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const
 std::string SpiceManager::dateFromEphemerisTime(double ephemerisTime,
                                                     const std::string& formatString) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!formatString.empty(), "Format is empty");
 
     constexpr const int BufferSize = 256;
@@ -509,6 +570,8 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
 
+    // The coverage is answered from the snapshot, so CSPICE only has to be locked for
+    // the actual position query
     bool targetHasCoverage = hasSpkCoverage(target, ephemerisTime);
     bool observerHasCoverage = hasSpkCoverage(observer, ephemerisTime);
     if (!targetHasCoverage && !observerHasCoverage) {
@@ -524,7 +587,9 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
             return glm::dvec3();
         }
     }
-    else if (targetHasCoverage && observerHasCoverage) {
+
+    std::lock_guard lock(_mutex);
+    if (targetHasCoverage && observerHasCoverage) {
         glm::dvec3 position;
         spkpos_c(
             target.c_str(),
@@ -582,10 +647,35 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     );
 }
 
+std::vector<glm::dvec3> SpiceManager::targetPositions(const std::string& target,
+                                                      const std::string& observer,
+                                                      const std::string& referenceFrame,
+                                               AberrationCorrection aberrationCorrection,
+                                        const std::vector<double>& ephemerisTimes) const
+{
+    std::vector<glm::dvec3> positions;
+    positions.reserve(ephemerisTimes.size());
+
+    std::lock_guard lock(_mutex);
+    for (double ephemerisTime : ephemerisTimes) {
+        double lightTime = 0.0;
+        positions.push_back(targetPosition(
+            target,
+            observer,
+            referenceFrame,
+            aberrationCorrection,
+            ephemerisTime,
+            lightTime
+        ));
+    }
+    return positions;
+}
+
 glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
                                                    const std::string& to,
                                                    double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!from.empty(), "From must not be empty");
     ghoul_assert(!to.empty(), "To must not be empty");
 
@@ -618,6 +708,7 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
                                                                      double ephemerisTime,
                                                   const glm::dvec3& directionVector) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -662,6 +753,7 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
                                          AberrationCorrection aberrationCorrection,
                                          double& ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -694,6 +786,7 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
                                          AberrationCorrection aberrationCorrection,
                                          double& ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     return isTargetInFieldOfView(
         target,
         observer,
@@ -711,6 +804,7 @@ SpiceManager::TargetStateResult SpiceManager::targetState(const std::string& tar
                                                 AberrationCorrection aberrationCorrection,
                                                                double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
@@ -746,6 +840,7 @@ SpiceManager::TransformMatrix SpiceManager::stateTransformMatrix(
                                                       const std::string& destinationFrame,
                                                                double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "toFrame must not be empty");
 
@@ -768,6 +863,7 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  const std::string& destinationFrame,
                                                  double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
@@ -793,11 +889,29 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     return glm::transpose(result);
 }
 
+std::vector<glm::dmat3> SpiceManager::positionTransformMatrices(
+                                                          const std::string& sourceFrame,
+                                                     const std::string& destinationFrame,
+                                        const std::vector<double>& ephemerisTimes) const
+{
+    std::vector<glm::dmat3> matrices;
+    matrices.reserve(ephemerisTimes.size());
+
+    std::lock_guard lock(_mutex);
+    for (double ephemerisTime : ephemerisTimes) {
+        matrices.push_back(
+            positionTransformMatrix(sourceFrame, destinationFrame, ephemerisTime)
+        );
+    }
+    return matrices;
+}
+
 glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  const std::string& destinationFrame,
                                                  double ephemerisTimeFrom,
                                                  double ephemerisTimeTo) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
@@ -826,6 +940,7 @@ SpiceManager::fieldOfView(const std::string& instrument) const
 }
 
 SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const {
+    std::lock_guard lock(_mutex);
     constexpr int MaxBoundsSize = 64;
     constexpr int BufferSize = 128;
 
@@ -881,6 +996,7 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
                                                                      double ephemerisTime,
                                                              int numberOfTerminatorPoints)
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!frame.empty(), "Frame must not be empty");
@@ -914,6 +1030,7 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
 }
 
 bool SpiceManager::addFrame(std::string body, std::string frame) {
+    std::lock_guard lock(_mutex);
     if (body.empty() || frame.empty()) {
         return false;
     }
@@ -924,6 +1041,7 @@ bool SpiceManager::addFrame(std::string body, std::string frame) {
 }
 
 std::string SpiceManager::frameFromBody(const std::string& body) const {
+    std::lock_guard lock(_mutex);
     for (const std::pair<std::string, std::string>& pair : _frameByBody) {
         if (pair.first == body) {
             return pair.second;
@@ -1232,6 +1350,7 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
 }
 
 void SpiceManager::setExceptionHandling(UseException useException) {
+    std::lock_guard lock(_mutex);
     _useExceptions = useException;
 }
 
@@ -1239,6 +1358,60 @@ SpiceManager::UseException SpiceManager::exceptionHandling() const {
     return _useExceptions;
 }
 
+unsigned int SpiceManager::kernelGeneration() const {
+    return _kernelGeneration;
+}
+
+std::shared_ptr<const LeapSecondTable> SpiceManager::leapSecondTable() const {
+    return std::atomic_load(&_snapshot)->leapSeconds;
+}
+
+void SpiceManager::resetSnapshot() {
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->ckIntervals = _ckIntervals;
+    snapshot->spkIntervals = _spkIntervals;
+
+    // The leap seconds are only read if no error of a previous CSPICE call is pending,
+    // as that error is reported by the caller
+    auto leapSeconds = std::make_shared<LeapSecondTable>();
+    if (!failed_c()) {
+        SpiceInt n = 0;
+        SpiceBoolean found = SPICEFALSE;
+        std::array<double, 2> m = { 0.0, 0.0 };
+        gdpool_c("DELTET/DELTA_T_A", 0, 1, &n, &leapSeconds->deltaTA, &found);
+        gdpool_c("DELTET/K", 0, 1, &n, &leapSeconds->k, &found);
+        gdpool_c("DELTET/EB", 0, 1, &n, &leapSeconds->eb, &found);
+        gdpool_c("DELTET/M", 0, 2, &n, m.data(), &found);
+        leapSeconds->m0 = m[0];
+        leapSeconds->m1 = m[1];
+
+        SpiceChar type;
+        dtpool_c("DELTET/DELTA_AT", &found, &n, &type);
+        if (found && type == 'N' && n % 2 == 0) {
+            // The pairs are stored as alternating TAI - UTC and epoch values
+            std::vector<double> values(n);
+            gdpool_c("DELTET/DELTA_AT", 0, n, &n, values.data(), &found);
+            for (SpiceInt i = 0; i + 1 < n; i += 2) {
+                leapSeconds->deltaAT.emplace_back(values[i], values[i + 1]);
+            }
+        }
+        if (failed_c()) {
+            reset_c();
+            leapSeconds->deltaAT.clear();
+        }
+    }
+    snapshot->leapSeconds = std::move(leapSeconds);
+    std::atomic_store(&_snapshot, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+}
+
+void SpiceManager::publishId(std::map<std::string, int> Snapshot::* table,
+                             const std::string& name, int id) const
+{
+    auto snapshot = std::make_shared<Snapshot>(*std::atomic_load(&_snapshot));
+    ((*snapshot).*table)[name] = id;
+    std::atomic_store(&_snapshot, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+}
+
 scripting::LuaLibrary SpiceManager::luaLibrary() {
     return {
         "spice",
@@ -24,20 +24,24 @@
 
 #include <openspace/util/syncbuffer.h>
 
+#include <algorithm>
+
 namespace openspace {
 
 SyncBuffer::SyncBuffer(size_t n)
     : _n(n)
 {
     _dataStream.resize(_n);
+    _decodeData = _dataStream.data();
+    _decodeSize = _dataStream.size();
 }
 
 SyncBuffer::~SyncBuffer() {} // NOLINT
 
 void SyncBuffer::encode(const std::string& s) {
-    ghoul_assert(_encodeOffset + sizeof(char) * s.size() + sizeof(int32_t) < _n, "");
-
     int32_t length = static_cast<int32_t>(s.length());
+    reserveForEncode(sizeof(int32_t) + length);
+
     memcpy(
         _dataStream.data() + _encodeOffset,
         reinterpret_cast<const char*>(&length),
@@ -52,15 +56,13 @@ std::string SyncBuffer::decode() {
     int32_t length;
     memcpy(
         reinterpret_cast<char*>(&length),
-        _dataStream.data() + _decodeOffset,
+        _decodeData + _decodeOffset,
         sizeof(int32_t)
     );
-    std::vector<char> tmp(length + 1);
     _decodeOffset += sizeof(int32_t);
-    memcpy(tmp.data(), _dataStream.data() + _decodeOffset, length);
+    ghoul_assert(_decodeOffset + length <= _decodeSize, "Decoding past the end of data");
+    std::string ret(_decodeData + _decodeOffset, length);
     _decodeOffset += length;
-    tmp[length] = '\0';
-    std::string ret(tmp.data());
     return ret;
 }
 
@@ -70,18 +72,49 @@ void SyncBuffer::decode(std::string& s) {
 
 void SyncBuffer::setData(std::vector<char> data) {
     _dataStream = std::move(data);
+    _decodeData = _dataStream.data();
+    _decodeSize = _dataStream.size();
+    _decodeOffset = 0;
+}
+
+void SyncBuffer::setDataView(const char* data, size_t size) {
+    _decodeData = data;
+    _decodeSize = size;
+    _decodeOffset = 0;
 }
 
 std::vector<char> SyncBuffer::data() {
-    _dataStream.resize(_encodeOffset);
+    return std::vector<char>(_dataStream.begin(), _dataStream.begin() + _encodeOffset);
+}
 
-    return _dataStream;
+const char* SyncBuffer::encodedData() const {
+    return _dataStream.data();
+}
+
+size_t SyncBuffer::encodedSize() const {
+    return _encodeOffset;
+}
+
+size_t SyncBuffer::decodedSize() const {
+    return _decodeOffset;
 }
 
 void SyncBuffer::reset() {
-    _dataStream.resize(_n);
+    if (_dataStream.size() < _n) {
+        _dataStream.resize(_n);
+    }
     _encodeOffset = 0;
     _decodeOffset = 0;
+    _decodeData = _dataStream.data();
+    _decodeSize = _dataStream.size();
+}
+
+void SyncBuffer::reserveForEncode(size_t size) {
+    if (_encodeOffset + size > _dataStream.size()) {
+        _dataStream.resize(std::max(_encodeOffset + size, 2 * _dataStream.size()));
+        _decodeData = _dataStream.data();
+        _decodeSize = _dataStream.size();
+    }
 }
 
 //void SyncBuffer::write() {
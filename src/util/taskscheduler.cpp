@@ -0,0 +1,294 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/taskscheduler.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    constexpr const char* _loggerCat = "TaskScheduler";
+
+    // The scheduler and worker index of the current thread, if it is a worker thread.
+    // Tasks that are enqueued from a worker are pushed onto that worker's own queue
+    thread_local openspace::TaskScheduler* CurrentScheduler = nullptr;
+    thread_local unsigned int CurrentWorker = 0;
+
+    unsigned int defaultNumberOfThreads() {
+        const unsigned int nHardwareThreads = std::thread::hardware_concurrency();
+        return nHardwareThreads <= 1 ? 1 : nHardwareThreads - 1;
+    }
+} // namespace
+
+namespace openspace {
+
+TaskScheduler::TaskScheduler(unsigned int nThreads)
+    : _nThreads(nThreads == 0 ? defaultNumberOfThreads() : nThreads)
+    , _queues(std::make_unique<WorkerQueue[]>(_nThreads))
+{}
+
+TaskScheduler::~TaskScheduler() {
+    _shouldStop = true;
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wakeCondition.notify_all();
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void TaskScheduler::enqueue(std::function<void()> task, Priority priority) {
+    ghoul_assert(task, "Task must not be empty");
+    enqueue(Task{ std::move(task), nullptr }, priority);
+}
+
+void TaskScheduler::enqueue(Task task, Priority priority) {
+    std::call_once(_startFlag, [this]() { startWorkers(); });
+
+    // Tasks spawned by one of our workers stay local to that worker, all other tasks are
+    // spread out over all of the workers
+    const unsigned int index = (CurrentScheduler == this) ?
+        CurrentWorker :
+        _nextQueue++ % _nThreads;
+
+    // The counter is incremented before the task becomes visible so that it can never
+    // underflow when another thread pops the task immediately
+    ++_nPendingTasks;
+    {
+        std::lock_guard<std::mutex> lock(_queues[index].mutex);
+        _queues[index].tasks[static_cast<int>(priority)].push_back(std::move(task));
+    }
+
+    if (_nSleepingWorkers > 0) {
+        // Acquiring the lock guarantees that a worker that is about to go to sleep has
+        // either seen the new pending task or is already waiting for the notification
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _wakeCondition.notify_one();
+    }
+}
+
+bool TaskScheduler::runPendingTask() {
+    Task task;
+    bool foundTask = false;
+    if (CurrentScheduler == this) {
+        foundTask = popOwnTask(CurrentWorker, task) || stealTask(CurrentWorker, task);
+    }
+    else if (_nPendingTasks > 0) {
+        foundTask = stealTask(_nextQueue++ % _nThreads, task);
+    }
+
+    if (foundTask) {
+        execute(task);
+    }
+    return foundTask;
+}
+
+bool TaskScheduler::runPendingTask(const TaskGroup& group) {
+    if (_nPendingTasks == 0) {
+        return false;
+    }
+
+    Task task;
+    const unsigned int start = (CurrentScheduler == this) ?
+        CurrentWorker :
+        _nextQueue++ % _nThreads;
+    if (takeGroupTask(start, group, task)) {
+        execute(task);
+        return true;
+    }
+    return false;
+}
+
+unsigned int TaskScheduler::numberOfThreads() const {
+    return _nThreads;
+}
+
+size_t TaskScheduler::numberOfPendingTasks() const {
+    return _nPendingTasks;
+}
+
+void TaskScheduler::startWorkers() {
+    _workers.reserve(_nThreads);
+    for (unsigned int i = 0; i < _nThreads; ++i) {
+        _workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+void TaskScheduler::workerLoop(unsigned int index) {
+    CurrentScheduler = this;
+    CurrentWorker = index;
+
+    Task task;
+    while (!_shouldStop) {
+        if (popOwnTask(index, task) || stealTask(index, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        ++_nSleepingWorkers;
+        _wakeCondition.wait(lock, [this]() { return _shouldStop || _nPendingTasks > 0; });
+        --_nSleepingWorkers;
+    }
+}
+
+bool TaskScheduler::popOwnTask(unsigned int index, Task& task) {
+    WorkerQueue& queue = _queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (std::deque<Task>& tasks : queue.tasks) {
+        if (!tasks.empty()) {
+            // The owner works on the most recently added tasks as their data is more
+            // likely to still be in the cache
+            task = std::move(tasks.back());
+            tasks.pop_back();
+            --_nPendingTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::stealTask(unsigned int thief, Task& task) {
+    // Look for the highest priority task across all workers before considering lower
+    // priorities. The queues of other workers are only tried, never waited for, as a
+    // contended queue is most likely being emptied by someone else already
+    for (int p = 0; p < NumberOfPriorities; ++p) {
+        for (unsigned int i = 0; i < _nThreads; ++i) {
+            WorkerQueue& queue = _queues[(thief + i) % _nThreads];
+            std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || queue.tasks[p].empty()) {
+                continue;
+            }
+
+            task = std::move(queue.tasks[p].front());
+            queue.tasks[p].pop_front();
+            --_nPendingTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::takeGroupTask(unsigned int start, const TaskGroup& group,
+                                  Task& task)
+{
+    const auto isInGroup = [&group](const Task& t) { return t.group == &group; };
+    for (int p = 0; p < NumberOfPriorities; ++p) {
+        for (unsigned int i = 0; i < _nThreads; ++i) {
+            WorkerQueue& queue = _queues[(start + i) % _nThreads];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            std::deque<Task>& tasks = queue.tasks[p];
+            const auto it = std::find_if(tasks.begin(), tasks.end(), isInGroup);
+            if (it == tasks.end()) {
+                continue;
+            }
+
+            task = std::move(*it);
+            tasks.erase(it);
+            --_nPendingTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::execute(Task& task) {
+    try {
+        task.function();
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+    }
+    catch (const std::exception& e) {
+        LERROR(e.what());
+    }
+    // Release everything that was captured by the task before going idle
+    task.function = nullptr;
+
+    if (task.group) {
+        task.group->taskFinished();
+        task.group = nullptr;
+    }
+}
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler) : _scheduler(scheduler) {}
+
+TaskGroup::~TaskGroup() {
+    wait();
+}
+
+void TaskGroup::run(std::function<void()> task, TaskScheduler::Priority priority) {
+    ghoul_assert(task, "Task must not be empty");
+    ++_nPendingTasks;
+    _scheduler.enqueue(TaskScheduler::Task{ std::move(task), this }, priority);
+}
+
+void TaskGroup::wait() {
+    while (_nPendingTasks > 0) {
+        // Instead of blocking, help out with the pending tasks of this group. Tasks of
+        // other groups are left alone, as they might be long running background work. If
+        // there is nothing to do the remaining tasks are already running on other threads
+        if (!_scheduler.runPendingTask(*this)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _finishedCondition.wait_for(
+                lock,
+                std::chrono::milliseconds(1),
+                [this]() { return _nPendingTasks == 0; }
+            );
+        }
+    }
+
+    // Synchronize with the last call to taskFinished so that the group can be safely
+    // destroyed after this function returns
+    std::lock_guard<std::mutex> lock(_mutex);
+}
+
+bool TaskGroup::isDone() const {
+    return _nPendingTasks == 0;
+}
+
+void TaskGroup::taskFinished() {
+    // Only the last task of the group needs the lock to wake up the waiting thread, all
+    // other tasks just decrement the counter
+    int nPending = _nPendingTasks;
+    while (nPending > 1) {
+        if (_nPendingTasks.compare_exchange_weak(nPending, nPending - 1)) {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (--_nPendingTasks == 0) {
+        _finishedCondition.notify_all();
+    }
+}
+
+} // namespace openspace
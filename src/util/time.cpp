@@ -30,6 +30,9 @@
 #include <openspace/util/timemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <mutex>
 
 #include "time_lua.inl"
@@ -38,6 +41,12 @@ namespace openspace {
 
 double Time::convertTime(const std::string& time) {
     ghoul_assert(!time.empty(), "timeString must not be empty");
+
+    // The common date formats are converted natively, everything else is left to SPICE
+    double et;
+    if (parseDate(time, *SpiceManager::ref().leapSecondTable(), et)) {
+        return et;
+    }
     return SpiceManager::ref().ephemerisTimeFromDate(time);
 }
 
@@ -70,60 +79,54 @@ double Time::advanceTime(double delta) {
 }
 
 void Time::setTime(std::string time) {
-    _time = SpiceManager::ref().ephemerisTimeFromDate(std::move(time));
+    _time = convertTime(time);
 }
 
 std::string Time::UTC() const {
-    return SpiceManager::ref().dateFromEphemerisTime(_time);
+    char buffer[DateBufferSize];
+    return std::string(UTC(buffer));
+}
+
+std::string_view Time::UTC(char (&buffer)[DateBufferSize]) const {
+    if (!formatDate(_time, *SpiceManager::ref().leapSecondTable(), DateFormat::Spice,
+                    buffer))
+    {
+        const std::string date = SpiceManager::ref().dateFromEphemerisTime(_time);
+        *std::copy_n(
+            date.begin(),
+            std::min(date.size(), DateBufferSize - 1),
+            buffer
+        ) = '\0';
+    }
+    return std::string_view(buffer);
 }
 
 std::string Time::ISO8601() const {
-    std::string datetime = SpiceManager::ref().dateFromEphemerisTime(_time);
-    const std::string& month = datetime.substr(5, 3);
+    char buffer[DateBufferSize];
+    return std::string(ISO8601(buffer));
+}
 
-    std::string MM;
-    if (month == "JAN") {
-        MM = "01";
-    }
-    else if (month == "FEB") {
-        MM = "02";
-    }
-    else if (month == "MAR") {
-        MM = "03";
-    }
-    else if (month == "APR") {
-        MM = "04";
-    }
-    else if (month == "MAY") {
-        MM = "05";
+std::string_view Time::ISO8601(char (&buffer)[DateBufferSize]) const {
+    if (!formatDate(_time, *SpiceManager::ref().leapSecondTable(), DateFormat::ISO8601,
+                    buffer))
+    {
+        // Replace " MON " in the SPICE format with "-MM-"
+        UTC(buffer);
+        const std::string_view month = std::string_view(buffer).substr(5, 3);
+        constexpr const std::array<const char*, 12> Months = {
+            "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+            "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+        };
+        const auto it = std::find(Months.begin(), Months.end(), month);
+        ghoul_assert(it != Months.end(), "Bad month");
+        const int mm = static_cast<int>(std::distance(Months.begin(), it)) + 1;
+        buffer[4] = '-';
+        buffer[5] = static_cast<char>('0' + mm / 10);
+        buffer[6] = static_cast<char>('0' + mm % 10);
+        buffer[7] = '-';
+        std::memmove(buffer + 8, buffer + 9, std::strlen(buffer + 9) + 1);
     }
-    else if (month == "JUN") {
-        MM = "06";
-    }
-    else if (month == "JUL") {
-        MM = "07";
-    }
-    else if (month == "AUG") {
-        MM = "08";
-    }
-    else if (month == "SEP") {
-        MM = "09";
-    }
-    else if (month == "OCT") {
-        MM = "10";
-    }
-    else if (month == "NOV") {
-        MM = "11";
-    }
-    else if (month == "DEC") {
-        MM = "12";
-    }
-    else {
-        ghoul_assert(false, "Bad month");
-    }
-
-    datetime.replace(4, 5, "-" + MM + "-");
-    return datetime;
+    return std::string_view(buffer);
 }
 
 scripting::LuaLibrary Time::luaLibrary() {
@@ -512,7 +512,8 @@ int time_currentTime(lua_State* L) {
  * timezone by calling the Time::UTC method
  */
 int time_currentTimeUTC(lua_State* L) {
-    lua_pushstring(L, global::timeManager.time().UTC().c_str());
+    char buffer[DateBufferSize];
+    lua_pushstring(L, global::timeManager.time().UTC(buffer).data());
     ghoul_assert(lua_gettop(L) == 1, "Incorrect number of items left on stack");
     return 1;
 }
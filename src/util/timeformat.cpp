@@ -0,0 +1,363 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/timeformat.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    constexpr const int64_t SecondsPerDay = 86400;
+    // Julian day number of 2000 JAN 01, the J2000 epoch is at noon of that day
+    constexpr const int64_t JulianDayJ2000 = 2451545;
+
+    constexpr const std::array<const char*, 12> Months = {
+        "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+        "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+    };
+
+    // The longest seconds field that is accepted, which is more than enough for the
+    // precision of a double
+    constexpr const size_t MaxSecondsLength = 24;
+
+    struct Date {
+        int year;
+        int month;
+        int day;
+    };
+
+    // Like SPICE's default calendar, both conversions use the Gregorian calendar for all
+    // dates, including the ones before its introduction in 1582
+    Date dateFromJulianDay(int64_t jd) {
+        // Richards' algorithm for the Gregorian calendar
+        const int64_t f = jd + 1401 + (((4 * jd + 274277) / 146097) * 3) / 4 - 38;
+        const int64_t e = 4 * f + 3;
+        const int64_t g = (e % 1461) / 4;
+        const int64_t h = 5 * g + 2;
+        Date d;
+        d.day = static_cast<int>((h % 153) / 5 + 1);
+        d.month = static_cast<int>(((h / 153 + 2) % 12) + 1);
+        d.year = static_cast<int>(e / 1461 - 4716 + (14 - d.month) / 12);
+        return d;
+    }
+
+    int64_t julianDayFromDate(const Date& d) {
+        const int64_t a = (14 - d.month) / 12;
+        const int64_t y = d.year + 4800 - a;
+        const int64_t m = d.month + 12 * a - 3;
+        return d.day + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
+    }
+
+    double tdbFromTdt(double tdt, const openspace::LeapSecondTable& table) {
+        const double m = table.m0 + table.m1 * tdt;
+        const double e = m + table.eb * std::sin(m);
+        return tdt + table.k * std::sin(e);
+    }
+
+    double tdtFromTdb(double tdb, const openspace::LeapSecondTable& table) {
+        // TDB - TDT changes by less than 1e-9 s per second, so the fixed point iteration
+        // converges to machine precision within a few steps
+        double tdt = tdb;
+        for (int i = 0; i < 3; ++i) {
+            const double m = table.m0 + table.m1 * tdt;
+            const double e = m + table.eb * std::sin(m);
+            tdt = tdb - table.k * std::sin(e);
+        }
+        return tdt;
+    }
+
+    // Returns the index of the last entry of the table that starts at or before the
+    // UTC date; the first entry is used for dates before the table
+    size_t deltaATIndex(double utc, const openspace::LeapSecondTable& table) {
+        const auto it = std::upper_bound(
+            table.deltaAT.begin(),
+            table.deltaAT.end(),
+            utc,
+            [](double t, const std::pair<double, double>& e) { return t < e.second; }
+        );
+        return it == table.deltaAT.begin() ? 0 : (it - table.deltaAT.begin()) - 1;
+    }
+
+    // Returns the number of leap seconds at the end of the day with the \p dayIndex
+    // counted from 2000 JAN 01
+    double leapSecondsAtEndOfDay(int64_t dayIndex, const openspace::LeapSecondTable& t) {
+        const double nextMidnight = static_cast<double>(
+            (dayIndex + 1) * SecondsPerDay - SecondsPerDay / 2
+        );
+        const size_t i = deltaATIndex(nextMidnight, t);
+        if (i > 0 && t.deltaAT[i].second == nextMidnight) {
+            return t.deltaAT[i].first - t.deltaAT[i - 1].first;
+        }
+        return 0.0;
+    }
+
+    char* writeDigits(char* p, int64_t value, int nDigits) {
+        for (int i = nDigits - 1; i >= 0; --i) {
+            p[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        return p + nDigits;
+    }
+
+    bool readDigits(std::string_view s, size_t& pos, int nDigits, int& result) {
+        if (pos + nDigits > s.size()) {
+            return false;
+        }
+        result = 0;
+        for (int i = 0; i < nDigits; ++i) {
+            const char c = s[pos + i];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            result = result * 10 + (c - '0');
+        }
+        pos += nDigits;
+        return true;
+    }
+
+    bool readMonthName(std::string_view s, size_t& pos, int& month) {
+        if (pos + 3 > s.size()) {
+            return false;
+        }
+        char name[3];
+        for (int i = 0; i < 3; ++i) {
+            const char c = s[pos + i];
+            name[i] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+        }
+        for (size_t i = 0; i < Months.size(); ++i) {
+            if (std::equal(name, name + 3, Months[i])) {
+                month = static_cast<int>(i + 1);
+                pos += 3;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool readCharacter(std::string_view s, size_t& pos, char c) {
+        if (pos < s.size() && s[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    // Reads "HR:MN[:SC[.###]]" at pos
+    bool readTimeOfDay(std::string_view s, size_t& pos, int& hour, int& minute,
+                       double& second)
+    {
+        if (!readDigits(s, pos, 2, hour) || !readCharacter(s, pos, ':') ||
+            !readDigits(s, pos, 2, minute))
+        {
+            return false;
+        }
+        second = 0.0;
+        if (!readCharacter(s, pos, ':')) {
+            return true;
+        }
+        // The field is converted as a single decimal number, which rounds correctly
+        // unlike adding up the whole seconds and the scaled fraction
+        const size_t begin = pos;
+        int wholeSeconds;
+        if (!readDigits(s, pos, 2, wholeSeconds)) {
+            return false;
+        }
+        if (readCharacter(s, pos, '.')) {
+            while (pos < s.size() && s[pos] >= '0' && s[pos] <= '9') {
+                ++pos;
+            }
+        }
+        if (pos - begin > MaxSecondsLength) {
+            return false;
+        }
+        std::array<char, MaxSecondsLength + 1> field;
+        std::copy(s.begin() + begin, s.begin() + pos, field.begin());
+        field[pos - begin] = '\0';
+        second = std::strtod(field.data(), nullptr);
+        return true;
+    }
+} // namespace
+
+namespace openspace {
+
+bool formatDate(double ephemerisTime, const LeapSecondTable& table, DateFormat format,
+                char (&buffer)[DateBufferSize])
+{
+    if (table.deltaAT.empty()) {
+        return false;
+    }
+
+    const double tai = tdtFromTdb(ephemerisTime, table) - table.deltaTA;
+
+    // Find the TAI - UTC that applies, the table epochs are given in UTC
+    const auto it = std::upper_bound(
+        table.deltaAT.begin(),
+        table.deltaAT.end(),
+        tai,
+        [](double t, const std::pair<double, double>& e) { return t < e.second + e.first; }
+    );
+    const size_t i = it == table.deltaAT.begin() ? 0 : (it - table.deltaAT.begin()) - 1;
+    const double utc = tai - table.deltaAT[i].first;
+
+    // Seconds since 2000 JAN 01 00:00:00, the day's seconds exceed 86400 during a leap
+    // second that belongs to the previous day
+    const double sinceMidnight = utc + SecondsPerDay / 2;
+    int64_t dayIndex = static_cast<int64_t>(std::floor(sinceMidnight / SecondsPerDay));
+    if (i + 1 < table.deltaAT.size() && utc >= table.deltaAT[i + 1].second) {
+        dayIndex -= 1;
+    }
+    int64_t ms = std::llround((sinceMidnight - dayIndex * SecondsPerDay) * 1000.0);
+    const int64_t dayLengthMs = static_cast<int64_t>(
+        (SecondsPerDay + leapSecondsAtEndOfDay(dayIndex, table)) * 1000.0
+    );
+    if (ms >= dayLengthMs) {
+        ms -= dayLengthMs;
+        dayIndex += 1;
+    }
+
+    const Date date = dateFromJulianDay(JulianDayJ2000 + dayIndex);
+    if (date.year < 1 || date.year > 9999) {
+        return false;
+    }
+
+    int64_t hour = ms / 3600000;
+    int64_t minute = (ms / 60000) % 60;
+    int64_t second = (ms / 1000) % 60;
+    if (ms >= SecondsPerDay * 1000) {
+        // Leap second
+        hour = 23;
+        minute = 59;
+        second = 60 + (ms - SecondsPerDay * 1000) / 1000;
+    }
+
+    char* p = writeDigits(buffer, date.year, 4);
+    if (format == DateFormat::Spice) {
+        *p++ = ' ';
+        p = std::copy(Months[date.month - 1], Months[date.month - 1] + 3, p);
+        *p++ = ' ';
+    }
+    else {
+        *p++ = '-';
+        p = writeDigits(p, date.month, 2);
+        *p++ = '-';
+    }
+    p = writeDigits(p, date.day, 2);
+    *p++ = 'T';
+    p = writeDigits(p, hour, 2);
+    *p++ = ':';
+    p = writeDigits(p, minute, 2);
+    *p++ = ':';
+    p = writeDigits(p, second, 2);
+    *p++ = '.';
+    p = writeDigits(p, ms % 1000, 3);
+    *p = '\0';
+    return true;
+}
+
+bool parseDate(std::string_view date, const LeapSecondTable& table,
+               double& ephemerisTime)
+{
+    if (table.deltaAT.empty()) {
+        return false;
+    }
+
+    while (!date.empty() && date.front() == ' ') {
+        date.remove_prefix(1);
+    }
+    while (!date.empty() && date.back() == ' ') {
+        date.remove_suffix(1);
+    }
+
+    Date d;
+    size_t pos = 0;
+    if (!readDigits(date, pos, 4, d.year)) {
+        return false;
+    }
+    bool hasTimeOfDay = false;
+    if (readCharacter(date, pos, '-')) {
+        // YYYY-MM-DD[THR:MN[:SC[.###]]]
+        if (!readDigits(date, pos, 2, d.month) || !readCharacter(date, pos, '-') ||
+            !readDigits(date, pos, 2, d.day))
+        {
+            return false;
+        }
+        hasTimeOfDay = readCharacter(date, pos, 'T');
+    }
+    else if (readCharacter(date, pos, ' ')) {
+        // YYYY MON DD[( |T)HR:MN[:SC[.###]]]
+        if (!readMonthName(date, pos, d.month) || !readCharacter(date, pos, ' ') ||
+            !readDigits(date, pos, 2, d.day))
+        {
+            return false;
+        }
+        hasTimeOfDay = readCharacter(date, pos, 'T') || readCharacter(date, pos, ' ');
+    }
+    else {
+        return false;
+    }
+
+    int hour = 0;
+    int minute = 0;
+    double second = 0.0;
+    if (hasTimeOfDay && !readTimeOfDay(date, pos, hour, minute, second)) {
+        return false;
+    }
+    if (pos != date.size()) {
+        return false;
+    }
+
+    // Dates that do not exist do not survive the round trip
+    if (d.year < 1 || d.month < 1 || d.month > 12) {
+        return false;
+    }
+    const int64_t jd = julianDayFromDate(d);
+    const Date check = dateFromJulianDay(jd);
+    if (check.year != d.year || check.month != d.month || check.day != d.day) {
+        return false;
+    }
+
+    const int64_t dayIndex = jd - JulianDayJ2000;
+    if (hour > 23 || minute > 59) {
+        return false;
+    }
+    if (second >= 60.0) {
+        const bool isLastMinute = hour == 23 && minute == 59;
+        if (!isLastMinute || second >= 60.0 + leapSecondsAtEndOfDay(dayIndex, table)) {
+            return false;
+        }
+    }
+
+    const double minuteStart = static_cast<double>(
+        dayIndex * SecondsPerDay - SecondsPerDay / 2 + hour * 3600 + minute * 60
+    );
+    const double tai = minuteStart + second +
+        table.deltaAT[deltaATIndex(minuteStart, table)].first;
+    ephemerisTime = tdbFromTdt(tai + table.deltaTA, table);
+    return true;
+}
+
+} // namespace openspace
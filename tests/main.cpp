@@ -63,26 +63,47 @@
 
 #include <test_common.inl>
 #include <test_assetloader.inl>
+#include <test_cameraencoding.inl>
 #include <test_documentation.inl>
 #include <test_luaconversions.inl>
+#include <test_messageoutbox.inl>
 #include <test_optionproperty.inl>
 #include <test_powerscalecoordinates.inl>
+#include <test_propertyindex.inl>
+#include <test_recordingblocks.inl>
 #include <test_scriptscheduler.inl>
+#include <test_speckfile.inl>
 #include <test_spicemanager.inl>
+#include <test_syncengine.inl>
+#include <test_taskscheduler.inl>
+#include <test_timeformat.inl>
 #include <test_timeline.inl>
+#include <test_transformstore.inl>
+
+#ifdef OPENSPACE_MODULE_GAIA_ENABLED
+#include <test_octreemanager.inl>
+#endif
 
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
 #include <test_angle.inl>
 #include <test_concurrentjobmanager.inl>
 #include <test_concurrentqueue.inl>
+#include <test_disktilecache.inl>
+#include <test_heightcache.inl>
 #include <test_lrucache.inl>
+#include <test_memoryawaretilecache.inl>
 #include <test_gdalwms.inl>
+#include <test_tilepreprocessing.inl>
 #endif
 
 #ifdef OPENSPACE_MODULE_ISWA_ENABLED
 #include <test_screenspaceimage.inl>
 #endif
 
+#ifdef OPENSPACE_MODULE_SERVER_ENABLED
+#include <test_messagepackwriter.inl>
+#endif
+
 #ifdef OPENSPACE_MODULE_VOLUME_ENABLED
 #include <test_rawvolumeio.inl>
 #endif
@@ -0,0 +1,199 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/network/cameraencoding.h>
+#include <random>
+
+class CameraEncodingTest : public testing::Test {};
+
+namespace {
+    openspace::datamessagestructures::CameraKeyframe keyframe(glm::dvec3 position,
+                                                              std::string focusNode)
+    {
+        openspace::datamessagestructures::CameraKeyframe kf;
+        kf._position = position;
+        kf._rotation = glm::normalize(glm::dquat(0.9, 0.1, -0.3, 0.2));
+        kf._followNodeRotation = true;
+        kf._focusNode = std::move(focusNode);
+        kf._scale = 0.5f;
+        kf._timestamp = 1234.5678;
+        return kf;
+    }
+} // namespace
+
+TEST_F(CameraEncodingTest, QuantizedRotation) {
+    using namespace openspace::datamessagestructures;
+
+    std::mt19937 generator(1337);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    for (int i = 0; i < 10000; ++i) {
+        const glm::dquat q = glm::normalize(glm::dquat(
+            distribution(generator),
+            distribution(generator),
+            distribution(generator),
+            distribution(generator)
+        ));
+        const glm::dquat result = dequantizeRotation(quantizeRotation(q));
+
+        // q and -q are the same rotation
+        const double similarity = std::abs(glm::dot(q, result));
+        const double angle = 2.0 * std::acos(std::min(similarity, 1.0));
+        EXPECT_LT(angle, 1e-5) << "Rotation " << i;
+    }
+}
+
+TEST_F(CameraEncodingTest, RoundTrip) {
+    using namespace openspace::datamessagestructures;
+
+    CameraKeyframeEncoder encoder;
+    CameraKeyframeDecoder decoder;
+    std::vector<char> reference;
+    std::vector<char> buffer;
+
+    const CameraKeyframe first = keyframe(glm::dvec3(1e7, 2e7, -3e6), "Earth");
+    ASSERT_TRUE(encoder.encode(first, reference, buffer));
+    ASSERT_TRUE(decoder.decodeReference(reference));
+
+    CameraKeyframe result;
+    ASSERT_TRUE(decoder.decode(buffer, result));
+    EXPECT_EQ(result._focusNode, "Earth");
+    EXPECT_EQ(result._position, first._position);
+    EXPECT_EQ(result._followNodeRotation, first._followNodeRotation);
+    EXPECT_EQ(result._scale, first._scale);
+    EXPECT_EQ(result._timestamp, first._timestamp);
+    EXPECT_NEAR(std::abs(glm::dot(result._rotation, first._rotation)), 1.0, 1e-10);
+
+    // A small movement only needs the offset from the reference
+    const CameraKeyframe second = keyframe(glm::dvec3(1e7 + 12.25, 2e7, -3e6), "Earth");
+    EXPECT_FALSE(encoder.encode(second, reference, buffer));
+    EXPECT_TRUE(reference.empty());
+    ASSERT_TRUE(decoder.decode(buffer, result));
+    EXPECT_NEAR(glm::length(result._position - second._position), 0.0, 1e-2);
+
+    // A large movement requires a new reference, but not the focus node name
+    const CameraKeyframe third = keyframe(glm::dvec3(5e7, 2e7, -3e6), "Earth");
+    ASSERT_TRUE(encoder.encode(third, reference, buffer));
+    EXPECT_LT(reference.size(), 2 * sizeof(uint32_t) + sizeof(glm::dvec3));
+    ASSERT_TRUE(decoder.decodeReference(reference));
+    ASSERT_TRUE(decoder.decode(buffer, result));
+    EXPECT_EQ(result._position, third._position);
+    EXPECT_EQ(result._focusNode, "Earth");
+
+    // Switching back to a known focus node uses its identifier
+    ASSERT_TRUE(encoder.encode(keyframe(glm::dvec3(1.0), "Moon"), reference, buffer));
+    ASSERT_TRUE(decoder.decodeReference(reference));
+    ASSERT_TRUE(encoder.encode(keyframe(glm::dvec3(1.0), "Earth"), reference, buffer));
+    ASSERT_TRUE(decoder.decodeReference(reference));
+    ASSERT_TRUE(decoder.decode(buffer, result));
+    EXPECT_EQ(result._focusNode, "Earth");
+}
+
+TEST_F(CameraEncodingTest, HeliocentricPrecision) {
+    using namespace openspace::datamessagestructures;
+
+    CameraKeyframeEncoder encoder;
+    CameraKeyframeDecoder decoder;
+    std::vector<char> reference;
+    std::vector<char> buffer;
+
+    // Far away from the world origin, the offsets must still be precise to the millimeter
+    const glm::dvec3 start = glm::dvec3(1.5e11, -2e10, 3e9);
+    const glm::dvec3 direction = glm::normalize(glm::dvec3(1.0, 2.0, -0.5));
+    int nReferences = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const CameraKeyframe kf = keyframe(start + direction * (37.3 * i), "Earth");
+        if (encoder.encode(kf, reference, buffer)) {
+            ASSERT_TRUE(decoder.decodeReference(reference));
+            nReferences++;
+        }
+
+        CameraKeyframe result;
+        ASSERT_TRUE(decoder.decode(buffer, result));
+        EXPECT_LT(glm::length(result._position - kf._position), 1e-3) << "Keyframe " << i;
+    }
+    // Most keyframes only need the offset from the reference
+    EXPECT_LT(nReferences, 100);
+}
+
+TEST_F(CameraEncodingTest, MissingReference) {
+    using namespace openspace::datamessagestructures;
+
+    CameraKeyframeEncoder encoder;
+    std::vector<char> reference;
+    std::vector<char> buffer;
+    encoder.encode(keyframe(glm::dvec3(1.0), "Earth"), reference, buffer);
+
+    // A peer that joined late cannot decode keyframes until it received a reference
+    CameraKeyframeDecoder lateDecoder;
+    CameraKeyframe result;
+    EXPECT_FALSE(lateDecoder.decode(buffer, result));
+
+    encoder.reset();
+    ASSERT_TRUE(encoder.encode(keyframe(glm::dvec3(2.0), "Earth"), reference, buffer));
+    ASSERT_TRUE(lateDecoder.decodeReference(reference));
+    ASSERT_TRUE(lateDecoder.decode(buffer, result));
+    EXPECT_EQ(result._focusNode, "Earth");
+}
+
+TEST_F(CameraEncodingTest, MalformedReference) {
+    using namespace openspace::datamessagestructures;
+
+    CameraKeyframeEncoder encoder;
+    CameraKeyframeDecoder decoder;
+    std::vector<char> reference;
+    std::vector<char> buffer;
+
+    ASSERT_TRUE(encoder.encode(keyframe(glm::dvec3(1e7), "Earth"), reference, buffer));
+    ASSERT_TRUE(decoder.decodeReference(reference));
+
+    // The keyframes following a broken reference must not be applied to the previous one
+    ASSERT_TRUE(encoder.encode(keyframe(glm::dvec3(5e7), "Earth"), reference, buffer));
+    std::vector<char> truncated(reference.begin(), reference.end() - 1);
+    EXPECT_FALSE(decoder.decodeReference(truncated));
+    CameraKeyframe result;
+    EXPECT_FALSE(decoder.decode(buffer, result));
+
+    const CameraKeyframe nearby = keyframe(glm::dvec3(5e7 + 1.0), "Earth");
+    ASSERT_FALSE(encoder.encode(nearby, reference, buffer));
+    EXPECT_FALSE(decoder.decode(buffer, result));
+
+    // The next valid reference restores decoding
+    ASSERT_TRUE(encoder.encode(keyframe(glm::dvec3(1e9), "Earth"), reference, buffer));
+    ASSERT_TRUE(decoder.decodeReference(reference));
+    ASSERT_TRUE(decoder.decode(buffer, result));
+    EXPECT_EQ(result._focusNode, "Earth");
+    EXPECT_EQ(result._position, glm::dvec3(1e9));
+
+    // A broken reference does not define its focus node for later references
+    CameraKeyframeEncoder newEncoder;
+    CameraKeyframeDecoder newDecoder;
+    ASSERT_TRUE(newEncoder.encode(keyframe(glm::dvec3(1.0), "Mars"), reference, buffer));
+    truncated.assign(reference.begin(), reference.end() - 1);
+    EXPECT_FALSE(newDecoder.decodeReference(truncated));
+    ASSERT_TRUE(newEncoder.encode(keyframe(glm::dvec3(1e8), "Mars"), reference, buffer));
+    EXPECT_FALSE(newDecoder.decodeReference(reference));
+    EXPECT_FALSE(newDecoder.decode(buffer, result));
+}
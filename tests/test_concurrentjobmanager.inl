@@ -26,8 +26,7 @@
 #include "gtest/gtest.h"
 
 #include <openspace/util/concurrentjobmanager.h>
-
-#include <ghoul/misc/threadpool.h>
+#include <openspace/util/taskscheduler.h>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -62,7 +61,8 @@ private:
 TEST_F(ConcurrentJobManagerTest, Basic) {
     using namespace openspace;
 
-    ConcurrentJobManager<int> jobManager(ThreadPool(1));
+    TaskScheduler scheduler(1);
+    ConcurrentJobManager<int> jobManager(scheduler);
 
     auto testJob1 = std::shared_ptr<TestJob>(new TestJob(20));
     auto testJob2 = std::shared_ptr<TestJob>(new TestJob(20));
@@ -134,7 +134,8 @@ TEST_F(ConcurrentJobManagerTest, JobCreation) {
     
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
 
-    ConcurrentJobManager<VerboseProduct> jobManager(ThreadPool(1));
+    TaskScheduler scheduler(1);
+    ConcurrentJobManager<VerboseProduct> jobManager(scheduler);
 
     auto testJob1 = std::shared_ptr<VerboseJob>(new VerboseJob(20));
 
@@ -0,0 +1,163 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/disktilecache.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+    openspace::globebrowsing::RawTile testTile(int x, size_t nBytes) {
+        using namespace openspace::globebrowsing;
+
+        RawTile tile;
+        tile.tileIndex = TileIndex(x, 1, 2);
+        tile.imageData = std::unique_ptr<std::byte[]>(new std::byte[nBytes]);
+        for (size_t i = 0; i < nBytes; ++i) {
+            tile.imageData[i] = static_cast<std::byte>((i + x) % 251);
+        }
+        tile.tileMetaData.maxValues = { 1.f, 2.f, 3.f };
+        tile.tileMetaData.minValues = { -1.f, -2.f, -3.f };
+        tile.tileMetaData.hasMissingData = { false, true, false };
+        return tile;
+    }
+} // namespace
+
+class DiskTileCacheTest : public testing::Test {
+protected:
+    const std::string _directory = absPath("${CACHE}/test_disktilecache");
+};
+
+TEST_F(DiskTileCacheTest, StoreAndReload) {
+    using namespace openspace::globebrowsing;
+    constexpr const size_t NBytes = 1000;
+
+    {
+        cache::DiskTileCache cache(_directory, 1024 * 1024);
+        cache.clear();
+
+        RawTile tile = testTile(3, NBytes);
+        cache.put(1, tile, NBytes);
+        ASSERT_TRUE(cache.exist(1, tile.tileIndex));
+        ASSERT_FALSE(cache.exist(2, tile.tileIndex)) << "Datasets must not be mixed";
+
+        // A different size means the tile layout has changed
+        ASSERT_FALSE(cache.get(1, tile.tileIndex, NBytes / 2).has_value());
+        ASSERT_FALSE(cache.exist(1, tile.tileIndex));
+        cache.put(1, tile, NBytes);
+    }
+
+    // The index is written on destruction and the tile is available in the next session
+    cache::DiskTileCache cache(_directory, 1024 * 1024);
+    const RawTile reference = testTile(3, NBytes);
+    std::optional<RawTile> tile = cache.get(1, reference.tileIndex, NBytes);
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_EQ(tile->tileIndex, reference.tileIndex);
+    EXPECT_EQ(tile->tileMetaData.maxValues, reference.tileMetaData.maxValues);
+    EXPECT_EQ(tile->tileMetaData.minValues, reference.tileMetaData.minValues);
+    EXPECT_EQ(tile->tileMetaData.hasMissingData, reference.tileMetaData.hasMissingData);
+    EXPECT_EQ(
+        std::memcmp(tile->imageData.get(), reference.imageData.get(), NBytes),
+        0
+    );
+    cache.clear();
+}
+
+TEST_F(DiskTileCacheTest, Eviction) {
+    using namespace openspace::globebrowsing;
+    constexpr const size_t NBytes = 4096;
+
+    // Room for three tiles including their headers
+    cache::DiskTileCache cache(_directory, 3 * NBytes + 1024);
+    cache.clear();
+
+    cache.put(1, testTile(0, NBytes), NBytes);
+    cache.put(1, testTile(1, NBytes), NBytes);
+    cache.put(1, testTile(2, NBytes), NBytes);
+    ASSERT_TRUE(cache.get(1, TileIndex(0, 1, 2), NBytes).has_value());
+
+    cache.put(1, testTile(3, NBytes), NBytes);
+    EXPECT_TRUE(cache.exist(1, TileIndex(0, 1, 2))) << "Recently read tile should remain";
+    EXPECT_FALSE(cache.exist(1, TileIndex(1, 1, 2))) << "Oldest tile should be evicted";
+    EXPECT_FALSE(cache.get(1, TileIndex(1, 1, 2), NBytes).has_value());
+    EXPECT_LE(cache.size(), 3 * NBytes + 1024);
+
+    // Tiles with errors are never stored
+    RawTile failed = testTile(4, NBytes);
+    failed.error = RawTile::ReadError::Failure;
+    cache.put(1, failed, NBytes);
+    EXPECT_FALSE(cache.exist(1, failed.tileIndex));
+
+    cache.setMaximumSize(0);
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(DiskTileCacheTest, CorruptIndex) {
+    using namespace openspace::globebrowsing;
+    constexpr const size_t NBytes = 1000;
+
+    {
+        cache::DiskTileCache cache(_directory, 1024 * 1024);
+        cache.clear();
+        cache.put(1, testTile(3, NBytes), NBytes);
+    }
+
+    // Claim far more entries than the index file contains
+    {
+        std::fstream index(
+            _directory + "/index.bin",
+            std::fstream::in | std::fstream::out | std::fstream::binary
+        );
+        ASSERT_TRUE(index.good());
+        const uint64_t nEntries = std::numeric_limits<uint64_t>::max() / 2;
+        index.seekp(2 * sizeof(uint32_t));
+        index.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    }
+
+    // The index is discarded together with the tiles it described
+    cache::DiskTileCache cache(_directory, 1024 * 1024);
+    EXPECT_FALSE(cache.exist(1, TileIndex(3, 1, 2)));
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(DiskTileCacheTest, DatasetIdentifierTracksFile) {
+    using namespace openspace::globebrowsing;
+
+    const TileTextureInitData initData = tileTextureInitData(
+        layergroupid::GroupID::ColorLayers,
+        true
+    );
+    const std::string path = absPath("${CACHE}/test_disktilecache_dataset.txt");
+    std::ofstream(path) << "first";
+    const cache::DiskTileCache::DatasetIdentifier first =
+        cache::DiskTileCache::datasetIdentifier(path, initData, false);
+    EXPECT_EQ(first, cache::DiskTileCache::datasetIdentifier(path, initData, false));
+
+    std::ofstream(path) << "changed contents";
+    EXPECT_NE(first, cache::DiskTileCache::datasetIdentifier(path, initData, false));
+    std::remove(path.c_str());
+}
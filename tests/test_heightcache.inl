@@ -0,0 +1,131 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/heightcache.h>
+#include <modules/globebrowsing/src/rawtile.h>
+#include <glm/gtc/constants.hpp>
+
+namespace {
+    // Creates an unpadded 4x4 height tile in which the value of each pixel is given by
+    // the function \p f of its pixel coordinates
+    template <typename Func>
+    openspace::globebrowsing::RawTile heightTile(
+                                               openspace::globebrowsing::TileIndex index,
+                                                                                  Func f)
+    {
+        using namespace openspace::globebrowsing;
+
+        RawTile tile;
+        tile.tileIndex = index;
+        tile.textureInitData.emplace(
+            4,
+            4,
+            GL_FLOAT,
+            ghoul::opengl::Texture::Format::Red,
+            TileTextureInitData::PadTiles::No
+        );
+        tile.imageData = std::unique_ptr<std::byte[]>(new std::byte[16 * sizeof(float)]);
+        float* values = reinterpret_cast<float*>(tile.imageData.get());
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                values[y * 4 + x] = f(x, y);
+            }
+        }
+        return tile;
+    }
+
+    constexpr const float NoDataValue = -9999.f;
+} // namespace
+
+class HeightCacheTest : public testing::Test {};
+
+TEST_F(HeightCacheTest, BilinearInterpolation) {
+    using namespace openspace::globebrowsing;
+    constexpr const double Pi = glm::pi<double>();
+
+    // The tile covers longitudes [-pi/2, 0] and latitudes [0, pi/2]
+    cache::HeightCache cache(1024 * 1024, { 2.f, 10.f }, NoDataValue);
+    cache.put(heightTile({ 1, 0, 2 }, [](int x, int y) { return x + 10.f * y; }));
+    ASSERT_EQ(cache.size(), 1);
+
+    // Pixel (1, 2)
+    const std::optional<float> h1 = cache.height({ Pi / 4.0, -3.0 * Pi / 8.0 });
+    ASSERT_TRUE(h1.has_value());
+    EXPECT_FLOAT_EQ(*h1, 10.f + 2.f * 21.f);
+
+    // Between pixel (1, 2) and (2, 2)
+    const std::optional<float> h2 = cache.height({ Pi / 4.0, -5.5 * Pi / 16.0 });
+    ASSERT_TRUE(h2.has_value());
+    EXPECT_FLOAT_EQ(*h2, 10.f + 2.f * 21.25f);
+
+    EXPECT_FALSE(cache.height({ Pi / 4.0, Pi / 4.0 }).has_value()) << "Not covered";
+}
+
+TEST_F(HeightCacheTest, FallbackAndMissingData) {
+    using namespace openspace::globebrowsing;
+    constexpr const double Pi = glm::pi<double>();
+
+    cache::HeightCache cache(1024 * 1024, { 1.f, 0.f }, NoDataValue);
+    cache.put(heightTile({ 0, 0, 1 }, [](int, int) { return 100.f; }));
+    cache.put(heightTile({ 1, 0, 2 }, [](int x, int) {
+        return x == 0 ? NoDataValue : 5.f;
+    }));
+
+    const std::vector<std::optional<float>> heights = cache.heights({
+        // Only covered by the coarse tile
+        { 0.1, -3.0 * Pi / 4.0 },
+        // Covered by the fine tile
+        { Pi / 4.0, -Pi / 8.0 },
+        // Next to a missing value in the fine tile
+        { Pi / 4.0, -Pi / 2.0 + 0.01 }
+    });
+    ASSERT_EQ(heights.size(), 3);
+    ASSERT_TRUE(heights[0].has_value());
+    EXPECT_FLOAT_EQ(*heights[0], 100.f);
+    ASSERT_TRUE(heights[1].has_value());
+    EXPECT_FLOAT_EQ(*heights[1], 5.f);
+    EXPECT_FALSE(heights[2].has_value());
+
+    cache.clear();
+    EXPECT_FALSE(cache.height({ 0.1, -3.0 * Pi / 4.0 }).has_value());
+}
+
+TEST_F(HeightCacheTest, RestoreEvictedTile) {
+    using namespace openspace::globebrowsing;
+    constexpr const double Pi = glm::pi<double>();
+
+    // Room for a single 4x4 tile
+    cache::HeightCache cache(16 * sizeof(float), { 1.f, 0.f }, NoDataValue);
+    const RawTile first = heightTile({ 1, 0, 2 }, [](int, int) { return 7.f; });
+    cache.put(first);
+    cache.put(heightTile({ 0, 0, 2 }, [](int, int) { return 3.f; }));
+    EXPECT_FALSE(cache.exist(first.tileIndex));
+
+    // The values are the same as the CPU copy of the texture of a tile
+    cache.put(first.tileIndex, *first.textureInitData, first.imageData.get());
+    EXPECT_TRUE(cache.exist(first.tileIndex));
+    const std::optional<float> h = cache.height({ Pi / 4.0, -Pi / 4.0 });
+    ASSERT_TRUE(h.has_value());
+    EXPECT_FLOAT_EQ(*h, 7.f);
+}
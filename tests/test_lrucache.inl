@@ -23,6 +23,9 @@
  ****************************************************************************************/
 
 #include <modules/globebrowsing/src/lrucache.h>
+#include <algorithm>
+#include <list>
+#include <random>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -95,3 +98,111 @@ TEST_F(LRUCacheTest, StructKey) {
     ASSERT_EQ(lru.get(key1), val2);
     ASSERT_EQ(lru.get(key2), val2);
 }
+
+TEST_F(LRUCacheTest, CostEviction) {
+    // The maximum size is interpreted as the total cost of all items
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(100);
+    lru.put(1, 1, 40);
+    lru.put(2, 2, 40);
+    ASSERT_EQ(lru.totalCost(), 80);
+
+    lru.touch(1);
+    lru.put(3, 3, 40);
+    ASSERT_TRUE(lru.exist(1)) << "Recently touched element should remain in cache";
+    ASSERT_FALSE(lru.exist(2)) << "Least recently used element should be evicted";
+    ASSERT_TRUE(lru.exist(3));
+    ASSERT_EQ(lru.totalCost(), 80);
+
+    // Replacing a value updates its cost
+    lru.put(3, 4, 10);
+    ASSERT_EQ(lru.totalCost(), 50);
+    ASSERT_EQ(lru.get(3), 4);
+
+    lru.setMaximumCacheSize(20);
+    ASSERT_EQ(lru.size(), 1);
+    ASSERT_TRUE(lru.exist(3));
+}
+
+TEST_F(LRUCacheTest, Extract) {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(100);
+    lru.put(1, 10, 40);
+    lru.put(2, 20, 40);
+
+    std::optional<int> value = lru.extract(1);
+    ASSERT_TRUE(value.has_value());
+    ASSERT_EQ(*value, 10);
+    ASSERT_FALSE(lru.exist(1));
+    ASSERT_EQ(lru.totalCost(), 40);
+    ASSERT_EQ(lru.statistics().evictions, 0);
+
+    ASSERT_FALSE(lru.extract(1).has_value());
+}
+
+TEST_F(LRUCacheTest, Statistics) {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(2);
+    lru.put(1, 1);
+    lru.put(2, 2);
+    lru.put(3, 3);
+
+    ASSERT_NE(lru.tryGet(2), nullptr);
+    ASSERT_EQ(*lru.tryGet(3), 3);
+    ASSERT_EQ(lru.tryGet(1), nullptr);
+
+    ASSERT_EQ(lru.statistics().hits, 2);
+    ASSERT_EQ(lru.statistics().misses, 1);
+    ASSERT_EQ(lru.statistics().evictions, 1);
+
+    lru.resetStatistics();
+    ASSERT_EQ(lru.statistics().hits, 0);
+}
+
+TEST_F(LRUCacheTest, MatchesReferenceImplementation) {
+    // Compare against a straightforward list based implementation with a key range that
+    // forces plenty of collisions, removals, and slot reuse
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(64);
+    std::list<std::pair<int, int>> reference;
+
+    std::mt19937 random(1337);
+    std::uniform_int_distribution<int> keyDistribution(0, 255);
+    for (int i = 0; i < 100000; ++i) {
+        const int key = keyDistribution(random);
+        auto it = std::find_if(
+            reference.begin(),
+            reference.end(),
+            [key](const std::pair<int, int>& p) { return p.first == key; }
+        );
+
+        switch (random() % 4) {
+            case 0:
+            case 1:
+                if (it != reference.end()) {
+                    reference.erase(it);
+                }
+                reference.emplace_front(key, i);
+                if (reference.size() > 64) {
+                    reference.pop_back();
+                }
+                lru.put(key, i);
+                break;
+            case 2:
+                ASSERT_EQ(lru.touch(key), it != reference.end());
+                if (it != reference.end()) {
+                    reference.splice(reference.begin(), reference, it);
+                }
+                break;
+            case 3:
+                if (!reference.empty()) {
+                    std::pair<int, int> item = lru.popLRU();
+                    ASSERT_EQ(item, reference.back());
+                    reference.pop_back();
+                }
+                break;
+        }
+        ASSERT_EQ(lru.size(), reference.size());
+    }
+
+    for (const std::pair<int, int>& p : reference) {
+        ASSERT_EQ(lru.popMRU(), p);
+    }
+    ASSERT_TRUE(lru.isEmpty());
+}
@@ -0,0 +1,67 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/memoryawaretilecache.h>
+
+class MemoryAwareTileCacheTest : public testing::Test {};
+
+TEST_F(MemoryAwareTileCacheTest, ReplaceTile) {
+    using namespace openspace::globebrowsing;
+
+    cache::MemoryAwareTileCache tileCache;
+    const TileTextureInitData initData = tileTextureInitData(
+        layergroupid::GroupID::ColorLayers,
+        true
+    );
+
+    // The textures are only handed around and never used, so they do not have to exist
+    int first = 0;
+    int second = 0;
+    ghoul::opengl::Texture* firstTexture =
+        reinterpret_cast<ghoul::opengl::Texture*>(&first);
+    ghoul::opengl::Texture* secondTexture =
+        reinterpret_cast<ghoul::opengl::Texture*>(&second);
+
+    const cache::ProviderTileKey key = { TileIndex(1, 2, 3), 1 };
+    tileCache.put(
+        key,
+        initData.hashKey,
+        Tile{ firstTexture, std::nullopt, Tile::Status::OK }
+    );
+    EXPECT_EQ(tileCache.tileDataSize(), initData.totalNumBytes);
+
+    tileCache.put(
+        key,
+        initData.hashKey,
+        Tile{ secondTexture, std::nullopt, Tile::Status::OK }
+    );
+    EXPECT_EQ(tileCache.tileDataSize(), initData.totalNumBytes);
+    EXPECT_EQ(tileCache.get(key).texture, secondTexture);
+
+    // The texture of the replaced tile is handed out again
+    EXPECT_EQ(tileCache.texture(initData), firstTexture);
+}
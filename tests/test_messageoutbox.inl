@@ -0,0 +1,118 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/network/messageoutbox.h>
+
+class MessageOutboxTest : public testing::Test {};
+
+namespace {
+    openspace::MessageOutbox::EncodedMessage message(char id) {
+        return std::make_shared<const std::vector<char>>(1, id);
+    }
+} // namespace
+
+TEST_F(MessageOutboxTest, StalledPeerCoalescesKeyframes) {
+    std::vector<char> sent;
+    std::atomic_size_t dropped = 0;
+    openspace::MessageOutbox outbox(
+        [&sent](const std::vector<char>& m) { sent.push_back(m[0]); },
+        dropped,
+        2
+    );
+
+    // The peer never acknowledges, so only the first two keyframes are sent
+    for (char i = 0; i < 10; ++i) {
+        if (outbox.push(message(i), true)) {
+            outbox.flush();
+        }
+    }
+    EXPECT_EQ(sent, std::vector<char>({ 0, 1 }));
+    EXPECT_EQ(outbox.nWaitingMessages(), 1u);
+    EXPECT_EQ(dropped.load(), 7u);
+
+    // The acknowledgement releases the newest keyframe only
+    ASSERT_TRUE(outbox.acknowledgeKeyframe());
+    outbox.flush();
+    EXPECT_EQ(sent, std::vector<char>({ 0, 1, 9 }));
+    EXPECT_EQ(outbox.nWaitingMessages(), 0u);
+
+    // Nothing is waiting anymore, so further acknowledgements do not need a flush
+    EXPECT_FALSE(outbox.acknowledgeKeyframe());
+    EXPECT_FALSE(outbox.acknowledgeKeyframe());
+    EXPECT_EQ(dropped.load(), 7u);
+}
+
+TEST_F(MessageOutboxTest, OtherMessagesAreKeptInOrder) {
+    std::vector<char> sent;
+    std::atomic_size_t dropped = 0;
+    openspace::MessageOutbox outbox(
+        [&sent](const std::vector<char>& m) { sent.push_back(m[0]); },
+        dropped,
+        1
+    );
+
+    ASSERT_TRUE(outbox.push(message('a'), true));
+    outbox.flush();
+
+    // The keyframe has to wait for an acknowledgement and holds back the messages
+    // behind it
+    EXPECT_FALSE(outbox.push(message('b'), true));
+    EXPECT_FALSE(outbox.push(message('c'), false));
+    EXPECT_EQ(outbox.nWaitingMessages(), 2u);
+
+    // Replacing the waiting keyframe moves it behind the other message, which can then
+    // be sent right away
+    ASSERT_TRUE(outbox.push(message('d'), true));
+    outbox.flush();
+    EXPECT_EQ(sent, std::vector<char>({ 'a', 'c' }));
+    EXPECT_EQ(outbox.nWaitingMessages(), 1u);
+    EXPECT_EQ(dropped.load(), 1u);
+
+    ASSERT_TRUE(outbox.acknowledgeKeyframe());
+    outbox.flush();
+    EXPECT_EQ(sent, std::vector<char>({ 'a', 'c', 'd' }));
+}
+
+TEST_F(MessageOutboxTest, OneFlushAtATime) {
+    std::vector<char> sent;
+    std::atomic_size_t dropped = 0;
+    openspace::MessageOutbox outbox(
+        [&sent](const std::vector<char>& m) { sent.push_back(m[0]); },
+        dropped
+    );
+
+    EXPECT_TRUE(outbox.push(message('a'), false));
+    // The pending flush will send the following messages as well
+    EXPECT_FALSE(outbox.push(message('b'), false));
+    EXPECT_FALSE(outbox.push(message('c'), true));
+    outbox.flush();
+    EXPECT_EQ(sent, std::vector<char>({ 'a', 'b', 'c' }));
+
+    EXPECT_TRUE(outbox.push(message('d'), false));
+    outbox.flush();
+    EXPECT_EQ(sent, std::vector<char>({ 'a', 'b', 'c', 'd' }));
+    EXPECT_EQ(dropped.load(), 0u);
+}
@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/include/messagepackwriter.h>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+    nlohmann::json decode(const std::string& buffer) {
+        return nlohmann::json::from_msgpack(
+            std::vector<uint8_t>(buffer.begin(), buffer.end())
+        );
+    }
+} // namespace
+
+class MessagePackWriterTest : public testing::Test {};
+
+TEST_F(MessagePackWriterTest, Integers) {
+    const std::vector<int64_t> values = {
+        0, 1, 127, 128, 255, 256, 65535, 65536, 4294967295, 4294967296,
+        std::numeric_limits<int64_t>::max(), -1, -32, -33, -128, -129, -32768, -32769,
+        std::numeric_limits<int32_t>::min(),
+        static_cast<int64_t>(std::numeric_limits<int32_t>::min()) - 1,
+        std::numeric_limits<int64_t>::min()
+    };
+    for (int64_t v : values) {
+        std::string buffer;
+        openspace::MessagePackWriter(buffer).writeInteger(v);
+        EXPECT_EQ(decode(buffer).get<int64_t>(), v);
+    }
+
+    // Positive values use the smallest encoding and negative fixints a single byte
+    std::string buffer;
+    openspace::MessagePackWriter writer(buffer);
+    writer.writeInteger(127);
+    writer.writeInteger(-32);
+    writer.writeInteger(128);
+    EXPECT_EQ(buffer, std::string("\x7f\xe0\xcc\x80"));
+}
+
+TEST_F(MessagePackWriterTest, UnsignedIntegers) {
+    const std::vector<uint64_t> values = {
+        0, 200, static_cast<uint64_t>(std::numeric_limits<int64_t>::max()),
+        static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1,
+        std::numeric_limits<uint64_t>::max()
+    };
+    for (uint64_t v : values) {
+        std::string buffer;
+        openspace::MessagePackWriter(buffer).writeUnsignedInteger(v);
+        const nlohmann::json json = decode(buffer);
+        EXPECT_TRUE(json.is_number_unsigned());
+        EXPECT_EQ(json.get<uint64_t>(), v);
+    }
+}
+
+TEST_F(MessagePackWriterTest, Doubles) {
+    const std::vector<double> values = {
+        0.0, 0.5, -2.25, 3.141592653589793, 1e300, -1e-300,
+        std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()
+    };
+    for (double v : values) {
+        std::string buffer;
+        openspace::MessagePackWriter(buffer).writeDouble(v);
+        const nlohmann::json json = decode(buffer);
+        EXPECT_TRUE(json.is_number_float());
+        EXPECT_EQ(json.get<double>(), v);
+    }
+}
+
+TEST_F(MessagePackWriterTest, Strings) {
+    // The lengths around the limits of fixstr, str 8, and str 16
+    for (size_t length : { 0, 1, 31, 32, 255, 256, 65535, 65536 }) {
+        std::string value(length, '\0');
+        for (size_t i = 0; i < length; ++i) {
+            value[i] = static_cast<char>('a' + i % 26);
+        }
+
+        std::string buffer;
+        openspace::MessagePackWriter(buffer).writeString(value);
+        EXPECT_EQ(decode(buffer).get<std::string>(), value) << "Length " << length;
+    }
+}
+
+TEST_F(MessagePackWriterTest, Arrays) {
+    // The lengths around the limits of fixarray and array 16
+    for (uint32_t length : { 0u, 15u, 16u, 65535u, 65536u }) {
+        std::string buffer;
+        openspace::MessagePackWriter writer(buffer);
+        writer.writeArray(length);
+        nlohmann::json expected = nlohmann::json::array();
+        for (uint32_t i = 0; i < length; ++i) {
+            writer.writeInteger(i);
+            expected.push_back(i);
+        }
+        EXPECT_EQ(decode(buffer), expected) << "Length " << length;
+    }
+}
+
+TEST_F(MessagePackWriterTest, NestedObjects) {
+    std::string buffer;
+    openspace::MessagePackWriter writer(buffer);
+    writer.writeMap(3);
+    writer.writeString("topic");
+    writer.writeInteger(-5);
+    writer.writeString("payload");
+    writer.writeMap(2);
+    writer.writeString("values");
+    writer.writeArray(3);
+    writer.writeBool(true);
+    writer.writeNil();
+    writer.writeMap(1);
+    writer.writeString(std::string(40, 'k'));
+    writer.writeDouble(1.5);
+    writer.writeString("empty");
+    writer.writeMap(0);
+    writer.writeString("many");
+    writer.writeMap(20);
+    nlohmann::json many = nlohmann::json::object();
+    for (int i = 0; i < 20; ++i) {
+        writer.writeString("key" + std::to_string(i));
+        writer.writeInteger(i * 1000);
+        many["key" + std::to_string(i)] = i * 1000;
+    }
+
+    nlohmann::json expected = {
+        { "topic", -5 },
+        {
+            "payload",
+            {
+                { "values", { true, nullptr, { { std::string(40, 'k'), 1.5 } } } },
+                { "empty", nlohmann::json::object() }
+            }
+        },
+        { "many", many }
+    };
+    EXPECT_EQ(decode(buffer), expected);
+}
+
+TEST_F(MessagePackWriterTest, JsonText) {
+    const std::vector<std::string> texts = {
+        "true", " false ", "null", "0", "-17", "123456789012", "2.5", "-1e-3",
+        "9223372036854775807", "-9223372036854775808", "18446744073709551615",
+        "[]", "[1, -2, 3.5]",
+        "[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19]",
+        "[1, [2, 3]]", "[1, \"a\"]",
+        "{\"a\": {\"b\": [1, 2.5, \"c\"]}, \"d\": \"" + std::string(300, 'e') + "\"}",
+        "\"" + std::string(40, 's') + "\""
+    };
+    for (const std::string& text : texts) {
+        std::string buffer;
+        openspace::MessagePackWriter(buffer).writeJsonText(text);
+        EXPECT_EQ(decode(buffer), nlohmann::json::parse(text)) << text;
+    }
+
+    // Integers above the signed range remain integers
+    std::string buffer;
+    openspace::MessagePackWriter(buffer).writeJsonText("9223372036854775808");
+    nlohmann::json json = decode(buffer);
+    ASSERT_TRUE(json.is_number_unsigned());
+    EXPECT_EQ(json.get<uint64_t>(), 9223372036854775808ull);
+
+    // Integers beyond the range of 64 bits can only be represented as doubles
+    buffer.clear();
+    openspace::MessagePackWriter(buffer).writeJsonText("-9223372036854775809");
+    json = decode(buffer);
+    ASSERT_TRUE(json.is_number_float());
+    EXPECT_EQ(json.get<double>(), -9223372036854775809.0);
+
+    buffer.clear();
+    openspace::MessagePackWriter(buffer).writeJsonText("18446744073709551616");
+    json = decode(buffer);
+    ASSERT_TRUE(json.is_number_float());
+    EXPECT_EQ(json.get<double>(), 18446744073709551616.0);
+}
@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/gaia/rendering/octreemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr const int MaxDist = 2;
+    constexpr const int MaxStarsPerNode = 16;
+
+    // Stars spread over all branches, with some of them clustered so that the Octree
+    // becomes deep in places. The magnitudes are distinct, as the order of stars with
+    // the same magnitude in the LOD cache depends on the order in which they were stored
+    std::vector<float> testStars(size_t nStars) {
+        std::mt19937 random(1337);
+        std::uniform_real_distribution<float> position(-1.9f, 1.9f);
+        std::uniform_real_distribution<float> cluster(0.1f, 0.15f);
+        std::uniform_real_distribution<float> value(-1.f, 1.f);
+        std::vector<size_t> magnitudeOrder(nStars);
+        std::iota(magnitudeOrder.begin(), magnitudeOrder.end(), 0);
+        std::shuffle(magnitudeOrder.begin(), magnitudeOrder.end(), random);
+
+        std::vector<float> stars;
+        stars.reserve(nStars * 8);
+        for (size_t i = 0; i < nStars; ++i) {
+            std::uniform_real_distribution<float>& pos = (i % 3 == 0) ?
+                cluster :
+                position;
+            stars.push_back(pos(random));
+            stars.push_back(pos(random));
+            stars.push_back(pos(random));
+            stars.push_back(-5.f + 0.001f * magnitudeOrder[i]);
+            for (int v = 0; v < 4; ++v) {
+                stars.push_back(value(random));
+            }
+        }
+        return stars;
+    }
+
+    struct NodeStructure {
+        bool isLeaf;
+        int32_t numStars;
+    };
+
+    // Returns whether every node of the unsliced \p octree is a leaf and the number of
+    // stars stored in it, which for inner nodes is the size of their LOD cache
+    std::vector<NodeStructure> octreeStructure(openspace::OctreeManager& octree,
+                                               const std::string& file)
+    {
+        {
+            std::ofstream out(file, std::ios::binary);
+            octree.writeToFile(out, false);
+        }
+        std::ifstream in(file, std::ios::binary);
+        // Skip the values per star, the maximum number of stars, and the maximum distance
+        in.seekg(3 * sizeof(int32_t));
+        std::vector<NodeStructure> nodes;
+        NodeStructure node;
+        while (in.read(reinterpret_cast<char*>(&node.isLeaf), sizeof(bool)) &&
+               in.read(reinterpret_cast<char*>(&node.numStars), sizeof(int32_t)))
+        {
+            nodes.push_back(node);
+        }
+        return nodes;
+    }
+
+    // Writes the structure and the data of all nodes of the sliced \p octree to a file
+    // and returns the contents of that file
+    std::string octreeContents(openspace::OctreeManager& octree, const std::string& file)
+    {
+        for (size_t i = 0; i < 8; ++i) {
+            octree.sliceLodData(i);
+        }
+        {
+            std::ofstream out(file, std::ios::binary);
+            octree.writeToFile(out, true);
+        }
+        std::ifstream in(file, std::ios::binary);
+        return std::string(
+            std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>()
+        );
+    }
+} // namespace
+
+class OctreeManagerTest : public testing::Test {};
+
+TEST_F(OctreeManagerTest, InsertBatchMatchesInsert) {
+    using namespace openspace;
+    constexpr const size_t NStars = 5000;
+
+    const std::vector<float> stars = testStars(NStars);
+
+    OctreeManager reference;
+    reference.initOctree(0, MaxDist, MaxStarsPerNode);
+    for (size_t i = 0; i < NStars; ++i) {
+        reference.insert(std::vector<float>(
+            stars.begin() + i * 8,
+            stars.begin() + (i + 1) * 8
+        ));
+    }
+
+    // A single batch, and several batches that continue in an existing Octree
+    OctreeManager single;
+    single.initOctree(0, MaxDist, MaxStarsPerNode);
+    single.insertBatch(OctreeManager::StarBatch(stars.data(), NStars, 8));
+
+    OctreeManager multiple;
+    multiple.initOctree(0, MaxDist, MaxStarsPerNode);
+    const std::vector<size_t> batchBegins = { 0, 1, 100, 1000, 3000, NStars };
+    for (size_t i = 0; i + 1 < batchBegins.size(); ++i) {
+        multiple.insertBatch(OctreeManager::StarBatch(
+            stars.data() + batchBegins[i] * 8,
+            batchBegins[i + 1] - batchBegins[i],
+            8
+        ));
+    }
+
+    EXPECT_GT(reference.totalDepth(), 3u);
+    EXPECT_EQ(single.totalDepth(), reference.totalDepth());
+    EXPECT_EQ(single.numLeafNodes(), reference.numLeafNodes());
+    EXPECT_EQ(single.numInnerNodes(), reference.numInnerNodes());
+    EXPECT_EQ(multiple.totalDepth(), reference.totalDepth());
+    EXPECT_EQ(multiple.numLeafNodes(), reference.numLeafNodes());
+    EXPECT_EQ(multiple.numInnerNodes(), reference.numInnerNodes());
+
+    const std::string referenceContents = octreeContents(
+        reference,
+        absPath("${CACHE}/test_octreemanager_insert.bin")
+    );
+    EXPECT_EQ(
+        octreeContents(single, absPath("${CACHE}/test_octreemanager_batch.bin")),
+        referenceContents
+    );
+    EXPECT_EQ(
+        octreeContents(multiple, absPath("${CACHE}/test_octreemanager_batches.bin")),
+        referenceContents
+    );
+}
+
+TEST_F(OctreeManagerTest, InsertBatchLimitsLodCache) {
+    using namespace openspace;
+    constexpr const size_t NStars = 50000;
+    const std::vector<float> stars = testStars(NStars);
+
+    OctreeManager reference;
+    reference.initOctree(0, MaxDist, MaxStarsPerNode);
+    for (size_t i = 0; i < NStars; ++i) {
+        reference.insert(std::vector<float>(
+            stars.begin() + i * 8,
+            stars.begin() + (i + 1) * 8
+        ));
+    }
+
+    // All stars of a large file in one batch. Inner nodes only ever add stars to their
+    // LOD cache until it is sliced, so its size now is the largest it has been
+    OctreeManager batch;
+    batch.initOctree(0, MaxDist, MaxStarsPerNode);
+    batch.insertBatch(OctreeManager::StarBatch(stars.data(), NStars, 8));
+
+    const std::vector<NodeStructure> referenceNodes = octreeStructure(
+        reference,
+        absPath("${CACHE}/test_octreemanager_insert_structure.bin")
+    );
+    const std::vector<NodeStructure> batchNodes = octreeStructure(
+        batch,
+        absPath("${CACHE}/test_octreemanager_batch_structure.bin")
+    );
+    ASSERT_EQ(batchNodes.size(), referenceNodes.size());
+
+    size_t nReferenceLodStars = 0;
+    size_t nBatchLodStars = 0;
+    for (size_t i = 0; i < batchNodes.size(); ++i) {
+        ASSERT_EQ(batchNodes[i].isLeaf, referenceNodes[i].isLeaf);
+        if (batchNodes[i].isLeaf) {
+            EXPECT_EQ(batchNodes[i].numStars, referenceNodes[i].numStars);
+            continue;
+        }
+
+        // The threshold of the LOD cache rises while the batch is inserted in the same
+        // way as with single stars, instead of every star passing the initial threshold
+        EXPECT_LE(batchNodes[i].numStars, 2 * referenceNodes[i].numStars) << "Node " << i;
+        nReferenceLodStars += referenceNodes[i].numStars;
+        nBatchLodStars += batchNodes[i].numStars;
+    }
+    EXPECT_LT(nBatchLodStars, NStars);
+    EXPECT_LE(nBatchLodStars, nReferenceLodStars * 5 / 4);
+
+    EXPECT_EQ(
+        octreeContents(batch, absPath("${CACHE}/test_octreemanager_batch.bin")),
+        octreeContents(reference, absPath("${CACHE}/test_octreemanager_insert.bin"))
+    );
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/properties/propertyindex.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/boolproperty.h>
+
+class PropertyIndexTest : public testing::Test {};
+
+TEST_F(PropertyIndexTest, MatchesPattern) {
+    using openspace::properties::PropertyIndex;
+    EXPECT_TRUE(PropertyIndex::matchesPattern("Scene.Earth.Enabled", "Scene.*.Enabled"));
+    EXPECT_TRUE(PropertyIndex::matchesPattern("Scene.Earth.Enabled", "*Earth*"));
+    EXPECT_TRUE(PropertyIndex::matchesPattern("Scene.Earth.Enabled", "*"));
+    EXPECT_TRUE(PropertyIndex::matchesPattern("a.b.a.b", "*a.b"));
+    EXPECT_FALSE(PropertyIndex::matchesPattern("Scene.Earth.Enabled", "Scene.*.Opacity"));
+    EXPECT_FALSE(PropertyIndex::matchesPattern("Scene.Earth.Enabled", "Scene.Earth"));
+    EXPECT_FALSE(PropertyIndex::matchesPattern("SceneXEarth.Enabled", "Scene.*"));
+}
+
+TEST_F(PropertyIndexTest, FollowsOwnerTree) {
+    using namespace openspace::properties;
+
+    PropertyOwner root({ "" });
+    PropertyOwner scene({ "Scene" });
+    PropertyOwner earth({ "Earth" });
+    PropertyOwner moon({ "Moon" });
+    BoolProperty earthEnabled({ "Enabled", "Enabled", "" });
+    BoolProperty moonEnabled({ "Enabled", "Enabled", "" });
+    BoolProperty moonTrail({ "Trail", "Trail", "" });
+
+    earth.addProperty(earthEnabled);
+    root.addPropertySubOwner(scene);
+    scene.addPropertySubOwner(earth);
+
+    // Attaching the index picks up the existing tree
+    PropertyIndex index;
+    root.setPropertyIndex(&index);
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_EQ(index.property("Scene.Earth.Enabled"), &earthEnabled);
+
+    // Subtrees and properties added later are indexed as well
+    moon.addProperty(moonEnabled);
+    scene.addPropertySubOwner(moon);
+    moon.addProperty(moonTrail);
+    EXPECT_EQ(index.size(), 3);
+    EXPECT_EQ(index.property("Scene.Moon.Trail"), &moonTrail);
+
+    std::vector<Property*> enabled = index.matches("Scene.*.Enabled");
+    ASSERT_EQ(enabled.size(), 2);
+    EXPECT_NE(std::find(enabled.begin(), enabled.end(), &moonEnabled), enabled.end());
+    EXPECT_EQ(index.matches("*.Moon.*").size(), 2);
+    EXPECT_EQ(index.matches("Scene.M*Trail").size(), 1);
+    EXPECT_TRUE(index.matches("Scene.*.Opacity").empty());
+
+    // Renaming an owner reindexes its subtree
+    moon.setIdentifier("Luna");
+    EXPECT_EQ(index.property("Scene.Moon.Trail"), nullptr);
+    EXPECT_EQ(index.property("Scene.Luna.Trail"), &moonTrail);
+
+    moon.removeProperty(moonTrail);
+    scene.removePropertySubOwner(earth);
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_EQ(index.property("Scene.Earth.Enabled"), nullptr);
+    EXPECT_EQ(index.matches("*Enabled").size(), 1);
+
+    // Detached owners no longer update the index
+    earth.addProperty(moonTrail);
+    EXPECT_EQ(index.size(), 1);
+
+    root.setPropertyIndex(nullptr);
+    EXPECT_EQ(index.size(), 0);
+}
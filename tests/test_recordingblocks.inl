@@ -0,0 +1,359 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/recordingblocks.h>
+#include <openspace/interaction/sessionrecording.h>
+#include <openspace/network/messagestructures.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    using openspace::interaction::RecordingBlockReader;
+
+    constexpr const size_t EntryHeaderSize = sizeof(char) + 3 * sizeof(double);
+
+    // Creates an entry of the type 't' whose payload consists of its size followed by
+    // \p nBytes bytes that depend on the index \p i of the entry
+    std::vector<char> testEntry(int i, uint32_t nBytes) {
+        std::vector<char> entry(EntryHeaderSize + sizeof(uint32_t) + nBytes);
+        entry[0] = 't';
+        const double timestamps[3] = { 10.0 + i, static_cast<double>(i), 100.0 + i };
+        std::memcpy(entry.data() + 1, timestamps, sizeof(timestamps));
+        std::memcpy(entry.data() + EntryHeaderSize, &nBytes, sizeof(uint32_t));
+        for (uint32_t j = 0; j < nBytes; ++j) {
+            entry[EntryHeaderSize + sizeof(uint32_t) + j] = static_cast<char>(i + j);
+        }
+        return entry;
+    }
+
+    // Splits the entry data of all blocks back into the entries created by testEntry
+    std::vector<std::vector<char>> readTestEntries(std::istream& in,
+                                                   const RecordingBlockReader& reader)
+    {
+        std::vector<std::vector<char>> entries;
+        std::vector<char> data;
+        for (size_t i = 0; i < reader.blocks().size(); ++i) {
+            EXPECT_TRUE(reader.readBlockData(in, i, data));
+            size_t offset = 0;
+            size_t nEntries = 0;
+            while (offset < data.size()) {
+                uint32_t nBytes = 0;
+                std::memcpy(
+                    &nBytes,
+                    data.data() + offset + EntryHeaderSize,
+                    sizeof(uint32_t)
+                );
+                const size_t size = EntryHeaderSize + sizeof(uint32_t) + nBytes;
+                entries.emplace_back(
+                    data.begin() + offset,
+                    data.begin() + offset + size
+                );
+                offset += size;
+                nEntries++;
+            }
+            EXPECT_EQ(offset, data.size());
+            EXPECT_EQ(nEntries, reader.blocks()[i].header.nEntries());
+        }
+        return entries;
+    }
+
+    // Keeps a copy of the stream contents after every write, which are all the states
+    // in which an interrupted recording can be left
+    class SnapshotBuffer : public std::stringbuf {
+    public:
+        std::vector<std::string> snapshots;
+
+    protected:
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            const std::streamsize result = std::stringbuf::xsputn(s, n);
+            snapshots.push_back(str());
+            return result;
+        }
+    };
+} // namespace
+
+class RecordingBlocksTest : public testing::Test {};
+
+TEST_F(RecordingBlocksTest, EntriesSpanningBlocks) {
+    using namespace openspace::interaction;
+
+    // 1000 byte entries do not divide the block size, so the blocks are not filled
+    // completely and the entries continue in the next block
+    std::vector<std::vector<char>> entries;
+    for (int i = 0; i < 200; ++i) {
+        entries.push_back(testEntry(i, 1000));
+    }
+    // An entry that is larger than a block gets a block of its own
+    entries.push_back(testEntry(200, 100 * 1024));
+    entries.push_back(testEntry(201, 10));
+
+    std::stringstream stream;
+    RecordingBlockWriter writer;
+    for (const std::vector<char>& e : entries) {
+        writer.addEntry(stream, e.data(), e.size());
+    }
+    writer.flush(stream);
+    ASSERT_EQ(stream.str().size() % RecordingBlockWriter::BlockSize, 0u);
+
+    stream.seekg(0);
+    RecordingBlockReader reader;
+    ASSERT_TRUE(reader.readIndex(stream));
+    const std::vector<RecordingBlockReader::Block>& blocks = reader.blocks();
+    ASSERT_EQ(blocks.size(), 6u);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(blocks[i].header.blockSize, RecordingBlockWriter::BlockSize);
+        EXPECT_EQ(blocks[i].offset, i * RecordingBlockWriter::BlockSize);
+    }
+    EXPECT_EQ(blocks[4].header.nEntries(), 1u);
+    EXPECT_EQ(blocks[4].header.blockSize, 2 * RecordingBlockWriter::BlockSize);
+    EXPECT_EQ(blocks[5].header.nEntries(), 1u);
+
+    // The first timestamps of a block are those of its first entry
+    EXPECT_EQ(blocks[0].header.firstTimestampRecorded, 0.0);
+    const double firstInSecond = static_cast<double>(blocks[0].header.nEntries());
+    EXPECT_EQ(blocks[1].header.firstTimestampApplication, 10.0 + firstInSecond);
+    EXPECT_EQ(blocks[1].header.firstTimestampRecorded, firstInSecond);
+    EXPECT_EQ(blocks[1].header.firstTimestampSimulation, 100.0 + firstInSecond);
+
+    EXPECT_EQ(readTestEntries(stream, reader), entries);
+}
+
+TEST_F(RecordingBlocksTest, TruncatedLastBlock) {
+    using namespace openspace::interaction;
+
+    std::vector<std::vector<char>> entries;
+    for (int i = 0; i < 100; ++i) {
+        entries.push_back(testEntry(i, 1000));
+    }
+
+    std::stringstream stream;
+    RecordingBlockWriter writer;
+    for (const std::vector<char>& e : entries) {
+        writer.addEntry(stream, e.data(), e.size());
+    }
+    writer.flush(stream);
+    const std::string complete = stream.str();
+    ASSERT_EQ(complete.size(), 2u * RecordingBlockWriter::BlockSize);
+
+    RecordingBlockReader reader;
+    {
+        // Only the header and a part of the entries of the last block were written
+        std::stringstream truncated(
+            complete.substr(0, RecordingBlockWriter::BlockSize + 1000)
+        );
+        ASSERT_TRUE(reader.readIndex(truncated));
+        ASSERT_EQ(reader.blocks().size(), 1u);
+
+        const std::vector<std::vector<char>> read = readTestEntries(truncated, reader);
+        ASSERT_EQ(read.size(), reader.blocks()[0].header.nEntries());
+        EXPECT_TRUE(std::equal(read.begin(), read.end(), entries.begin()));
+    }
+    {
+        // Not even the header of the last block was written completely
+        std::stringstream truncated(
+            complete.substr(0, RecordingBlockWriter::BlockSize + 10)
+        );
+        ASSERT_TRUE(reader.readIndex(truncated));
+        EXPECT_EQ(reader.blocks().size(), 1u);
+    }
+    {
+        // The last block is complete apart from its padding
+        const size_t dataSize = reader.blocks()[0].header.dataSize;
+        std::stringstream truncated;
+        truncated.str(complete);
+        truncated.seekg(RecordingBlockWriter::BlockSize);
+        RecordingBlockHeader header;
+        truncated.read(reinterpret_cast<char*>(&header), sizeof(RecordingBlockHeader));
+        truncated.str(complete.substr(
+            0,
+            RecordingBlockWriter::BlockSize + sizeof(RecordingBlockHeader) +
+                header.dataSize
+        ));
+        ASSERT_TRUE(reader.readIndex(truncated));
+        ASSERT_EQ(reader.blocks().size(), 2u);
+        EXPECT_EQ(reader.blocks()[0].header.dataSize, dataSize);
+        EXPECT_EQ(readTestEntries(truncated, reader), entries);
+    }
+}
+
+TEST_F(RecordingBlocksTest, Checkpoint) {
+    using namespace openspace::interaction;
+
+    std::vector<std::vector<char>> entries;
+    for (int i = 0; i < 100; ++i) {
+        entries.push_back(testEntry(i, 1000));
+    }
+
+    std::stringstream reference;
+    {
+        RecordingBlockWriter writer;
+        for (const std::vector<char>& e : entries) {
+            writer.addEntry(reference, e.data(), e.size());
+        }
+        writer.flush(reference);
+    }
+
+    std::stringstream stream;
+    RecordingBlockWriter writer;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        writer.addEntry(stream, entries[i].data(), entries[i].size());
+        writer.checkpoint(stream);
+
+        // If the recording was interrupted now, all entries so far could be read
+        if (i % 25 == 0) {
+            std::stringstream interrupted(stream.str());
+            RecordingBlockReader reader;
+            ASSERT_TRUE(reader.readIndex(interrupted));
+            const std::vector<std::vector<char>> read =
+                readTestEntries(interrupted, reader);
+            ASSERT_EQ(read.size(), i + 1);
+            EXPECT_TRUE(std::equal(read.begin(), read.end(), entries.begin()));
+        }
+    }
+    writer.flush(stream);
+
+    // Checkpoints do not change the finished recording
+    EXPECT_EQ(stream.str(), reference.str());
+}
+
+TEST_F(RecordingBlocksTest, InterruptedCheckpoint) {
+    using namespace openspace::interaction;
+
+    std::vector<std::vector<char>> entries;
+    for (int i = 0; i < 100; ++i) {
+        entries.push_back(testEntry(i, 1000));
+    }
+
+    SnapshotBuffer buffer;
+    std::ostream stream(&buffer);
+    RecordingBlockWriter writer;
+    size_t nCheckpointedEntries = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const size_t firstSnapshot = buffer.snapshots.size();
+        writer.addEntry(stream, entries[i].data(), entries[i].size());
+        writer.checkpoint(stream);
+
+        // An interruption during any of the writes must not lose the entries of the
+        // previous checkpoints
+        for (size_t j = firstSnapshot; j < buffer.snapshots.size(); ++j) {
+            std::stringstream interrupted(buffer.snapshots[j]);
+            RecordingBlockReader reader;
+            ASSERT_TRUE(reader.readIndex(interrupted)) << "Entry " << i;
+            const std::vector<std::vector<char>> read =
+                readTestEntries(interrupted, reader);
+            ASSERT_GE(read.size(), nCheckpointedEntries) << "Entry " << i;
+            EXPECT_TRUE(std::equal(read.begin(), read.end(), entries.begin()));
+        }
+        nCheckpointedEntries = i + 1;
+    }
+}
+
+TEST_F(RecordingBlocksTest, ConvertAsciiToBinary) {
+    using namespace openspace::interaction;
+
+    const std::string asciiFile = absPath("${CACHE}/test_recordingblocks_ascii.osrectxt");
+    const std::string binaryFile = absPath("${CACHE}/test_recordingblocks_binary.osrec");
+    {
+        std::ofstream f(asciiFile);
+        f << "OpenSpace_record/playback00.85A\n";
+        f << "camera 1.5 0.5 100.25 1 2 3 0.5 0.5 0.5 0.5 2.5 F Earth\n";
+        f << "time 2.5 1.5 101.25 0.1 P J\n";
+        f << "script 3.5 2.5 102.25 2 openspace.printInfo('a')\n";
+        f << "openspace.printInfo('b')\n";
+        f << "camera 4.5 3.5 103.25 -1 -2 -3 0 0 0 1 1 R Mars\n";
+    }
+
+    SessionRecording recording;
+    ASSERT_TRUE(recording.convertToBinary(asciiFile, binaryFile));
+    EXPECT_FALSE(recording.convertToBinary(binaryFile, asciiFile + ".twice")) <<
+        "Converting a recording that is already stored in blocks must fail";
+
+    std::ifstream in(binaryFile, std::ios::binary);
+    std::string header;
+    std::getline(in, header);
+    EXPECT_EQ(header, "OpenSpace_record/playback01.00B");
+
+    RecordingBlockReader reader;
+    ASSERT_TRUE(reader.readIndex(in));
+    ASSERT_EQ(reader.blocks().size(), 1u);
+    const RecordingBlockHeader& h = reader.blocks()[0].header;
+    EXPECT_EQ(h.nCameraEntries, 2u);
+    EXPECT_EQ(h.nTimeEntries, 1u);
+    EXPECT_EQ(h.nScriptEntries, 1u);
+    EXPECT_EQ(h.firstTimestampApplication, 1.5);
+    EXPECT_EQ(h.firstTimestampRecorded, 0.5);
+    EXPECT_EQ(h.firstTimestampSimulation, 100.25);
+
+    std::vector<char> data;
+    ASSERT_TRUE(reader.readBlockData(in, 0, data));
+
+    size_t offset = 0;
+    auto readTimestamps = [&](char type, double recorded) {
+        ASSERT_LE(offset + EntryHeaderSize, data.size());
+        EXPECT_EQ(data[offset], type);
+        double timestamps[3];
+        std::memcpy(timestamps, data.data() + offset + 1, sizeof(timestamps));
+        EXPECT_EQ(timestamps[0], recorded + 1.0);
+        EXPECT_EQ(timestamps[1], recorded);
+        EXPECT_EQ(timestamps[2], recorded + 99.75);
+        offset += EntryHeaderSize;
+    };
+
+    readTimestamps('c', 0.5);
+    openspace::datamessagestructures::CameraKeyframe kf;
+    offset = kf.deserialize(data, offset);
+    EXPECT_EQ(kf._position, glm::dvec3(1.0, 2.0, 3.0));
+    EXPECT_EQ(kf._rotation, glm::dquat(0.5, 0.5, 0.5, 0.5));
+    EXPECT_EQ(kf._scale, 2.5f);
+    EXPECT_TRUE(kf._followNodeRotation);
+    EXPECT_EQ(kf._focusNode, "Earth");
+    EXPECT_EQ(kf._timestamp, 1.5);
+
+    readTimestamps('t', 1.5);
+    double dt;
+    std::memcpy(&dt, data.data() + offset, sizeof(double));
+    EXPECT_EQ(dt, 0.1);
+    EXPECT_EQ(data[offset + sizeof(double)], 1);
+    EXPECT_EQ(data[offset + sizeof(double) + 1], 1);
+    offset += sizeof(double) + 2;
+
+    readTimestamps('s', 2.5);
+    size_t scriptLength;
+    std::memcpy(&scriptLength, data.data() + offset, sizeof(size_t));
+    offset += sizeof(size_t);
+    EXPECT_EQ(
+        std::string(data.data() + offset, scriptLength),
+        "openspace.printInfo('a')\nopenspace.printInfo('b')"
+    );
+    offset += scriptLength;
+
+    readTimestamps('c', 3.5);
+    offset = kf.deserialize(data, offset);
+    EXPECT_EQ(kf._position, glm::dvec3(-1.0, -2.0, -3.0));
+    EXPECT_FALSE(kf._followNodeRotation);
+    EXPECT_EQ(kf._focusNode, "Mars");
+    EXPECT_EQ(offset, data.size());
+}
@@ -0,0 +1,227 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/speckfile.h>
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+
+class SpeckFileTest : public testing::Test {
+protected:
+    const std::string _file = absPath("${CACHE}/test_speckfile.speck");
+};
+
+TEST_F(SpeckFileTest, Scanner) {
+    using namespace openspace::speck;
+
+    const std::string content =
+        "# comment\r\n"
+        "\n"
+        "   \t\n"
+        "datavar 0  lum\r\n"
+        "  1.5 -2e3 +.25 7E-2 abc # name\n"
+        "last";
+    Scanner scanner(content.data(), content.data() + content.size());
+
+    ASSERT_TRUE(scanner.nextLine());
+    EXPECT_EQ(scanner.token(), "datavar");
+    float value = -1.f;
+    ASSERT_TRUE(scanner.number(value));
+    EXPECT_EQ(value, 0.f);
+    EXPECT_EQ(scanner.token(), "lum");
+    EXPECT_FALSE(scanner.hasToken()) << "The \\r must not be a token";
+    EXPECT_EQ(scanner.token(), "");
+
+    ASSERT_TRUE(scanner.nextLine());
+    ASSERT_TRUE(scanner.number(value));
+    EXPECT_EQ(value, 1.5f);
+    ASSERT_TRUE(scanner.number(value));
+    EXPECT_EQ(value, -2000.f);
+    ASSERT_TRUE(scanner.number(value));
+    EXPECT_EQ(value, 0.25f);
+    ASSERT_TRUE(scanner.number(value));
+    EXPECT_EQ(value, 0.07f);
+    EXPECT_FALSE(scanner.number(value));
+    EXPECT_EQ(value, 0.07f) << "A failed number must not change the value";
+    EXPECT_EQ(scanner.token(), "abc");
+    EXPECT_EQ(scanner.token(), "#");
+
+    scanner.rewindLine();
+    ASSERT_TRUE(scanner.number(value));
+    EXPECT_EQ(value, 1.5f);
+
+    ASSERT_TRUE(scanner.nextLine());
+    EXPECT_EQ(scanner.token(), "last");
+    EXPECT_FALSE(scanner.nextLine());
+}
+
+TEST_F(SpeckFileTest, NumberPrecision) {
+    using namespace openspace::speck;
+
+    // The parsed numbers have to be identical to those of the standard library
+    const char* numbers[] = {
+        "0", "-0.0", "1", "0.1", "3.14159265358979", "123456789012345678901234",
+        "1e-30", "-6.02214076e23", "0.000001234567", "98765.4321", "1.17549435e-38",
+        "3.40282346e38", "2.5E+10",
+        // Close to halfway between two floats, where a double rounded to float is off
+        "108.163814544677734", "0.23959892243146896", "0.3864121586084365845",
+        "4.290845421016014e-26", "2.618502145732772e+17", "1e39", "4.5e-44"
+    };
+    for (const char* number : numbers) {
+        const std::string content = number;
+        Scanner scanner(content.data(), content.data() + content.size());
+        ASSERT_TRUE(scanner.nextLine());
+        float value;
+        ASSERT_TRUE(scanner.number(value)) << number;
+        EXPECT_EQ(value, std::strtof(number, nullptr)) << number;
+    }
+
+    // The numbers halfway between random floats, written with varying precision
+    std::mt19937 generator(1337);
+    std::uniform_real_distribution<float> distribution(-1e6f, 1e6f);
+    for (int i = 0; i < 100000; ++i) {
+        const float f = distribution(generator);
+        const double halfway =
+            (static_cast<double>(f) + std::nextafter(f, 2e6f)) / 2.0;
+        char number[32];
+        std::snprintf(number, sizeof(number), "%.*g", 9 + i % 11, halfway);
+
+        Scanner scanner(number, number + std::strlen(number));
+        ASSERT_TRUE(scanner.nextLine());
+        float value;
+        ASSERT_TRUE(scanner.number(value)) << number;
+        EXPECT_EQ(value, std::strtof(number, nullptr)) << number;
+    }
+}
+
+TEST_F(SpeckFileTest, LoadDataset) {
+    using namespace openspace::speck;
+
+    {
+        std::ofstream file(_file);
+        file << "# Test dataset\n"
+                "datavar 0 colorb_v\n"
+                "datavar 1 ori\n"
+                "texturevar 7\n"
+                "polyorivar 1\n"
+                "texture -M 1 galaxy-1.sgi\n"
+                "maxcomment 2\n"
+                "\n"
+                "1 2 3 4 5 6 7 8 9 10 11 # first\r\n"
+                "# comment between the data\n"
+                "-1 -2 -3 0.5\n";
+    }
+
+    Dataset dataset;
+    ASSERT_TRUE(loadSpeckFile(_file, dataset));
+    ASSERT_EQ(dataset.variables.size(), 2);
+    EXPECT_EQ(dataset.variables[0].index, 0);
+    EXPECT_EQ(dataset.variables[0].name, "colorb_v");
+    EXPECT_EQ(dataset.variables[1].index, 1);
+    EXPECT_EQ(dataset.variables[1].name, "ori");
+    EXPECT_EQ(dataset.textureVariable, 7);
+    EXPECT_EQ(dataset.orientationVariable, 1);
+    ASSERT_EQ(dataset.textures.size(), 1);
+    EXPECT_EQ(dataset.textures[0].index, 1);
+    EXPECT_EQ(dataset.textures[0].file, "galaxy-1.sgi");
+
+    // X, Y, Z, one value for colorb_v, and six for the orientation
+    ASSERT_EQ(dataset.valuesPerEntry, 10);
+    ASSERT_EQ(dataset.numberOfEntries(), 2);
+    const std::vector<float> expected = {
+        1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f,
+        -1.f, -2.f, -3.f, 0.5f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f
+    };
+    EXPECT_EQ(dataset.values, expected);
+
+    const std::string missing = absPath("${CACHE}/test_speckfile_missing.speck");
+    EXPECT_FALSE(loadSpeckFile(missing, dataset));
+}
+
+TEST_F(SpeckFileTest, ConcurrentLoad) {
+    using namespace openspace;
+
+    // Large enough to be split into multiple chunks
+    {
+        std::ofstream file(_file);
+        file << "datavar 0 lum\n";
+        for (int i = 0; i < 400000; ++i) {
+            file << i << ".25 " << -i << " 1e-3 " << (i % 7) << " # star\n";
+            if (i % 1000 == 0) {
+                file << "# comment\n\n";
+            }
+        }
+    }
+
+    speck::Dataset serial;
+    ASSERT_TRUE(speck::loadSpeckFile(_file, serial));
+    ASSERT_EQ(serial.numberOfEntries(), 400000);
+    EXPECT_EQ(serial.values[4 * 12345 + 0], 12345.25f);
+    EXPECT_EQ(serial.values[4 * 12345 + 1], -12345.f);
+    EXPECT_EQ(serial.values[4 * 12345 + 3], 12345 % 7);
+
+    TaskScheduler scheduler(3);
+    speck::Dataset concurrent;
+    ASSERT_TRUE(speck::loadSpeckFile(_file, concurrent, &scheduler));
+    EXPECT_EQ(concurrent.values, serial.values);
+}
+
+TEST_F(SpeckFileTest, LabelsAndColorMap) {
+    using namespace openspace::speck;
+
+    {
+        std::ofstream file(_file);
+        file << "textcolor 1\n"
+                "1 2 3 text Alpha  Centauri # comment\n"
+                "4 5 6 text Sol\r\n";
+    }
+    std::vector<Label> labels;
+    ASSERT_TRUE(loadLabelFile(_file, labels));
+    ASSERT_EQ(labels.size(), 2);
+    EXPECT_EQ(labels[0].position, glm::vec3(1.f, 2.f, 3.f));
+    EXPECT_EQ(labels[0].text, "Alpha Centauri");
+    EXPECT_EQ(labels[1].position, glm::vec3(4.f, 5.f, 6.f));
+    EXPECT_EQ(labels[1].text, "Sol");
+
+    {
+        std::ofstream file(_file);
+        file << "# Color map\n"
+                "2\n"
+                "1 0 0 1\n"
+                "0 0.5 1 0.25\n";
+    }
+    std::vector<glm::vec4> colors;
+    ASSERT_TRUE(loadColorMapFile(_file, colors));
+    ASSERT_EQ(colors.size(), 2);
+    EXPECT_EQ(colors[0], glm::vec4(1.f, 0.f, 0.f, 1.f));
+    EXPECT_EQ(colors[1], glm::vec4(0.f, 0.5f, 1.f, 0.25f));
+}
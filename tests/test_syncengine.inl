@@ -0,0 +1,183 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/engine/syncengine.h>
+#include <openspace/util/syncable.h>
+#include <openspace/util/syncbuffer.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace {
+    class TestSyncable : public openspace::Syncable {
+    public:
+        std::string value;
+        std::string received;
+        int nDecodes = 0;
+
+    protected:
+        void encode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->encode(value);
+        }
+
+        void decode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->decode(received);
+            ++nDecodes;
+        }
+    };
+
+    struct Cluster {
+        Cluster(size_t nSyncables) : master(4096), slave(4096) {
+            masterSyncables.resize(nSyncables);
+            slaveSyncables.resize(nSyncables);
+            for (size_t i = 0; i < nSyncables; ++i) {
+                master.addSyncable(&masterSyncables[i]);
+                slave.addSyncable(&slaveSyncables[i]);
+            }
+        }
+
+        // Returns the number of bytes that were transferred
+        size_t synchronize() {
+            std::vector<char> data = master.encodeSyncables();
+            const size_t size = data.size();
+            slave.decodeSyncables(std::move(data));
+            return size;
+        }
+
+        openspace::SyncEngine master;
+        openspace::SyncEngine slave;
+        std::vector<TestSyncable> masterSyncables;
+        std::vector<TestSyncable> slaveSyncables;
+    };
+} // namespace
+
+class SyncEngineTest : public testing::Test {};
+
+TEST_F(SyncEngineTest, OnlyTransfersChangedSyncables) {
+    Cluster cluster(16);
+    for (size_t i = 0; i < 16; ++i) {
+        cluster.masterSyncables[i].value = std::string(100, 'a' + static_cast<char>(i));
+    }
+    const size_t keyframeSize = cluster.synchronize();
+    for (size_t i = 0; i < 16; ++i) {
+        ASSERT_EQ(cluster.slaveSyncables[i].received, cluster.masterSyncables[i].value);
+    }
+
+    cluster.masterSyncables[3].value = "changed";
+    const size_t deltaSize = cluster.synchronize();
+    EXPECT_LT(deltaSize, keyframeSize / 10) << "Only one Syncable should be transferred";
+    EXPECT_EQ(cluster.slaveSyncables[3].received, "changed");
+
+    // Unchanged Syncables have to be decoded every frame, as they might rely on it
+    for (size_t i = 0; i < 16; ++i) {
+        EXPECT_EQ(cluster.slaveSyncables[i].nDecodes, 2);
+        EXPECT_EQ(cluster.slaveSyncables[i].received, cluster.masterSyncables[i].value);
+    }
+}
+
+TEST_F(SyncEngineTest, Compression) {
+    Cluster cluster(4);
+    cluster.master.setCompressionEnabled(true);
+    for (TestSyncable& s : cluster.masterSyncables) {
+        s.value = std::string(10000, 'x');
+    }
+    const size_t size = cluster.synchronize();
+    EXPECT_LT(size, 4000) << "Repetitive data should be compressed";
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(cluster.slaveSyncables[i].received, cluster.masterSyncables[i].value);
+    }
+
+    // Data that is too small to be compressed is sent uncompressed
+    cluster.masterSyncables[0].value = "a";
+    cluster.synchronize();
+    EXPECT_EQ(cluster.slaveSyncables[0].received, "a");
+}
+
+TEST_F(SyncEngineTest, RejectsOversizedFrame) {
+    Cluster cluster(1);
+
+    // A compressed keyframe that claims to expand to almost 4 GB
+    std::vector<char> frame;
+    const uint8_t flags = 0b11;
+    const uint32_t nSyncables = 1;
+    const uint32_t uncompressedSize = 0xFFFFFFF0;
+    frame.insert(frame.end(), reinterpret_cast<const char*>(&flags),
+        reinterpret_cast<const char*>(&flags) + sizeof(uint8_t));
+    frame.insert(frame.end(), reinterpret_cast<const char*>(&nSyncables),
+        reinterpret_cast<const char*>(&nSyncables) + sizeof(uint32_t));
+    frame.insert(frame.end(), reinterpret_cast<const char*>(&uncompressedSize),
+        reinterpret_cast<const char*>(&uncompressedSize) + sizeof(uint32_t));
+    frame.insert(frame.end(), 16, 'x');
+
+    cluster.slave.decodeSyncables(std::move(frame));
+    EXPECT_EQ(cluster.slaveSyncables[0].nDecodes, 0);
+
+    // The engine still accepts valid frames afterwards
+    cluster.masterSyncables[0].value = "valid";
+    cluster.synchronize();
+    EXPECT_EQ(cluster.slaveSyncables[0].received, "valid");
+}
+
+TEST_F(SyncEngineTest, DISABLED_LoopbackBenchmark) {
+    // Roughly the state of a large scene: many Syncables of which few change each frame
+    constexpr const size_t NSyncables = 500;
+    constexpr const size_t SyncableSize = 256;
+    constexpr const int NFrames = 1000;
+    constexpr const size_t NChangesPerFrame = 20;
+
+    for (bool isCompressed : { false, true }) {
+        Cluster cluster(NSyncables);
+        cluster.master.setCompressionEnabled(isCompressed);
+        std::mt19937 random(1337);
+        for (TestSyncable& s : cluster.masterSyncables) {
+            s.value = std::string(SyncableSize, 'a');
+        }
+
+        size_t nBytes = 0;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < NFrames; ++frame) {
+            for (size_t i = 0; i < NChangesPerFrame; ++i) {
+                std::string& value = cluster.masterSyncables[random() % NSyncables].value;
+                value[random() % SyncableSize] = static_cast<char>(random());
+            }
+            nBytes += cluster.synchronize();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+
+        for (size_t i = 0; i < NSyncables; ++i) {
+            const TestSyncable& s = cluster.slaveSyncables[i];
+            ASSERT_EQ(s.received, cluster.masterSyncables[i].value);
+        }
+
+        const double stateSize = static_cast<double>(NSyncables * SyncableSize * NFrames);
+        std::cout << (isCompressed ? "Compressed" : "Uncompressed") << ": "
+            << nBytes / NFrames << " bytes per frame ("
+            << 100.0 * nBytes / stateSize << "% of the full state), "
+            << stateSize / seconds / (1024.0 * 1024.0) << " MB/s of state encoded and "
+            << "decoded, " << 1000.0 * seconds / NFrames << " ms per frame" << std::endl;
+    }
+}
@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/taskscheduler.h>
+#include <openspace/util/threadpool.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+class TaskSchedulerTest : public testing::Test {};
+
+TEST_F(TaskSchedulerTest, ExecutesAllTasks) {
+    openspace::TaskScheduler scheduler(4);
+    openspace::TaskGroup group(scheduler);
+
+    std::atomic_int counter = 0;
+    for (int i = 0; i < 1000; ++i) {
+        group.run([&counter]() { ++counter; });
+    }
+    group.wait();
+
+    EXPECT_TRUE(group.isDone());
+    EXPECT_EQ(counter, 1000) << "All tasks should have run after wait";
+}
+
+TEST_F(TaskSchedulerTest, NestedGroups) {
+    // Waiting on a group from inside a task must not deadlock even with a single worker
+    openspace::TaskScheduler scheduler(1);
+    openspace::TaskGroup outer(scheduler);
+
+    std::atomic_int counter = 0;
+    for (int i = 0; i < 8; ++i) {
+        outer.run([&scheduler, &counter]() {
+            openspace::TaskGroup inner(scheduler);
+            for (int j = 0; j < 8; ++j) {
+                inner.run([&counter]() { ++counter; });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+
+    EXPECT_EQ(counter, 64) << "All nested tasks should have run after wait";
+}
+
+TEST_F(TaskSchedulerTest, Priorities) {
+    using Priority = openspace::TaskScheduler::Priority;
+    openspace::TaskScheduler scheduler(1);
+
+    // Block the only worker so that the following tasks queue up behind it
+    std::atomic_bool isBlocked = true;
+    std::atomic_bool hasStarted = false;
+    scheduler.enqueue([&isBlocked, &hasStarted]() {
+        hasStarted = true;
+        while (isBlocked) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!hasStarted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::mutex mutex;
+    std::vector<Priority> order;
+    openspace::TaskGroup group(scheduler);
+    for (Priority p : { Priority::Low, Priority::Normal, Priority::High }) {
+        group.run(
+            [&mutex, &order, p]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(p);
+            },
+            p
+        );
+    }
+    isBlocked = false;
+    group.wait();
+
+    ASSERT_EQ(order.size(), 3);
+    EXPECT_EQ(order[0], Priority::High);
+    EXPECT_EQ(order[1], Priority::Normal);
+    EXPECT_EQ(order[2], Priority::Low);
+}
+
+TEST_F(TaskSchedulerTest, WaitOnlyRunsOwnTasks) {
+    using Priority = openspace::TaskScheduler::Priority;
+    openspace::TaskScheduler scheduler(1);
+
+    // Block the only worker so that all tasks have to be run by the waiting thread
+    std::atomic_bool isBlocked = true;
+    std::atomic_bool hasStarted = false;
+    scheduler.enqueue([&isBlocked, &hasStarted]() {
+        hasStarted = true;
+        while (isBlocked) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!hasStarted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Background work, both without a group and in another group
+    std::atomic_int nForeignTasks = 0;
+    scheduler.enqueue([&nForeignTasks]() { ++nForeignTasks; }, Priority::Low);
+    openspace::TaskGroup other(scheduler);
+    other.run([&nForeignTasks]() { ++nForeignTasks; }, Priority::Low);
+
+    std::atomic_int nOwnTasks = 0;
+    {
+        openspace::TaskGroup group(scheduler);
+        for (int i = 0; i < 4; ++i) {
+            group.run([&nOwnTasks]() { ++nOwnTasks; }, Priority::Low);
+        }
+        group.wait();
+    }
+
+    EXPECT_EQ(nOwnTasks, 4);
+    EXPECT_EQ(nForeignTasks, 0) << "Waiting must not run tasks of other groups";
+    EXPECT_EQ(scheduler.numberOfPendingTasks(), 2);
+
+    isBlocked = false;
+    other.wait();
+    while (scheduler.numberOfPendingTasks() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(other.isDone());
+}
+
+TEST_F(TaskSchedulerTest, ExceptionDoesNotBlockGroup) {
+    openspace::TaskScheduler scheduler(2);
+    openspace::TaskGroup group(scheduler);
+
+    std::atomic_int counter = 0;
+    group.run([]() { throw std::runtime_error("Expected failure"); });
+    group.run([&counter]() { ++counter; });
+    group.wait();
+
+    EXPECT_EQ(counter, 1);
+}
+
+namespace {
+    // Microbenchmark that compares the TaskScheduler to the single-queue ThreadPool. The
+    // tests are disabled by default and can be run by passing
+    // --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+    template <typename Func>
+    double measureMilliseconds(Func&& f) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void spin(int nIterations, std::atomic_int& sink) {
+        int value = 0;
+        for (int i = 0; i < nIterations; ++i) {
+            value += (i * 31) ^ (value >> 3);
+        }
+        sink += value & 1;
+    }
+
+    void benchmark(int nTasks, int nIterations) {
+        const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 2u);
+        std::atomic_int sink = 0;
+
+        double threadPoolTime = measureMilliseconds([&]() {
+            std::atomic_int nFinished = 0;
+            openspace::ThreadPool pool(nThreads);
+            for (int i = 0; i < nTasks; ++i) {
+                pool.enqueue([&]() {
+                    spin(nIterations, sink);
+                    ++nFinished;
+                });
+            }
+            while (nFinished < nTasks) {
+                std::this_thread::yield();
+            }
+        });
+
+        double schedulerTime = measureMilliseconds([&]() {
+            openspace::TaskScheduler scheduler(nThreads);
+            openspace::TaskGroup group(scheduler);
+            for (int i = 0; i < nTasks; ++i) {
+                group.run([&]() { spin(nIterations, sink); });
+            }
+            group.wait();
+        });
+
+        std::cout << nTasks << " tasks of " << nIterations << " iterations on "
+            << nThreads << " threads: ThreadPool " << threadPoolTime
+            << " ms, TaskScheduler " << schedulerTime << " ms" << std::endl;
+    }
+} // namespace
+
+TEST_F(TaskSchedulerTest, DISABLED_BenchmarkTinyTasks) {
+    benchmark(1000000, 10);
+}
+
+TEST_F(TaskSchedulerTest, DISABLED_BenchmarkLargeTasks) {
+    benchmark(2000, 1000000);
+}
@@ -0,0 +1,192 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/src/tilepreprocessing.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+class TilePreprocessingTest : public testing::Test {};
+
+namespace {
+    // Straightforward implementation to compare the vectorized kernels against
+    template <typename T>
+    openspace::globebrowsing::TileMetaData referenceMetaData(std::vector<T>& values,
+                                                             size_t nRasters,
+                                                             float noDataValue)
+    {
+        openspace::globebrowsing::TileMetaData result;
+        result.maxValues.resize(nRasters, -FLT_MAX);
+        result.minValues.resize(nRasters, FLT_MAX);
+        result.hasMissingData.resize(nRasters, false);
+        for (size_t i = 0; i < values.size(); ++i) {
+            const size_t raster = i % nRasters;
+            const float value = static_cast<float>(values[i]);
+            if (value != noDataValue && !std::isnan(value)) {
+                result.maxValues[raster] = std::max(result.maxValues[raster], value);
+                result.minValues[raster] = std::min(result.minValues[raster], value);
+            }
+            else {
+                result.hasMissingData[raster] = true;
+                values[i] = std::is_floating_point_v<T> ?
+                    static_cast<T>(-FLT_MAX) :
+                    std::numeric_limits<T>::lowest();
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    std::vector<T> randomTile(size_t nValues, T noDataValue, std::mt19937& random) {
+        std::uniform_real_distribution<double> dist(-1000.0, 70000.0);
+        std::vector<T> values(nValues);
+        for (size_t i = 0; i < nValues; ++i) {
+            const double v = dist(random);
+            values[i] = static_cast<T>(std::clamp(
+                v,
+                static_cast<double>(std::numeric_limits<T>::lowest()),
+                static_cast<double>(std::numeric_limits<T>::max())
+            ));
+            if (random() % 50 == 0) {
+                values[i] = noDataValue;
+            }
+            if constexpr (std::is_floating_point_v<T>) {
+                if (random() % 70 == 0) {
+                    values[i] = std::numeric_limits<T>::quiet_NaN();
+                }
+            }
+        }
+        return values;
+    }
+
+    template <typename T>
+    void compareWithReference(GLenum glType, T noDataValue) {
+        std::mt19937 random(1337);
+        for (size_t nRasters = 1; nRasters <= 4; ++nRasters) {
+            // An odd number of pixels exercises the scalar remainder of the vector loop
+            const size_t nValues = 67 * 61 * nRasters;
+            std::vector<T> values = randomTile<T>(nValues, noDataValue, random);
+            std::vector<T> expectedValues = values;
+
+            const float noData = static_cast<float>(noDataValue);
+            openspace::globebrowsing::TileMetaData expected = referenceMetaData(
+                expectedValues,
+                nRasters,
+                noData
+            );
+            openspace::globebrowsing::TileMetaData result =
+                openspace::globebrowsing::calculateTileMetaData(
+                    reinterpret_cast<std::byte*>(values.data()),
+                    nValues,
+                    nRasters,
+                    glType,
+                    noData
+                );
+
+            EXPECT_EQ(result.minValues, expected.minValues) << nRasters << " rasters";
+            EXPECT_EQ(result.maxValues, expected.maxValues) << nRasters << " rasters";
+            EXPECT_EQ(result.hasMissingData, expected.hasMissingData);
+            EXPECT_EQ(
+                std::memcmp(values.data(), expectedValues.data(), nValues * sizeof(T)),
+                0
+            ) << "Missing values must be replaced";
+        }
+    }
+} // namespace
+
+TEST_F(TilePreprocessingTest, Float) {
+    compareWithReference<GLfloat>(GL_FLOAT, -32768.f);
+}
+
+TEST_F(TilePreprocessingTest, UnsignedShort) {
+    compareWithReference<GLushort>(GL_UNSIGNED_SHORT, 0);
+}
+
+TEST_F(TilePreprocessingTest, Short) {
+    compareWithReference<GLshort>(GL_SHORT, -32768);
+}
+
+TEST_F(TilePreprocessingTest, UnsignedByte) {
+    compareWithReference<GLubyte>(GL_UNSIGNED_BYTE, 255);
+}
+
+TEST_F(TilePreprocessingTest, AllMissing) {
+    std::vector<GLfloat> values(64, std::numeric_limits<float>::quiet_NaN());
+    openspace::globebrowsing::TileMetaData result =
+        openspace::globebrowsing::calculateTileMetaData(
+            reinterpret_cast<std::byte*>(values.data()),
+            values.size(),
+            1,
+            GL_FLOAT,
+            0.f
+        );
+    EXPECT_TRUE(result.hasMissingData[0]);
+    EXPECT_GT(result.minValues[0], result.maxValues[0]);
+}
+
+namespace {
+    // Benchmark of the tile preprocessing on 512x512 tiles. The tests are disabled by
+    // default and can be run by passing
+    // --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+    template <typename T>
+    void benchmarkTiles(GLenum glType, const char* typeName) {
+        constexpr const size_t TileSize = 512;
+        constexpr const int NumIterations = 500;
+
+        std::mt19937 random(1337);
+        std::vector<T> values = randomTile<T>(TileSize * TileSize, T(0), random);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        float sink = 0.f;
+        for (int i = 0; i < NumIterations; ++i) {
+            openspace::globebrowsing::TileMetaData result =
+                openspace::globebrowsing::calculateTileMetaData(
+                    reinterpret_cast<std::byte*>(values.data()),
+                    values.size(),
+                    1,
+                    glType,
+                    0.f
+                );
+            sink += result.maxValues[0];
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << TileSize << "x" << TileSize << " " << typeName << " tiles: "
+            << NumIterations / seconds << " tiles/s (" << sink << ")" << std::endl;
+    }
+} // namespace
+
+TEST_F(TilePreprocessingTest, DISABLED_BenchmarkFloat) {
+    benchmarkTiles<GLfloat>(GL_FLOAT, "float");
+}
+
+TEST_F(TilePreprocessingTest, DISABLED_BenchmarkUnsignedShort) {
+    benchmarkTiles<GLushort>(GL_UNSIGNED_SHORT, "uint16");
+}
@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/spicemanager.h>
+#include <openspace/util/timeformat.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <cstring>
+#include <limits>
+
+class TimeFormatTest : public testing::Test {
+protected:
+    void SetUp() override {
+        openspace::SpiceManager::initialize();
+        openspace::SpiceManager::ref().loadKernel(
+            absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls")
+        );
+    }
+
+    void TearDown() override {
+        openspace::SpiceManager::deinitialize();
+    }
+};
+
+namespace {
+    // Ephemeris times from the year 1049 to 2950, plus the seconds around a leap second
+    std::vector<double> testTimes() {
+        std::vector<double> times;
+        for (double et = -3e10; et < 3e10; et += 7346917.123) {
+            times.push_back(et);
+        }
+        // 2005 DEC 31 23:59:60 is at about 189345664.18 seconds past J2000
+        for (double et = 189345660.0; et < 189345670.0; et += 0.1234) {
+            times.push_back(et);
+        }
+        return times;
+    }
+
+    // The number of doubles between a and b, counting across zero
+    int64_t ulpDistance(double a, double b) {
+        int64_t ia;
+        int64_t ib;
+        std::memcpy(&ia, &a, sizeof(double));
+        std::memcpy(&ib, &b, sizeof(double));
+        // Map the sign and magnitude representation onto a monotonic integer scale
+        if (ia < 0) {
+            ia = std::numeric_limits<int64_t>::min() - ia;
+        }
+        if (ib < 0) {
+            ib = std::numeric_limits<int64_t>::min() - ib;
+        }
+        return ia > ib ? ia - ib : ib - ia;
+    }
+} // namespace
+
+TEST_F(TimeFormatTest, LeapSecondTable) {
+    const auto table = openspace::SpiceManager::ref().leapSecondTable();
+    ASSERT_FALSE(table->deltaAT.empty());
+    EXPECT_EQ(table->deltaAT.front().first, 10.0);
+    EXPECT_EQ(table->deltaAT.back().first, 33.0);
+    EXPECT_EQ(table->deltaTA, 32.184);
+}
+
+TEST_F(TimeFormatTest, FormatMatchesSpice) {
+    using namespace openspace;
+    const SpiceManager& spice = SpiceManager::ref();
+    const auto table = spice.leapSecondTable();
+
+    for (double et : testTimes()) {
+        char buffer[DateBufferSize];
+        ASSERT_TRUE(formatDate(et, *table, DateFormat::Spice, buffer));
+        EXPECT_EQ(std::string(buffer), spice.dateFromEphemerisTime(et)) << et;
+
+        ASSERT_TRUE(formatDate(et, *table, DateFormat::ISO8601, buffer));
+        EXPECT_EQ(
+            std::string(buffer),
+            spice.dateFromEphemerisTime(et, "YYYY-MM-DDTHR:MN:SC.### ::RND")
+        ) << et;
+    }
+}
+
+TEST_F(TimeFormatTest, ParseMatchesSpice) {
+    using namespace openspace;
+    const SpiceManager& spice = SpiceManager::ref();
+    const auto table = spice.leapSecondTable();
+
+    for (double et : testTimes()) {
+        const std::string dates[] = {
+            spice.dateFromEphemerisTime(et),
+            spice.dateFromEphemerisTime(et, "YYYY-MM-DDTHR:MN:SC.###### ::RND"),
+            spice.dateFromEphemerisTime(et, "YYYY MON DD HR:MN:SC ::RND"),
+            spice.dateFromEphemerisTime(et, "YYYY-MM-DD ::TRNC")
+        };
+        for (const std::string& date : dates) {
+            double parsed;
+            ASSERT_TRUE(parseDate(date, *table, parsed)) << date;
+            const double expected = spice.ephemerisTimeFromDate(date);
+            EXPECT_LE(ulpDistance(parsed, expected), MaxParseErrorUlps)
+                << date << ": " << parsed << " instead of " << expected;
+        }
+    }
+}
+
+TEST_F(TimeFormatTest, UnsupportedFormats) {
+    using namespace openspace;
+    const auto table = SpiceManager::ref().leapSecondTable();
+
+    double et;
+    EXPECT_FALSE(parseDate("2018-001T00:00:00", *table, et));
+    EXPECT_FALSE(parseDate("2018 JAN 01 00:00:00 TDB", *table, et));
+    EXPECT_FALSE(parseDate("2017-02-29", *table, et));
+    // The Gregorian calendar is used before 1582 as well
+    EXPECT_FALSE(parseDate("1500-02-29", *table, et));
+    EXPECT_FALSE(parseDate("2018-06-30T23:59:60", *table, et));
+    EXPECT_FALSE(parseDate("2018-01-01T24:00:00", *table, et));
+    EXPECT_FALSE(parseDate("2018-01-01", openspace::LeapSecondTable(), et));
+}
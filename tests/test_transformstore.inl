@@ -0,0 +1,110 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/scene/transformstore.h>
+
+class TransformStoreTest : public testing::Test {};
+
+TEST_F(TransformStoreTest, ComposesWorldTransforms) {
+    openspace::TransformStore store;
+    using Handle = openspace::TransformStore::Handle;
+    const Handle child = store.allocate();
+    const Handle root = store.allocate();
+    const Handle grandChild = store.allocate();
+
+    // The parent has to precede its children, regardless of the allocation order
+    store.setLayout({ root, child, grandChild }, {
+        openspace::TransformStore::InvalidHandle,
+        root,
+        child
+    });
+    EXPECT_EQ(store.slot(root), 0);
+    EXPECT_EQ(store.slot(child), 1);
+    EXPECT_EQ(store.slot(grandChild), 2);
+
+    // A rotation of 90 degrees around the z axis
+    const glm::dmat3 rotation = glm::dmat3(
+        glm::dvec3(0.0, 1.0, 0.0),
+        glm::dvec3(-1.0, 0.0, 0.0),
+        glm::dvec3(0.0, 0.0, 1.0)
+    );
+    store.setLocalTransform(root, glm::dvec3(1.0, 0.0, 0.0), glm::dmat3(1.0), 1.0);
+    store.setLocalTransform(child, glm::dvec3(0.0, 0.0, 1.0), rotation, 2.0);
+    store.setLocalTransform(grandChild, glm::dvec3(1.0, 0.0, 0.0), glm::dmat3(1.0), 1.0);
+    store.composeWorldTransforms(0, store.size());
+
+    EXPECT_EQ(store.worldPosition(child), glm::dvec3(1.0, 0.0, 1.0));
+    EXPECT_EQ(store.worldScale(grandChild), 2.0);
+    EXPECT_EQ(store.worldRotation(grandChild), rotation);
+    EXPECT_EQ(store.worldPosition(grandChild), glm::dvec3(1.0, 2.0, 1.0));
+    EXPECT_EQ(store.modelTransform(grandChild)[3], glm::dvec4(1.0, 2.0, 1.0, 1.0));
+    EXPECT_EQ(store.worldPositions()[2], store.worldPosition(grandChild));
+}
+
+TEST_F(TransformStoreTest, RetainsValuesAcrossLayouts) {
+    openspace::TransformStore store;
+    using Handle = openspace::TransformStore::Handle;
+    const Handle a = store.allocate();
+    const Handle b = store.allocate();
+    store.setLocalTransform(a, glm::dvec3(1.0), glm::dmat3(1.0), 1.0);
+    store.setLocalTransform(b, glm::dvec3(2.0), glm::dmat3(1.0), 1.0);
+    store.composeWorldTransforms(0, store.size());
+
+    // Released slots are reclaimed and unordered handles are placed last
+    store.release(a);
+    const Handle c = store.allocate();
+    EXPECT_EQ(c, a) << "Released handles should be reused";
+    store.setLayout({ c }, { openspace::TransformStore::InvalidHandle });
+    EXPECT_EQ(store.size(), 2);
+    EXPECT_EQ(store.slot(c), 0);
+    EXPECT_EQ(store.slot(b), 1);
+    EXPECT_EQ(store.worldPosition(c), glm::dvec3(0.0));
+    EXPECT_EQ(store.worldPosition(b), glm::dvec3(2.0));
+}
+
+TEST_F(TransformStoreTest, SkipsUnchangedSubtrees) {
+    openspace::TransformStore store;
+    using Handle = openspace::TransformStore::Handle;
+    const Handle root = store.allocate();
+    const Handle child = store.allocate();
+    const Handle sibling = store.allocate();
+    const Handle none = openspace::TransformStore::InvalidHandle;
+    store.setLayout({ root, child, sibling }, { none, root, none });
+    store.composeWorldTransforms(0, store.size());
+    EXPECT_TRUE(store.hasWorldTransformChanged(child));
+
+    store.composeWorldTransforms(0, store.size());
+    EXPECT_FALSE(store.hasWorldTransformChanged(root));
+    EXPECT_FALSE(store.hasWorldTransformChanged(child));
+
+    // Changing the root invalidates its subtree, but not the unrelated sibling
+    store.setLocalTransform(root, glm::dvec3(1.0), glm::dmat3(1.0), 1.0);
+    store.composeWorldTransforms(0, store.size());
+    EXPECT_TRUE(store.hasWorldTransformChanged(root));
+    EXPECT_TRUE(store.hasWorldTransformChanged(child));
+    EXPECT_FALSE(store.hasWorldTransformChanged(sibling));
+    EXPECT_EQ(store.worldPosition(child), glm::dvec3(1.0));
+}